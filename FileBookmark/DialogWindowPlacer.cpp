@@ -15,6 +15,8 @@
 //
 #include "DialogWindowPlacer.h"
 
+#include "../_shared/WindowQuery/WindowQuery.h"
+
 #include <vector>
 #include <chrono>
 #include <algorithm>
@@ -23,22 +25,17 @@ using filebookmark::DialogWindowPlacer;
 
 namespace
 {
-	struct WindowCollectorContext {
-		DWORD processId;
-		std::vector<HWND> wnds;
-	};
-
-	BOOL CALLBACK CollectProcessWindows(_In_ HWND hWnd, _In_ LPARAM lParam)
+	void CollectProcessWindows(WQQuery& query, std::vector<WQWindow>& wnds)
 	{
-		WindowCollectorContext* context = reinterpret_cast<WindowCollectorContext*>(lParam);
-		DWORD processId = 0;
-		DWORD threadId = ::GetWindowThreadProcessId(hWnd, &processId);
+		wnds.clear();
 
-		if (IsWindowVisible(hWnd) && (processId == context->processId))
+		WQSnapshot snapshot;
+		if (WQSnapshotTake(&snapshot, WQGetWin32Provider(), 0))
 		{
-			context->wnds.push_back(hWnd);
+			wnds.resize(snapshot.count);
+			wnds.resize(WQQueryRun(&query, &snapshot, wnds.data(), wnds.size()));
 		}
-		return TRUE;
+		WQSnapshotFree(&snapshot);
 	}
 
 	struct MonitorCollectorContext {
@@ -75,30 +72,35 @@ DialogWindowPlacer::DialogWindowPlacer()
 		}
 	}
 
-	WindowCollectorContext context;
-	context.processId = GetCurrentProcessId();
-	EnumWindows(&CollectProcessWindows, reinterpret_cast<LPARAM>(&context));
+	// visible windows of this process
+	m_processId = GetCurrentProcessId();
+	WQQueryInit(&m_query);
+	WQQueryProcessIdIn(&m_query, &m_processId, 1);
+	WQQueryVisible(&m_query);
+	WQQueryCompile(&m_query);
+
+	std::vector<WQWindow> windows;
+	CollectProcessWindows(m_query, windows);
 
 	m_run = true;
 	m_worker = std::move(std::thread(
-		[this, windows = context.wnds]()
+		[this, windows = std::move(windows)]()
 		{
-			WindowCollectorContext context;
-			context.processId = GetCurrentProcessId();
+			std::vector<WQWindow> wnds;
 			typedef std::chrono::high_resolution_clock clock;
 
 			auto start = clock::now();
 			while (m_run && ((clock::now() - start) < std::chrono::seconds(10)))
 			{
 				std::this_thread::sleep_for(std::chrono::milliseconds(10));
-				EnumWindows(&CollectProcessWindows, reinterpret_cast<LPARAM>(&context));
+				CollectProcessWindows(m_query, wnds);
 
-				for (HWND w : context.wnds)
+				for (WQWindow w : wnds)
 				{
 					if (std::find(windows.begin(), windows.end(), w) != windows.end())
 						continue;
 
-					PlaceWindow(w);
+					PlaceWindow(reinterpret_cast<HWND>(w));
 					m_run = false;
 				}
 			}
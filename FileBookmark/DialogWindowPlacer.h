@@ -19,6 +19,9 @@
 #define VC_EXTRALEAN
 #include <Windows.h>
 
+#include "../_shared/WindowQuery/WindowQuery.h"
+
+#include <cstdint>
 #include <thread>
 
 namespace filebookmark
@@ -36,6 +39,8 @@ namespace filebookmark
 		bool m_run;
 		std::thread m_worker;
 		RECT m_targetArea;
+		uint32_t m_processId;
+		WQQuery m_query;
 	};
 
 }
@@ -0,0 +1,112 @@
+#include "pch.h"
+#include "ActionRegistry.h"
+
+#include <cwctype>
+
+namespace
+{
+	bool EqualsNoCase(std::wstring const& a, std::wstring const& b)
+	{
+		if (a.size() != b.size()) return false;
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			if (std::towlower(a[i]) != std::towlower(b[i])) return false;
+		}
+		return true;
+	}
+}
+
+bool ActionRegistry::Register(std::wstring const& name, std::vector<Parameter> parameters, Handler handler)
+{
+	if (name.empty() || !handler) return false;
+	if (!m_byName.insert(std::make_pair(name, m_actions.size())).second) return false;
+	m_actions.push_back({ name, std::move(parameters), std::move(handler) });
+	return true;
+}
+
+bool ActionRegistry::Contains(std::wstring const& name) const
+{
+	return m_byName.find(name) != m_byName.end();
+}
+
+bool ActionRegistry::Bind(std::wstring const& name, std::vector<std::wstring> const& args, Binding& outBinding, std::wstring& outError) const
+{
+	outBinding = Binding{};
+
+	auto it = m_byName.find(name);
+	if (it == m_byName.end())
+	{
+		outError = L"action `" + name + L"` is unknown; available actions are";
+		for (Action const& action : m_actions)
+		{
+			outError += L" " + action.name;
+		}
+		return false;
+	}
+	Action const& action = m_actions[it->second];
+
+	if (args.size() > action.parameters.size())
+	{
+		outError = L"action `" + name + L"` takes at most " + std::to_wstring(action.parameters.size())
+			+ L" arguments, but " + std::to_wstring(args.size()) + L" are given";
+		return false;
+	}
+
+	std::vector<std::wstring> bound;
+	bound.reserve(action.parameters.size());
+	for (size_t i = 0; i < action.parameters.size(); ++i)
+	{
+		Parameter const& param = action.parameters[i];
+		if (i >= args.size())
+		{
+			if (param.required)
+			{
+				outError = L"action `" + name + L"` requires argument `" + param.name + L"`";
+				return false;
+			}
+			bound.push_back(param.defaultValue);
+			continue;
+		}
+
+		if (param.choices.empty())
+		{
+			bound.push_back(args[i]);
+			continue;
+		}
+
+		bool found = false;
+		for (std::wstring const& choice : param.choices)
+		{
+			if (EqualsNoCase(choice, args[i]))
+			{
+				bound.push_back(choice);
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+		{
+			outError = L"action `" + name + L"` argument `" + param.name + L"` must be one of";
+			for (std::wstring const& choice : param.choices)
+			{
+				outError += L" " + choice;
+			}
+			outError += L", but is " + args[i];
+			return false;
+		}
+	}
+
+	outBinding.m_index = it->second;
+	outBinding.m_args = std::move(bound);
+	return true;
+}
+
+bool ActionRegistry::Invoke(Binding const& binding, std::wstring& outError) const
+{
+	if (binding.m_index >= m_actions.size())
+	{
+		outError = L"action is not bound";
+		return false;
+	}
+	return m_actions[binding.m_index].handler(binding.m_args, outError);
+}
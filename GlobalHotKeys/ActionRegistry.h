@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// Named actions which hot keys configured with `action` instead of `exec` run in-process,
+/// e.g. to sound a beep without the cost of starting a process.
+/// Actions are registered once at startup. Arguments are bound and checked when a configuration is loaded,
+/// so running an action is a direct call.
+/// Has no platform dependencies.
+/// </summary>
+class ActionRegistry
+{
+public:
+	struct Parameter
+	{
+		std::wstring name;
+		// used if the argument is omitted; ignored for required parameters
+		std::wstring defaultValue{};
+		bool required{ false };
+		// if not empty, the argument must be one of these, compared case-insensitive
+		std::vector<std::wstring> choices{};
+	};
+
+	/// <summary>
+	/// Runs an action with exactly one argument per parameter.
+	/// Returns false and sets `outError` on failure.
+	/// Called on the launch worker thread.
+	/// </summary>
+	using Handler = std::function<bool(std::vector<std::wstring> const& args, std::wstring& outError)>;
+
+	/// <summary>
+	/// An action with its arguments bound at load time
+	/// </summary>
+	class Binding
+	{
+	public:
+		inline bool IsValid() const noexcept
+		{
+			return m_index != c_invalidIndex;
+		}
+
+		/// <summary>
+		/// One argument per parameter, with defaults applied and choices in their registered spelling
+		/// </summary>
+		inline std::vector<std::wstring> const& GetArguments() const noexcept
+		{
+			return m_args;
+		}
+
+	private:
+		friend class ActionRegistry;
+		static constexpr const size_t c_invalidIndex = SIZE_MAX;
+
+		size_t m_index{ c_invalidIndex };
+		std::vector<std::wstring> m_args{};
+	};
+
+	/// <summary>
+	/// Adds an action; returns false if an action of the same name is already registered
+	/// </summary>
+	bool Register(std::wstring const& name, std::vector<Parameter> parameters, Handler handler);
+
+	bool Contains(std::wstring const& name) const;
+
+	/// <summary>
+	/// Binds the positional `args` to the parameters of the named action.
+	/// On failure `outBinding` is invalid and `outError` describes the problem.
+	/// </summary>
+	bool Bind(std::wstring const& name, std::vector<std::wstring> const& args, Binding& outBinding, std::wstring& outError) const;
+
+	/// <summary>
+	/// Runs the bound action; does not allocate unless the action does
+	/// </summary>
+	bool Invoke(Binding const& binding, std::wstring& outError) const;
+
+private:
+	struct Action
+	{
+		std::wstring name;
+		std::vector<Parameter> parameters;
+		Handler handler;
+	};
+
+	std::vector<Action> m_actions{};
+	std::unordered_map<std::wstring, size_t> m_byName{};
+};
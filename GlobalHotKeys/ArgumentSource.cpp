@@ -0,0 +1,43 @@
+#include "pch.h"
+#include "ArgumentSource.h"
+
+bool ArgumentSource::GetEnvironmentValue(std::wstring const& name, std::wstring& outValue)
+{
+	const DWORD size = GetEnvironmentVariableW(name.c_str(), nullptr, 0);
+	if (size == 0) return false;
+	outValue.resize(size);
+	const DWORD len = GetEnvironmentVariableW(name.c_str(), outValue.data(), size);
+	if (len == 0 || len >= size) return false;
+	outValue.resize(len);
+	return true;
+}
+
+bool ArgumentSource::GetClipboardText(std::wstring& outText)
+{
+	if (!IsClipboardFormatAvailable(CF_UNICODETEXT)) return false;
+	if (!OpenClipboard(NULL)) return false;
+
+	bool found = false;
+	HANDLE data = GetClipboardData(CF_UNICODETEXT);
+	if (data != NULL)
+	{
+		const wchar_t* text = static_cast<const wchar_t*>(GlobalLock(data));
+		if (text != nullptr)
+		{
+			outText = text;
+			found = true;
+			GlobalUnlock(data);
+		}
+	}
+
+	CloseClipboard();
+	return found;
+}
+
+std::tm ArgumentSource::GetNow()
+{
+	const std::time_t now = std::time(nullptr);
+	std::tm local{};
+	localtime_s(&local, &now);
+	return local;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "ArgumentTemplate.h"
+
+/// <summary>
+/// Provides placeholder values from the process environment, the clipboard, and the system clock
+/// </summary>
+class ArgumentSource : public IArgumentSource
+{
+public:
+	bool GetEnvironmentValue(std::wstring const& name, std::wstring& outValue) override;
+	bool GetClipboardText(std::wstring& outText) override;
+	std::tm GetNow() override;
+};
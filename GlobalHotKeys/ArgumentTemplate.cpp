@@ -0,0 +1,279 @@
+#include "pch.h"
+#include "ArgumentTemplate.h"
+
+#include <cwchar>
+#include <iterator>
+
+namespace
+{
+	/// <summary>
+	/// Upper bound of the length of a conversion, or zero if the specifier is not supported.
+	/// Supported are the conversions of C99, which the MSVC runtime supports as well; not the modifiers `E`, `O` and `#`.
+	/// Names and locale formats are bounded generously.
+	/// </summary>
+	size_t GetMaxDateConversionLength(wchar_t spec)
+	{
+		switch (spec)
+		{
+		case L'%': case L'n': case L't':
+			return 1;
+		case L'C': case L'd': case L'e': case L'g': case L'H': case L'I': case L'j': case L'm': case L'M':
+		case L'S': case L'u': case L'U': case L'V': case L'w': case L'W': case L'y':
+			return 3;
+		case L'z': case L'R': case L'T': case L'D':
+			return 8;
+		case L'Y': case L'G':
+			return 11;
+		case L'F':
+			return 17;
+		case L'a': case L'A': case L'b': case L'B': case L'h': case L'p':
+			return 32;
+		case L'c': case L'r': case L'x': case L'X': case L'Z':
+			return 64;
+		default:
+			return 0;
+		}
+	}
+
+	void AddWarning(std::wstring& warnings, std::wstring const& warning)
+	{
+		if (!warnings.empty()) warnings += L"; ";
+		warnings += warning;
+	}
+}
+
+bool ArgumentTemplate::IsValidDateFormat(std::wstring const& format, std::wstring& outError)
+{
+	size_t maxLength = 0;
+	for (size_t i = 0; i < format.size(); ++i)
+	{
+		if (format[i] != L'%')
+		{
+			maxLength++;
+			continue;
+		}
+		if (++i == format.size())
+		{
+			outError = L"date format `" + format + L"` ends with `%`";
+			return false;
+		}
+		const size_t length = GetMaxDateConversionLength(format[i]);
+		if (length == 0)
+		{
+			outError = L"date format `" + format + L"` has unsupported conversion `%" + std::wstring(1, format[i]) + L"`";
+			return false;
+		}
+		maxLength += length;
+	}
+	if (maxLength > c_maxDateLength)
+	{
+		outError = L"date format `" + format + L"` can be longer than " + std::to_wstring(c_maxDateLength) + L" characters";
+		return false;
+	}
+	return true;
+}
+
+bool ArgumentTemplate::Compile(std::wstring const& source, std::wstring& outError, std::wstring& outWarning)
+{
+	m_tokens.clear();
+	outWarning.clear();
+
+	size_t pos = 0;
+	while (pos < source.size())
+	{
+		const size_t start = source.find(L"${", pos);
+		if (start == std::wstring::npos)
+		{
+			AppendLiteral(source.substr(pos));
+			break;
+		}
+		AppendLiteral(source.substr(pos, start - pos));
+
+		const size_t end = source.find(L'}', start + 2);
+		if (end == std::wstring::npos)
+		{
+			AddWarning(outWarning, L"placeholder at position " + std::to_wstring(start + 1) + L" is not closed by `}`, kept as text");
+			AppendLiteral(source.substr(start));
+			break;
+		}
+		const std::wstring name = source.substr(start + 2, end - start - 2);
+		pos = end + 1;
+
+		if (name == L"$")
+		{
+			AppendLiteral(L"$");
+		}
+		else if (name.compare(0, 4, L"env:") == 0 && name.size() > 4)
+		{
+			m_tokens.push_back({ Op::Env, name.substr(4) });
+		}
+		else if (name == L"date")
+		{
+			m_tokens.push_back({ Op::Date, c_defaultDateFormat });
+		}
+		else if (name.compare(0, 5, L"date:") == 0 && name.size() > 5)
+		{
+			std::wstring format = name.substr(5);
+			if (!IsValidDateFormat(format, outError))
+			{
+				m_tokens.clear();
+				return false;
+			}
+			m_tokens.push_back({ Op::Date, std::move(format) });
+		}
+		else if (name == L"configdir")
+		{
+			m_tokens.push_back({ Op::ConfigDir, {} });
+		}
+		else if (name == L"clipboard")
+		{
+			m_tokens.push_back({ Op::Clipboard, {} });
+		}
+		else
+		{
+			AddWarning(outWarning, L"unknown placeholder `${" + name + L"}` kept as text");
+			AppendLiteral(source.substr(start, end + 1 - start));
+		}
+	}
+
+	return true;
+}
+
+ArgumentTemplate ArgumentTemplate::Fold(IArgumentSource& source, std::filesystem::path const& configDir) const
+{
+	ArgumentTemplate folded;
+	for (Token const& token : m_tokens)
+	{
+		switch (token.op)
+		{
+		case Op::Literal:
+			folded.AppendLiteral(token.text);
+			break;
+		case Op::Env:
+		{
+			std::wstring value;
+			if (source.GetEnvironmentValue(token.text, value))
+			{
+				folded.AppendLiteral(value);
+			}
+			break;
+		}
+		case Op::ConfigDir:
+			folded.AppendLiteral(configDir.wstring());
+			break;
+		default:
+			folded.m_tokens.push_back(token);
+			break;
+		}
+	}
+	return folded;
+}
+
+void ArgumentTemplate::Evaluate(IArgumentSource& source, std::filesystem::path const& configDir, std::wstring& out) const
+{
+	for (Token const& token : m_tokens)
+	{
+		switch (token.op)
+		{
+		case Op::Literal:
+			out += token.text;
+			break;
+		case Op::Env:
+		{
+			std::wstring value;
+			if (source.GetEnvironmentValue(token.text, value))
+			{
+				out += value;
+			}
+			break;
+		}
+		case Op::Date:
+		{
+			// the format was checked by `IsValidDateFormat` when compiling
+			const std::tm now = source.GetNow();
+			wchar_t buf[c_maxDateLength + 1];
+			const size_t len = std::wcsftime(buf, std::size(buf), token.text.c_str(), &now);
+			out.append(buf, len);
+			break;
+		}
+		case Op::ConfigDir:
+			out += configDir.wstring();
+			break;
+		case Op::Clipboard:
+		{
+			std::wstring text;
+			if (source.GetClipboardText(text))
+			{
+				out += text;
+			}
+			break;
+		}
+		}
+	}
+}
+
+std::wstring ArgumentTemplate::GetLiteral() const
+{
+	return m_tokens.empty() ? std::wstring{} : m_tokens.front().text;
+}
+
+bool ArgumentTemplate::DependsOnEnvironment() const noexcept
+{
+	for (Token const& token : m_tokens)
+	{
+		if (token.op == Op::Env) return true;
+	}
+	return false;
+}
+
+std::wstring ArgumentTemplate::ToString() const
+{
+	std::wstring str;
+	for (size_t i = 0; i < m_tokens.size(); ++i)
+	{
+		Token const& token = m_tokens[i];
+		switch (token.op)
+		{
+		case Op::Literal:
+			for (size_t c = 0; c < token.text.size(); ++c)
+			{
+				// a literal `${` would start a placeholder
+				if (token.text[c] == L'$' && c + 1 < token.text.size() && token.text[c + 1] == L'{')
+				{
+					str += L"${$}";
+				}
+				else
+				{
+					str += token.text[c];
+				}
+			}
+			break;
+		case Op::Env:
+			str += L"${env:" + token.text + L"}";
+			break;
+		case Op::Date:
+			str += L"${date:" + token.text + L"}";
+			break;
+		case Op::ConfigDir:
+			str += L"${configdir}";
+			break;
+		case Op::Clipboard:
+			str += L"${clipboard}";
+			break;
+		}
+	}
+	return str;
+}
+
+void ArgumentTemplate::AppendLiteral(std::wstring const& text)
+{
+	if (text.empty()) return;
+	if (!m_tokens.empty() && m_tokens.back().op == Op::Literal)
+	{
+		m_tokens.back().text += text;
+	}
+	else
+	{
+		m_tokens.push_back({ Op::Literal, text });
+	}
+}
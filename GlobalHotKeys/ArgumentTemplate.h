@@ -0,0 +1,128 @@
+#pragma once
+
+#include <ctime>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Values of placeholders in hot key arguments, used by `ArgumentTemplate`
+/// </summary>
+class IArgumentSource
+{
+public:
+	virtual ~IArgumentSource() = default;
+
+	/// <summary>
+	/// The value of the environment variable; false if it is not set
+	/// </summary>
+	virtual bool GetEnvironmentValue(std::wstring const& name, std::wstring& outValue) = 0;
+
+	/// <summary>
+	/// The text on the clipboard; false if there is none
+	/// </summary>
+	virtual bool GetClipboardText(std::wstring& outText) = 0;
+
+	/// <summary>
+	/// The current local time
+	/// </summary>
+	virtual std::tm GetNow() = 0;
+};
+
+/// <summary>
+/// A hot key argument compiled into literals and placeholder operations, so triggers do not parse strings.
+/// Placeholders are `${env:NAME}`, `${date:FORMAT}` with an `strftime` format, `${configdir}`, and `${clipboard}`.
+/// `${$}` is a literal `$`, needed to write a literal `${` as `${$}{`.
+/// Unknown or unclosed placeholders stay literal text, so arguments written before placeholders existed keep their value.
+/// Has no platform dependencies.
+/// </summary>
+class ArgumentTemplate
+{
+public:
+	enum class Op : uint8_t
+	{
+		Literal,
+		Env,
+		Date,
+		ConfigDir,
+		Clipboard
+	};
+
+	struct Token
+	{
+		Op op;
+		// the literal text, the environment variable name, or the date format
+		std::wstring text;
+
+		inline bool operator==(Token const& other) const
+		{
+			return op == other.op && text == other.text;
+		}
+	};
+
+	// format of `${date}` without a format
+	static constexpr const wchar_t* c_defaultDateFormat = L"%Y-%m-%d";
+
+	// maximum length of the value of a `${date:FORMAT}` placeholder
+	static constexpr const size_t c_maxDateLength = 255;
+
+	/// <summary>
+	/// Compiles the argument; on failure the template is empty and `outError` describes the problem.
+	/// Only an invalid `${date:FORMAT}` fails, see `IsValidDateFormat`.
+	/// Placeholders kept as literal text are described in `outWarning`, which is empty otherwise.
+	/// </summary>
+	bool Compile(std::wstring const& source, std::wstring& outError, std::wstring& outWarning);
+
+	/// <summary>
+	/// True if the format only uses conversion specifiers supported by `wcsftime` on all platforms,
+	/// without modifiers, and its value cannot exceed `c_maxDateLength`.
+	/// The MSVC runtime ends the process on an invalid format, so `Evaluate` only gets checked formats.
+	/// </summary>
+	static bool IsValidDateFormat(std::wstring const& format, std::wstring& outError);
+
+	/// <summary>
+	/// Replaces the placeholders which only change when the configuration or the environment changes,
+	/// `${configdir}` and `${env:...}`, by their values
+	/// </summary>
+	ArgumentTemplate Fold(IArgumentSource& source, std::filesystem::path const& configDir) const;
+
+	/// <summary>
+	/// Appends the value of the argument, evaluating all placeholders
+	/// </summary>
+	void Evaluate(IArgumentSource& source, std::filesystem::path const& configDir, std::wstring& out) const;
+
+	/// <summary>
+	/// True if the template only consists of literals, i.e. evaluates to `GetLiteral` without a source
+	/// </summary>
+	inline bool IsConstant() const noexcept
+	{
+		return m_tokens.empty() || (m_tokens.size() == 1 && m_tokens.front().op == Op::Literal);
+	}
+
+	/// <summary>
+	/// The value of a constant template
+	/// </summary>
+	std::wstring GetLiteral() const;
+
+	/// <summary>
+	/// True if the template contains placeholders of the environment
+	/// </summary>
+	bool DependsOnEnvironment() const noexcept;
+
+	/// <summary>
+	/// The template in source syntax, which compiles to an equal template
+	/// </summary>
+	std::wstring ToString() const;
+
+	inline std::vector<Token> const& GetTokens() const noexcept
+	{
+		return m_tokens;
+	}
+
+private:
+	void AppendLiteral(std::wstring const& text);
+
+	// adjacent literals are merged
+	std::vector<Token> m_tokens{};
+};
@@ -0,0 +1,296 @@
+#include "pch.h"
+#include "AsyncLog.h"
+
+#include <cwchar>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+	constexpr const size_t c_batchSize = 64;
+
+	inline bool IsFlag(wchar_t c)
+	{
+		return c == L'-' || c == L'+' || c == L' ' || c == L'#' || c == L'0';
+	}
+
+	inline bool IsLengthModifier(wchar_t c)
+	{
+		return c == L'h' || c == L'l' || c == L'L' || c == L'z' || c == L'j' || c == L't' || c == L'I' || c == L'w' || (c >= L'0' && c <= L'9');
+	}
+}
+
+AsyncLog::AsyncLog(Sink sink, size_t capacity)
+	: m_sink{ std::move(sink) }
+{
+	// round up to a power of two, so positions map to slots by masking
+	size_t size = 2;
+	while (size < capacity) size <<= 1;
+	m_ring = std::make_unique<Message[]>(size);
+	m_mask = size - 1;
+	for (size_t i = 0; i < size; ++i)
+	{
+		m_ring[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	m_worker = std::thread{ &AsyncLog::Run, this };
+}
+
+AsyncLog::~AsyncLog()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_lock };
+		m_stop = true;
+	}
+	m_wake.notify_one();
+	if (m_worker.joinable())
+	{
+		m_worker.join();
+	}
+}
+
+bool AsyncLog::Flush(std::chrono::milliseconds timeout)
+{
+	const size_t target = m_enqueuePos.load(std::memory_order_acquire);
+	std::unique_lock<std::mutex> lock{ m_lock };
+	m_wake.notify_one();
+	return m_flushed.wait_for(lock, timeout, [this, target]() { return m_written.load(std::memory_order_acquire) >= target || m_stop; });
+}
+
+bool AsyncLog::TryDrain() noexcept
+{
+	if (m_consuming.exchange(true, std::memory_order_acquire))
+	{
+		return false;
+	}
+	while (HasPending())
+	{
+		const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+		Message& cell = m_ring[pos & m_mask];
+		try
+		{
+			m_sink(cell.level, Format(cell));
+		}
+		catch (...)
+		{
+			// a failing sink must not stop logging
+		}
+		cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+		m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+	}
+	// a waiting `Flush` notices on its timeout, as notifying would need the lock
+	m_written.store(m_dequeuePos.load(std::memory_order_relaxed), std::memory_order_release);
+	m_consuming.store(false, std::memory_order_release);
+	return true;
+}
+
+AsyncLog::Message* AsyncLog::BeginPush(size_t& outPos) noexcept
+{
+	// bounded multi-producer queue, after Dmitry Vyukov
+	size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		Message& cell = m_ring[pos & m_mask];
+		const size_t seq = cell.sequence.load(std::memory_order_acquire);
+		const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+		if (diff == 0)
+		{
+			if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				outPos = pos;
+				return &cell;
+			}
+		}
+		else if (diff < 0)
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		else
+		{
+			pos = m_enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void AsyncLog::EndPush(Message* m, size_t pos) noexcept
+{
+	m->sequence.store(pos + 1, std::memory_order_release);
+
+	// pairs with the fence in `Run`, so either the worker sees the message, or we see it sleeping
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_sleeping.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> lock{ m_lock };
+		m_wake.notify_one();
+	}
+}
+
+bool AsyncLog::HasPending() const noexcept
+{
+	const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+	return m_ring[pos & m_mask].sequence.load(std::memory_order_acquire) == pos + 1;
+}
+
+void AsyncLog::Run()
+{
+	std::vector<std::pair<Level, std::wstring>> batch;
+	batch.reserve(c_batchSize);
+
+	for (;;)
+	{
+		if (m_consuming.exchange(true, std::memory_order_acquire))
+		{
+			// a crash handler drains the ring buffer
+			std::this_thread::yield();
+			continue;
+		}
+
+		size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+		while (HasPending() && batch.size() < c_batchSize)
+		{
+			Message& cell = m_ring[pos & m_mask];
+			batch.emplace_back(cell.level, Format(cell));
+			cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+			m_dequeuePos.store(++pos, std::memory_order_relaxed);
+		}
+
+		const bool wrote = !batch.empty();
+		for (auto const& msg : batch)
+		{
+			try
+			{
+				m_sink(msg.first, msg.second);
+			}
+			catch (...)
+			{
+				// a failing sink must not stop logging
+			}
+		}
+		batch.clear();
+		m_written.store(pos, std::memory_order_release);
+		m_consuming.store(false, std::memory_order_release);
+
+		if (wrote)
+		{
+			std::lock_guard<std::mutex> lock{ m_lock };
+			m_flushed.notify_all();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock{ m_lock };
+		m_flushed.notify_all();
+
+		m_sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		m_wake.wait(lock, [this]() { return m_stop || HasPending(); });
+		m_sleeping.store(false, std::memory_order_relaxed);
+
+		if (m_stop && !HasPending())
+		{
+			// messages claimed but not yet published are lost on shutdown
+			break;
+		}
+	}
+}
+
+std::wstring AsyncLog::Format(Message const& m)
+{
+	// narrow format strings are ASCII and widened on the fly
+	auto at = [&m](size_t i) -> wchar_t
+		{
+			return m.wide
+				? static_cast<const wchar_t*>(m.format)[i]
+				: static_cast<wchar_t>(static_cast<unsigned char>(static_cast<const char*>(m.format)[i]));
+		};
+
+	std::wstring out;
+	std::wstring spec;
+	wchar_t buf[128];
+	size_t argi = 0;
+
+	for (size_t i = 0; at(i) != 0; ++i)
+	{
+		const wchar_t c = at(i);
+		if (c != L'%')
+		{
+			out.push_back(c);
+			continue;
+		}
+		if (at(i + 1) == L'%')
+		{
+			out.push_back(L'%');
+			++i;
+			continue;
+		}
+
+		// %[flags][width][.precision][length]conversion; length modifiers are replaced by our own
+		spec.assign(1, L'%');
+		size_t j = i + 1;
+		while (at(j) != 0 && IsFlag(at(j))) spec.push_back(at(j++));
+		while (at(j) >= L'0' && at(j) <= L'9') spec.push_back(at(j++));
+		if (at(j) == L'.')
+		{
+			spec.push_back(at(j++));
+			while (at(j) >= L'0' && at(j) <= L'9') spec.push_back(at(j++));
+		}
+		while (at(j) != 0 && IsLengthModifier(at(j))) ++j;
+		const wchar_t conv = at(j);
+		if (conv == 0) break;
+		i = j;
+
+		if (argi >= m.argCount)
+		{
+			out += L"<?>";
+			continue;
+		}
+		Arg const& a = m.args[argi++];
+
+		int len = -1;
+		switch (conv)
+		{
+		case L'd': case L'i':
+			spec += L"lld";
+			len = std::swprintf(buf, std::size(buf), spec.c_str(), (a.type == Arg::Type::Int) ? static_cast<long long>(a.i) : static_cast<long long>(a.u));
+			break;
+		case L'u': case L'x': case L'X': case L'o':
+			spec += L"ll";
+			spec.push_back(conv);
+			len = std::swprintf(buf, std::size(buf), spec.c_str(), (a.type == Arg::Type::Int) ? static_cast<unsigned long long>(a.i) : static_cast<unsigned long long>(a.u));
+			break;
+		case L'f': case L'F': case L'e': case L'E': case L'g': case L'G':
+			spec.push_back(conv);
+			len = std::swprintf(buf, std::size(buf), spec.c_str(),
+				(a.type == Arg::Type::Double) ? a.d : (a.type == Arg::Type::Int) ? static_cast<double>(a.i) : static_cast<double>(a.u));
+			break;
+		case L'c': case L'C':
+			spec += L"lc";
+			len = std::swprintf(buf, std::size(buf), spec.c_str(), static_cast<wint_t>(a.u));
+			break;
+		case L's': case L'S':
+			if (a.type == Arg::Type::String)
+			{
+				out += &m.strings[a.offset];
+				if (a.truncated)
+				{
+					out.push_back(L'\u2026');
+				}
+				continue;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (len >= 0)
+		{
+			out.append(buf, static_cast<size_t>(len));
+		}
+		else
+		{
+			out += L"<?>";
+		}
+	}
+
+	return out;
+}
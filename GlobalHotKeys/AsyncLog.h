@@ -0,0 +1,227 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+/// <summary>
+/// Logging front end for hot paths.
+/// Callers only copy the format string pointer and the arguments into a lock-free ring buffer;
+/// a background thread formats the messages and passes them to the sink in batches.
+/// When the ring buffer is full, messages are dropped and counted instead of blocking.
+/// Has no platform dependencies.
+/// </summary>
+/// <remarks>
+/// Format strings must be string literals, as only their pointers are stored.
+/// Supported arguments are integers, floating point numbers, and strings, which are copied
+/// (narrow strings are expected to be ASCII). `%s` formats a string of either width.
+/// Strings not fitting into `c_maxStringChars` are cut and marked with a trailing ellipsis, U+2026.
+/// </remarks>
+class AsyncLog
+{
+public:
+	enum class Level : uint8_t
+	{
+		Detail,
+		Write,
+		Warning,
+		Error
+	};
+
+	using Sink = std::function<void(Level level, std::wstring const& message)>;
+
+	static constexpr const size_t c_defaultCapacity = 256;
+	static constexpr const size_t c_maxArgs = 6;
+	// characters of copied string arguments per message, including terminators; longer strings are cut
+	static constexpr const size_t c_maxStringChars = 400;
+
+	AsyncLog(Sink sink, size_t capacity = c_defaultCapacity);
+	~AsyncLog();
+
+	AsyncLog(AsyncLog const&) = delete;
+	AsyncLog& operator=(AsyncLog const&) = delete;
+
+	template<typename... ARGS>
+	inline void Detail(const char* format, ARGS... args) { Push(Level::Detail, format, false, args...); }
+	template<typename... ARGS>
+	inline void Detail(const wchar_t* format, ARGS... args) { Push(Level::Detail, format, true, args...); }
+	template<typename... ARGS>
+	inline void Write(const char* format, ARGS... args) { Push(Level::Write, format, false, args...); }
+	template<typename... ARGS>
+	inline void Write(const wchar_t* format, ARGS... args) { Push(Level::Write, format, true, args...); }
+	template<typename... ARGS>
+	inline void Warning(const char* format, ARGS... args) { Push(Level::Warning, format, false, args...); }
+	template<typename... ARGS>
+	inline void Warning(const wchar_t* format, ARGS... args) { Push(Level::Warning, format, true, args...); }
+	template<typename... ARGS>
+	inline void Error(const char* format, ARGS... args) { Push(Level::Error, format, false, args...); }
+	template<typename... ARGS>
+	inline void Error(const wchar_t* format, ARGS... args) { Push(Level::Error, format, true, args...); }
+
+	/// <summary>
+	/// Blocks until all messages queued before this call were passed to the sink, or the timeout elapsed.
+	/// Returns false on timeout.
+	/// </summary>
+	bool Flush(std::chrono::milliseconds timeout = std::chrono::milliseconds{ 2000 });
+
+	/// <summary>
+	/// Passes the queued messages to the sink on the calling thread, without taking a lock or waiting.
+	/// Returns false at once if the worker is passing messages to the sink right now.
+	/// For crash handlers, where the worker might be the crashing thread or never run again.
+	/// </summary>
+	bool TryDrain() noexcept;
+
+	/// <summary>
+	/// Number of messages dropped because the ring buffer was full
+	/// </summary>
+	inline uint64_t GetDroppedCount() const noexcept
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct Arg
+	{
+		enum class Type : uint8_t
+		{
+			Int,
+			UInt,
+			Double,
+			String
+		};
+		Type type;
+		// the string was cut to fit into `Message::strings`
+		bool truncated;
+		union
+		{
+			int64_t i;
+			uint64_t u;
+			double d;
+			// offset into `Message::strings`
+			uint32_t offset;
+		};
+	};
+
+	struct Message
+	{
+		std::atomic<size_t> sequence;
+		Level level;
+		bool wide;
+		uint8_t argCount;
+		uint16_t stringsUsed;
+		const void* format;
+		Arg args[c_maxArgs];
+		wchar_t strings[c_maxStringChars];
+	};
+
+	template<typename T>
+	inline static void Capture(Message& m, T value)
+	{
+		if (m.argCount >= c_maxArgs) return;
+		Arg& a = m.args[m.argCount++];
+		a.truncated = false;
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			a.type = Arg::Type::Double;
+			a.d = static_cast<double>(value);
+		}
+		else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+		{
+			a.type = Arg::Type::Int;
+			a.i = static_cast<int64_t>(value);
+		}
+		else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+		{
+			a.type = Arg::Type::UInt;
+			a.u = static_cast<uint64_t>(value);
+		}
+		else if constexpr (std::is_same_v<T, const wchar_t*> || std::is_same_v<T, wchar_t*>)
+		{
+			a.type = Arg::Type::String;
+			a.offset = CopyString(m, value, a.truncated);
+		}
+		else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+		{
+			a.type = Arg::Type::String;
+			a.offset = CopyString(m, value, a.truncated);
+		}
+		else
+		{
+			static_assert(std::is_void_v<T> && !std::is_void_v<T>, "Unsupported AsyncLog argument type");
+		}
+	}
+
+	template<typename CHAR>
+	static uint32_t CopyString(Message& m, const CHAR* str, bool& outTruncated);
+
+	template<typename CHAR, typename... ARGS>
+	void Push(Level level, const CHAR* format, bool wide, ARGS... args)
+	{
+		size_t pos;
+		Message* m = BeginPush(pos);
+		if (m == nullptr) return;
+		m->level = level;
+		m->wide = wide;
+		m->format = format;
+		m->argCount = 0;
+		m->stringsUsed = 0;
+		(Capture(*m, args), ...);
+		EndPush(m, pos);
+	}
+
+	Message* BeginPush(size_t& outPos) noexcept;
+	void EndPush(Message* m, size_t pos) noexcept;
+	bool HasPending() const noexcept;
+
+	void Run();
+	static std::wstring Format(Message const& m);
+
+	Sink m_sink;
+	std::unique_ptr<Message[]> m_ring;
+	size_t m_mask;
+	std::atomic<size_t> m_enqueuePos{ 0 };
+	std::atomic<size_t> m_dequeuePos{ 0 };
+	// held by whoever dequeues, the worker or `TryDrain`
+	std::atomic<bool> m_consuming{ false };
+	std::atomic<uint64_t> m_dropped{ 0 };
+
+	// only used to wake and wait for the worker; producers only take it to wake the sleeping worker
+	std::atomic<bool> m_sleeping{ false };
+	std::mutex m_lock;
+	std::condition_variable m_wake;
+	std::condition_variable m_flushed;
+	// position up to which messages were passed to the sink; only stored while holding `m_consuming`
+	std::atomic<size_t> m_written{ 0 };
+	bool m_stop{ false };
+	std::thread m_worker;
+};
+
+template<typename CHAR>
+uint32_t AsyncLog::CopyString(Message& m, const CHAR* str, bool& outTruncated)
+{
+	static const CHAR empty[1] = { 0 };
+	if (str == nullptr) str = empty;
+	const uint32_t offset = m.stringsUsed;
+	if (offset >= c_maxStringChars)
+	{
+		// the terminator of the previous string, read as empty string
+		outTruncated = (*str != 0);
+		return c_maxStringChars - 1;
+	}
+	size_t pos = offset;
+	for (; *str != 0 && pos + 1 < c_maxStringChars; ++str, ++pos)
+	{
+		m.strings[pos] = static_cast<wchar_t>(static_cast<std::make_unsigned_t<CHAR>>(*str));
+	}
+	outTruncated = (*str != 0);
+	m.strings[pos++] = 0;
+	m.stringsUsed = static_cast<uint16_t>(pos);
+	return offset;
+}
@@ -0,0 +1,108 @@
+#include "pch.h"
+#include "BuiltInActions.h"
+
+#include "ActionRegistry.h"
+
+#include <cwctype>
+
+namespace
+{
+	bool Beep(std::vector<std::wstring> const& args, std::wstring& outError)
+	{
+		UINT type = MB_OK;
+		if (args[0] == L"info") type = MB_ICONINFORMATION;
+		else if (args[0] == L"warning") type = MB_ICONWARNING;
+		else if (args[0] == L"error") type = MB_ICONERROR;
+		else if (args[0] == L"question") type = MB_ICONQUESTION;
+
+		if (!MessageBeep(type))
+		{
+			outError = L"MessageBeep failed: " + std::to_wstring(GetLastError());
+			return false;
+		}
+		return true;
+	}
+
+	struct WindowQuery
+	{
+		std::wstring title;
+		std::wstring className;
+		HWND found;
+	};
+
+	std::wstring ToLower(std::wstring str)
+	{
+		for (wchar_t& c : str)
+		{
+			c = static_cast<wchar_t>(std::towlower(c));
+		}
+		return str;
+	}
+
+	BOOL CALLBACK FindWindowProc(HWND hWnd, LPARAM lParam)
+	{
+		WindowQuery* query = reinterpret_cast<WindowQuery*>(lParam);
+		if (!IsWindowVisible(hWnd) || GetWindow(hWnd, GW_OWNER) != NULL) return TRUE;
+
+		if (!query->className.empty())
+		{
+			wchar_t className[256];
+			const int len = GetClassNameW(hWnd, className, 256);
+			if (len <= 0 || query->className != std::wstring{ className, static_cast<size_t>(len) }) return TRUE;
+		}
+
+		const int len = GetWindowTextLengthW(hWnd);
+		if (len <= 0) return TRUE;
+		std::wstring title(static_cast<size_t>(len) + 1, L'\0');
+		title.resize(static_cast<size_t>(GetWindowTextW(hWnd, title.data(), len + 1)));
+		if (ToLower(title).find(query->title) == std::wstring::npos) return TRUE;
+
+		query->found = hWnd;
+		return FALSE; // windows are enumerated in z-order; the first match is the topmost one
+	}
+
+	bool BringToFront(std::vector<std::wstring> const& args, std::wstring& outError)
+	{
+		WindowQuery query{ ToLower(args[0]), args[1], NULL };
+		EnumWindows(&FindWindowProc, reinterpret_cast<LPARAM>(&query));
+		if (query.found == NULL)
+		{
+			outError = L"no window found with title containing \"" + args[0] + L"\"";
+			return false;
+		}
+		const HWND hWnd = query.found;
+
+		// having received the hot key, this process is allowed to set the foreground window
+		if (IsIconic(hWnd))
+		{
+			ShowWindow(hWnd, SW_RESTORE);
+		}
+		SetForegroundWindow(hWnd);
+		if (GetForegroundWindow() == hWnd) return true;
+
+		// fallback like `HWndToFront`: minimize and restore to force activation
+		const BOOL maximized = IsZoomed(hWnd);
+		ShowWindow(hWnd, SW_MINIMIZE);
+		ShowWindow(hWnd, maximized ? SW_SHOWMAXIMIZED : SW_SHOWNORMAL);
+		if (GetForegroundWindow() == hWnd) return true;
+
+		outError = L"window could not be brought to front";
+		return false;
+	}
+}
+
+void RegisterBuiltInActions(ActionRegistry& registry)
+{
+	registry.Register(L"beep",
+		{
+			{ L"type", L"ok", false, { L"ok", L"info", L"warning", L"error", L"question" } }
+		},
+		&Beep);
+
+	registry.Register(L"bring-to-front",
+		{
+			{ L"title", L"", true },
+			{ L"class" }
+		},
+		&BringToFront);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+class ActionRegistry;
+
+/// <summary>
+/// Registers the actions hot keys can run in-process:
+///   `beep [ok|info|warning|error|question]` plays the system sound, like the `beep` tool;
+///   `bring-to-front <title> [class]` activates the topmost window whose title contains `title`,
+///   optionally only of the given window class, like the `HWndToFront` tool.
+/// </summary>
+void RegisterBuiltInActions(ActionRegistry& registry);
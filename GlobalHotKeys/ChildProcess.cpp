@@ -0,0 +1,22 @@
+#include "pch.h"
+#include "ChildProcess.h"
+
+ChildProcess::ChildProcess(HANDLE hProcess)
+	: m_hProcess{ hProcess }
+{
+	// intentionally empty
+}
+
+ChildProcess::~ChildProcess()
+{
+	if (m_hProcess != NULL)
+	{
+		CloseHandle(m_hProcess);
+		m_hProcess = NULL;
+	}
+}
+
+bool ChildProcess::IsRunning()
+{
+	return m_hProcess != NULL && WaitForSingleObject(m_hProcess, 0) == WAIT_TIMEOUT;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "LaunchScheduler.h"
+
+/// <summary>
+/// Owns a process handle returned by `CreateProcessW`
+/// </summary>
+class ChildProcess : public IChildProcess
+{
+public:
+	explicit ChildProcess(HANDLE hProcess);
+	~ChildProcess() override;
+
+	ChildProcess(ChildProcess const&) = delete;
+	ChildProcess& operator=(ChildProcess const&) = delete;
+
+	bool IsRunning() override;
+
+private:
+	HANDLE m_hProcess;
+};
@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "CommandLine.h"
+
+#include "../_shared/CommandLine/CommandLine.h"
+
+size_t CommandLine::GetArgumentLength(std::wstring_view arg) noexcept
+{
+	return CLArgumentLength(arg.data(), arg.size());
+}
+
+wchar_t* CommandLine::WriteArgument(std::wstring_view arg, wchar_t* out) noexcept
+{
+	return CLWriteArgument(arg.data(), arg.size(), out);
+}
+
+void CommandLine::Build(std::vector<std::wstring> const& args, std::vector<wchar_t>& outCmdLine)
+{
+	size_t len = 1;
+	for (std::wstring const& arg : args)
+	{
+		len += 1 + CLArgumentLength(arg.data(), arg.size());
+	}
+	outCmdLine.resize(len);
+
+	wchar_t* out = outCmdLine.data();
+	for (std::wstring const& arg : args)
+	{
+		*out++ = L' ';
+		out = CLWriteArgument(arg.data(), arg.size(), out);
+	}
+	*out = 0;
+}
+
+std::vector<std::wstring> CommandLine::Parse(std::wstring_view cmdLine, bool hasProgramName)
+{
+	std::vector<std::wstring> args;
+	const wchar_t* pos = cmdLine.data();
+	const wchar_t* const end = pos + cmdLine.size();
+	// no argument is longer than the rest of the command line
+	std::wstring buffer(cmdLine.size(), L'\0');
+	size_t len = 0;
+
+	if (hasProgramName)
+	{
+		pos = CLParseProgramName(pos, end, buffer.data(), &len);
+		args.emplace_back(buffer.data(), len);
+	}
+	while ((pos = CLParseArgument(pos, end, buffer.data(), &len)) != nullptr)
+	{
+		args.emplace_back(buffer.data(), len);
+	}
+
+	return args;
+}
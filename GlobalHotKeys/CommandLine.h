@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// Builds command lines for `CreateProcessW` which the Microsoft C runtime and `CommandLineToArgvW`
+/// split back into exactly the given arguments, and parses them with the same rules.
+/// An argument is quoted if it is empty or contains whitespace or quotes.
+/// Inside quotes, a quote is escaped by a backslash, and backslashes are only doubled if they precede a quote.
+/// Wraps the C implementation in `_shared/CommandLine`, which HWndToFront uses as well.
+/// Has no platform dependencies.
+/// </summary>
+class CommandLine
+{
+public:
+	/// <summary>
+	/// Number of characters `WriteArgument` writes for the argument
+	/// </summary>
+	static size_t GetArgumentLength(std::wstring_view arg) noexcept;
+
+	/// <summary>
+	/// Writes the argument, quoted if needed, and returns the end of the written characters.
+	/// `out` must hold `GetArgumentLength(arg)` characters.
+	/// </summary>
+	static wchar_t* WriteArgument(std::wstring_view arg, wchar_t* out) noexcept;
+
+	/// <summary>
+	/// Sets `outCmdLine` to the zero-terminated command line of the arguments, sized once before writing.
+	/// Each argument is preceded by a space, so the program name is empty,
+	/// as `CreateProcessW` gets the executable separately.
+	/// Does not allocate if `outCmdLine` has enough capacity.
+	/// </summary>
+	static void Build(std::vector<std::wstring> const& args, std::vector<wchar_t>& outCmdLine);
+
+	/// <summary>
+	/// Splits a command line like the Microsoft C runtime since 2008, the reference for `Build`.
+	/// If `hasProgramName`, the first argument follows the program name rules: it ends at whitespace
+	/// outside of quotes, and backslashes do not escape quotes.
+	/// </summary>
+	static std::vector<std::wstring> Parse(std::wstring_view cmdLine, bool hasProgramName);
+};
@@ -0,0 +1,138 @@
+#include "pch.h"
+#include "ConfigCache.h"
+#include "ConfigCacheImage.h"
+#include "FileContent.h"
+#include "SimpleLog/SimpleLog.hpp"
+
+#include <vector>
+
+namespace
+{
+	/// <summary>
+	/// Read-only view of the cache file, so the image is read in place.
+	/// Unlike the yaml file, the cache is only ever replaced via `MoveFileExW`, never truncated,
+	/// and the view only exists while loading.
+	/// </summary>
+	class MappedImage
+	{
+	public:
+		MappedImage(std::filesystem::path const& path)
+		{
+			m_file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (m_file == INVALID_HANDLE_VALUE) return;
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0 || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX) return;
+
+			m_mapping = CreateFileMappingW(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (m_mapping == NULL) return;
+
+			m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+			if (m_data != nullptr) m_size = static_cast<size_t>(size.QuadPart);
+		}
+
+		~MappedImage()
+		{
+			if (m_data != nullptr) UnmapViewOfFile(m_data);
+			if (m_mapping != NULL) CloseHandle(m_mapping);
+			if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+		}
+
+		MappedImage(MappedImage const&) = delete;
+		MappedImage& operator=(MappedImage const&) = delete;
+
+		// views are page aligned, as `ConfigCacheImage` requires
+		inline const uint8_t* GetData() const noexcept
+		{
+			return m_data;
+		}
+		inline size_t GetSize() const noexcept
+		{
+			return m_size;
+		}
+
+	private:
+		HANDLE m_file{ INVALID_HANDLE_VALUE };
+		HANDLE m_mapping{ NULL };
+		const uint8_t* m_data{ nullptr };
+		size_t m_size{ 0 };
+	};
+}
+
+std::filesystem::path ConfigCache::GetCachePath(std::filesystem::path const& configPath)
+{
+	std::filesystem::path p{ configPath };
+	p += L".cache";
+	return p;
+}
+
+ConfigCache::SourceKey ConfigCache::MakeSourceKey(FileContent const& configFile)
+{
+	SourceKey key;
+	key.size = configFile.GetSize();
+	key.lastWriteTime = configFile.GetLastWriteTime();
+	key.contentHash = ConfigCacheImage::Hash(configFile.GetData(), configFile.GetSize());
+	// single character key codes are resolved using the active keyboard layout
+	key.keyboardLayout = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(GetKeyboardLayout(0)));
+	return key;
+}
+
+ConfigCache::ConfigCache(sgrottel::ISimpleLog& log)
+	: m_log{ log }
+{
+	// intentionally empty
+}
+
+bool ConfigCache::TryLoad(std::filesystem::path const& configPath, SourceKey const& key, YamlConfigBinder::Result& outResult)
+{
+	const std::filesystem::path cachePath = GetCachePath(configPath);
+
+	MappedImage image{ cachePath };
+	if (image.GetData() == nullptr)
+	{
+		return false;
+	}
+
+	if (!ConfigCacheImage::Deserialize(image.GetData(), image.GetSize(), key, outResult))
+	{
+		m_log.Write(L"Configuration cache outdated or invalid: %s", cachePath.wstring().c_str());
+		return false;
+	}
+
+	m_log.Write(L"Configuration loaded from cache: %s", cachePath.wstring().c_str());
+	return true;
+}
+
+void ConfigCache::Store(std::filesystem::path const& configPath, SourceKey const& key, YamlConfigBinder::Result const& result)
+{
+	const std::filesystem::path cachePath = GetCachePath(configPath);
+	std::filesystem::path tmpPath{ cachePath };
+	tmpPath += L".tmp";
+
+	const std::vector<uint8_t> image = ConfigCacheImage::Serialize(key, result);
+
+	HANDLE file = CreateFileW(tmpPath.wstring().c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		m_log.Warning(L"Failed to write configuration cache %s: %d", tmpPath.wstring().c_str(), static_cast<int>(GetLastError()));
+		return;
+	}
+
+	DWORD written = 0;
+	const BOOL writeOk = WriteFile(file, image.data(), static_cast<DWORD>(image.size()), &written, NULL);
+	CloseHandle(file);
+
+	if (!writeOk || written != image.size())
+	{
+		m_log.Warning(L"Failed to write configuration cache %s", tmpPath.wstring().c_str());
+		DeleteFileW(tmpPath.wstring().c_str());
+		return;
+	}
+
+	// replace in one step, so that readers never see a partially written image
+	if (!MoveFileExW(tmpPath.wstring().c_str(), cachePath.wstring().c_str(), MOVEFILE_REPLACE_EXISTING))
+	{
+		m_log.Warning(L"Failed to replace configuration cache %s: %d", cachePath.wstring().c_str(), static_cast<int>(GetLastError()));
+		DeleteFileW(tmpPath.wstring().c_str());
+	}
+}
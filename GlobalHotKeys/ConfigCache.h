@@ -0,0 +1,36 @@
+#pragma once
+#include "ConfigCacheImage.h"
+#include "YamlConfigBinder.h"
+
+#include <cstdint>
+#include <filesystem>
+
+namespace sgrottel {
+	class ISimpleLog;
+}
+class FileContent;
+
+/// <summary>
+/// Binary image of a successfully parsed configuration, stored next to the yaml file.
+/// The image is relocatable (offsets only, no pointers), and is only used when it was
+/// created from the identical yaml file content.
+/// The image format itself is implemented by `ConfigCacheImage`.
+/// </summary>
+class ConfigCache
+{
+public:
+	using SourceKey = ConfigCacheImage::SourceKey;
+
+	static std::filesystem::path GetCachePath(std::filesystem::path const& configPath);
+
+	static SourceKey MakeSourceKey(FileContent const& configFile);
+
+	ConfigCache(sgrottel::ISimpleLog& log);
+
+	bool TryLoad(std::filesystem::path const& configPath, SourceKey const& key, YamlConfigBinder::Result& outResult);
+
+	void Store(std::filesystem::path const& configPath, SourceKey const& key, YamlConfigBinder::Result const& result);
+
+private:
+	sgrottel::ISimpleLog& m_log;
+};
@@ -0,0 +1,448 @@
+#include "pch.h"
+#include "ConfigCacheImage.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+	constexpr const char c_magic[8] = { 'S', 'G', 'R', 'G', 'H', 'K', 'C', '\0' };
+
+	// increment whenever the layout below or the semantic of `HotKeyConfig` changes;
+	// an image of the other byte order also fails this check
+	constexpr const uint32_t c_version = 7;
+
+	constexpr const uint32_t c_flagBell = 0x01;
+
+	constexpr const uint32_t c_hkFlagAlt = 0x01;
+	constexpr const uint32_t c_hkFlagCtrl = 0x02;
+	constexpr const uint32_t c_hkFlagShift = 0x04;
+	constexpr const uint32_t c_hkFlagIsRelExePath = 0x08;
+	constexpr const uint32_t c_hkFlagNoFileCheck = 0x10;
+	constexpr const uint32_t c_hkFlagCreateNoWindow = 0x20;
+	constexpr const uint32_t c_hkFlagCoalesce = 0x40;
+	constexpr const uint32_t c_hkFlagSingleInstance = 0x80;
+
+	constexpr const uint32_t c_raFlagIsRelPath = 0x01;
+
+	static_assert(sizeof(char16_t) == 2, "String pool holds UTF-16 code units");
+	static_assert(sizeof(float) == 4, "Bell volume is stored as 32-bit float");
+
+	/// <summary>
+	/// Reference into the string pool, in UTF-16 code units.
+	/// Strings are stored as UTF-16 independent of the size of `wchar_t`,
+	/// so the layout is identical for all platforms.
+	/// </summary>
+	struct StrRef
+	{
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	struct Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t headerSize;
+		uint64_t sourceSize;
+		uint64_t sourceLastWriteTime;
+		uint64_t sourceHash;
+		uint64_t keyboardLayout;
+		uint64_t payloadSize;
+		uint64_t payloadHash;
+		uint32_t flags;
+		uint32_t hotKeyCount;
+		uint32_t argCount;
+		uint32_t resolveArgCount;
+		uint32_t stringPoolSize;
+		StrRef customBellFile;
+		uint32_t includeCount;
+		float bellVolume;
+		uint32_t profileCount;
+		uint32_t applicationCount;
+		uint32_t headerHash; // computed with this field being zero
+	};
+	static_assert(sizeof(Header) == 112, "Cache header layout changed");
+	static_assert(offsetof(Header, version) == 8 && offsetof(Header, payloadHash) == 56 && offsetof(Header, headerHash) == 108, "Cache header layout changed");
+
+	struct HotKeyRecord
+	{
+		uint32_t virtualKeyCode;
+		uint32_t flags;
+		StrRef executable;
+		StrRef workingDirectory;
+		StrRef action;
+		StrRef profile;
+		uint32_t firstArg;
+		uint32_t argCount;
+		uint32_t firstResolveArg;
+		uint32_t resolveArgCount;
+		uint32_t cooldownMs;
+		uint32_t maxConcurrent;
+		uint32_t sourceLine;
+		uint32_t sourceColumn;
+	};
+	static_assert(sizeof(HotKeyRecord) == 72, "Cache hot key record layout changed");
+
+	struct ResolveArgRecord
+	{
+		uint32_t pos;
+		uint32_t flags;
+	};
+	static_assert(sizeof(ResolveArgRecord) == 8, "Cache resolve arg record layout changed");
+
+	struct ProfileRecord
+	{
+		StrRef name;
+		uint32_t firstApplication;
+		uint32_t applicationCount;
+	};
+	static_assert(sizeof(ProfileRecord) == 16, "Cache profile record layout changed");
+
+	void AppendUtf16(std::vector<char16_t>& pool, std::wstring const& s)
+	{
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+		{
+			pool.insert(pool.end(), s.begin(), s.end());
+		}
+		else
+		{
+			for (wchar_t c : s)
+			{
+				uint32_t cp = static_cast<uint32_t>(c);
+				if (cp >= 0x10000)
+				{
+					cp -= 0x10000;
+					pool.push_back(static_cast<char16_t>(0xD800 + (cp >> 10)));
+					pool.push_back(static_cast<char16_t>(0xDC00 + (cp & 0x3FF)));
+				}
+				else
+				{
+					pool.push_back(static_cast<char16_t>(cp));
+				}
+			}
+		}
+	}
+
+	std::wstring FromUtf16(const char16_t* s, size_t length)
+	{
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+		{
+			return std::wstring{ reinterpret_cast<const wchar_t*>(s), length };
+		}
+		else
+		{
+			std::wstring str;
+			str.reserve(length);
+			for (size_t i = 0; i < length; ++i)
+			{
+				uint32_t cp = s[i];
+				if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < length && s[i + 1] >= 0xDC00 && s[i + 1] <= 0xDFFF)
+				{
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (s[++i] - 0xDC00u);
+				}
+				str.push_back(static_cast<wchar_t>(cp));
+			}
+			return str;
+		}
+	}
+
+	class ImageWriter
+	{
+	public:
+		StrRef AddString(std::wstring const& s)
+		{
+			const size_t offset = m_pool.size();
+			AppendUtf16(m_pool, s);
+			return StrRef{ static_cast<uint32_t>(offset), static_cast<uint32_t>(m_pool.size() - offset) };
+		}
+
+		void Add(HotKeyConfig const& hk)
+		{
+			HotKeyRecord r{};
+			r.virtualKeyCode = hk.virtualKeyCode;
+			if (hk.modAlt) r.flags |= c_hkFlagAlt;
+			if (hk.modCtrl) r.flags |= c_hkFlagCtrl;
+			if (hk.modShift) r.flags |= c_hkFlagShift;
+			if (hk.isRelExePath) r.flags |= c_hkFlagIsRelExePath;
+			if (hk.noFileCheck) r.flags |= c_hkFlagNoFileCheck;
+			if (hk.createNoWindow) r.flags |= c_hkFlagCreateNoWindow;
+			if (hk.coalesce) r.flags |= c_hkFlagCoalesce;
+			if (hk.singleInstance) r.flags |= c_hkFlagSingleInstance;
+			r.cooldownMs = hk.cooldownMs;
+			r.maxConcurrent = hk.maxConcurrent;
+			r.sourceLine = hk.sourceLine;
+			r.sourceColumn = hk.sourceColumn;
+			r.executable = AddString(hk.executable);
+			r.workingDirectory = AddString(hk.workingDirectory);
+			r.action = AddString(hk.action);
+			r.profile = AddString(hk.profile);
+
+			r.firstArg = static_cast<uint32_t>(m_args.size());
+			r.argCount = static_cast<uint32_t>(hk.arguments.size());
+			for (std::wstring const& a : hk.arguments)
+			{
+				m_args.push_back(AddString(a));
+			}
+
+			r.firstResolveArg = static_cast<uint32_t>(m_resolveArgs.size());
+			r.resolveArgCount = static_cast<uint32_t>(hk.resolveArgsPaths.size());
+			for (auto const& ra : hk.resolveArgsPaths)
+			{
+				m_resolveArgs.push_back({ ra.first, ra.second.isRelPath ? c_raFlagIsRelPath : 0u });
+			}
+
+			m_hotKeys.push_back(r);
+		}
+
+		void AddInclude(std::wstring const& include)
+		{
+			m_includes.push_back(AddString(include));
+		}
+
+		void Add(HotKeyProfile const& profile)
+		{
+			ProfileRecord r{};
+			r.name = AddString(profile.name);
+			r.firstApplication = static_cast<uint32_t>(m_applications.size());
+			r.applicationCount = static_cast<uint32_t>(profile.applications.size());
+			for (std::wstring const& app : profile.applications)
+			{
+				m_applications.push_back(AddString(app));
+			}
+			m_profiles.push_back(r);
+		}
+
+		std::vector<uint8_t> Build(Header& header) const
+		{
+			header.hotKeyCount = static_cast<uint32_t>(m_hotKeys.size());
+			header.argCount = static_cast<uint32_t>(m_args.size());
+			header.includeCount = static_cast<uint32_t>(m_includes.size());
+			header.applicationCount = static_cast<uint32_t>(m_applications.size());
+			header.profileCount = static_cast<uint32_t>(m_profiles.size());
+			header.resolveArgCount = static_cast<uint32_t>(m_resolveArgs.size());
+			header.stringPoolSize = static_cast<uint32_t>(m_pool.size());
+
+			const size_t payloadSize
+				= sizeof(HotKeyRecord) * m_hotKeys.size()
+				+ sizeof(StrRef) * m_args.size()
+				+ sizeof(StrRef) * m_includes.size()
+				+ sizeof(StrRef) * m_applications.size()
+				+ sizeof(ProfileRecord) * m_profiles.size()
+				+ sizeof(ResolveArgRecord) * m_resolveArgs.size()
+				+ sizeof(char16_t) * m_pool.size();
+
+			std::vector<uint8_t> image(sizeof(Header) + payloadSize);
+			uint8_t* p = image.data() + sizeof(Header);
+			auto append = [&p](const void* src, size_t size)
+				{
+					if (size == 0) return;
+					std::memcpy(p, src, size);
+					p += size;
+				};
+			append(m_hotKeys.data(), sizeof(HotKeyRecord) * m_hotKeys.size());
+			append(m_args.data(), sizeof(StrRef) * m_args.size());
+			append(m_includes.data(), sizeof(StrRef) * m_includes.size());
+			append(m_applications.data(), sizeof(StrRef) * m_applications.size());
+			append(m_profiles.data(), sizeof(ProfileRecord) * m_profiles.size());
+			append(m_resolveArgs.data(), sizeof(ResolveArgRecord) * m_resolveArgs.size());
+			append(m_pool.data(), sizeof(char16_t) * m_pool.size());
+
+			header.payloadSize = payloadSize;
+			header.payloadHash = ConfigCacheImage::Hash(image.data() + sizeof(Header), payloadSize);
+			header.headerHash = 0;
+			header.headerHash = static_cast<uint32_t>(ConfigCacheImage::Hash(reinterpret_cast<const uint8_t*>(&header), sizeof(Header)));
+			std::memcpy(image.data(), &header, sizeof(Header));
+
+			return image;
+		}
+
+	private:
+		std::vector<HotKeyRecord> m_hotKeys;
+		std::vector<StrRef> m_args;
+		std::vector<StrRef> m_includes;
+		std::vector<StrRef> m_applications;
+		std::vector<ProfileRecord> m_profiles;
+		std::vector<ResolveArgRecord> m_resolveArgs;
+		std::vector<char16_t> m_pool;
+	};
+}
+
+uint64_t ConfigCacheImage::Hash(const uint8_t* data, size_t size)
+{
+	uint64_t h = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < size; ++i)
+	{
+		h ^= data[i];
+		h *= 0x100000001b3ull;
+	}
+	return h;
+}
+
+std::vector<uint8_t> ConfigCacheImage::Serialize(SourceKey const& key, YamlConfigBinder::Result const& result)
+{
+	ImageWriter writer;
+
+	Header header{};
+	std::memcpy(header.magic, c_magic, sizeof(c_magic));
+	header.version = c_version;
+	header.headerSize = sizeof(Header);
+	header.sourceSize = key.size;
+	header.sourceLastWriteTime = key.lastWriteTime;
+	header.sourceHash = key.contentHash;
+	header.keyboardLayout = key.keyboardLayout;
+	header.flags = result.bell ? c_flagBell : 0u;
+	header.customBellFile = writer.AddString(result.customBellFile.wstring());
+	header.bellVolume = result.bellVolume;
+
+	for (HotKeyConfig const& hk : result.hotKeys)
+	{
+		writer.Add(hk);
+	}
+	for (std::wstring const& inc : result.includes)
+	{
+		writer.AddInclude(inc);
+	}
+	for (HotKeyProfile const& profile : result.profiles)
+	{
+		writer.Add(profile);
+	}
+
+	return writer.Build(header);
+}
+
+bool ConfigCacheImage::Deserialize(const uint8_t* data, size_t size, SourceKey const& key, YamlConfigBinder::Result& outResult)
+{
+	if (data == nullptr || size < sizeof(Header)) return false;
+
+	Header header;
+	std::memcpy(&header, data, sizeof(Header));
+	if (std::memcmp(header.magic, c_magic, sizeof(c_magic)) != 0) return false;
+	if (header.version != c_version) return false;
+	if (header.headerSize != sizeof(Header)) return false;
+	{
+		Header h{ header };
+		h.headerHash = 0;
+		if (static_cast<uint32_t>(Hash(reinterpret_cast<const uint8_t*>(&h), sizeof(Header))) != header.headerHash) return false;
+	}
+	if (header.sourceSize != key.size
+		|| header.sourceLastWriteTime != key.lastWriteTime
+		|| header.sourceHash != key.contentHash
+		|| header.keyboardLayout != key.keyboardLayout) return false;
+
+	const uint64_t expectedPayloadSize
+		= static_cast<uint64_t>(sizeof(HotKeyRecord)) * header.hotKeyCount
+		+ static_cast<uint64_t>(sizeof(StrRef)) * (static_cast<uint64_t>(header.argCount) + header.includeCount + header.applicationCount)
+		+ static_cast<uint64_t>(sizeof(ProfileRecord)) * header.profileCount
+		+ static_cast<uint64_t>(sizeof(ResolveArgRecord)) * header.resolveArgCount
+		+ static_cast<uint64_t>(sizeof(char16_t)) * header.stringPoolSize;
+	if (header.payloadSize != expectedPayloadSize) return false;
+	if (static_cast<uint64_t>(size) - sizeof(Header) != header.payloadSize) return false;
+
+	const uint8_t* payload = data + sizeof(Header);
+	if (Hash(payload, static_cast<size_t>(header.payloadSize)) != header.payloadHash) return false;
+
+	// all records are 4-byte aligned, so is the buffer holding the image;
+	// they are read in place, only the final `HotKeyConfig` values are built
+	const HotKeyRecord* hotKeys = reinterpret_cast<const HotKeyRecord*>(payload);
+	const StrRef* args = reinterpret_cast<const StrRef*>(hotKeys + header.hotKeyCount);
+	const StrRef* includes = args + header.argCount;
+	const StrRef* applications = includes + header.includeCount;
+	const ProfileRecord* profiles = reinterpret_cast<const ProfileRecord*>(applications + header.applicationCount);
+	const ResolveArgRecord* resolveArgs = reinterpret_cast<const ResolveArgRecord*>(profiles + header.profileCount);
+	const char16_t* pool = reinterpret_cast<const char16_t*>(resolveArgs + header.resolveArgCount);
+
+	auto isValid = [&header](StrRef const& s)
+		{
+			return static_cast<uint64_t>(s.offset) + s.length <= header.stringPoolSize;
+		};
+	auto toString = [pool](StrRef const& s)
+		{
+			return FromUtf16(pool + s.offset, s.length);
+		};
+
+	if (!isValid(header.customBellFile)) return false;
+	for (uint32_t i = 0; i < header.argCount + header.includeCount + header.applicationCount; ++i)
+	{
+		if (!isValid(args[i])) return false;
+	}
+	for (uint32_t i = 0; i < header.profileCount; ++i)
+	{
+		ProfileRecord const& r = profiles[i];
+		if (!isValid(r.name)) return false;
+		if (static_cast<uint64_t>(r.firstApplication) + r.applicationCount > header.applicationCount) return false;
+	}
+	for (uint32_t i = 0; i < header.hotKeyCount; ++i)
+	{
+		HotKeyRecord const& r = hotKeys[i];
+		if (!isValid(r.executable) || !isValid(r.workingDirectory) || !isValid(r.action) || !isValid(r.profile)) return false;
+		if (static_cast<uint64_t>(r.firstArg) + r.argCount > header.argCount) return false;
+		if (static_cast<uint64_t>(r.firstResolveArg) + r.resolveArgCount > header.resolveArgCount) return false;
+	}
+
+	YamlConfigBinder::Result result;
+	result.bell = (header.flags & c_flagBell) != 0;
+	result.customBellFile = toString(header.customBellFile);
+	if (!(header.bellVolume >= 0.0f && header.bellVolume <= 1.0f)) return false;
+	result.bellVolume = header.bellVolume;
+	result.hotKeys.resize(header.hotKeyCount);
+	for (uint32_t i = 0; i < header.hotKeyCount; ++i)
+	{
+		HotKeyRecord const& r = hotKeys[i];
+		HotKeyConfig& hk = result.hotKeys[i];
+
+		hk.virtualKeyCode = r.virtualKeyCode;
+		hk.modAlt = (r.flags & c_hkFlagAlt) != 0;
+		hk.modCtrl = (r.flags & c_hkFlagCtrl) != 0;
+		hk.modShift = (r.flags & c_hkFlagShift) != 0;
+		hk.isRelExePath = (r.flags & c_hkFlagIsRelExePath) != 0;
+		hk.noFileCheck = (r.flags & c_hkFlagNoFileCheck) != 0;
+		hk.createNoWindow = (r.flags & c_hkFlagCreateNoWindow) != 0;
+		hk.coalesce = (r.flags & c_hkFlagCoalesce) != 0;
+		hk.singleInstance = (r.flags & c_hkFlagSingleInstance) != 0;
+		hk.cooldownMs = r.cooldownMs;
+		hk.maxConcurrent = r.maxConcurrent;
+		hk.sourceLine = r.sourceLine;
+		hk.sourceColumn = r.sourceColumn;
+		hk.executable = toString(r.executable);
+		hk.workingDirectory = toString(r.workingDirectory);
+		hk.action = toString(r.action);
+		hk.profile = toString(r.profile);
+
+		hk.arguments.reserve(r.argCount);
+		for (uint32_t a = 0; a < r.argCount; ++a)
+		{
+			hk.arguments.push_back(toString(args[r.firstArg + a]));
+		}
+
+		for (uint32_t a = 0; a < r.resolveArgCount; ++a)
+		{
+			ResolveArgRecord const& ra = resolveArgs[r.firstResolveArg + a];
+			HotKeyConfig::ResolveArgConfig cfg;
+			cfg.isRelPath = (ra.flags & c_raFlagIsRelPath) != 0;
+			hk.resolveArgsPaths.insert(std::make_pair(ra.pos, cfg));
+		}
+	}
+
+	result.includes.reserve(header.includeCount);
+	for (uint32_t i = 0; i < header.includeCount; ++i)
+	{
+		result.includes.push_back(toString(includes[i]));
+	}
+
+	result.profiles.resize(header.profileCount);
+	for (uint32_t i = 0; i < header.profileCount; ++i)
+	{
+		ProfileRecord const& r = profiles[i];
+		HotKeyProfile& profile = result.profiles[i];
+		profile.name = toString(r.name);
+		profile.applications.reserve(r.applicationCount);
+		for (uint32_t a = 0; a < r.applicationCount; ++a)
+		{
+			profile.applications.push_back(toString(applications[r.firstApplication + a]));
+		}
+	}
+
+	outResult = std::move(result);
+	return true;
+}
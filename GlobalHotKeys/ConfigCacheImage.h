@@ -0,0 +1,40 @@
+#pragma once
+#include "YamlConfigBinder.h"
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// The relocatable binary image of a parsed configuration, as stored by `ConfigCache`.
+/// The layout is fixed, little-endian with UTF-16 strings, and identical on all platforms.
+/// Has no platform dependencies.
+/// </summary>
+class ConfigCacheImage
+{
+public:
+	/// <summary>
+	/// Identity of the yaml file content an image was created from
+	/// </summary>
+	struct SourceKey
+	{
+		uint64_t size;
+		uint64_t lastWriteTime;
+		uint64_t contentHash;
+		uint64_t keyboardLayout;
+	};
+
+	/// <summary>
+	/// FNV-1a hash, used for the source content and the image itself
+	/// </summary>
+	static uint64_t Hash(const uint8_t* data, size_t size);
+
+	static std::vector<uint8_t> Serialize(SourceKey const& key, YamlConfigBinder::Result const& result);
+
+	/// <summary>
+	/// Validates the image completely before touching any of its content,
+	/// then reads its records in place, e.g. from a mapped file.
+	/// Returns false on any mismatch or corruption.
+	/// `data` must be 4-byte aligned.
+	/// </summary>
+	static bool Deserialize(const uint8_t* data, size_t size, SourceKey const& key, YamlConfigBinder::Result& outResult);
+};
@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "ConfigFileWatcher.h"
+
+#include "FileChangeSource.h"
+#include "ReloadDebouncer.h"
+#include "SimpleLog/SimpleLog.hpp"
+
+ConfigFileWatcher::ConfigFileWatcher(sgrottel::ISimpleLog& log, Loader loader, Notify notify)
+	: m_log{ log }, m_loader{ std::move(loader) }, m_notify{ std::move(notify) }
+{
+	// intentionally empty
+}
+
+ConfigFileWatcher::~ConfigFileWatcher()
+{
+	Stop();
+}
+
+void ConfigFileWatcher::SetFilePath(std::filesystem::path const& path)
+{
+	Stop();
+	if (path.empty()) return;
+
+	m_source = std::make_unique<FileChangeSource>();
+	if (!m_source->Start(path.parent_path()))
+	{
+		m_log.Warning(L"Failed to watch configuration file for changes: %s", path.wstring().c_str());
+		m_source.reset();
+		return;
+	}
+
+	m_thread = std::thread{ &ConfigFileWatcher::Run, this, path };
+}
+
+void ConfigFileWatcher::Stop()
+{
+	if (m_thread.joinable())
+	{
+		m_source->Stop();
+		m_thread.join();
+	}
+	m_source.reset();
+}
+
+bool ConfigFileWatcher::TakeLoadedConfig(std::filesystem::path& outPath, YamlConfigBinder::Result& outConfig)
+{
+	std::lock_guard<std::mutex> lock{ m_loadedLock };
+	if (!m_hasLoaded) return false;
+
+	outPath = std::move(m_loadedPath);
+	outConfig = std::move(m_loaded);
+	m_hasLoaded = false;
+	return true;
+}
+
+void ConfigFileWatcher::Run(std::filesystem::path path)
+{
+	ReloadDebouncer debouncer{ *m_source, path };
+	while (debouncer.WaitForChange())
+	{
+		m_log.Write(L"Configuration file changed, reloading: %s", path.wstring().c_str());
+
+		YamlConfigBinder::Result config;
+		if (!m_loader(path, config))
+		{
+			continue;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock{ m_loadedLock };
+			m_loadedPath = path;
+			m_loaded = std::move(config);
+			m_hasLoaded = true;
+		}
+		m_notify();
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "YamlConfigBinder.h"
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace sgrottel {
+	class ISimpleLog;
+}
+class IFileChangeSource;
+
+/// <summary>
+/// Watches the configuration file and loads it in the background after it changed.
+/// Bursts of changes are coalesced into a single reload by `ReloadDebouncer`.
+/// Only the main file is watched; changes of included fragments are picked up with the next reload.
+/// </summary>
+class ConfigFileWatcher
+{
+public:
+	static constexpr UINT c_Message = WM_APP + 2;
+
+	/// <summary>
+	/// Loads the configuration file; returns false if it is invalid
+	/// </summary>
+	using Loader = std::function<bool(std::filesystem::path const& path, YamlConfigBinder::Result& outConfig)>;
+
+	/// <summary>
+	/// Called on the watcher thread after a configuration was loaded, e.g. to post `c_Message` to the main window
+	/// </summary>
+	using Notify = std::function<void()>;
+
+	ConfigFileWatcher(sgrottel::ISimpleLog& log, Loader loader, Notify notify);
+	~ConfigFileWatcher();
+
+	/// <summary>
+	/// Starts watching the file; an empty path stops watching
+	/// </summary>
+	void SetFilePath(std::filesystem::path const& path);
+
+	void Stop();
+
+	/// <summary>
+	/// Takes the configuration loaded in the background, if any
+	/// </summary>
+	bool TakeLoadedConfig(std::filesystem::path& outPath, YamlConfigBinder::Result& outConfig);
+
+private:
+	void Run(std::filesystem::path path);
+
+	sgrottel::ISimpleLog& m_log;
+	Loader m_loader;
+	Notify m_notify;
+
+	std::unique_ptr<IFileChangeSource> m_source;
+	std::thread m_thread;
+
+	std::mutex m_loadedLock;
+	bool m_hasLoaded{ false };
+	std::filesystem::path m_loadedPath{};
+	YamlConfigBinder::Result m_loaded{};
+};
@@ -0,0 +1,269 @@
+#include "pch.h"
+#include "ConfigFragments.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+namespace
+{
+	inline wchar_t ToLowerAscii(wchar_t c)
+	{
+		return (c >= L'A' && c <= L'Z') ? static_cast<wchar_t>(c - L'A' + L'a') : c;
+	}
+
+	std::wstring ToLowerAscii(std::wstring s)
+	{
+		std::transform(s.begin(), s.end(), s.begin(), [](wchar_t c) { return ToLowerAscii(c); });
+		return s;
+	}
+
+	bool HasPattern(std::wstring const& name)
+	{
+		return name.find_first_of(L"*?") != std::wstring::npos;
+	}
+}
+
+bool FragmentFiles::IsDirectory(std::filesystem::path const& path)
+{
+	std::error_code ec;
+	return std::filesystem::is_directory(path, ec);
+}
+
+std::vector<std::filesystem::path> FragmentFiles::ListFiles(std::filesystem::path const& dir)
+{
+	std::vector<std::filesystem::path> files;
+	std::error_code ec;
+	for (auto const& entry : std::filesystem::directory_iterator{ dir, ec })
+	{
+		std::error_code fec;
+		if (entry.is_regular_file(fec))
+		{
+			files.push_back(entry.path());
+		}
+	}
+	return files;
+}
+
+std::vector<uint8_t> FragmentFiles::Read(std::filesystem::path const& path)
+{
+	std::ifstream file{ path, std::ios::binary };
+	if (!file)
+	{
+		throw std::runtime_error("Failed to open configuration fragment " + path.u8string());
+	}
+	return std::vector<uint8_t>{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+}
+
+ConfigFragments::ConfigFragments(IFragmentFiles& files, Parser parser, size_t threadCount)
+	: m_files{ files }, m_parser{ std::move(parser) }, m_threadCount{ std::max<size_t>(threadCount, 1) }
+{
+	// intentionally empty
+}
+
+bool ConfigFragments::MatchPattern(std::wstring const& pattern, std::wstring const& name)
+{
+	// iterative wildcard matching, backtracking to the last `*` only
+	size_t p = 0, n = 0;
+	size_t starP = std::wstring::npos, starN = 0;
+	while (n < name.size())
+	{
+		if (p < pattern.size() && (pattern[p] == L'?' || ToLowerAscii(pattern[p]) == ToLowerAscii(name[n])))
+		{
+			++p;
+			++n;
+		}
+		else if (p < pattern.size() && pattern[p] == L'*')
+		{
+			starP = p++;
+			starN = n;
+		}
+		else if (starP != std::wstring::npos)
+		{
+			p = starP + 1;
+			n = ++starN;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	while (p < pattern.size() && pattern[p] == L'*') ++p;
+	return p == pattern.size();
+}
+
+std::vector<std::filesystem::path> ConfigFragments::Resolve(std::vector<std::wstring> const& includes, std::filesystem::path const& baseDir)
+{
+	std::vector<std::filesystem::path> result;
+	std::unordered_set<std::wstring> seen;
+	auto add = [&](std::filesystem::path p)
+		{
+			p = p.lexically_normal();
+			if (seen.insert(ToLowerAscii(p.wstring())).second)
+			{
+				result.push_back(std::move(p));
+			}
+		};
+
+	for (std::wstring const& include : includes)
+	{
+		std::filesystem::path p{ include };
+		if (!p.is_absolute()) p = baseDir / p;
+
+		std::filesystem::path dir;
+		std::wstring pattern;
+		const std::wstring name = p.filename().wstring();
+		if (HasPattern(name))
+		{
+			dir = p.parent_path();
+			pattern = name;
+		}
+		else if (m_files.IsDirectory(p))
+		{
+			dir = p;
+		}
+		else
+		{
+			// plain file; a missing one is reported when reading it
+			add(p);
+			continue;
+		}
+
+		std::vector<std::filesystem::path> files;
+		for (auto& f : m_files.ListFiles(dir))
+		{
+			const std::wstring fileName = f.filename().wstring();
+			const bool match = pattern.empty()
+				? (MatchPattern(L"*.yaml", fileName) || MatchPattern(L"*.yml", fileName))
+				: MatchPattern(pattern, fileName);
+			if (match) files.push_back(std::move(f));
+		}
+		std::sort(files.begin(), files.end(), [](auto const& a, auto const& b)
+			{
+				const std::wstring la = ToLowerAscii(a.filename().wstring());
+				const std::wstring lb = ToLowerAscii(b.filename().wstring());
+				return (la != lb) ? (la < lb) : (a.filename().wstring() < b.filename().wstring());
+			});
+		for (auto& f : files)
+		{
+			add(std::move(f));
+		}
+	}
+
+	return result;
+}
+
+void ConfigFragments::LoadAndMerge(std::filesystem::path const& mainPath, YamlConfigBinder::Result& config)
+{
+	m_duplicates.clear();
+	m_fragmentCount = 0;
+
+	std::vector<std::filesystem::path> paths = Resolve(config.includes, mainPath.parent_path());
+	const std::wstring mainKey = ToLowerAscii(mainPath.lexically_normal().wstring());
+	paths.erase(std::remove_if(paths.begin(), paths.end(), [&mainKey](auto const& p) { return ToLowerAscii(p.wstring()) == mainKey; }), paths.end());
+	m_fragmentCount = paths.size();
+
+	std::vector<YamlConfigBinder::Result> fragments(paths.size());
+	std::vector<std::exception_ptr> errors(paths.size());
+
+	std::atomic<size_t> next{ 0 };
+	auto worker = [&]()
+		{
+			for (size_t i = next++; i < paths.size(); i = next++)
+			{
+				try
+				{
+					fragments[i] = m_parser(paths[i], m_files.Read(paths[i]));
+				}
+				catch (...)
+				{
+					errors[i] = std::current_exception();
+				}
+			}
+		};
+
+	const size_t threadCount = std::min(m_threadCount, paths.size());
+	if (threadCount <= 1)
+	{
+		worker();
+	}
+	else
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount - 1);
+		for (size_t t = 1; t < threadCount; ++t)
+		{
+			threads.emplace_back(worker);
+		}
+		worker();
+		for (auto& t : threads)
+		{
+			t.join();
+		}
+	}
+
+	for (auto const& e : errors)
+	{
+		if (e) std::rethrow_exception(e);
+	}
+
+	// merge in stable order; the first hot key of each chord within each profile wins
+	struct Origin
+	{
+		std::filesystem::path const* file;
+		uint32_t line;
+		uint32_t column;
+	};
+	std::map<std::pair<std::wstring, uint64_t>, Origin> chords;
+	std::vector<HotKeyConfig> merged;
+
+	auto mergeFrom = [&](std::vector<HotKeyConfig>& hotKeys, std::filesystem::path const& file)
+		{
+			for (auto& hk : hotKeys)
+			{
+				auto key = std::make_pair(hk.profile, hk.GetChord());
+				auto it = chords.find(key);
+				if (it != chords.end())
+				{
+					m_duplicates.push_back(Duplicate{ std::move(hk), file, *it->second.file, it->second.line, it->second.column });
+					continue;
+				}
+				chords.insert(std::make_pair(std::move(key), Origin{ &file, hk.sourceLine, hk.sourceColumn }));
+				merged.push_back(std::move(hk));
+			}
+		};
+
+	// profiles of the same name in several files are one profile with the applications of all of them
+	auto mergeProfiles = [&config](std::vector<HotKeyProfile>& profiles)
+		{
+			for (auto& profile : profiles)
+			{
+				auto it = std::find_if(config.profiles.begin(), config.profiles.end(),
+					[&profile](HotKeyProfile const& p) { return p.name == profile.name; });
+				if (it == config.profiles.end())
+				{
+					config.profiles.push_back(std::move(profile));
+					continue;
+				}
+				for (auto& app : profile.applications)
+				{
+					it->applications.push_back(std::move(app));
+				}
+			}
+		};
+
+	mergeFrom(config.hotKeys, mainPath);
+	for (size_t i = 0; i < fragments.size(); ++i)
+	{
+		mergeFrom(fragments[i].hotKeys, paths[i]);
+		mergeProfiles(fragments[i].profiles);
+	}
+
+	config.hotKeys = std::move(merged);
+}
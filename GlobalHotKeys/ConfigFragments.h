@@ -0,0 +1,112 @@
+#pragma once
+
+#include "YamlConfigBinder.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// File access used by `ConfigFragments`
+/// </summary>
+class IFragmentFiles
+{
+public:
+	virtual ~IFragmentFiles() = default;
+
+	virtual bool IsDirectory(std::filesystem::path const& path) = 0;
+
+	/// <summary>
+	/// Lists the regular files of the directory, in any order
+	/// </summary>
+	virtual std::vector<std::filesystem::path> ListFiles(std::filesystem::path const& dir) = 0;
+
+	/// <summary>
+	/// Reads the whole file; throws on errors.
+	/// Called concurrently from multiple threads.
+	/// </summary>
+	virtual std::vector<uint8_t> Read(std::filesystem::path const& path) = 0;
+};
+
+/// <summary>
+/// Reads from the file system via `std::filesystem`
+/// </summary>
+class FragmentFiles : public IFragmentFiles
+{
+public:
+	bool IsDirectory(std::filesystem::path const& path) override;
+	std::vector<std::filesystem::path> ListFiles(std::filesystem::path const& dir) override;
+	std::vector<uint8_t> Read(std::filesystem::path const& path) override;
+};
+
+/// <summary>
+/// Loads the configuration fragments listed in `include` of the main configuration file,
+/// and merges their hot keys.
+/// Fragments are parsed in parallel, each by its own parser, but merged in a stable order:
+/// the main file first, then the include entries as listed, files matching one entry sorted by name.
+/// Has no platform dependencies.
+/// </summary>
+class ConfigFragments
+{
+public:
+	static constexpr const size_t c_defaultThreadCount = 8;
+
+	/// <summary>
+	/// Parses one fragment; called concurrently from multiple threads
+	/// </summary>
+	using Parser = std::function<YamlConfigBinder::Result(std::filesystem::path const& path, std::vector<uint8_t> const& data)>;
+
+	/// <summary>
+	/// A hot key dropped because an earlier one uses the same key chord in the same profile
+	/// </summary>
+	struct Duplicate
+	{
+		HotKeyConfig hotKey;
+		std::filesystem::path file;
+		std::filesystem::path firstFile;
+		uint32_t firstLine;
+		uint32_t firstColumn;
+	};
+
+	ConfigFragments(IFragmentFiles& files, Parser parser, size_t threadCount = c_defaultThreadCount);
+
+	/// <summary>
+	/// Resolves include entries relative to `baseDir`.
+	/// An entry is a file, a directory meaning all its `*.yaml` and `*.yml` files,
+	/// or a file name pattern with `*` and `?` in its last component.
+	/// Files are returned once, in merge order; missing files only fail when being read.
+	/// </summary>
+	std::vector<std::filesystem::path> Resolve(std::vector<std::wstring> const& includes, std::filesystem::path const& baseDir);
+
+	/// <summary>
+	/// Loads the fragments included by `config`, and appends their hot keys and profiles to it.
+	/// Hot keys with a key chord already used in the same profile are removed and reported by `GetDuplicates`,
+	/// also within the main file.
+	/// Rethrows the error of the first failing fragment, in merge order.
+	/// </summary>
+	void LoadAndMerge(std::filesystem::path const& mainPath, YamlConfigBinder::Result& config);
+
+	inline std::vector<Duplicate> const& GetDuplicates() const noexcept
+	{
+		return m_duplicates;
+	}
+
+	inline size_t GetFragmentCount() const noexcept
+	{
+		return m_fragmentCount;
+	}
+
+	/// <summary>
+	/// Matches a file name against a pattern with `*` and `?`, ignoring ASCII case
+	/// </summary>
+	static bool MatchPattern(std::wstring const& pattern, std::wstring const& name);
+
+private:
+	IFragmentFiles& m_files;
+	Parser m_parser;
+	size_t m_threadCount;
+	std::vector<Duplicate> m_duplicates;
+	size_t m_fragmentCount{ 0 };
+};
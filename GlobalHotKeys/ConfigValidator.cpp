@@ -0,0 +1,262 @@
+#include "pch.h"
+#include "ConfigValidator.h"
+
+#include "ArgumentTemplate.h"
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+	using Kind = IPathProbe::Kind;
+
+	/// <summary>
+	/// Candidate paths of one hot key, as indices into the list of distinct paths
+	/// </summary>
+	struct Request
+	{
+		// any of these being a file makes the executable valid; empty if not checked
+		std::vector<size_t> executable;
+		bool checkExecutable{ false };
+		// SIZE_MAX if not checked
+		size_t workingDirectory{ SIZE_MAX };
+		// per resolvable argument: argument index and its candidates
+		std::vector<std::pair<uint32_t, std::vector<size_t>>> arguments;
+		// placeholder syntax errors of arguments
+		std::vector<std::wstring> argumentErrors;
+		// placeholders of arguments kept as literal text
+		std::vector<std::wstring> argumentWarnings;
+	};
+
+	class PathList
+	{
+	public:
+		size_t Add(std::filesystem::path const& path)
+		{
+			std::wstring key = path.lexically_normal().wstring();
+			auto it = m_index.find(key);
+			if (it != m_index.end()) return it->second;
+			const size_t i = m_paths.size();
+			m_paths.push_back(std::filesystem::path{ key });
+			m_index.insert(std::make_pair(std::move(key), i));
+			return i;
+		}
+
+		std::vector<std::filesystem::path> const& GetPaths() const noexcept
+		{
+			return m_paths;
+		}
+
+	private:
+		std::vector<std::filesystem::path> m_paths;
+		std::unordered_map<std::wstring, size_t> m_index;
+	};
+
+	std::filesystem::path MakeAbsolute(std::filesystem::path const& p, std::filesystem::path const& base)
+	{
+		return p.is_absolute() ? p : (base / p);
+	}
+
+	// mirrors the resolution order of `LaunchPlan`
+	Request MakeRequest(HotKeyConfig const& hk, ConfigValidator::Context const& context, PathList& paths)
+	{
+		Request req;
+
+		std::filesystem::path wd;
+		if (!hk.workingDirectory.empty())
+		{
+			wd = MakeAbsolute(hk.workingDirectory, context.currentDir);
+			req.workingDirectory = paths.Add(wd);
+		}
+
+		req.checkExecutable = !hk.noFileCheck && !hk.executable.empty();
+		if (req.checkExecutable)
+		{
+			std::filesystem::path exe{ hk.executable };
+			if (exe.is_absolute())
+			{
+				req.executable.push_back(paths.Add(exe));
+			}
+			else
+			{
+				if (hk.isRelExePath)
+				{
+					req.executable.push_back(paths.Add(context.configDir / exe));
+					req.executable.push_back(paths.Add(context.currentDir / exe));
+				}
+				if (!wd.empty())
+				{
+					req.executable.push_back(paths.Add(wd / exe));
+				}
+				for (auto const& dir : context.searchDirs)
+				{
+					req.executable.push_back(paths.Add(dir / exe));
+				}
+			}
+		}
+
+		// the value of each argument without placeholders; arguments of actions are bound as they are
+		std::vector<std::optional<std::wstring>> constants(hk.arguments.begin(), hk.arguments.end());
+		if (hk.action.empty())
+		{
+			for (size_t i = 0; i < hk.arguments.size(); ++i)
+			{
+				ArgumentTemplate arg;
+				std::wstring error;
+				std::wstring warning;
+				const bool compiled = arg.Compile(hk.arguments[i], error, warning);
+				if (!warning.empty())
+				{
+					req.argumentWarnings.push_back(L"argument " + std::to_wstring(i) + L" " + warning);
+				}
+				if (!compiled)
+				{
+					req.argumentErrors.push_back(L"argument " + std::to_wstring(i) + L" " + error);
+					constants[i].reset();
+				}
+				else if (!arg.IsConstant())
+				{
+					constants[i].reset();
+				}
+				else
+				{
+					constants[i] = arg.GetLiteral();
+				}
+			}
+		}
+
+		for (auto const& resArg : hk.resolveArgsPaths)
+		{
+			// paths with placeholders are only known when triggered
+			if (!resArg.second.isRelPath || resArg.first >= hk.arguments.size() || !constants[resArg.first].has_value()) continue;
+
+			std::filesystem::path arg{ *constants[resArg.first] };
+			std::vector<size_t> candidates;
+			if (arg.is_absolute())
+			{
+				candidates.push_back(paths.Add(arg));
+			}
+			else
+			{
+				candidates.push_back(paths.Add(context.currentDir / arg));
+				candidates.push_back(paths.Add(context.configDir / arg));
+			}
+			req.arguments.push_back(std::make_pair(resArg.first, std::move(candidates)));
+		}
+		std::sort(req.arguments.begin(), req.arguments.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+
+		return req;
+	}
+
+	bool AnyIs(std::vector<size_t> const& candidates, std::vector<Kind> const& kinds, Kind kind)
+	{
+		return std::any_of(candidates.begin(), candidates.end(), [&](size_t i) { return kinds[i] == kind; });
+	}
+
+	void ApplyResult(HotKeyConfig& hk, Request const& req, std::vector<Kind> const& kinds)
+	{
+		hk.validation = HotKeyConfig::Validation::Valid;
+		hk.validationMessage.clear();
+
+		auto addMessage = [&hk](std::wstring const& msg) {
+			if (!hk.validationMessage.empty()) hk.validationMessage += L"; ";
+			hk.validationMessage += msg;
+		};
+
+		if (req.checkExecutable && !AnyIs(req.executable, kinds, Kind::File))
+		{
+			hk.validation = HotKeyConfig::Validation::Invalid;
+			addMessage(AnyIs(req.executable, kinds, Kind::Inaccessible)
+				? (L"executable " + hk.executable + L" not accessible")
+				: (L"executable " + hk.executable + L" not found"));
+		}
+
+		for (auto const& error : req.argumentErrors)
+		{
+			hk.validation = HotKeyConfig::Validation::Invalid;
+			addMessage(error);
+		}
+
+		for (auto const& warning : req.argumentWarnings)
+		{
+			if (hk.validation == HotKeyConfig::Validation::Valid) hk.validation = HotKeyConfig::Validation::Warning;
+			addMessage(warning);
+		}
+
+		if (req.workingDirectory != SIZE_MAX && kinds[req.workingDirectory] != Kind::Directory)
+		{
+			if (hk.validation == HotKeyConfig::Validation::Valid) hk.validation = HotKeyConfig::Validation::Warning;
+			addMessage(L"working directory " + hk.workingDirectory + L" not found");
+		}
+
+		for (auto const& arg : req.arguments)
+		{
+			if (AnyIs(arg.second, kinds, Kind::File)) continue;
+			if (hk.validation == HotKeyConfig::Validation::Valid) hk.validation = HotKeyConfig::Validation::Warning;
+			addMessage(L"argument " + std::to_wstring(arg.first) + L" path " + hk.arguments[arg.first] + L" not found");
+		}
+	}
+}
+
+ConfigValidator::ConfigValidator(IPathProbe& probe, size_t threadCount)
+	: m_probe{ probe }, m_threadCount{ std::max<size_t>(threadCount, 1) }
+{
+}
+
+void ConfigValidator::Validate(std::vector<HotKeyConfig>& hotKeys, Context const& context)
+{
+	PathList paths;
+	std::vector<Request> requests;
+	requests.reserve(hotKeys.size());
+	for (auto const& hk : hotKeys)
+	{
+		requests.push_back(MakeRequest(hk, context, paths));
+	}
+
+	std::vector<std::filesystem::path> const& queries = paths.GetPaths();
+	std::vector<Kind> kinds(queries.size(), Kind::Missing);
+	m_queryCount = queries.size();
+
+	std::atomic<size_t> next{ 0 };
+	auto worker = [&]() {
+		for (size_t i = next++; i < queries.size(); i = next++)
+		{
+			try
+			{
+				kinds[i] = m_probe.Query(queries[i]);
+			}
+			catch (...)
+			{
+				kinds[i] = Kind::Inaccessible;
+			}
+		}
+	};
+
+	const size_t threadCount = std::min(m_threadCount, queries.size());
+	if (threadCount <= 1)
+	{
+		worker();
+	}
+	else
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount - 1);
+		for (size_t t = 1; t < threadCount; ++t)
+		{
+			threads.emplace_back(worker);
+		}
+		worker();
+		for (auto& t : threads)
+		{
+			t.join();
+		}
+	}
+
+	for (size_t i = 0; i < hotKeys.size(); ++i)
+	{
+		ApplyResult(hotKeys[i], requests[i], kinds);
+	}
+}
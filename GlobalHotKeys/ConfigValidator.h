@@ -0,0 +1,70 @@
+#pragma once
+
+#include "HotKeyConfig.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// File system queries used by `ConfigValidator`
+/// </summary>
+class IPathProbe
+{
+public:
+	enum class Kind
+	{
+		Missing,
+		File,
+		Directory,
+		Inaccessible
+	};
+
+	virtual ~IPathProbe() = default;
+
+	/// <summary>
+	/// Called concurrently from multiple threads
+	/// </summary>
+	virtual Kind Query(std::filesystem::path const& path) = 0;
+};
+
+/// <summary>
+/// Checks executables, working directories and resolvable arguments of hot keys
+/// when a configuration is loaded, instead of only when a hot key is triggered.
+/// Within one `Validate` call, each distinct path is queried once, on a small pool of threads, so slow drives do not add up.
+/// Results are not kept across calls, so each load sees the current file system.
+/// Has no platform dependencies.
+/// </summary>
+class ConfigValidator
+{
+public:
+	static constexpr const size_t c_defaultThreadCount = 8;
+
+	struct Context
+	{
+		std::filesystem::path configDir;
+		std::filesystem::path currentDir;
+		// directories searched for executables given without path, in the order of `SearchPathW`; see `PathProbe::GetSearchDirs`
+		std::vector<std::filesystem::path> searchDirs;
+	};
+
+	ConfigValidator(IPathProbe& probe, size_t threadCount = c_defaultThreadCount);
+
+	/// <summary>
+	/// Sets `validation` and `validationMessage` of all hot keys
+	/// </summary>
+	void Validate(std::vector<HotKeyConfig>& hotKeys, Context const& context);
+
+	/// <summary>
+	/// Number of paths queried by the last call to `Validate`
+	/// </summary>
+	inline size_t GetQueryCount() const noexcept
+	{
+		return m_queryCount;
+	}
+
+private:
+	IPathProbe& m_probe;
+	size_t m_threadCount;
+	size_t m_queryCount{ 0 };
+};
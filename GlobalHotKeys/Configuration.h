@@ -1,5 +1,6 @@
 #pragma once
 #include "HotKeyConfig.h"
+#include "YamlConfigBinder.h"
 
 #include <filesystem>
 #include <functional>
@@ -23,10 +24,25 @@ public:
 
 	bool SetFilePath(std::filesystem::path const& path, std::optional<std::function<void(std::wstring const&)>> errorMessageReceiver = std::nullopt);
 
+	/// <summary>
+	/// Loads and validates the configuration file without changing this object.
+	/// Safe to be called from a worker thread.
+	/// </summary>
+	bool Load(std::filesystem::path const& path, YamlConfigBinder::Result& outConfig, std::optional<std::function<void(std::wstring const&)>> errorMessageReceiver = std::nullopt) const;
+
+	/// <summary>
+	/// Makes a loaded configuration the current one
+	/// </summary>
+	void Apply(std::filesystem::path const& path, YamlConfigBinder::Result&& config);
+
 	inline std::vector<HotKeyConfig> const& GetHotKeys() const noexcept
 	{
 		return m_hotKeys;
 	}
+	inline std::vector<HotKeyProfile> const& GetProfiles() const noexcept
+	{
+		return m_profiles;
+	}
 	inline bool GetBell() const noexcept
 	{
 		return m_bell;
@@ -35,15 +51,21 @@ public:
 	{
 		return m_customBellFile;
 	}
+	inline float GetBellVolume() const noexcept
+	{
+		return m_bellVolume;
+	}
 
 private:
 	sgrottel::ISimpleLog& m_log;
 	std::filesystem::path m_configFile{};
 	bool m_configFileLoaded;
 	std::vector<HotKeyConfig> m_hotKeys{};
+	std::vector<HotKeyProfile> m_profiles{};
 
 	bool m_bell{ false };
 	std::filesystem::path m_customBellFile{};
+	float m_bellVolume{ 1.0f };
 
 	void LoadConfigFilePathFromRegistry();
 	void SaveConfigFilePathInRegistry();
@@ -0,0 +1,74 @@
+#include "pch.h"
+#include "EnvironmentRegistry.h"
+
+bool EnvironmentRegistry::Read(Root root, std::vector<Value>& outValues)
+{
+	HKEY hKey = nullptr;
+	const LSTATUS opened = (root == Root::Machine)
+		? RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"SYSTEM\\CurrentControlSet\\Control\\Session Manager\\Environment", 0, KEY_READ, &hKey)
+		: RegOpenKeyExW(HKEY_CURRENT_USER, L"Environment", 0, KEY_READ, &hKey);
+	if (opened != ERROR_SUCCESS)
+	{
+		return false;
+	}
+
+	DWORD valueCount = 0;
+	DWORD maxNameLen = 0;
+	DWORD maxValueLen = 0;
+
+	if (RegQueryInfoKeyW(hKey, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &valueCount, &maxNameLen, &maxValueLen, nullptr, nullptr) != ERROR_SUCCESS)
+	{
+		RegCloseKey(hKey);
+		return false;
+	}
+
+	// buffers are kept, as the sizes rarely change between reads
+	m_nameBuf.resize(maxNameLen + 1);
+	m_valueBuf.resize(maxValueLen + 2);
+
+	for (DWORD i = 0; i < valueCount; ++i)
+	{
+		DWORD nameLen = maxNameLen + 1;
+		DWORD valueLen = maxValueLen + 2;
+		DWORD type = 0;
+
+		if (RegEnumValueW(hKey, i, m_nameBuf.data(), &nameLen, nullptr, &type, m_valueBuf.data(), &valueLen) != ERROR_SUCCESS)
+		{
+			continue;
+		}
+		if (type != REG_SZ && type != REG_EXPAND_SZ)
+		{
+			continue;
+		}
+
+		std::wstring data(reinterpret_cast<wchar_t*>(m_valueBuf.data()), valueLen / sizeof(wchar_t));
+
+		// Remove trailing nulls
+		while (!data.empty() && data.back() == L'\0')
+		{
+			data.pop_back();
+		}
+
+		outValues.push_back({ std::wstring(m_nameBuf.data(), nameLen), std::move(data), type == REG_EXPAND_SZ });
+	}
+
+	RegCloseKey(hKey);
+	return true;
+}
+
+std::wstring EnvironmentRegistry::Expand(std::wstring const& data)
+{
+	DWORD needed = ExpandEnvironmentStringsW(data.c_str(), nullptr, 0);
+	if (needed == 0)
+	{
+		return data;
+	}
+	std::wstring expanded(needed, L'\0');
+	ExpandEnvironmentStringsW(data.c_str(), expanded.data(), needed);
+	// Remove trailing null
+	while (!expanded.empty() && expanded.back() == L'\0')
+	{
+		expanded.pop_back();
+	}
+	return expanded;
+}
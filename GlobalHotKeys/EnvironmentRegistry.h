@@ -0,0 +1,17 @@
+#pragma once
+
+#include "EnvironmentSnapshot.h"
+
+/// <summary>
+/// Reads the environment variables of the machine and of the current user from the registry
+/// </summary>
+class EnvironmentRegistry : public IEnvironmentRegistry
+{
+public:
+	bool Read(Root root, std::vector<Value>& outValues) override;
+	std::wstring Expand(std::wstring const& data) override;
+
+private:
+	std::vector<wchar_t> m_nameBuf{};
+	std::vector<BYTE> m_valueBuf{};
+};
@@ -0,0 +1,129 @@
+#include "pch.h"
+#include "EnvironmentSnapshot.h"
+
+#include <algorithm>
+#include <cwctype>
+
+namespace
+{
+	std::wstring ToUpper(std::wstring const& str)
+	{
+		std::wstring upper{ str };
+		for (wchar_t& c : upper)
+		{
+			c = static_cast<wchar_t>(std::towupper(c));
+		}
+		return upper;
+	}
+}
+
+bool EnvironmentSnapshot::Refresh(IEnvironmentRegistry& registry, std::vector<Change>& outChanges)
+{
+	outChanges.clear();
+
+	bool rootChanged = false;
+	for (size_t i = 0; i < IEnvironmentRegistry::c_rootCount; ++i)
+	{
+		m_readBuffer.clear();
+		if (!registry.Read(static_cast<IEnvironmentRegistry::Root>(i), m_readBuffer))
+		{
+			continue;
+		}
+
+		RootState& root = m_roots[i];
+		const uint64_t hash = Hash(m_readBuffer);
+		if (root.valid && root.hash == hash)
+		{
+			continue;
+		}
+		root.valid = true;
+		root.hash = hash;
+		std::swap(root.values, m_readBuffer);
+		rootChanged = true;
+	}
+
+	if (!rootChanged && m_hasBaseline)
+	{
+		++m_unchangedCount;
+		return false;
+	}
+
+	VariableMap variables = Merge(registry);
+
+	for (auto const& [key, var] : variables)
+	{
+		auto it = m_variables.find(key);
+		if (it == m_variables.end() || it->second.value != var.value)
+		{
+			outChanges.push_back({ var.name, var.value, false });
+		}
+	}
+	for (auto const& [key, var] : m_variables)
+	{
+		if (variables.find(key) == variables.end())
+		{
+			outChanges.push_back({ var.name, {}, true });
+		}
+	}
+	std::sort(outChanges.begin(), outChanges.end(), [](Change const& a, Change const& b) { return a.name < b.name; });
+
+	m_variables = std::move(variables);
+	m_hasBaseline = true;
+	return !outChanges.empty();
+}
+
+uint64_t EnvironmentSnapshot::Hash(std::vector<IEnvironmentRegistry::Value> const& values) noexcept
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	auto add = [&hash](wchar_t c)
+		{
+			hash ^= static_cast<uint64_t>(c);
+			hash *= 0x100000001b3ull;
+		};
+	for (IEnvironmentRegistry::Value const& v : values)
+	{
+		for (wchar_t c : v.name) add(c);
+		// separators cannot occur in names, so different splits of the same text hash differently
+		add(v.expand ? L'%' : L'=');
+		for (wchar_t c : v.data) add(c);
+		add(L'\0');
+	}
+	return hash;
+}
+
+EnvironmentSnapshot::VariableMap EnvironmentSnapshot::Merge(IEnvironmentRegistry& registry) const
+{
+	VariableMap variables;
+	for (RootState const& root : m_roots)
+	{
+		for (IEnvironmentRegistry::Value const& v : root.values)
+		{
+			std::wstring key = ToUpper(v.name);
+			if (key == L"USERNAME")
+			{
+				// do not change the user name
+				continue;
+			}
+
+			std::wstring value = v.expand ? registry.Expand(v.data) : v.data;
+
+			if (key == L"PATH")
+			{
+				// merge path info
+				Variable& path = variables[key];
+				path.name = L"Path";
+				if (!path.value.empty())
+				{
+					path.value += L";";
+				}
+				path.value += value;
+			}
+			else
+			{
+				// the user root is merged last and overrides the machine root
+				variables[key] = { v.name, std::move(value) };
+			}
+		}
+	}
+	return variables;
+}
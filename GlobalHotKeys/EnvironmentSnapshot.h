@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// Access to the environment variables stored in the system settings, used by `EnvironmentSnapshot`
+/// </summary>
+class IEnvironmentRegistry
+{
+public:
+	enum class Root : uint8_t
+	{
+		Machine,
+		User
+	};
+	static constexpr const size_t c_rootCount = 2;
+
+	struct Value
+	{
+		std::wstring name;
+		std::wstring data;
+		// the data contains `%VAR%` references to expand
+		bool expand;
+	};
+
+	virtual ~IEnvironmentRegistry() = default;
+
+	/// <summary>
+	/// Reads all string values of the root in storage order; false if the root cannot be read
+	/// </summary>
+	virtual bool Read(Root root, std::vector<Value>& outValues) = 0;
+
+	/// <summary>
+	/// Expands the `%VAR%` references in the data with the current process environment
+	/// </summary>
+	virtual std::wstring Expand(std::wstring const& data) = 0;
+};
+
+/// <summary>
+/// The environment variables of the system settings, as merged for this process.
+/// Keeps the content hash of each root, so a refresh of unchanged settings costs one read per root,
+/// and reports only the variables which changed since the previous refresh.
+/// `Path` of the machine and of the user are concatenated, and `USERNAME` is never changed.
+/// Has no platform dependencies.
+/// </summary>
+class EnvironmentSnapshot
+{
+public:
+	struct Change
+	{
+		std::wstring name;
+		// empty if `unset`
+		std::wstring value;
+		bool unset;
+	};
+
+	/// <summary>
+	/// Reads the settings and sets `outChanges` to the variables to set or unset, ordered by name.
+	/// The first refresh reports all variables as set.
+	/// A root which cannot be read keeps its previous values.
+	/// Returns true if there are changes.
+	/// </summary>
+	bool Refresh(IEnvironmentRegistry& registry, std::vector<Change>& outChanges);
+
+	/// <summary>
+	/// Number of refreshes which found all roots unchanged and skipped the merge
+	/// </summary>
+	inline uint64_t GetUnchangedCount() const noexcept
+	{
+		return m_unchangedCount;
+	}
+
+	/// <summary>
+	/// FNV-1a over names, data and expand flags of the values, in order
+	/// </summary>
+	static uint64_t Hash(std::vector<IEnvironmentRegistry::Value> const& values) noexcept;
+
+private:
+	struct Variable
+	{
+		// spelling of the name in the settings
+		std::wstring name;
+		std::wstring value;
+	};
+
+	// keyed by upper-case name, as names are case-insensitive
+	using VariableMap = std::unordered_map<std::wstring, Variable>;
+
+	struct RootState
+	{
+		bool valid{ false };
+		uint64_t hash{ 0 };
+		std::vector<IEnvironmentRegistry::Value> values{};
+	};
+
+	VariableMap Merge(IEnvironmentRegistry& registry) const;
+
+	RootState m_roots[IEnvironmentRegistry::c_rootCount]{};
+	bool m_hasBaseline{ false };
+	VariableMap m_variables{};
+	std::vector<IEnvironmentRegistry::Value> m_readBuffer{};
+	uint64_t m_unchangedCount{ 0 };
+};
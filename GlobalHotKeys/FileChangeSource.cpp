@@ -0,0 +1,63 @@
+#include "pch.h"
+#include "FileChangeSource.h"
+
+FileChangeSource::FileChangeSource()
+	: m_change{ INVALID_HANDLE_VALUE }
+{
+	m_stop = CreateEventW(NULL, TRUE, FALSE, NULL);
+}
+
+FileChangeSource::~FileChangeSource()
+{
+	if (m_change != INVALID_HANDLE_VALUE)
+	{
+		FindCloseChangeNotification(m_change);
+		m_change = INVALID_HANDLE_VALUE;
+	}
+	if (m_stop != NULL)
+	{
+		CloseHandle(m_stop);
+		m_stop = NULL;
+	}
+}
+
+bool FileChangeSource::Start(std::filesystem::path const& directory)
+{
+	if (m_stop == NULL) return false;
+	if (m_change != INVALID_HANDLE_VALUE) return false;
+
+	// file names are included, as editors often save by writing a temporary file and renaming it
+	m_change = FindFirstChangeNotificationW(
+		directory.wstring().c_str(),
+		FALSE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+	return m_change != INVALID_HANDLE_VALUE;
+}
+
+IFileChangeSource::WaitResult FileChangeSource::Wait(uint32_t timeoutMs)
+{
+	if (m_change == INVALID_HANDLE_VALUE) return WaitResult::Failed;
+
+	const HANDLE handles[2] = { m_stop, m_change };
+	DWORD res = WaitForMultipleObjects(2, handles, FALSE, (timeoutMs == c_infinite) ? INFINITE : static_cast<DWORD>(timeoutMs));
+	switch (res)
+	{
+	case WAIT_OBJECT_0:
+		return WaitResult::Stopped;
+	case WAIT_OBJECT_0 + 1:
+		if (!FindNextChangeNotification(m_change)) return WaitResult::Failed;
+		return WaitResult::Changed;
+	case WAIT_TIMEOUT:
+		return WaitResult::Timeout;
+	default:
+		return WaitResult::Failed;
+	}
+}
+
+void FileChangeSource::Stop()
+{
+	if (m_stop != NULL)
+	{
+		SetEvent(m_stop);
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ReloadDebouncer.h"
+
+#include <filesystem>
+
+/// <summary>
+/// Change source using `FindFirstChangeNotificationW`
+/// </summary>
+class FileChangeSource : public IFileChangeSource
+{
+public:
+	FileChangeSource();
+	~FileChangeSource();
+
+	bool Start(std::filesystem::path const& directory) override;
+	WaitResult Wait(uint32_t timeoutMs) override;
+	void Stop() override;
+
+private:
+	HANDLE m_change;
+	HANDLE m_stop;
+};
@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "FileContent.h"
+
+#include <algorithm>
+
+namespace
+{
+	struct FileStamp
+	{
+		uint64_t size{ 0 };
+		uint64_t lastWriteTime{ 0 };
+
+		inline bool operator==(FileStamp const& other) const
+		{
+			return size == other.size && lastWriteTime == other.lastWriteTime;
+		}
+	};
+
+	bool GetStamp(HANDLE file, FileStamp& outStamp)
+	{
+		LARGE_INTEGER size;
+		FILETIME ft;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart < 0 || !GetFileTime(file, NULL, NULL, &ft))
+		{
+			return false;
+		}
+		outStamp.size = static_cast<uint64_t>(size.QuadPart);
+		outStamp.lastWriteTime = (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | static_cast<uint64_t>(ft.dwLowDateTime);
+		return true;
+	}
+
+	// reads up to `data.size()` bytes; shrinks `data` if the file ended early, e.g. as it was truncated meanwhile
+	bool ReadAll(HANDLE file, std::vector<uint8_t>& data)
+	{
+		size_t pos = 0;
+		while (pos < data.size())
+		{
+			const DWORD chunk = static_cast<DWORD>(std::min<size_t>(data.size() - pos, 0x40000000));
+			DWORD read = 0;
+			if (!ReadFile(file, data.data() + pos, chunk, &read, NULL))
+			{
+				return false;
+			}
+			if (read == 0) break;
+			pos += read;
+		}
+		data.resize(pos);
+		return true;
+	}
+}
+
+bool FileContent::Open(std::filesystem::path const& path)
+{
+	Close();
+
+	// share write and delete, so that editors can still save the file while we read it
+	HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	for (int attempt = 0; attempt < c_maxReadAttempts && !m_open; ++attempt)
+	{
+		FileStamp before;
+		if (!GetStamp(file, before) || before.size > SIZE_MAX) break;
+
+		LARGE_INTEGER start{};
+		m_data.resize(static_cast<size_t>(before.size));
+		if (!SetFilePointerEx(file, start, NULL, FILE_BEGIN) || !ReadAll(file, m_data)) break;
+
+		// an editor writing the file meanwhile might have left a mix of old and new content
+		FileStamp after;
+		if (!GetStamp(file, after)) break;
+		if (after == before && m_data.size() == before.size)
+		{
+			m_lastWriteTime = after.lastWriteTime;
+			m_open = true;
+		}
+	}
+	CloseHandle(file);
+
+	if (!m_open)
+	{
+		Close();
+	}
+	return m_open;
+}
+
+void FileContent::Close()
+{
+	m_open = false;
+	m_data.clear();
+	m_data.shrink_to_fit();
+	m_lastWriteTime = 0;
+}
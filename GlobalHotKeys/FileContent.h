@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+/// <summary>
+/// The whole content of a file, read into memory.
+/// The file is only open while reading it and shares write and delete access,
+/// so editors can save, truncate, or replace it at any time.
+/// A memory mapping would be kept open instead, and make editors truncating the file fail.
+/// </summary>
+class FileContent
+{
+public:
+	FileContent() = default;
+
+	FileContent(FileContent const&) = delete;
+	FileContent& operator=(FileContent const&) = delete;
+
+	/// <summary>
+	/// Reads the file; retries if it changed while being read
+	/// </summary>
+	bool Open(std::filesystem::path const& path);
+	void Close();
+
+	inline bool IsOpen() const noexcept
+	{
+		return m_open;
+	}
+	inline const uint8_t* GetData() const noexcept
+	{
+		return m_data.data();
+	}
+	inline size_t GetSize() const noexcept
+	{
+		return m_data.size();
+	}
+
+	/// <summary>
+	/// Last write time of the file as FILETIME value when it was read, or zero on error
+	/// </summary>
+	inline uint64_t GetLastWriteTime() const noexcept
+	{
+		return m_lastWriteTime;
+	}
+
+private:
+	static constexpr const int c_maxReadAttempts = 3;
+
+	bool m_open{ false };
+	std::vector<uint8_t> m_data{};
+	uint64_t m_lastWriteTime{ 0 };
+};
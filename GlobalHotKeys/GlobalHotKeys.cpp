@@ -25,6 +25,7 @@
 #include "Menu.h"
 #include "SingleInstanceGuard.h"
 #include "Configuration.h"
+#include "ConfigFileWatcher.h"
 #include "HotKeyManager.h"
 #include "Version.h"
 #include "StringUtils.h"
@@ -37,6 +38,19 @@
 
 namespace
 {
+	// the hot key log to flush if the process crashes
+	HotKeyManager* g_crashFlushKeys = nullptr;
+
+	LONG WINAPI FlushLogOnCrash(EXCEPTION_POINTERS* /*exceptionInfo*/)
+	{
+		// must not wait: the crashing thread might hold the log's lock, or be its worker
+		if (g_crashFlushKeys != nullptr)
+		{
+			g_crashFlushKeys->DrainLogOnCrash();
+		}
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+
 	class CoGuard {
 	public:
 		CoGuard() : m_inited{ false }
@@ -114,8 +128,19 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstan
 		std::unique_ptr<NotifyIcon> notifyIcon = std::make_unique<NotifyIcon>(log, wnd);
 		Menu menu{ log, wnd.GetHInstance() };
 		HotKeyManager keys{ log, wnd };
-		keys.SetHotKeys(config.GetHotKeys(), config.GetFilePath().parent_path());
-		keys.SetBell(config.GetBell(), config.GetCustomBellFile());
+		g_crashFlushKeys = &keys;
+		SetUnhandledExceptionFilter(&FlushLogOnCrash);
+		const std::filesystem::path statsFile = log.GetFilePath().empty()
+			? std::filesystem::path{}
+			: std::filesystem::path{ log.GetFilePath() }.replace_filename(L"GlobalHotKeys.stats.txt");
+		keys.SetStatsFile(statsFile);
+		keys.SetHotKeys(config.GetHotKeys(), config.GetProfiles(), config.GetFilePath().parent_path());
+		keys.SetBell(config.GetBell(), config.GetCustomBellFile(), config.GetBellVolume());
+		ConfigFileWatcher configWatcher{
+			log,
+			[&config](std::filesystem::path const& path, YamlConfigBinder::Result& outConfig) { return config.Load(path, outConfig); },
+			[&wnd]() { PostMessageW(wnd.GetHandle(), ConfigFileWatcher::c_Message, 0, 0); } };
+		configWatcher.SetFilePath(config.GetFilePath());
 
 		menu.SetOnShowAboutCallback([hInstance]() { ShowAboutDlg(hInstance); });
 
@@ -132,7 +157,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstan
 					MainWindow::c_WindowName,
 					MB_ICONERROR | MB_OK);
 			};
-		auto selectConfig = [&log, &config, &configLoadErrorMessageBox, &keys]()
+		auto selectConfig = [&log, &config, &configLoadErrorMessageBox, &keys, &configWatcher]()
 			{
 				std::unique_ptr<IFileOpenDialog, std::function<void(IFileOpenDialog*)>> dlg;
 				{
@@ -196,8 +221,9 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstan
 				files->Release();
 
 				config.SetFilePath(p, configLoadErrorMessageBox);
-				keys.SetHotKeys(config.GetHotKeys(), config.GetFilePath().parent_path());
-				keys.SetBell(config.GetBell(), config.GetCustomBellFile());
+				keys.SetHotKeys(config.GetHotKeys(), config.GetProfiles(), config.GetFilePath().parent_path());
+				keys.SetBell(config.GetBell(), config.GetCustomBellFile(), config.GetBellVolume());
+				configWatcher.SetFilePath(config.GetFilePath());
 			};
 		menu.SetOnSelectConfigCallback(selectConfig);
 		menu.SetOnReloadConfigCallback(
@@ -211,11 +237,21 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstan
 				}
 
 				config.SetFilePath(config.GetFilePath(), configLoadErrorMessageBox);
-				keys.SetHotKeys(config.GetHotKeys(), config.GetFilePath().parent_path());
-				keys.SetBell(config.GetBell(), config.GetCustomBellFile());
+				keys.SetHotKeys(config.GetHotKeys(), config.GetProfiles(), config.GetFilePath().parent_path());
+				keys.SetBell(config.GetBell(), config.GetCustomBellFile(), config.GetBellVolume());
 			});
 		menu.SetOnRegAutostartCallback(std::bind(&AutostartRegistry::Register, &autostart));
 		menu.SetOnUnregAutostartCallback(std::bind(&AutostartRegistry::Unregister, &autostart));
+		menu.SetOnShowStatsCallback(
+			[&keys, &statsFile]()
+			{
+				if (!keys.WriteStats())
+				{
+					MessageBox(NULL, L"Failed to write launch statistics", MainWindow::c_WindowName, MB_ICONERROR | MB_OK);
+					return;
+				}
+				ShellExecuteW(NULL, L"open", statsFile.wstring().c_str(), NULL, NULL, SW_SHOW);
+			});
 
 		wnd.SetNotifyCallback(
 			[&wnd, &menu, &notifyIcon, &config, &keys, &autostart]()
@@ -238,12 +274,31 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstan
 				notifyIcon = std::make_unique<NotifyIcon>(log, wnd); // then ctor
 			});
 
-		wnd.SetHotKeyCallback(std::bind(&HotKeyManager::HotKeyTriggered, &keys, std::placeholders::_1));
+		wnd.SetHotKeyCallback(std::bind(&HotKeyManager::HotKeyTriggered, &keys, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+		wnd.SetEnvironmentChangedCallback(std::bind(&HotKeyManager::InvalidateLaunchPlans, &keys));
+		wnd.SetConfigFileChangedCallback(
+			[&config, &configWatcher, &keys]()
+			{
+				std::filesystem::path path;
+				YamlConfigBinder::Result loaded;
+				if (!configWatcher.TakeLoadedConfig(path, loaded)) return;
+				if (path != config.GetFilePath()) return; // outdated, user selected another file meanwhile
+
+				config.Apply(path, std::move(loaded));
+				keys.SetHotKeys(config.GetHotKeys(), config.GetProfiles(), config.GetFilePath().parent_path());
+				keys.SetBell(config.GetBell(), config.GetCustomBellFile(), config.GetBellVolume());
+			});
 
 		retval = wnd.RunMainLoop();
 
+		configWatcher.Stop();
+
 		wnd.SetNotifyCallback({});
 		wnd.SetMenuItemCallback({});
+		wnd.SetConfigFileChangedCallback({});
+		wnd.SetEnvironmentChangedCallback({});
+
+		g_crashFlushKeys = nullptr;
 	}
 
 	log.Write("GlobalHotKeys exit: %d", retval);
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
+// When adding fields, also update the binary image in `ConfigCache` and bump its version
 struct HotKeyConfig
 {
 	static constexpr const uint32_t c_invalidVirtualKeyCode = 0xffffffffu;
@@ -26,6 +28,9 @@ struct HotKeyConfig
 
 	std::wstring executable{};
 
+	// Name of an in-process action from `ActionRegistry`, run instead of `executable` with `arguments`
+	std::wstring action{};
+
 	std::wstring workingDirectory{};
 
 	std::vector<std::wstring> arguments{};
@@ -36,8 +41,63 @@ struct HotKeyConfig
 
 	bool createNoWindow{ true };
 
+	// Triggers within this time after the last launch are ignored; zero disables
+	uint32_t cooldownMs{ 0 };
+
+	// Triggers are ignored while a previous trigger is still waiting to be launched
+	bool coalesce{ false };
+
+	// Maximum number of running processes launched by this hot key; zero is unlimited
+	uint32_t maxConcurrent{ 0 };
+
+	// Shorthand for `maxConcurrent` of one
+	bool singleInstance{ false };
+
 	std::unordered_map<uint32_t, ResolveArgConfig> resolveArgsPaths{};
 
+	// Name of the profile this hot key belongs to; empty if used in all applications without a profile of their own
+	std::wstring profile{};
+
+	// Position of the entry within its yaml file (1-based); zero if unknown
+	uint32_t sourceLine{ 0 };
+	uint32_t sourceColumn{ 0 };
+
+	enum class Validation
+	{
+		Unchecked,
+		Valid,
+		// the hot key can launch, but e.g. its working directory is missing
+		Warning,
+		// the executable was not found, or an argument is malformed
+		Invalid
+	};
+
+	// Set by `ConfigValidator` on every load; not stored in the `ConfigCache` image
+	Validation validation{ Validation::Unchecked };
+
+	std::wstring validationMessage{};
+
 	std::wstring GetKeyWString() const;
+
+	/// <summary>
+	/// The identity of a hot key registration: modifiers and virtual key code
+	/// </summary>
+	inline uint64_t GetChord() const noexcept
+	{
+		uint64_t chord = virtualKeyCode;
+		if (modAlt) chord |= 1ull << 32;
+		if (modCtrl) chord |= 1ull << 33;
+		if (modShift) chord |= 1ull << 34;
+		return chord;
+	}
+};
+
+// Hot keys of a profile are used while one of its applications is in the foreground
+struct HotKeyProfile
+{
+	std::wstring name;
+
+	// image file names of the executables, e.g. `notepad.exe`
+	std::vector<std::wstring> applications;
 };
 
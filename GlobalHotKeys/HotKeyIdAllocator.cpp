@@ -0,0 +1,53 @@
+#include "pch.h"
+#include "HotKeyIdAllocator.h"
+
+HotKeyIdAllocator::HotKeyIdAllocator(uint32_t firstId, uint32_t lastId)
+	: m_firstId{ firstId }, m_lastId{ lastId }, m_used((static_cast<size_t>(lastId - firstId) + 1 + 63) / 64, 0)
+{
+	// mark the bits beyond the range in the last word as used
+	const uint32_t tailBits = (lastId - firstId + 1) % 64;
+	if (tailBits != 0)
+	{
+		m_used.back() = ~((1ull << tailBits) - 1);
+	}
+}
+
+uint32_t HotKeyIdAllocator::Allocate()
+{
+	for (size_t w = m_searchStart; w < m_used.size(); ++w)
+	{
+		const uint64_t word = m_used[w];
+		if (word == ~0ull) continue;
+
+		uint32_t bit = 0;
+		while ((word & (1ull << bit)) != 0) ++bit;
+
+		m_used[w] |= 1ull << bit;
+		m_searchStart = w;
+		m_allocatedCount++;
+		return m_firstId + static_cast<uint32_t>(w * 64) + bit;
+	}
+	m_searchStart = m_used.size();
+	return c_invalidId;
+}
+
+void HotKeyIdAllocator::Release(uint32_t id)
+{
+	if (!IsAllocated(id)) return;
+
+	const uint32_t index = id - m_firstId;
+	const size_t w = index / 64;
+	m_used[w] &= ~(1ull << (index % 64));
+	m_allocatedCount--;
+	if (w < m_searchStart)
+	{
+		m_searchStart = w;
+	}
+}
+
+bool HotKeyIdAllocator::IsAllocated(uint32_t id) const
+{
+	if (id < m_firstId || id > m_lastId) return false;
+	const uint32_t index = id - m_firstId;
+	return (m_used[index / 64] & (1ull << (index % 64))) != 0;
+}
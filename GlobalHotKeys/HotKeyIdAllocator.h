@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Allocates hot key ids from a fixed range using a bitmap, always handing out the lowest free id.
+/// Released ids are recycled, so the range is not exhausted by repeated enable and disable cycles.
+/// As a released id can be handed out again right away, triggers still queued for it are matched by their key chord.
+/// Has no platform dependencies.
+/// </summary>
+class HotKeyIdAllocator
+{
+public:
+	static constexpr const uint32_t c_invalidId = 0;
+
+	/// <summary>
+	/// Ids are allocated from [firstId, lastId]; firstId must not be zero
+	/// </summary>
+	HotKeyIdAllocator(uint32_t firstId, uint32_t lastId);
+
+	/// <summary>
+	/// Returns the lowest free id, or `c_invalidId` if all are in use
+	/// </summary>
+	uint32_t Allocate();
+
+	void Release(uint32_t id);
+
+	bool IsAllocated(uint32_t id) const;
+
+	inline uint32_t GetAllocatedCount() const noexcept
+	{
+		return m_allocatedCount;
+	}
+
+private:
+	uint32_t m_firstId;
+	uint32_t m_lastId;
+	std::vector<uint64_t> m_used;
+	// no free bit below this word
+	size_t m_searchStart{ 0 };
+	uint32_t m_allocatedCount{ 0 };
+};
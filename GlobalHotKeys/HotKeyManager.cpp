@@ -2,351 +2,614 @@
 
 #include "HotKeyManager.h"
 
+#include "BuiltInActions.h"
+#include "ChildProcess.h"
+#include "HotKeyRegistrar.h"
 #include "MainWindow.h"
 #include "StringUtils.h"
 
 #include "SimpleLog/SimpleLog.hpp"
 
-#include <stdexcept>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <Mmsystem.h>
 
 namespace
 {
-	constexpr const uint32_t c_idOffset = 42;
+	void WriteToLog(sgrottel::ISimpleLog& log, AsyncLog::Level level, std::wstring const& message)
+	{
+		switch (level)
+		{
+		case AsyncLog::Level::Detail:
+			log.Detail(L"%s", message.c_str());
+			break;
+		case AsyncLog::Level::Warning:
+			log.Warning(L"%s", message.c_str());
+			break;
+		case AsyncLog::Level::Error:
+			log.Error(L"%s", message.c_str());
+			break;
+		default:
+			log.Write(L"%s", message.c_str());
+			break;
+		}
+	}
+
+	LaunchPolicy GetPolicy(HotKeyConfig const& hk)
+	{
+		LaunchPolicy policy;
+		policy.cooldownMs = hk.cooldownMs;
+		policy.coalesce = hk.coalesce;
+		policy.maxConcurrent = hk.maxConcurrent;
+		if (hk.singleInstance)
+		{
+			policy.maxConcurrent = 1;
+		}
+		return policy;
+	}
+
+	// same bits as `HotKeyConfig::GetChord`
+	uint64_t GetChord(uint32_t modifiers, uint32_t virtualKeyCode)
+	{
+		uint64_t chord = virtualKeyCode;
+		if (modifiers & MOD_ALT) chord |= 1ull << 32;
+		if (modifiers & MOD_CONTROL) chord |= 1ull << 33;
+		if (modifiers & MOD_SHIFT) chord |= 1ull << 34;
+		return chord;
+	}
+
+	// profile ids are 1-based positions, which fit into the bits above the chord
+	uint64_t GetProfileKey(uint64_t chord, uint32_t profileId)
+	{
+		return chord | (static_cast<uint64_t>(profileId) << 35);
+	}
 }
 
 HotKeyManager::HotKeyManager(sgrottel::ISimpleLog& log, MainWindow& wnd)
-	: m_wnd{ wnd }, m_log{ log }
+	: HotKeyManager{ log, std::make_unique<HotKeyRegistrar>(wnd) }
 {
 }
 
+HotKeyManager::HotKeyManager(sgrottel::ISimpleLog& log, std::unique_ptr<IHotKeyRegistrar> registrar)
+	: m_log{ log },
+	m_hotLog{ [&log](AsyncLog::Level level, std::wstring const& message) { WriteToLog(log, level, message); } },
+	m_registrations{ log, std::move(registrar), c_firstId, c_lastId },
+	m_launchQueue{ [this](LaunchQueue::Item const& item) { OnLaunchItem(item); } }
+{
+	RegisterBuiltInActions(m_actions);
+}
+
 HotKeyManager::~HotKeyManager()
 {
+	m_launchQueue.Stop();
 	DisableAllHotKeys();
+	WriteStats();
+	FlushLog();
 }
 
-void HotKeyManager::SetHotKeys(std::vector<HotKeyConfig> const& hotKeys, std::filesystem::path const& configDir)
+void HotKeyManager::SetHotKeys(std::vector<HotKeyConfig> const& hotKeys, std::vector<HotKeyProfile> const& profiles, std::filesystem::path const& configDir)
 {
-	bool allPrevKeysDiabled = false;
-	if (!m_hotKeys.empty())
+	std::lock_guard<std::mutex> lock{ m_lock };
+
+	// hot keys all disabled by the user stay disabled, including added ones
+	const bool allPrevKeysDisabled = !m_registrations.IsEmpty() && !m_registrations.HasRegistered();
+
+	m_profiles.Build(profiles);
+	for (auto const& conflict : m_profiles.GetConflicts())
 	{
-		allPrevKeysDiabled = true;
-		for (auto const& hk : m_hotKeys)
+		m_log.Warning(L"Application listed by several profiles; ignored in the later one: %s", conflict.c_str());
+	}
+
+	// match new configurations to existing statistics by chord and profile; registrations are matched by chord
+	std::map<std::pair<std::wstring, uint64_t>, size_t> oldByProfile;
+	for (size_t i = 0; i < m_hotKeys.size(); ++i)
+	{
+		oldByProfile.insert(std::make_pair(std::make_pair(m_hotKeys[i].profile, m_hotKeys[i].GetChord()), i));
+	}
+
+	std::vector<HotKey> newHotKeys;
+	newHotKeys.reserve(hotKeys.size());
+	std::vector<uint64_t> chords;
+	chords.reserve(hotKeys.size());
+	std::unordered_set<uint64_t> newChords;
+	std::unordered_set<uint64_t> profileChords;
+	for (auto const& hkc : hotKeys)
+	{
+		newHotKeys.push_back({ hkc });
+		HotKey& hk = newHotKeys.back();
+		hk.m_activeId = 0;
+		hk.m_registers = newChords.insert(hkc.GetChord()).second;
+		if (hk.m_registers) chords.push_back(hkc.GetChord());
+		hk.m_byProfile = false;
+		hk.m_profileId = m_profiles.GetProfileId(hkc.profile);
+		hk.m_plan = std::make_shared<LaunchPlan>();
+		if (hk.action.empty())
 		{
-			if (hk.m_activeId != 0)
-			{
-				allPrevKeysDiabled = false;
-				break;
-			}
+			// placeholders are parsed once here; building the plan only evaluates them
+			hk.m_plan->Compile(hk);
 		}
+		if (hk.m_profileId != ProfileResolver::c_noProfile)
+		{
+			profileChords.insert(hkc.GetChord());
+		}
+
+		auto oldStats = oldByProfile.find(std::make_pair(hkc.profile, hkc.GetChord()));
+		hk.m_stats = (oldStats != oldByProfile.end())
+			? m_hotKeys[oldStats->second].m_stats
+			: std::make_shared<LaunchStats>();
 	}
-	DisableAllHotKeys();
 
-	m_hotKeys.clear();
-	for (auto const& hkc : hotKeys)
+	m_profileDispatch.clear();
+	for (size_t i = 0; i < newHotKeys.size(); ++i)
 	{
-		m_hotKeys.push_back({ hkc });
-		m_hotKeys.back().m_activeId = 0;
+		HotKey& hk = newHotKeys[i];
+		if (profileChords.find(hk.GetChord()) == profileChords.end()) continue;
+		hk.m_byProfile = true;
+		m_profileDispatch.insert(std::make_pair(GetProfileKey(hk.GetChord(), hk.m_profileId), i));
 	}
-	m_configDir = configDir;
 
-	if (!allPrevKeysDiabled)
+	const HotKeyRegistrations::Changes changes = m_registrations.Update(chords, !allPrevKeysDisabled);
+
+	m_hotKeys = std::move(newHotKeys);
+	m_configDir = configDir;
+	for (auto& hk : m_hotKeys)
 	{
-		EnableAllHotKeys();
+		BuildLaunchPlan(hk);
 	}
+	UpdateIdTables();
+
+	m_log.Write("Hot keys updated: %u kept, %u unregistered", static_cast<unsigned int>(changes.kept), static_cast<unsigned int>(changes.removed.size()));
 }
 
-bool HotKeyManager::CanEnableAllHotKeys()
+void HotKeyManager::SetBell(bool bell, std::filesystem::path const& customFile, float volume)
 {
-	for (auto const& hk : m_hotKeys)
 	{
-		if (hk.m_activeId == 0) return true;
+		std::lock_guard<std::mutex> lock{ m_lock };
+		m_bell = bell;
+	}
+
+	WaveSound sound;
+	if (!customFile.empty())
+	{
+		LoadBellSound(customFile, volume, sound);
+	}
+
+	std::lock_guard<std::mutex> bellLock{ m_bellLock };
+	// stop a playing sound before releasing its memory
+	if (!m_bellSound.IsEmpty())
+	{
+		PlaySoundW(NULL, NULL, 0);
 	}
-	return false;
+	m_bellSound = std::move(sound);
 }
 
-bool HotKeyManager::CanDisableAllHotKeys()
+void HotKeyManager::LoadBellSound(std::filesystem::path const& file, float volume, WaveSound& outSound)
 {
-	for (auto const& hk : m_hotKeys)
+	std::vector<uint8_t> image;
 	{
-		if (hk.m_activeId != 0) return true;
+		std::ifstream stream{ file, std::ios::binary };
+		if (!stream)
+		{
+			m_log.Warning(L"Custom bell file cannot be opened: %s", file.wstring().c_str());
+			return;
+		}
+		image.assign(std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{});
 	}
-	return false;
+
+	std::string error;
+	if (!outSound.Load(std::move(image), error))
+	{
+		m_log.Warning(L"Custom bell file %s is invalid: %s", file.wstring().c_str(), ToW(error.c_str()).c_str());
+		outSound.Clear();
+		return;
+	}
+	outSound.ScaleVolume(volume);
+}
+
+bool HotKeyManager::CanEnableAllHotKeys()
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	return m_registrations.HasUnregistered();
+}
+
+bool HotKeyManager::CanDisableAllHotKeys()
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	return m_registrations.HasRegistered();
 }
 
 void HotKeyManager::EnableAllHotKeys()
 {
-	uint32_t nextId = c_idOffset;
-	for (auto const& hk : m_hotKeys)
+	std::lock_guard<std::mutex> lock{ m_lock };
+	m_registrations.RegisterAll();
+	UpdateIdTables();
+}
+
+void HotKeyManager::DisableAllHotKeys()
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	m_registrations.UnregisterAll();
+	UpdateIdTables();
+}
+
+void HotKeyManager::UpdateIdTables()
+{
+	std::unordered_map<uint32_t, TriggerInfo> prevInfos;
+	prevInfos.swap(m_triggerInfos);
+	m_dispatch.clear();
+	for (size_t i = 0; i < m_hotKeys.size(); ++i)
 	{
-		if (hk.m_activeId >= nextId)
+		HotKey& hk = m_hotKeys[i];
+		hk.m_activeId = hk.m_registers ? m_registrations.GetId(hk.GetChord()) : 0;
+		if (hk.m_activeId == 0) continue;
+
+		m_triggerInfos.insert(std::make_pair(hk.m_activeId, TriggerInfo{ hk.GetChord(), hk.m_byProfile, GetPolicy(hk), hk.m_stats }));
+
+		const size_t slot = hk.m_activeId - c_firstId;
+		if (slot >= m_dispatch.size())
 		{
-			nextId = hk.m_activeId;
+			m_dispatch.resize(slot + 1, c_noHotKey);
 		}
+		m_dispatch[slot] = i;
 	}
-
-	for (auto& hk : m_hotKeys)
+	// queued triggers of removed or reassigned ids will not match anymore; those of kept ids still launch
+	for (auto const& prev : prevInfos)
 	{
-		if (hk.m_activeId == 0)
+		auto info = m_triggerInfos.find(prev.first);
+		if (info == m_triggerInfos.end() || info->second.chord != prev.second.chord)
 		{
-			m_log.Write(L"RegisterHotKey(..., %u, %s)", nextId, hk.GetKeyWString().c_str());
-
-			UINT mods = 0;
-			if (hk.modAlt) mods |= MOD_ALT;
-			if (hk.modCtrl) mods |= MOD_CONTROL;
-			if (hk.modShift) mods |= MOD_SHIFT;
-			BOOL res = RegisterHotKey(m_wnd.GetHandle(), nextId, mods, hk.virtualKeyCode);
-			if (res == 0)
-			{
-				m_log.Error(L"RegisterHotKey failed: %d", static_cast<int>(GetLastError()));
-			}
-			else
-			{
-				hk.m_activeId = nextId;
-			}
-
-			nextId++;
-			if (nextId > 0xBFFF)
-			{
-				m_log.Error("RegisterHotKey id limit hit. Abort.");
-				break;
-			}
+			m_scheduler.ResetPending(prev.second.chord);
 		}
 	}
 }
 
-void HotKeyManager::DisableAllHotKeys()
+HotKeyManager::HotKey* HotKeyManager::FindHotKey(uint32_t id)
 {
-	for (auto& hk : m_hotKeys)
+	if (id < c_firstId) return nullptr;
+	const size_t slot = id - c_firstId;
+	if (slot >= m_dispatch.size() || m_dispatch[slot] == c_noHotKey) return nullptr;
+	return &m_hotKeys[m_dispatch[slot]];
+}
+
+HotKeyManager::HotKey* HotKeyManager::FindProfileHotKey(HotKey const& hk, uint32_t processId)
+{
+	uint32_t profileId = ProfileResolver::c_noProfile;
+	if (processId != 0)
 	{
-		if (hk.m_activeId != 0)
-		{
-			m_log.Write("UnregisterHotKey(..., %u)", hk.m_activeId);
-			UnregisterHotKey(m_wnd.GetHandle(), hk.m_activeId);
-			hk.m_activeId = 0;
-		}
+		profileId = m_profiles.Resolve(m_processImages.Lookup(processId));
+	}
+
+	auto it = m_profileDispatch.find(GetProfileKey(hk.GetChord(), profileId));
+	if (it == m_profileDispatch.end() && profileId != ProfileResolver::c_noProfile)
+	{
+		// applications of a profile without this chord use the hot key without profile
+		it = m_profileDispatch.find(GetProfileKey(hk.GetChord(), ProfileResolver::c_noProfile));
 	}
+	return (it != m_profileDispatch.end()) ? &m_hotKeys[it->second] : nullptr;
 }
 
-namespace
+void HotKeyManager::InvalidateLaunchPlans()
 {
-	std::filesystem::path SearchExePath(wchar_t const* dir, std::filesystem::path const& exe)
+	std::lock_guard<std::mutex> lock{ m_lock };
+	m_log.Write("Rebuilding launch plans");
+	for (auto& hk : m_hotKeys)
 	{
-		std::vector<wchar_t> p(MAX_PATH, L'\0');
+		BuildLaunchPlan(hk);
+	}
+}
 
-		DWORD res = SearchPathW(dir, exe.wstring().c_str(), NULL, static_cast<DWORD>(p.size()), p.data(), NULL);
-		if (res == 0) return {};
-		if (res > p.size())
+void HotKeyManager::BuildLaunchPlan(HotKey& hk)
+{
+	if (!hk.action.empty())
+	{
+		std::wstring error;
+		if (!m_actions.Bind(hk.action, hk.arguments, hk.m_actionBinding, error))
 		{
-			p.resize(res, L'\0');
-			res = SearchPathW(dir, exe.wstring().c_str(), NULL, static_cast<DWORD>(p.size()), p.data(), NULL);
-			if (res == 0) return {};
+			m_log.Warning(L"HotKey %s %s", hk.GetKeyWString().c_str(), error.c_str());
 		}
-
-		return std::filesystem::path{ p.begin(), p.begin() + res };
+		return;
 	}
 
-	std::filesystem::path TryResolve(std::filesystem::path const& base, std::filesystem::path const& rel)
-	{
-		if (!base.is_absolute()) throw std::invalid_argument("`base` must be absolute");
-		if (!std::filesystem::exists(base)) throw std::invalid_argument("`base` must exist");
-		if (!std::filesystem::is_directory(base)) throw std::invalid_argument("`base` must be a directory");
+	// the launch worker might still use the current plan
+	auto plan = std::make_shared<LaunchPlan>(*hk.m_plan);
+	BuildLaunchPlan(hk, m_configDir, *plan);
+	hk.m_plan = std::move(plan);
+}
 
-		std::filesystem::path p = base / rel;
+void HotKeyManager::BuildLaunchPlan(HotKeyConfig const& config, std::filesystem::path const& configDir, LaunchPlan& plan)
+{
+	plan.Build(config, configDir, m_argumentSource, m_pathProbe);
+	if (!plan.IsValid())
+	{
+		m_log.Warning(L"HotKey %s %s", config.GetKeyWString().c_str(), plan.GetError().c_str());
+	}
+	else if (!plan.GetWarning().empty())
+	{
+		m_log.Write(L"HotKey %s %s", config.GetKeyWString().c_str(), plan.GetWarning().c_str());
+	}
+}
 
-		if (!std::filesystem::exists(p))
+void HotKeyManager::PublishLaunchPlan(std::shared_ptr<LaunchPlan> const& oldPlan, std::shared_ptr<LaunchPlan> const& newPlan)
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	// not found if the hot keys were set or the plans were rebuilt meanwhile; then those plans are newer
+	for (auto& hk : m_hotKeys)
+	{
+		if (hk.m_plan == oldPlan)
 		{
-			return rel;
+			hk.m_plan = newPlan;
+			return;
 		}
+	}
+}
 
-		return std::filesystem::canonical(p);
+bool HotKeyManager::FlushLog()
+{
+	if (m_hotLog.GetDroppedCount() > 0)
+	{
+		m_log.Warning("%u hot key log messages dropped", static_cast<unsigned int>(m_hotLog.GetDroppedCount()));
 	}
+	return m_hotLog.Flush();
+}
 
+bool HotKeyManager::DrainLogOnCrash() noexcept
+{
+	return m_hotLog.TryDrain();
 }
 
-void HotKeyManager::HotKeyTriggered(uint32_t id)
+void HotKeyManager::HotKeyTriggered(uint32_t id, uint32_t modifiers, uint32_t virtualKeyCode)
 {
-	m_log.Write("HotKeyTriggered(%u)", id);
+	m_hotLog.Write("HotKeyTriggered(%u)", id);
+
+	const uint64_t chord = GetChord(modifiers, virtualKeyCode);
+	auto info = m_triggerInfos.find(id);
+	if (info != m_triggerInfos.end() && info->second.chord != chord)
+	{
+		// posted before the id was released and registered again for another chord
+		m_hotLog.Detail("HotKey(%u) dropped, the id was reused by another key chord", id);
+		m_unmatchedStats.CountFailure(LaunchStats::Failure::NotFound);
+		return;
+	}
+	if (info != m_triggerInfos.end()
+		&& m_scheduler.OnTriggered(info->second.chord, info->second.policy) == LaunchScheduler::Decision::Coalesced)
+	{
+		m_hotLog.Detail("HotKey(%u) coalesced with pending trigger", id);
+		info->second.stats->CountFailure(LaunchStats::Failure::Coalesced);
+		return;
+	}
+
+	uint32_t processId = 0;
+	if (info != m_triggerInfos.end() && info->second.byProfile)
+	{
+		// only the process is determined here; its profile is resolved on the worker thread
+		DWORD pid = 0;
+		const HWND foreground = GetForegroundWindow();
+		if (foreground != NULL && GetWindowThreadProcessId(foreground, &pid) != 0)
+		{
+			processId = static_cast<uint32_t>(pid);
+		}
+	}
 
-	auto hk = std::find_if(m_hotKeys.begin(), m_hotKeys.end(), [&id](auto const& key) { return key.m_activeId == id; });
-	if (hk == m_hotKeys.end())
+	if (!m_launchQueue.TryPush(id, chord, processId))
 	{
-		m_log.Error("HotKey(%u) not found", id);
+		m_hotLog.Error("HotKey(%u) dropped, launch queue is full", id);
+		if (info != m_triggerInfos.end())
+		{
+			m_scheduler.OnTriggerDropped(info->second.chord);
+			info->second.stats->CountFailure(LaunchStats::Failure::QueueFull);
+		}
+		else
+		{
+			m_unmatchedStats.CountFailure(LaunchStats::Failure::QueueFull);
+		}
 		if (m_bell)
 		{
 			SoundBellError();
 		}
-		return;
 	}
+}
 
-	std::filesystem::path exe{ hk->executable };
-
-	std::filesystem::path wd{ hk->workingDirectory };
-	if (!wd.empty() && !wd.is_absolute()) wd = std::filesystem::absolute(wd);
-
-	if (!exe.is_absolute())
+void HotKeyManager::OnLaunchItem(LaunchQueue::Item const& item)
+{
+	const auto startedAt = std::chrono::steady_clock::now();
+	Launch(item);
+	const auto finishedAt = std::chrono::steady_clock::now();
+
+	using std::chrono::duration_cast;
+	using std::chrono::milliseconds;
+	m_hotLog.Detail("HotKey(%u) handled: %u ms queued, %u ms launching",
+		item.id,
+		static_cast<unsigned int>(duration_cast<milliseconds>(startedAt - item.queuedAt).count()),
+		static_cast<unsigned int>(duration_cast<milliseconds>(finishedAt - startedAt).count()));
+
+	bool writeStats;
+	{
+		std::lock_guard<std::mutex> lock{ m_lock };
+		writeStats = !m_statsFile.empty() && GetTickCount64() - m_statsWrittenTick >= c_statsWriteIntervalMs;
+	}
+	if (writeStats)
 	{
-		if (hk->isRelExePath)
+		WriteStats();
+	}
+}
+
+void HotKeyManager::Launch(LaunchQueue::Item const& item)
+{
+	const uint32_t id = item.id;
+	auto phaseStart = std::chrono::steady_clock::now();
+	auto endPhase = [&phaseStart]()
 		{
-			std::filesystem::path e2 = TryResolve(m_configDir, exe);
-			if (e2.is_absolute() && std::filesystem::exists(e2) && std::filesystem::is_regular_file(e2)) exe = e2;
+			const auto now = std::chrono::steady_clock::now();
+			const auto duration = now - phaseStart;
+			phaseStart = now;
+			return duration;
+		};
+
+	// copies of what is launched, so the lock is not held while launching; `stats` stays empty if the hot key is not found
+	uint64_t chord = 0;
+	LaunchPolicy policy;
+	std::wstring action;
+	ActionRegistry::Binding actionBinding;
+	std::shared_ptr<LaunchPlan> plan;
+	std::shared_ptr<LaunchStats> stats;
+	bool bell;
+	// only set if the plan needs to be rebuilt
+	std::unique_ptr<HotKeyConfig> rebuildConfig;
+	std::filesystem::path configDir;
+	{
+		std::lock_guard<std::mutex> lock{ m_lock };
+		bell = m_bell;
 
-			if (!exe.is_absolute())
+		HotKey* hk = FindHotKey(id);
+		if (hk != nullptr && hk->GetChord() != item.chord)
+		{
+			// the id was released and registered again for another chord since the trigger was queued
+			m_hotLog.Detail("HotKey(%u) queued for another key chord", id);
+			hk = nullptr;
+		}
+		if (hk != nullptr && hk->m_byProfile)
+		{
+			HotKey* selected = FindProfileHotKey(*hk, item.processId);
+			if (selected == nullptr)
 			{
-				e2 = TryResolve(std::filesystem::current_path(), exe);
-				if (e2.is_absolute() && std::filesystem::exists(e2) && std::filesystem::is_regular_file(e2)) exe = e2;
+				m_hotLog.Detail("HotKey(%u) not used by the foreground application", id);
+				m_scheduler.OnTriggerDropped(hk->GetChord());
+				return;
 			}
+			hk = selected;
 		}
 
-		if (!exe.is_absolute())
+		if (hk != nullptr)
 		{
-			if (!hk->workingDirectory.empty())
+			chord = hk->GetChord();
+			policy = GetPolicy(*hk);
+			stats = hk->m_stats;
+			if (!hk->action.empty())
 			{
-				std::filesystem::path e2 = SearchExePath(wd.wstring().c_str(), exe);
-				if (!e2.empty() && e2.is_absolute()) exe = e2;
+				action = hk->action;
+				actionBinding = hk->m_actionBinding;
 			}
-			if (!exe.is_absolute())
+			else
 			{
-				std::filesystem::path e2 = SearchExePath(nullptr, exe);
-				if (!e2.empty() && e2.is_absolute()) exe = e2;
+				plan = hk->m_plan;
+				if (!plan->IsValid() || plan->IsStale())
+				{
+					rebuildConfig = std::make_unique<HotKeyConfig>(*hk);
+					configDir = m_configDir;
+				}
 			}
-			exe = std::filesystem::absolute(exe);
 		}
 	}
 
-	if (exe.empty())
+	if (!stats)
 	{
-		m_log.Error(L"HotKey(%u) executable %s not found", id, hk->executable.c_str());
-		if (m_bell)
+		m_hotLog.Error("HotKey(%u) not found", id);
+		m_unmatchedStats.CountFailure(LaunchStats::Failure::NotFound);
+		if (bell)
 		{
 			SoundBellError();
 		}
 		return;
 	}
 
-	if (!hk->noFileCheck)
+	stats->Record(LaunchStats::Phase::Queue, phaseStart - item.queuedAt);
+	stats->Record(LaunchStats::Phase::Lookup, endPhase());
+
+	switch (m_scheduler.BeginLaunch(chord, policy))
 	{
-		std::error_code ec;
-		if (!std::filesystem::is_regular_file(exe, ec))
-		{
-			if (ec)
-			{
-				m_log.Error(L"HotKey(%u) executable %s not accessible: %s", id, exe.wstring().c_str(), ToW(ec.message().c_str()).c_str());
-			}
-			else
-			{
-				m_log.Error(L"HotKey(%u) executable %s not found", id, hk->executable.c_str());
-			}
-			if (m_bell)
-			{
-				SoundBellError();
-			}
-			return;
-		}
+	case LaunchScheduler::Decision::Launch:
+		break;
+	case LaunchScheduler::Decision::Cooldown:
+		m_hotLog.Detail("HotKey(%u) suppressed, cooling down", id);
+		stats->CountFailure(LaunchStats::Failure::Cooldown);
+		return;
+	default:
+		m_hotLog.Write("HotKey(%u) suppressed, %u instances still running", id, static_cast<unsigned int>(m_scheduler.GetRunningCount(chord)));
+		stats->CountFailure(LaunchStats::Failure::ConcurrencyLimit);
+		return;
 	}
 
-	m_log.Write(L"Found HotKey(%u) executable %s", id, exe.wstring().c_str());
-
-	if (!wd.empty() && !std::filesystem::is_directory(wd))
+	if (!action.empty())
 	{
-		m_log.Write(L"HotKey(%u) working directory not found %s", id, wd.wstring().c_str());
-		wd.clear();
+		RunAction(id, action, actionBinding, bell, *stats, item.queuedAt);
+		return;
 	}
 
-	std::vector<wchar_t> arguments;
-	arguments.push_back(L' ');
-
-	for (size_t argi = 0; argi < hk->arguments.size(); ++argi)
+	if (rebuildConfig)
 	{
-		std::wstring as = hk->arguments[argi];
-
-		auto resArg = hk->resolveArgsPaths.find(static_cast<uint32_t>(argi));
-		if (resArg != hk->resolveArgsPaths.end())
-		{
-			std::filesystem::path exe{ as };
-
-			if (resArg->second.isRelPath)
-			{
-				if (!exe.is_absolute())
-				{
-					std::filesystem::path e2 = TryResolve(std::filesystem::current_path(), exe);
-					if (e2.is_absolute() && std::filesystem::exists(e2) && std::filesystem::is_regular_file(e2)) exe = e2;
-				}
-				if (!exe.is_absolute())
-				{
-					std::filesystem::path e2 = TryResolve(m_configDir, exe);
-					if (e2.is_absolute() && std::filesystem::exists(e2) && std::filesystem::is_regular_file(e2)) exe = e2;
-				}
-
-			}
-
-			if (exe.is_absolute())
-			{
-				as = exe;
-			}
-		}
-
-		bool needEsc = false;
-		size_t pos = 0;
-		while ((pos = as.find(L'"', pos)) != std::string::npos) {
-			as.replace(pos, 1, L"\\\"");
-			pos += 2; // Skip the newly added escape character
-			needEsc = true;
-		}
-
-		if (arguments.capacity() < arguments.size() + 3 + as.size())
+		// slow path: the executable might have appeared since the plan was built
+		auto rebuilt = std::make_shared<LaunchPlan>(*plan);
+		BuildLaunchPlan(*rebuildConfig, configDir, *rebuilt);
+		PublishLaunchPlan(plan, rebuilt);
+		plan = std::move(rebuilt);
+	}
+	stats->Record(LaunchStats::Phase::Resolve, endPhase());
+	if (!plan->IsValid())
+	{
+		m_hotLog.Error(L"HotKey(%u) %s", id, plan->GetError().c_str());
+		stats->CountFailure(LaunchStats::Failure::InvalidPlan);
+		if (bell)
 		{
-			arguments.reserve(arguments.size() + 3 + as.size());
+			SoundBellError();
 		}
-
-		if (needEsc) arguments.push_back(L'"');
-		for (wchar_t c : as) arguments.push_back(c);
-		if (needEsc) arguments.push_back(L'"');
-		arguments.push_back(L' ');
+		return;
 	}
-	arguments.push_back(0);
 
-	m_log.Write(L"HotKey(%u) args: %s", id, arguments.data());
+	// evaluates the placeholders of this trigger, so the log shows the arguments actually passed
+	wchar_t* cmdLine = plan->PrepareCommandLine(m_argumentSource, m_launchBuffers);
+	m_hotLog.Write(L"Found HotKey(%u) executable %s", id, plan->GetExecutable().c_str());
+	m_hotLog.Write(L"HotKey(%u) args: %s", id, cmdLine);
 
-	if (m_bell)
+	if (bell)
 	{
 		SoundBell();
 	}
+	stats->Record(LaunchStats::Phase::Bell, endPhase());
 
 	STARTUPINFO si = { sizeof(STARTUPINFO) };
 	PROCESS_INFORMATION pi;
 
-	DWORD creationFlags = CREATE_NEW_PROCESS_GROUP;
-	if (hk->createNoWindow)
-	{
-		creationFlags |= CREATE_NO_WINDOW;
-	}
-	else
-	{
-		creationFlags |= CREATE_NEW_CONSOLE;
-	}
-
 	if (CreateProcessW(
-		exe.wstring().c_str(),
-		arguments.data(),
+		plan->GetExecutable().c_str(),
+		cmdLine,
 		nullptr,
 		nullptr,
 		FALSE,
-		creationFlags,
+		plan->GetCreationFlags(),
 		nullptr,
-		wd.empty() ? nullptr : wd.wstring().c_str(),
+		plan->GetWorkingDirectory(),
 		&si,
 		&pi
 		))
 	{
-		CloseHandle(pi.hProcess);
 		CloseHandle(pi.hThread);
+		if (policy.maxConcurrent > 0)
+		{
+			m_scheduler.AddChild(chord, std::make_unique<ChildProcess>(pi.hProcess));
+		}
+		else
+		{
+			CloseHandle(pi.hProcess);
+		}
+		stats->Record(LaunchStats::Phase::CreateProcess, endPhase());
+		stats->Record(LaunchStats::Phase::Total, phaseStart - item.queuedAt);
 	}
 	else
 	{
-		m_log.Error(L"HotKey(%u) executable could not be started: %d", id, static_cast<int>(GetLastError()));
-		if (m_bell)
+		DWORD err = GetLastError();
+		m_hotLog.Error(L"HotKey(%u) executable could not be started: %d", id, static_cast<int>(err));
+		stats->CountFailure(LaunchStats::Failure::CreateProcessFailed);
+		if (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND || err == ERROR_DIRECTORY)
+		{
+			// resolved paths are outdated; plans are copied under the lock when rebuilt
+			std::lock_guard<std::mutex> lock{ m_lock };
+			plan->Invalidate();
+		}
+		if (bell)
 		{
 			SoundBellError();
 		}
@@ -355,19 +618,99 @@ void HotKeyManager::HotKeyTriggered(uint32_t id)
 
 }
 
-void HotKeyManager::SoundBell()
+void HotKeyManager::RunAction(uint32_t id, std::wstring const& action, ActionRegistry::Binding const& binding, bool bell, LaunchStats& stats, std::chrono::steady_clock::time_point queuedAt)
 {
-	if (!m_customBellFile.empty())
+	auto phaseStart = std::chrono::steady_clock::now();
+
+	if (!binding.IsValid())
 	{
-		if (std::filesystem::is_regular_file(m_customBellFile))
+		m_hotLog.Error(L"HotKey(%u) action %s cannot be run; see configuration warnings", id, action.c_str());
+		stats.CountFailure(LaunchStats::Failure::InvalidPlan);
+		if (bell)
 		{
-			PlaySoundW(m_customBellFile.wstring().c_str(), 0, SND_FILENAME | SND_ASYNC | SND_SYSTEM);
-			return;
+			SoundBellError();
 		}
-		else
+		return;
+	}
+
+	m_hotLog.Write(L"HotKey(%u) action %s", id, action.c_str());
+
+	if (bell)
+	{
+		SoundBell();
+	}
+	auto now = std::chrono::steady_clock::now();
+	stats.Record(LaunchStats::Phase::Bell, now - phaseStart);
+	phaseStart = now;
+
+	std::wstring error;
+	if (!m_actions.Invoke(binding, error))
+	{
+		m_hotLog.Error(L"HotKey(%u) action %s failed: %s", id, action.c_str(), error.c_str());
+		stats.CountFailure(LaunchStats::Failure::ActionFailed);
+		if (bell)
+		{
+			SoundBellError();
+		}
+		return;
+	}
+	now = std::chrono::steady_clock::now();
+	stats.Record(LaunchStats::Phase::Action, now - phaseStart);
+	stats.Record(LaunchStats::Phase::Total, now - queuedAt);
+}
+
+void HotKeyManager::SetStatsFile(std::filesystem::path const& path)
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	m_statsFile = path;
+}
+
+bool HotKeyManager::WriteStats()
+{
+	std::filesystem::path file;
+	std::wstring text;
+	{
+		std::lock_guard<std::mutex> lock{ m_lock };
+		if (m_statsFile.empty()) return false;
+		file = m_statsFile;
+		m_statsWrittenTick = GetTickCount64();
+
+		text = L"GlobalHotKeys launch statistics\n\n";
+		LaunchStats::Snapshot total;
+		for (auto const& hk : m_hotKeys)
 		{
-			m_log.Warning(L"Custom bell file is not a regular file: %s", m_customBellFile.wstring().c_str());
+			const LaunchStats::Snapshot stats = hk.m_stats->GetSnapshot();
+			total.Merge(stats);
+			text += L"Hot key " + hk.GetKeyWString() + (hk.profile.empty() ? L"" : (L" in " + hk.profile)) + L"  ->  " + (hk.action.empty() ? hk.executable : (L"action " + hk.action)) + L"\n";
+			stats.Format(text);
+			text += L"\n";
 		}
+		text += L"Unmatched triggers\n";
+		const LaunchStats::Snapshot unmatched = m_unmatchedStats.GetSnapshot();
+		total.Merge(unmatched);
+		unmatched.Format(text);
+		text += L"\nAll hot keys\n";
+		total.Format(text);
+	}
+
+	std::ofstream out{ file, std::ios::binary | std::ios::trunc };
+	if (!out)
+	{
+		m_log.Warning(L"Failed to write launch statistics: %s", file.wstring().c_str());
+		return false;
+	}
+	const std::string utf8 = ToUtf8(text);
+	out.write(utf8.data(), static_cast<std::streamsize>(utf8.size()));
+	return static_cast<bool>(out);
+}
+
+void HotKeyManager::SoundBell()
+{
+	std::lock_guard<std::mutex> lock{ m_bellLock };
+	if (!m_bellSound.IsEmpty())
+	{
+		PlaySoundW(reinterpret_cast<LPCWSTR>(m_bellSound.GetImage().data()), NULL, SND_MEMORY | SND_ASYNC | SND_SYSTEM);
+		return;
 	}
 	MessageBeep(MB_ICONINFORMATION);
 }
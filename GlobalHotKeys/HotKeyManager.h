@@ -1,48 +1,178 @@
 #pragma once
+#include "ActionRegistry.h"
+#include "ArgumentSource.h"
+#include "AsyncLog.h"
 #include "HotKeyConfig.h"
+#include "HotKeyRegistrations.h"
+#include "LaunchPlan.h"
+#include "LaunchQueue.h"
+#include "LaunchScheduler.h"
+#include "LaunchStats.h"
+#include "PathProbe.h"
+#include "ProcessImageCache.h"
+#include "ProcessInfo.h"
+#include "ProfileResolver.h"
+#include "WaveSound.h"
 
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace sgrottel {
 	class ISimpleLog;
 }
 class MainWindow;
+class IHotKeyRegistrar;
 
 class HotKeyManager
 {
 public:
 	HotKeyManager(sgrottel::ISimpleLog& log, MainWindow& wnd);
+	HotKeyManager(sgrottel::ISimpleLog& log, std::unique_ptr<IHotKeyRegistrar> registrar);
 	~HotKeyManager();
 
-	void SetHotKeys(std::vector<HotKeyConfig> const& hotKeys, std::filesystem::path const& configDir);
-	inline void SetBell(bool bell, std::filesystem::path const& customFile)
-	{
-		m_bell = bell;
-		m_customBellFile = customFile;
-	}
+	/// <summary>
+	/// Updates the hot keys incrementally.
+	/// Hot keys with unchanged key chords keep their registration; only added and removed chords are (un)registered.
+	/// Each chord is registered once; hot keys of profiles sharing a chord are selected by the foreground application when triggered.
+	/// </summary>
+	void SetHotKeys(std::vector<HotKeyConfig> const& hotKeys, std::vector<HotKeyProfile> const& profiles, std::filesystem::path const& configDir);
+	/// <summary>
+	/// Sets the bell; a custom bell file is loaded and validated once, here
+	/// </summary>
+	void SetBell(bool bell, std::filesystem::path const& customFile, float volume = 1.0f);
 
 	bool CanEnableAllHotKeys();
 	bool CanDisableAllHotKeys();
 	void EnableAllHotKeys();
 	void DisableAllHotKeys();
 
-	void HotKeyTriggered(uint32_t id);
+	/// <summary>
+	/// Rebuilds all launch plans, e.g. after the environment variables changed;
+	/// this also evaluates `${env:...}` placeholders again
+	/// </summary>
+	void InvalidateLaunchPlans();
+
+	/// <summary>
+	/// The in-process actions hot keys can run; register actions before setting the hot keys
+	/// </summary>
+	inline ActionRegistry& GetActions() noexcept
+	{
+		return m_actions;
+	}
+
+	/// <summary>
+	/// Sets the file the launch statistics are periodically written to; empty disables writing
+	/// </summary>
+	void SetStatsFile(std::filesystem::path const& path);
+
+	/// <summary>
+	/// Writes the launch statistics of all hot keys to the stats file
+	/// </summary>
+	bool WriteStats();
+
+	/// <summary>
+	/// Queues the hot key for launching on the worker thread; does not block.
+	/// `modifiers` and `virtualKeyCode` are of the `WM_HOTKEY` message; triggers of an id since reused by another chord are dropped.
+	/// </summary>
+	void HotKeyTriggered(uint32_t id, uint32_t modifiers, uint32_t virtualKeyCode);
+
+	/// <summary>
+	/// Writes all queued messages of the hot path log; e.g. before exiting
+	/// </summary>
+	bool FlushLog();
+
+	/// <summary>
+	/// Writes the queued messages of the hot path log on the calling thread, without locking or waiting;
+	/// for the unhandled exception filter. Returns false if the log's worker is writing right now.
+	/// </summary>
+	bool DrainLogOnCrash() noexcept;
 
 private:
 	struct HotKey : public HotKeyConfig
 	{
+		// the first hot key of each chord holds its registration
+		bool m_registers;
+		// the hot key of this chord is selected by the foreground application
+		bool m_byProfile;
+		uint32_t m_profileId;
 		uint32_t m_activeId;
+		// replaced by a rebuilt copy instead of being rebuilt in place, as the launch worker uses it without the lock
+		std::shared_ptr<LaunchPlan> m_plan;
+		ActionRegistry::Binding m_actionBinding;
+		std::shared_ptr<LaunchStats> m_stats;
 	};
 
+	struct TriggerInfo
+	{
+		uint64_t chord;
+		bool byProfile;
+		LaunchPolicy policy;
+		std::shared_ptr<LaunchStats> stats;
+	};
+
+	// range of ids valid for `RegisterHotKey`
+	static constexpr const uint32_t c_firstId = 42;
+	static constexpr const uint32_t c_lastId = 0xBFFF;
+	static constexpr const size_t c_noHotKey = SIZE_MAX;
+
+	static constexpr const uint64_t c_statsWriteIntervalMs = 10 * 60 * 1000;
+
+	void BuildLaunchPlan(HotKey& hk);
+	void BuildLaunchPlan(HotKeyConfig const& config, std::filesystem::path const& configDir, LaunchPlan& plan);
+	void PublishLaunchPlan(std::shared_ptr<LaunchPlan> const& oldPlan, std::shared_ptr<LaunchPlan> const& newPlan);
+	void UpdateIdTables();
+	HotKey* FindHotKey(uint32_t id);
+	HotKey* FindProfileHotKey(HotKey const& hk, uint32_t processId);
+
+	void OnLaunchItem(LaunchQueue::Item const& item);
+	void Launch(LaunchQueue::Item const& item);
+	void RunAction(uint32_t id, std::wstring const& action, ActionRegistry::Binding const& binding, bool bell, LaunchStats& stats, std::chrono::steady_clock::time_point queuedAt);
+
+	void LoadBellSound(std::filesystem::path const& file, float volume, WaveSound& outSound);
 	void SoundBell();
 	void SoundBellError();
 
-	MainWindow& m_wnd;
 	sgrottel::ISimpleLog& m_log;
+	// used for messages when hot keys are triggered, to not block on writing the log file
+	AsyncLog m_hotLog;
+	HotKeyRegistrations m_registrations;
+	ActionRegistry m_actions;
 	std::vector<HotKey> m_hotKeys{};
+	// index into `m_hotKeys` by `m_activeId - c_firstId`
+	std::vector<size_t> m_dispatch{};
+	// index into `m_hotKeys` by chord and profile id, of chords used by profiles
+	std::unordered_map<uint64_t, size_t> m_profileDispatch{};
+	ProfileResolver m_profiles;
+	ProcessInfo m_processInfo;
+	// only used on the launch worker thread
+	ProcessImageCache m_processImages{ m_processInfo };
 	std::filesystem::path m_configDir{};
+	ArgumentSource m_argumentSource;
+	PathProbe m_pathProbe;
+	// only used on the launch worker thread
+	LaunchPlan::Buffers m_launchBuffers{};
 	bool m_bell{false};
-	std::filesystem::path m_customBellFile{};
+	std::filesystem::path m_statsFile{};
+	uint64_t m_statsWrittenTick{ 0 };
+
+	// stats of triggers not matching any hot key
+	LaunchStats m_unmatchedStats;
+
+	// active ids to policies and stats, only used on the UI thread
+	std::unordered_map<uint32_t, TriggerInfo> m_triggerInfos;
+	LaunchScheduler m_scheduler;
+
+	// guards all of the above against the launch worker thread;
+	// the worker only holds it to look up and copy what it launches, and not while launching
+	std::mutex m_lock;
+
+	// custom bell sound played from memory; empty to use the system sound
+	WaveSound m_bellSound{};
+	// guards the bell sound, so its memory is not released while starting to play it, without waiting for `m_lock`
+	std::mutex m_bellLock;
+	LaunchQueue m_launchQueue;
 };
 
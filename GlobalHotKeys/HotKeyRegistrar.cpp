@@ -0,0 +1,31 @@
+#include "pch.h"
+#include "HotKeyRegistrar.h"
+
+#include "MainWindow.h"
+
+HotKeyRegistrar::HotKeyRegistrar(MainWindow const& wnd)
+	: m_wnd{ wnd }, m_lastError{ 0 }
+{
+	// intentionally empty
+}
+
+bool HotKeyRegistrar::Register(uint32_t id, uint32_t modifiers, uint32_t virtualKeyCode)
+{
+	BOOL res = RegisterHotKey(m_wnd.GetHandle(), static_cast<int>(id), static_cast<UINT>(modifiers), static_cast<UINT>(virtualKeyCode));
+	if (res == 0)
+	{
+		m_lastError = static_cast<int>(GetLastError());
+		return false;
+	}
+	return true;
+}
+
+void HotKeyRegistrar::Unregister(uint32_t id)
+{
+	UnregisterHotKey(m_wnd.GetHandle(), static_cast<int>(id));
+}
+
+int HotKeyRegistrar::GetLastErrorCode() const
+{
+	return m_lastError;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+class MainWindow;
+
+/// <summary>
+/// Registration of hot keys with the operating system
+/// </summary>
+class IHotKeyRegistrar
+{
+public:
+	// modifiers, values of `MOD_ALT`, `MOD_CONTROL`, and `MOD_SHIFT`
+	static constexpr const uint32_t c_modAlt = 0x0001;
+	static constexpr const uint32_t c_modControl = 0x0002;
+	static constexpr const uint32_t c_modShift = 0x0004;
+
+	virtual ~IHotKeyRegistrar() = default;
+
+	/// <summary>
+	/// Registers the key chord under the given id.
+	/// Returns false and logs nothing on failure; use `GetLastErrorCode` for details.
+	/// </summary>
+	virtual bool Register(uint32_t id, uint32_t modifiers, uint32_t virtualKeyCode) = 0;
+
+	virtual void Unregister(uint32_t id) = 0;
+
+	virtual int GetLastErrorCode() const = 0;
+};
+
+/// <summary>
+/// Registers the hot keys for the message window using `RegisterHotKey`
+/// </summary>
+class HotKeyRegistrar : public IHotKeyRegistrar
+{
+public:
+	HotKeyRegistrar(MainWindow const& wnd);
+
+	bool Register(uint32_t id, uint32_t modifiers, uint32_t virtualKeyCode) override;
+	void Unregister(uint32_t id) override;
+	int GetLastErrorCode() const override;
+
+private:
+	MainWindow const& m_wnd;
+	int m_lastError;
+};
@@ -0,0 +1,145 @@
+#include "pch.h"
+#include "HotKeyRegistrations.h"
+
+#include "HotKeyConfig.h"
+#include "HotKeyRegistrar.h"
+
+#include "SimpleLog/SimpleLog.hpp"
+
+#include <string>
+
+namespace
+{
+	HotKeyConfig FromChord(uint64_t chord)
+	{
+		HotKeyConfig hk;
+		hk.virtualKeyCode = static_cast<uint32_t>(chord & 0xffffffffu);
+		hk.modAlt = (chord & (1ull << 32)) != 0;
+		hk.modCtrl = (chord & (1ull << 33)) != 0;
+		hk.modShift = (chord & (1ull << 34)) != 0;
+		return hk;
+	}
+}
+
+HotKeyRegistrations::HotKeyRegistrations(sgrottel::ISimpleLog& log, std::unique_ptr<IHotKeyRegistrar> registrar, uint32_t firstId, uint32_t lastId)
+	: m_log{ log }, m_registrar{ std::move(registrar) }, m_ids{ firstId, lastId }
+{
+	// intentionally empty
+}
+
+HotKeyRegistrations::~HotKeyRegistrations()
+{
+	UnregisterAll();
+}
+
+HotKeyRegistrations::Changes HotKeyRegistrations::Update(std::vector<uint64_t> const& chords, bool registerAdded)
+{
+	Changes changes;
+
+	std::vector<Entry> entries;
+	entries.reserve(chords.size());
+	std::unordered_map<uint64_t, size_t> byChord;
+	byChord.reserve(chords.size());
+	for (uint64_t chord : chords)
+	{
+		if (!byChord.insert(std::make_pair(chord, entries.size())).second) continue;
+
+		auto old = m_byChord.find(chord);
+		const uint32_t id = (old != m_byChord.end()) ? m_entries[old->second].id : 0;
+		if (id != 0) changes.kept++;
+		entries.push_back({ chord, id });
+	}
+
+	// unregister first, so the ids are free again for the added chords
+	for (Entry& old : m_entries)
+	{
+		if (old.id == 0 || byChord.count(old.chord) > 0) continue;
+		changes.removed.push_back(std::make_pair(old.chord, old.id));
+		Unregister(old);
+	}
+
+	m_entries = std::move(entries);
+	m_byChord = std::move(byChord);
+
+	if (registerAdded)
+	{
+		RegisterAll();
+	}
+	return changes;
+}
+
+void HotKeyRegistrations::RegisterAll()
+{
+	for (Entry& entry : m_entries)
+	{
+		if (entry.id == 0 && !Register(entry)) break;
+	}
+}
+
+void HotKeyRegistrations::UnregisterAll()
+{
+	for (Entry& entry : m_entries)
+	{
+		if (entry.id != 0) Unregister(entry);
+	}
+}
+
+uint32_t HotKeyRegistrations::GetId(uint64_t chord) const
+{
+	auto it = m_byChord.find(chord);
+	return (it != m_byChord.end()) ? m_entries[it->second].id : 0;
+}
+
+bool HotKeyRegistrations::HasRegistered() const
+{
+	for (Entry const& entry : m_entries)
+	{
+		if (entry.id != 0) return true;
+	}
+	return false;
+}
+
+bool HotKeyRegistrations::HasUnregistered() const
+{
+	for (Entry const& entry : m_entries)
+	{
+		if (entry.id == 0) return true;
+	}
+	return false;
+}
+
+bool HotKeyRegistrations::Register(Entry& entry)
+{
+	const uint32_t id = m_ids.Allocate();
+	if (id == HotKeyIdAllocator::c_invalidId)
+	{
+		m_log.Error("RegisterHotKey id limit hit. Abort.");
+		return false;
+	}
+
+	const HotKeyConfig hk = FromChord(entry.chord);
+	m_log.Write(L"RegisterHotKey(..., %u, %s)", id, hk.GetKeyWString().c_str());
+
+	uint32_t mods = 0;
+	if (hk.modAlt) mods |= IHotKeyRegistrar::c_modAlt;
+	if (hk.modCtrl) mods |= IHotKeyRegistrar::c_modControl;
+	if (hk.modShift) mods |= IHotKeyRegistrar::c_modShift;
+	if (!m_registrar->Register(id, mods, hk.virtualKeyCode))
+	{
+		m_log.Error(L"RegisterHotKey failed: %d", m_registrar->GetLastErrorCode());
+		m_ids.Release(id);
+	}
+	else
+	{
+		entry.id = id;
+	}
+	return true;
+}
+
+void HotKeyRegistrations::Unregister(Entry& entry)
+{
+	m_log.Write("UnregisterHotKey(..., %u)", entry.id);
+	m_registrar->Unregister(entry.id);
+	m_ids.Release(entry.id);
+	entry.id = 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "HotKeyIdAllocator.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sgrottel {
+	class ISimpleLog;
+}
+class IHotKeyRegistrar;
+
+/// <summary>
+/// The key chords registered with the operating system, each under its own id.
+/// Updates are incremental: chords which stay listed keep their registration and id.
+/// Has no platform dependencies.
+/// </summary>
+class HotKeyRegistrations
+{
+public:
+	struct Changes
+	{
+		// registered chords which are still listed
+		size_t kept{ 0 };
+		// chords which were unregistered as they are not listed anymore, with their former id
+		std::vector<std::pair<uint64_t, uint32_t>> removed{};
+	};
+
+	HotKeyRegistrations(sgrottel::ISimpleLog& log, std::unique_ptr<IHotKeyRegistrar> registrar, uint32_t firstId, uint32_t lastId);
+	~HotKeyRegistrations();
+
+	/// <summary>
+	/// Sets the listed chords, see `HotKeyConfig::GetChord`; duplicates are ignored.
+	/// Chords not listed anymore are unregistered.
+	/// Listed chords without registration are registered if `registerAdded`, i.e. unless the user disabled all hot keys.
+	/// </summary>
+	Changes Update(std::vector<uint64_t> const& chords, bool registerAdded);
+
+	/// <summary>
+	/// Registers all listed chords which are not registered yet
+	/// </summary>
+	void RegisterAll();
+
+	/// <summary>
+	/// Unregisters all chords; they stay listed
+	/// </summary>
+	void UnregisterAll();
+
+	/// <summary>
+	/// Returns the id the chord is registered under, or zero
+	/// </summary>
+	uint32_t GetId(uint64_t chord) const;
+
+	bool HasRegistered() const;
+	bool HasUnregistered() const;
+
+	inline bool IsEmpty() const noexcept
+	{
+		return m_entries.empty();
+	}
+
+private:
+	struct Entry
+	{
+		uint64_t chord;
+		// zero if not registered
+		uint32_t id;
+	};
+
+	// returns false if no id is left, and further registrations are pointless
+	bool Register(Entry& entry);
+	void Unregister(Entry& entry);
+
+	sgrottel::ISimpleLog& m_log;
+	std::unique_ptr<IHotKeyRegistrar> m_registrar;
+	HotKeyIdAllocator m_ids;
+	// in the order listed
+	std::vector<Entry> m_entries{};
+	// index into `m_entries` by chord
+	std::unordered_map<uint64_t, size_t> m_byChord{};
+};
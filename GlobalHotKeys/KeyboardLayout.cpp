@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "KeyboardLayout.h"
+
+#include "VirtualKeyNames.h"
+
+#include <mutex>
+
+#include "Winuser.h"
+
+namespace
+{
+	std::shared_ptr<const KeyboardLayout> BuildKeyboardLayout()
+	{
+		auto map = std::make_shared<KeyboardLayout>();
+		for (uint32_t vk = 0; vk < 256; ++vk)
+		{
+			const UINT charCode = MapVirtualKeyW(vk, MAPVK_VK_TO_CHAR);
+			if (charCode == vk) map->identity.set(vk);
+			if (charCode != 0 && MapVirtualKeyW(vk, MAPVK_VK_TO_VSC) != 0)
+			{
+				map->charByCode[vk] = static_cast<wchar_t>(charCode);
+			}
+		}
+		for (size_t i = 0; i < VirtualKeyNames::GetCount(); ++i)
+		{
+			VirtualKeyNames::Entry const& e = VirtualKeyNames::GetEntry(i);
+			if (!e.IsOem()) continue;
+			const wchar_t c = static_cast<wchar_t>(MapVirtualKeyW(e.code, MAPVK_VK_TO_CHAR));
+			if (c == 0) continue;
+			// first listed key wins
+			map->oemByChar.insert(std::make_pair(c, e.code));
+		}
+		return map;
+	}
+}
+
+std::shared_ptr<const KeyboardLayout> KeyboardLayout::GetCurrent()
+{
+	static std::mutex lock;
+	static std::unordered_map<HKL, std::shared_ptr<const KeyboardLayout>> maps;
+
+	const HKL layout = GetKeyboardLayout(0);
+	std::lock_guard<std::mutex> guard{ lock };
+	auto& map = maps[layout];
+	if (!map)
+	{
+		map = BuildKeyboardLayout();
+	}
+	return map;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+/// <summary>
+/// Characters of the virtual keys of one keyboard layout
+/// </summary>
+struct KeyboardLayout
+{
+	// virtual keys whose character equals their code, e.g. letters and digits
+	std::bitset<256> identity;
+	// OEM virtual keys by their character
+	std::unordered_map<wchar_t, uint32_t> oemByChar;
+	// character of each virtual key with a scan code, or zero
+	std::array<wchar_t, 256> charByCode{};
+
+	/// <summary>
+	/// Returns the character map of the keyboard layout active for the calling thread.
+	/// The map is built once per layout.
+	/// </summary>
+	static std::shared_ptr<const KeyboardLayout> GetCurrent();
+};
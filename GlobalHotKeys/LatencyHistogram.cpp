@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "LatencyHistogram.h"
+
+namespace
+{
+	uint32_t HighestBit(uint64_t v) noexcept
+	{
+		uint32_t bit = 0;
+		if (v >= (1ull << 32)) { v >>= 32; bit += 32; }
+		if (v >= (1ull << 16)) { v >>= 16; bit += 16; }
+		if (v >= (1ull << 8)) { v >>= 8; bit += 8; }
+		if (v >= (1ull << 4)) { v >>= 4; bit += 4; }
+		if (v >= (1ull << 2)) { v >>= 2; bit += 2; }
+		if (v >= (1ull << 1)) { bit += 1; }
+		return bit;
+	}
+}
+
+uint32_t LatencyHistogram::BucketIndex(uint64_t value) noexcept
+{
+	if (value < c_subBucketCount)
+	{
+		return static_cast<uint32_t>(value);
+	}
+	const uint32_t magnitude = HighestBit(value);
+	const uint32_t shift = magnitude - c_subBucketBits;
+	const uint32_t sub = static_cast<uint32_t>(value >> shift) - c_subBucketCount;
+	return (shift + 1) * c_subBucketCount + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(uint32_t index) noexcept
+{
+	if (index < c_subBucketCount)
+	{
+		return index;
+	}
+	const uint32_t shift = index / c_subBucketCount - 1;
+	const uint64_t sub = index % c_subBucketCount;
+	const uint64_t lower = (c_subBucketCount + sub) << shift;
+	return lower + ((1ull << shift) - 1);
+}
+
+void LatencyHistogram::Record(uint64_t valueUs) noexcept
+{
+	m_buckets[BucketIndex(valueUs)].fetch_add(1, std::memory_order_relaxed);
+	m_sum.fetch_add(valueUs, std::memory_order_relaxed);
+
+	uint64_t cur = m_min.load(std::memory_order_relaxed);
+	while (valueUs < cur && !m_min.compare_exchange_weak(cur, valueUs, std::memory_order_relaxed)) {}
+	cur = m_max.load(std::memory_order_relaxed);
+	while (valueUs > cur && !m_max.compare_exchange_weak(cur, valueUs, std::memory_order_relaxed)) {}
+
+	// published last, so readers seeing the count also see the bucket
+	m_count.fetch_add(1, std::memory_order_release);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const noexcept
+{
+	Snapshot s;
+	s.count = m_count.load(std::memory_order_acquire);
+	s.sum = m_sum.load(std::memory_order_relaxed);
+	s.min = m_min.load(std::memory_order_relaxed);
+	s.max = m_max.load(std::memory_order_relaxed);
+	if (s.count == 0) s.min = 0;
+	for (uint32_t i = 0; i < c_bucketCount; ++i)
+	{
+		s.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+	}
+	return s;
+}
+
+void LatencyHistogram::Reset() noexcept
+{
+	for (auto& b : m_buckets)
+	{
+		b.store(0, std::memory_order_relaxed);
+	}
+	m_sum.store(0, std::memory_order_relaxed);
+	m_min.store(UINT64_MAX, std::memory_order_relaxed);
+	m_max.store(0, std::memory_order_relaxed);
+	m_count.store(0, std::memory_order_release);
+}
+
+void LatencyHistogram::Snapshot::Merge(Snapshot const& other) noexcept
+{
+	if (other.count == 0) return;
+	// the min of an empty snapshot is zero, not a recorded value
+	min = (count == 0 || other.min < min) ? other.min : min;
+	max = (other.max > max) ? other.max : max;
+	count += other.count;
+	sum += other.sum;
+	for (uint32_t i = 0; i < c_bucketCount; ++i)
+	{
+		buckets[i] += other.buckets[i];
+	}
+}
+
+uint64_t LatencyHistogram::Snapshot::ValueAtPercentile(double percentile) const noexcept
+{
+	uint64_t total = 0;
+	for (uint64_t b : buckets) total += b;
+	if (total == 0) return 0;
+
+	if (percentile < 0.0) percentile = 0.0;
+	if (percentile > 100.0) percentile = 100.0;
+	uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+	if (rank < 1) rank = 1;
+
+	uint64_t seen = 0;
+	for (uint32_t i = 0; i < c_bucketCount; ++i)
+	{
+		seen += buckets[i];
+		if (seen >= rank)
+		{
+			const uint64_t v = BucketUpperBound(i);
+			return v < max ? v : max;
+		}
+	}
+	return max;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/// <summary>
+/// Lock-free log-linear histogram of latencies in microseconds, in the style of HDR histograms.
+/// Each power-of-two range is split into `c_subBucketCount` linear buckets,
+/// bounding the relative error of reported values to 1/`c_subBucketCount`.
+/// Recording is wait-free apart from min/max updates and may happen concurrently from any thread.
+/// Has no platform dependencies.
+/// </summary>
+class LatencyHistogram
+{
+public:
+	static constexpr const uint32_t c_subBucketBits = 3;
+	static constexpr const uint32_t c_subBucketCount = 1u << c_subBucketBits;
+	static constexpr const uint32_t c_bucketCount = (64 - c_subBucketBits + 1) * c_subBucketCount;
+
+	struct Snapshot
+	{
+		uint64_t count{ 0 };
+		uint64_t sum{ 0 };
+		uint64_t min{ 0 };
+		uint64_t max{ 0 };
+		std::array<uint64_t, c_bucketCount> buckets{};
+
+		/// <summary>
+		/// Upper bound of the bucket holding the given percentile [0..100], clamped to `max`
+		/// </summary>
+		uint64_t ValueAtPercentile(double percentile) const noexcept;
+
+		inline double Mean() const noexcept
+		{
+			return count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+		}
+
+		/// <summary>
+		/// Adds the values of `other`, as if they had been recorded into this histogram
+		/// </summary>
+		void Merge(Snapshot const& other) noexcept;
+	};
+
+	void Record(uint64_t valueUs) noexcept;
+
+	Snapshot GetSnapshot() const noexcept;
+
+	void Reset() noexcept;
+
+	static uint32_t BucketIndex(uint64_t value) noexcept;
+	static uint64_t BucketUpperBound(uint32_t index) noexcept;
+
+private:
+	std::array<std::atomic<uint64_t>, c_bucketCount> m_buckets{};
+	std::atomic<uint64_t> m_count{ 0 };
+	std::atomic<uint64_t> m_sum{ 0 };
+	std::atomic<uint64_t> m_min{ UINT64_MAX };
+	std::atomic<uint64_t> m_max{ 0 };
+};
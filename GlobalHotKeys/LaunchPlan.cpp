@@ -0,0 +1,238 @@
+#include "pch.h"
+#include "LaunchPlan.h"
+
+#include "CommandLine.h"
+#include "HotKeyConfig.h"
+#include "StringUtils.h"
+
+#include <stdexcept>
+
+namespace
+{
+	std::filesystem::path TryResolve(std::filesystem::path const& base, std::filesystem::path const& rel)
+	{
+		if (!base.is_absolute()) throw std::invalid_argument("`base` must be absolute");
+		if (!std::filesystem::exists(base)) throw std::invalid_argument("`base` must exist");
+		if (!std::filesystem::is_directory(base)) throw std::invalid_argument("`base` must be a directory");
+
+		std::filesystem::path p = base / rel;
+
+		if (!std::filesystem::exists(p))
+		{
+			return rel;
+		}
+
+		return std::filesystem::canonical(p);
+	}
+
+	bool IsExistingFile(std::filesystem::path const& p)
+	{
+		return p.is_absolute() && std::filesystem::exists(p) && std::filesystem::is_regular_file(p);
+	}
+
+	std::filesystem::path ResolveExecutable(HotKeyConfig const& config, std::filesystem::path const& configDir, std::filesystem::path const& wd, IExecutableSearch& search)
+	{
+		std::filesystem::path exe{ config.executable };
+		if (exe.is_absolute()) return exe;
+
+		if (config.isRelExePath)
+		{
+			std::filesystem::path e2 = TryResolve(configDir, exe);
+			if (IsExistingFile(e2)) return e2;
+
+			e2 = TryResolve(std::filesystem::current_path(), exe);
+			if (IsExistingFile(e2)) return e2;
+		}
+
+		if (!config.workingDirectory.empty())
+		{
+			std::filesystem::path e2 = search.Search(wd.wstring().c_str(), exe);
+			if (!e2.empty() && e2.is_absolute()) return e2;
+		}
+		std::filesystem::path e2 = search.Search(nullptr, exe);
+		if (!e2.empty() && e2.is_absolute()) return e2;
+
+		return std::filesystem::absolute(exe);
+	}
+
+	std::wstring ResolveArgument(std::wstring const& arg, HotKeyConfig::ResolveArgConfig const& resolve, std::filesystem::path const& configDir)
+	{
+		std::filesystem::path p{ arg };
+
+		if (resolve.isRelPath)
+		{
+			if (!p.is_absolute())
+			{
+				std::filesystem::path e2 = TryResolve(std::filesystem::current_path(), p);
+				if (IsExistingFile(e2)) p = e2;
+			}
+			if (!p.is_absolute())
+			{
+				std::filesystem::path e2 = TryResolve(configDir, p);
+				if (IsExistingFile(e2)) p = e2;
+			}
+		}
+
+		return p.is_absolute() ? p.wstring() : arg;
+	}
+}
+
+void LaunchPlan::Compile(HotKeyConfig const& config)
+{
+	m_templates.clear();
+	m_templateError.clear();
+	m_templates.resize(config.arguments.size());
+	for (size_t i = 0; i < config.arguments.size(); ++i)
+	{
+		std::wstring error;
+		// placeholders kept as text are reported by `ConfigValidator` when loading
+		std::wstring warning;
+		if (!m_templates[i].Compile(config.arguments[i], error, warning) && m_templateError.empty())
+		{
+			m_templateError = L"argument " + std::to_wstring(i) + L" " + error;
+		}
+	}
+}
+
+void LaunchPlan::Build(HotKeyConfig const& config, std::filesystem::path const& configDir, IArgumentSource& source, IExecutableSearch& search)
+{
+	m_valid = false;
+	m_stale = false;
+	m_error.clear();
+	m_warning.clear();
+	m_executable.clear();
+	m_workingDirectory.clear();
+	m_commandLine.clear();
+	m_dynamicArguments.clear();
+	m_argumentValues.clear();
+
+	if (m_templates.size() != config.arguments.size())
+	{
+		Compile(config);
+	}
+	if (!m_templateError.empty())
+	{
+		m_error = m_templateError;
+		return;
+	}
+
+	m_creationFlags = c_createNewProcessGroup;
+	if (config.createNoWindow)
+	{
+		m_creationFlags |= c_createNoWindow;
+	}
+	else
+	{
+		m_creationFlags |= c_createNewConsole;
+	}
+
+	try
+	{
+		std::filesystem::path wd{ config.workingDirectory };
+		if (!wd.empty() && !wd.is_absolute()) wd = std::filesystem::absolute(wd);
+
+		std::filesystem::path exe = ResolveExecutable(config, configDir, wd, search);
+		if (exe.empty())
+		{
+			m_error = L"executable " + config.executable + L" not found";
+			return;
+		}
+
+		if (!config.noFileCheck)
+		{
+			std::error_code ec;
+			if (!std::filesystem::is_regular_file(exe, ec))
+			{
+				if (ec)
+				{
+					m_error = L"executable " + exe.wstring() + L" not accessible: " + ToW(ec.message().c_str());
+				}
+				else
+				{
+					m_error = L"executable " + config.executable + L" not found";
+				}
+				return;
+			}
+		}
+
+		if (!wd.empty() && !std::filesystem::is_directory(wd))
+		{
+			m_warning = L"working directory not found " + wd.wstring();
+			wd.clear();
+		}
+
+		std::vector<ArgumentTemplate> folded;
+		folded.reserve(m_templates.size());
+		bool isDynamic = false;
+		for (ArgumentTemplate const& arg : m_templates)
+		{
+			folded.push_back(arg.Fold(source, configDir));
+			isDynamic = isDynamic || !folded.back().IsConstant();
+		}
+
+		std::vector<std::wstring> args;
+		args.reserve(folded.size());
+		for (size_t argi = 0; argi < folded.size(); ++argi)
+		{
+			if (!folded[argi].IsConstant())
+			{
+				if (config.resolveArgsPaths.find(static_cast<uint32_t>(argi)) != config.resolveArgsPaths.end())
+				{
+					m_warning = L"argument " + std::to_wstring(argi) + L" path not resolved, as it has placeholders evaluated when launching";
+				}
+				args.push_back(folded[argi].ToString());
+				continue;
+			}
+			auto resArg = config.resolveArgsPaths.find(static_cast<uint32_t>(argi));
+			args.push_back(
+				(resArg != config.resolveArgsPaths.end())
+					? ResolveArgument(folded[argi].GetLiteral(), resArg->second, configDir)
+					: folded[argi].GetLiteral());
+		}
+		CommandLine::Build(args, m_commandLine);
+		if (isDynamic)
+		{
+			// constant arguments keep their resolved values; only the dynamic ones are evaluated when launching
+			for (size_t argi = 0; argi < folded.size(); ++argi)
+			{
+				if (!folded[argi].IsConstant())
+				{
+					m_dynamicArguments.push_back(std::make_pair(argi, std::move(folded[argi])));
+				}
+			}
+			m_argumentValues = std::move(args);
+		}
+
+		m_executable = exe.wstring();
+		m_workingDirectory = wd.wstring();
+		m_valid = true;
+	}
+	catch (std::exception const& ex)
+	{
+		m_error = L"launch plan failed: " + ToW(ex.what());
+	}
+}
+
+wchar_t* LaunchPlan::PrepareCommandLine(IArgumentSource& source, Buffers& buffers) const
+{
+	if (m_dynamicArguments.empty())
+	{
+		buffers.commandLine.assign(m_commandLine.begin(), m_commandLine.end());
+		return buffers.commandLine.data();
+	}
+
+	// assigning keeps the capacity of the buffers of previous launches
+	buffers.argumentValues.resize(m_argumentValues.size());
+	for (size_t i = 0; i < m_argumentValues.size(); ++i)
+	{
+		buffers.argumentValues[i].assign(m_argumentValues[i]);
+	}
+	for (auto const& arg : m_dynamicArguments)
+	{
+		std::wstring& value = buffers.argumentValues[arg.first];
+		value.clear();
+		arg.second.Evaluate(source, {}, value);
+	}
+	CommandLine::Build(buffers.argumentValues, buffers.commandLine);
+	return buffers.commandLine.data();
+}
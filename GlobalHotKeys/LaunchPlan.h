@@ -0,0 +1,149 @@
+#pragma once
+
+#include "ArgumentTemplate.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct HotKeyConfig;
+
+/// <summary>
+/// Searches executables given without an absolute path, like `SearchPathW`
+/// </summary>
+class IExecutableSearch
+{
+public:
+	virtual ~IExecutableSearch() = default;
+
+	/// <summary>
+	/// The absolute path of `exe` found in `dir`, or in the default search directories if `dir` is nullptr; empty if not found
+	/// </summary>
+	virtual std::filesystem::path Search(wchar_t const* dir, std::filesystem::path const& exe) = 0;
+};
+
+/// <summary>
+/// A hot key configuration compiled for launching:
+/// resolved absolute executable, resolved working directory, and ready-to-use command line.
+/// Building resolves all paths and placeholders of the configuration and the environment once,
+/// so launching does not touch the file system.
+/// Only `${date}` and `${clipboard}` placeholders are evaluated when launching.
+/// A built plan is only read when launching, so it can be used without a lock while a rebuilt copy replaces it.
+/// A plan is only rebuilt after `Invalidate`, or while it is invalid, as launching would fail anyway.
+/// Has no platform dependencies.
+/// </summary>
+class LaunchPlan
+{
+public:
+	/// <summary>
+	/// Process creation flags, with the values of `CREATE_NEW_CONSOLE`, `CREATE_NEW_PROCESS_GROUP`, and `CREATE_NO_WINDOW`
+	/// </summary>
+	static constexpr const uint32_t c_createNewConsole = 0x00000010;
+	static constexpr const uint32_t c_createNewProcessGroup = 0x00000200;
+	static constexpr const uint32_t c_createNoWindow = 0x08000000;
+
+	/// <summary>
+	/// Buffers `PrepareCommandLine` writes into; kept by the caller to reuse them for the next launch
+	/// </summary>
+	struct Buffers
+	{
+		std::vector<wchar_t> commandLine{};
+		std::vector<std::wstring> argumentValues{};
+	};
+
+	/// <summary>
+	/// Compiles the arguments of the configuration; called once when the configuration is loaded
+	/// </summary>
+	void Compile(HotKeyConfig const& config);
+
+	/// <summary>
+	/// Builds the plan from the compiled arguments; on failure `IsValid` is false and `GetError` describes the problem
+	/// </summary>
+	void Build(HotKeyConfig const& config, std::filesystem::path const& configDir, IArgumentSource& source, IExecutableSearch& search);
+
+	/// <summary>
+	/// Marks the plan to be rebuilt before its next use, e.g. after its executable was not found when launching
+	/// </summary>
+	inline void Invalidate() noexcept
+	{
+		m_stale = true;
+	}
+
+	inline bool IsValid() const noexcept
+	{
+		return m_valid;
+	}
+
+	/// <summary>
+	/// True if the plan was invalidated since it was built
+	/// </summary>
+	inline bool IsStale() const noexcept
+	{
+		return m_stale;
+	}
+
+	inline std::wstring const& GetError() const noexcept
+	{
+		return m_error;
+	}
+
+	/// <summary>
+	/// Note about the build which is not an error, e.g. a missing working directory
+	/// </summary>
+	inline std::wstring const& GetWarning() const noexcept
+	{
+		return m_warning;
+	}
+
+	inline std::wstring const& GetExecutable() const noexcept
+	{
+		return m_executable;
+	}
+
+	/// <summary>
+	/// The working directory, or nullptr if the process should inherit the current one
+	/// </summary>
+	inline const wchar_t* GetWorkingDirectory() const noexcept
+	{
+		return m_workingDirectory.empty() ? nullptr : m_workingDirectory.c_str();
+	}
+
+	/// <summary>
+	/// The command line; with placeholders evaluated when launching still in their source syntax
+	/// </summary>
+	inline const wchar_t* GetCommandLine() const noexcept
+	{
+		return m_commandLine.data();
+	}
+
+	/// <summary>
+	/// Copies the command line into the writable buffer of `buffers`, as required by `CreateProcessW`.
+	/// Does not allocate once the buffers are warm, unless arguments contain placeholders evaluated when launching and their values grow.
+	/// </summary>
+	wchar_t* PrepareCommandLine(IArgumentSource& source, Buffers& buffers) const;
+
+	inline uint32_t GetCreationFlags() const noexcept
+	{
+		return m_creationFlags;
+	}
+
+private:
+	bool m_valid{ false };
+	bool m_stale{ true };
+	std::wstring m_error{};
+	std::wstring m_warning{};
+	std::wstring m_executable{};
+	std::wstring m_workingDirectory{};
+	std::vector<wchar_t> m_commandLine{};
+	// compiled arguments, and their error if any failed to compile
+	std::vector<ArgumentTemplate> m_templates{};
+	std::wstring m_templateError{};
+	// arguments with placeholders evaluated when launching, with their positions; empty if the command line is constant
+	std::vector<std::pair<size_t, ArgumentTemplate>> m_dynamicArguments{};
+	// values of all arguments if any is dynamic; constant ones are set by `Build`,
+	// dynamic ones are evaluated into the caller's `Buffers` when launching
+	std::vector<std::wstring> m_argumentValues{};
+	uint32_t m_creationFlags{ 0 };
+};
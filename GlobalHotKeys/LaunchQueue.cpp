@@ -0,0 +1,81 @@
+#include "pch.h"
+#include "LaunchQueue.h"
+
+LaunchQueue::LaunchQueue(Handler handler, size_t capacity)
+	: m_handler{ std::move(handler) }, m_ring(capacity > 0 ? capacity : 1)
+{
+	m_worker = std::thread{ &LaunchQueue::Run, this };
+}
+
+LaunchQueue::~LaunchQueue()
+{
+	Stop();
+}
+
+bool LaunchQueue::TryPush(uint32_t id, uint64_t chord, uint32_t processId)
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_lock };
+		if (m_stop || m_count == m_ring.size())
+		{
+			m_rejected++;
+			return false;
+		}
+		m_ring[(m_head + m_count) % m_ring.size()] = Item{ id, chord, processId, std::chrono::steady_clock::now() };
+		m_count++;
+	}
+	m_itemQueued.notify_one();
+	return true;
+}
+
+void LaunchQueue::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_lock };
+		m_stop = true;
+		m_count = 0;
+	}
+	m_itemQueued.notify_one();
+	m_idle.notify_all();
+	if (m_worker.joinable())
+	{
+		m_worker.join();
+	}
+}
+
+void LaunchQueue::WaitIdle()
+{
+	std::unique_lock<std::mutex> lock{ m_lock };
+	m_idle.wait(lock, [this]() { return m_stop || (m_count == 0 && !m_busy); });
+}
+
+uint64_t LaunchQueue::GetRejectedCount() const
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	return m_rejected;
+}
+
+void LaunchQueue::Run()
+{
+	std::unique_lock<std::mutex> lock{ m_lock };
+	for (;;)
+	{
+		m_itemQueued.wait(lock, [this]() { return m_stop || m_count > 0; });
+		if (m_stop) break;
+
+		const Item item = m_ring[m_head];
+		m_head = (m_head + 1) % m_ring.size();
+		m_count--;
+		m_busy = true;
+
+		lock.unlock();
+		m_handler(item);
+		lock.lock();
+
+		m_busy = false;
+		if (m_count == 0)
+		{
+			m_idle.notify_all();
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Bounded first-in-first-out queue of hot key triggers, served by one worker thread.
+/// Pushing never blocks: when the queue is full, the trigger is rejected.
+/// Has no platform dependencies.
+/// </summary>
+class LaunchQueue
+{
+public:
+	static constexpr const size_t c_defaultCapacity = 32;
+
+	struct Item
+	{
+		uint32_t id;
+		// key chord the id was triggered with; ids are reused, so a queued id might belong to another hot key when launching
+		uint64_t chord;
+		// foreground process when triggered; zero if not queried
+		uint32_t processId;
+		std::chrono::steady_clock::time_point queuedAt;
+	};
+
+	using Handler = std::function<void(Item const&)>;
+
+	LaunchQueue(Handler handler, size_t capacity = c_defaultCapacity);
+	~LaunchQueue();
+
+	LaunchQueue(LaunchQueue const&) = delete;
+	LaunchQueue& operator=(LaunchQueue const&) = delete;
+
+	/// <summary>
+	/// Queues a trigger; returns false if the queue is full or stopped
+	/// </summary>
+	bool TryPush(uint32_t id, uint64_t chord, uint32_t processId = 0);
+
+	/// <summary>
+	/// Stops the worker after the item currently being processed; queued items are discarded
+	/// </summary>
+	void Stop();
+
+	/// <summary>
+	/// Blocks until all queued items are processed
+	/// </summary>
+	void WaitIdle();
+
+	uint64_t GetRejectedCount() const;
+
+private:
+	void Run();
+
+	Handler m_handler;
+	std::vector<Item> m_ring;
+	size_t m_head{ 0 };
+	size_t m_count{ 0 };
+	bool m_busy{ false };
+	bool m_stop{ false };
+	uint64_t m_rejected{ 0 };
+
+	mutable std::mutex m_lock;
+	std::condition_variable m_itemQueued;
+	std::condition_variable m_idle;
+	std::thread m_worker;
+};
@@ -0,0 +1,106 @@
+#include "pch.h"
+#include "LaunchScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+LaunchScheduler::LaunchScheduler()
+	: LaunchScheduler{ []()
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count());
+		} }
+{
+	// intentionally empty
+}
+
+LaunchScheduler::LaunchScheduler(Clock clock)
+	: m_clock{ std::move(clock) }
+{
+	// intentionally empty
+}
+
+LaunchScheduler::Decision LaunchScheduler::OnTriggered(uint64_t key, LaunchPolicy const& policy)
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	State& state = m_states[key];
+	if (policy.coalesce && state.pending > 0)
+	{
+		return Decision::Coalesced;
+	}
+	state.pending++;
+	return Decision::Launch;
+}
+
+void LaunchScheduler::OnTriggerDropped(uint64_t key)
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	auto it = m_states.find(key);
+	if (it != m_states.end() && it->second.pending > 0)
+	{
+		it->second.pending--;
+	}
+}
+
+LaunchScheduler::Decision LaunchScheduler::BeginLaunch(uint64_t key, LaunchPolicy const& policy)
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	State& state = m_states[key];
+	if (state.pending > 0)
+	{
+		state.pending--;
+	}
+
+	const uint64_t now = m_clock();
+	if (policy.cooldownMs > 0 && state.hasLaunched && now - state.lastLaunch < policy.cooldownMs)
+	{
+		return Decision::Cooldown;
+	}
+
+	if (policy.maxConcurrent > 0)
+	{
+		PruneChildren(state);
+		if (state.children.size() >= policy.maxConcurrent)
+		{
+			return Decision::ConcurrencyLimit;
+		}
+	}
+
+	state.hasLaunched = true;
+	state.lastLaunch = now;
+	return Decision::Launch;
+}
+
+void LaunchScheduler::AddChild(uint64_t key, std::unique_ptr<IChildProcess> child)
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	State& state = m_states[key];
+	PruneChildren(state);
+	state.children.push_back(std::move(child));
+}
+
+void LaunchScheduler::ResetPending(uint64_t key)
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	auto it = m_states.find(key);
+	if (it != m_states.end())
+	{
+		it->second.pending = 0;
+	}
+}
+
+size_t LaunchScheduler::GetRunningCount(uint64_t key)
+{
+	std::lock_guard<std::mutex> lock{ m_lock };
+	auto it = m_states.find(key);
+	if (it == m_states.end()) return 0;
+	PruneChildren(it->second);
+	return it->second.children.size();
+}
+
+void LaunchScheduler::PruneChildren(State& state)
+{
+	state.children.erase(
+		std::remove_if(state.children.begin(), state.children.end(), [](auto const& c) { return !c->IsRunning(); }),
+		state.children.end());
+}
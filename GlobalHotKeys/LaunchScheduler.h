@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// A process started by a hot key, tracked while it is running
+/// </summary>
+class IChildProcess
+{
+public:
+	virtual ~IChildProcess() = default;
+	virtual bool IsRunning() = 0;
+};
+
+/// <summary>
+/// Per hot key limits on how often it launches
+/// </summary>
+struct LaunchPolicy
+{
+	uint32_t cooldownMs{ 0 };
+	bool coalesce{ false };
+	// zero is unlimited
+	uint32_t maxConcurrent{ 0 };
+};
+
+/// <summary>
+/// Enforces launch policies to suppress trigger storms, e.g. from auto-repeat or stuck keys.
+/// Hot keys are identified by a stable key, e.g. their key chord.
+/// Thread-safe; has no platform dependencies.
+/// </summary>
+class LaunchScheduler
+{
+public:
+	enum class Decision
+	{
+		Launch,
+		Coalesced,
+		Cooldown,
+		ConcurrencyLimit
+	};
+
+	/// <summary>
+	/// Monotonic time in milliseconds
+	/// </summary>
+	using Clock = std::function<uint64_t()>;
+
+	LaunchScheduler();
+	explicit LaunchScheduler(Clock clock);
+
+	/// <summary>
+	/// Called when a hot key is triggered, before queuing it.
+	/// Returns `Launch` if the trigger should be queued, or `Coalesced`.
+	/// </summary>
+	Decision OnTriggered(uint64_t key, LaunchPolicy const& policy);
+
+	/// <summary>
+	/// Reverts `OnTriggered` for a trigger which could not be queued
+	/// </summary>
+	void OnTriggerDropped(uint64_t key);
+
+	/// <summary>
+	/// Called for each queued trigger right before launching.
+	/// Only if `Launch` is returned, the process should be started.
+	/// </summary>
+	Decision BeginLaunch(uint64_t key, LaunchPolicy const& policy);
+
+	/// <summary>
+	/// Tracks a started process towards `LaunchPolicy::maxConcurrent`
+	/// </summary>
+	void AddChild(uint64_t key, std::unique_ptr<IChildProcess> child);
+
+	/// <summary>
+	/// Forgets the pending triggers of the key, e.g. after its hot key id changed and its queued triggers became unmatched
+	/// </summary>
+	void ResetPending(uint64_t key);
+
+	size_t GetRunningCount(uint64_t key);
+
+private:
+	struct State
+	{
+		uint32_t pending{ 0 };
+		bool hasLaunched{ false };
+		uint64_t lastLaunch{ 0 };
+		std::vector<std::unique_ptr<IChildProcess>> children;
+	};
+
+	static void PruneChildren(State& state);
+
+	Clock m_clock;
+	std::mutex m_lock;
+	std::unordered_map<uint64_t, State> m_states;
+};
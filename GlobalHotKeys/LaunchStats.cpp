@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "LaunchStats.h"
+
+#include <cwchar>
+#include <iterator>
+
+namespace
+{
+	double ToMs(uint64_t us)
+	{
+		return static_cast<double>(us) / 1000.0;
+	}
+}
+
+const wchar_t* LaunchStats::GetName(Phase phase)
+{
+	switch (phase)
+	{
+	case Phase::Queue: return L"queue";
+	case Phase::Lookup: return L"lookup";
+	case Phase::Resolve: return L"resolve";
+	case Phase::Bell: return L"bell";
+	case Phase::CreateProcess: return L"create-process";
+	case Phase::Action: return L"action";
+	case Phase::Total: return L"total";
+	}
+	return L"?";
+}
+
+const wchar_t* LaunchStats::GetName(Failure failure)
+{
+	switch (failure)
+	{
+	case Failure::NotFound: return L"not-found";
+	case Failure::InvalidPlan: return L"invalid-plan";
+	case Failure::CreateProcessFailed: return L"create-process";
+	case Failure::QueueFull: return L"queue-full";
+	case Failure::Coalesced: return L"coalesced";
+	case Failure::Cooldown: return L"cooldown";
+	case Failure::ConcurrencyLimit: return L"max-concurrent";
+	case Failure::ActionFailed: return L"action";
+	}
+	return L"?";
+}
+
+LaunchStats::Snapshot LaunchStats::GetSnapshot() const noexcept
+{
+	Snapshot s;
+	for (uint32_t i = 0; i < c_phaseCount; ++i)
+	{
+		s.phases[i] = m_phases[i].GetSnapshot();
+	}
+	for (uint32_t i = 0; i < c_failureCount; ++i)
+	{
+		s.failures[i] = m_failures[i].load(std::memory_order_relaxed);
+	}
+	return s;
+}
+
+void LaunchStats::Snapshot::Merge(Snapshot const& other) noexcept
+{
+	for (uint32_t i = 0; i < c_phaseCount; ++i)
+	{
+		phases[i].Merge(other.phases[i]);
+	}
+	for (uint32_t i = 0; i < c_failureCount; ++i)
+	{
+		failures[i] += other.failures[i];
+	}
+}
+
+void LaunchStats::Snapshot::Format(std::wstring& out) const
+{
+	wchar_t line[256];
+
+	out += L"  failures:";
+	for (uint32_t i = 0; i < c_failureCount; ++i)
+	{
+		swprintf(line, std::size(line), L" %ls %llu",
+			GetName(static_cast<Failure>(i)),
+			static_cast<unsigned long long>(failures[i]));
+		out += line;
+	}
+	out += L"\n";
+
+	swprintf(line, std::size(line), L"  %-16ls %8ls %10ls %10ls %10ls %10ls %10ls\n",
+		L"phase [ms]", L"count", L"mean", L"p50", L"p90", L"p99", L"max");
+	out += line;
+
+	for (uint32_t i = 0; i < c_phaseCount; ++i)
+	{
+		LatencyHistogram::Snapshot const& s = phases[i];
+		swprintf(line, std::size(line), L"  %-16ls %8llu %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+			GetName(static_cast<Phase>(i)),
+			static_cast<unsigned long long>(s.count),
+			s.Mean() / 1000.0,
+			ToMs(s.ValueAtPercentile(50.0)),
+			ToMs(s.ValueAtPercentile(90.0)),
+			ToMs(s.ValueAtPercentile(99.0)),
+			ToMs(s.max));
+		out += line;
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// Latency histograms of the phases of launching one hot key, and failure counters by cause.
+/// Recording is lock-free.
+/// </summary>
+class LaunchStats
+{
+public:
+	enum class Phase : uint32_t
+	{
+		Queue,
+		Lookup,
+		Resolve,
+		Bell,
+		CreateProcess,
+		Action,
+		Total
+	};
+	static constexpr const uint32_t c_phaseCount = static_cast<uint32_t>(Phase::Total) + 1;
+
+	enum class Failure : uint32_t
+	{
+		NotFound,
+		InvalidPlan,
+		CreateProcessFailed,
+		QueueFull,
+		Coalesced,
+		Cooldown,
+		ConcurrencyLimit,
+		ActionFailed
+	};
+	static constexpr const uint32_t c_failureCount = static_cast<uint32_t>(Failure::ActionFailed) + 1;
+
+	static const wchar_t* GetName(Phase phase);
+	static const wchar_t* GetName(Failure failure);
+
+	/// <summary>
+	/// Copy of all histograms and counters; snapshots of several hot keys can be merged into a total
+	/// </summary>
+	struct Snapshot
+	{
+		std::array<LatencyHistogram::Snapshot, c_phaseCount> phases{};
+		std::array<uint64_t, c_failureCount> failures{};
+
+		void Merge(Snapshot const& other) noexcept;
+
+		/// <summary>
+		/// Appends a human-readable table of all phases and failures, with latencies in milliseconds
+		/// </summary>
+		void Format(std::wstring& out) const;
+	};
+
+	inline void Record(Phase phase, std::chrono::steady_clock::duration duration) noexcept
+	{
+		const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+		m_phases[static_cast<uint32_t>(phase)].Record(us > 0 ? static_cast<uint64_t>(us) : 0);
+	}
+
+	inline void CountFailure(Failure failure) noexcept
+	{
+		m_failures[static_cast<uint32_t>(failure)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline LatencyHistogram const& GetHistogram(Phase phase) const noexcept
+	{
+		return m_phases[static_cast<uint32_t>(phase)];
+	}
+
+	inline uint64_t GetFailureCount(Failure failure) const noexcept
+	{
+		return m_failures[static_cast<uint32_t>(failure)].load(std::memory_order_relaxed);
+	}
+
+	Snapshot GetSnapshot() const noexcept;
+
+	/// <summary>
+	/// Appends a human-readable table of all phases and failures, with latencies in milliseconds
+	/// </summary>
+	inline void Format(std::wstring& out) const
+	{
+		GetSnapshot().Format(out);
+	}
+
+private:
+	std::array<LatencyHistogram, c_phaseCount> m_phases{};
+	std::array<std::atomic<uint64_t>, c_failureCount> m_failures{};
+};
@@ -1,12 +1,12 @@
 #include "pch.h"
 
 #include "MainWindow.h"
+#include "ConfigFileWatcher.h"
 #include "NotifyIcon.h"
 #include "SimpleLog/SimpleLog.hpp"
 
 #include <string_view>
 #include <string>
-#include <unordered_map>
 
 using namespace std::string_view_literals;
 
@@ -154,14 +154,35 @@ LRESULT CALLBACK MainWindow::wndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
 
 	case WM_HOTKEY:
 	{
-		that->m_hotKeyCallback(static_cast<uint32_t>(wParam));
+		that->m_hotKeyCallback(static_cast<uint32_t>(wParam), LOWORD(lParam), HIWORD(lParam));
 		return 0;
 	}
 
+	case ConfigFileWatcher::c_Message:
+		if (that->m_configFileChangedCallback)
+		{
+			that->m_configFileChangedCallback();
+		}
+		return 0;
+
 	case WM_SETTINGCHANGE:
 		if (lParam && std::wstring_view{ reinterpret_cast<const wchar_t*>(lParam) } == L"Environment"sv)
 		{
-			that->ReloadEnvironment();
+			// restarting the timer coalesces bursts of broadcasts into a single reload
+			SetTimer(hwnd, c_environmentTimerId, c_environmentDebounceMs, nullptr);
+		}
+		break;
+
+	case WM_TIMER:
+		if (wParam == c_environmentTimerId)
+		{
+			KillTimer(hwnd, c_environmentTimerId);
+			// launch plans only need rebuilding if a variable actually changed
+			if (that->ReloadEnvironment() && that->m_environmentChangedCallback)
+			{
+				that->m_environmentChangedCallback();
+			}
+			return 0;
 		}
 		break;
 	}
@@ -174,133 +195,39 @@ LRESULT CALLBACK MainWindow::wndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
 	return DefWindowProc(hwnd, uMsg, wParam, lParam);
 }
 
-void MainWindow::ReloadEnvironment()
+bool MainWindow::ReloadEnvironment()
 {
 	m_log.Write("Reloading environment variables from system settings");
 
-	std::unordered_map<std::wstring, std::wstring> env;
-
-	const struct
-	{
-		HKEY root;
-		const wchar_t* path;
-	} roots[] =
+	if (!m_environment.Refresh(m_environmentRegistry, m_environmentChanges))
 	{
-		{
-			HKEY_LOCAL_MACHINE,
-			L"SYSTEM\\CurrentControlSet\\Control\\Session Manager\\Environment"
-		},
-		{
-			HKEY_CURRENT_USER,
-			L"Environment"
-		}
-	};
-
-	std::vector<wchar_t> nameBuf(1024);
-	std::vector<BYTE> valueBuf(1024 * 2);
+		m_log.Detail("Environment variables unchanged");
+		return false;
+	}
 
-	for (const auto& r : roots)
+	bool changed = false;
+	for (EnvironmentSnapshot::Change const& change : m_environmentChanges)
 	{
-		HKEY hKey = nullptr;
-		if (RegOpenKeyExW(r.root, r.path, 0, KEY_READ, &hKey) != ERROR_SUCCESS)
-			continue;
-
-		DWORD valueCount = 0;
-		DWORD maxNameLen = 0;
-		DWORD maxValueLen = 0;
-
-		// Query number of keys
-		if (RegQueryInfoKeyW(hKey, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &valueCount, &maxNameLen, &maxValueLen, nullptr, nullptr) != ERROR_SUCCESS)
-		{
-			RegCloseKey(hKey);
-			continue;
-		}
-
-		// Allocate buffers
-		nameBuf.resize(maxNameLen + 1);
-		valueBuf.resize(maxValueLen + 2);
+		// Read current process value; the first reload reports all variables, most of which are already set
+		DWORD curSize = GetEnvironmentVariableW(change.name.c_str(), nullptr, 0);
+		const bool exists = curSize > 0;
 
-		for (DWORD i = 0; i < valueCount; ++i)
+		if (change.unset)
 		{
-			DWORD nameLen = maxNameLen + 1;
-			DWORD valueLen = maxValueLen + 2;
-			DWORD type = 0;
-
-			if (RegEnumValueW(hKey, i, nameBuf.data(), &nameLen, nullptr, &type, valueBuf.data(), &valueLen) != ERROR_SUCCESS)
-			{
-				continue;
-			}
-			if (type != REG_SZ && type != REG_EXPAND_SZ)
-			{
-				continue;
-			}
-
-			std::wstring name(nameBuf.data(), nameLen);
-			std::wstring nameUC{ name };
-			CharUpperBuffW(nameUC.data(), static_cast<DWORD>(nameUC.size()));
-
-			std::wstring value(reinterpret_cast<wchar_t*>(valueBuf.data()), valueLen / sizeof(wchar_t));
-
-			// Remove trailing nulls
-			while (!value.empty() && value.back() == L'\0')
-			{
-				value.pop_back();
-			}
-
-			// Expand REG_EXPAND_SZ
-			if (type == REG_EXPAND_SZ)
-			{
-				DWORD needed = ExpandEnvironmentStringsW(value.c_str(), nullptr, 0);
-				if (needed > 0)
-				{
-					std::wstring expanded(needed, L'\0');
-					ExpandEnvironmentStringsW(value.c_str(), expanded.data(), needed);
-					// Remove trailing null
-					if (!expanded.empty() && expanded.back() == L'\0')
-					{
-						expanded.pop_back();
-					}
-					value = std::move(expanded);
-				}
-			}
-
-			if (nameUC == L"USERNAME"sv)
-			{
-				// do not change the user name
-			}
-			else if (nameUC == L"PATH"sv)
-			{
-				// merge path info
-				if (env.find(L"Path") == env.end())
-				{
-					env[L"Path"] = L"";
-				}
-				auto& path = env[L"Path"];
-				if (!path.empty())
-				{
-					path += L";";
-				}
-				path += value;
-			}
-			else
+			if (exists)
 			{
-				env[name] = value;
+				m_log.Detail(L"Removing %s\n", change.name.c_str());
+				SetEnvironmentVariableW(change.name.c_str(), nullptr);
+				changed = true;
 			}
-
+			continue;
 		}
 
-		RegCloseKey(hKey);
-	}
-
-	for (auto const& [name, value] : env)
-	{
-		// Read current process value
-		DWORD curSize = GetEnvironmentVariableW(name.c_str(), nullptr, 0);
 		std::wstring current;
 		if (curSize > 0)
 		{
 			current.resize(curSize);
-			GetEnvironmentVariableW(name.c_str(), current.data(), curSize);
+			GetEnvironmentVariableW(change.name.c_str(), current.data(), curSize);
 			if (!current.empty() && current.back() == L'\0')
 			{
 				current.pop_back();
@@ -308,12 +235,13 @@ void MainWindow::ReloadEnvironment()
 		}
 
 		// Compare and update if different
-		if (current != value)
+		if (!exists || current != change.value)
 		{
-			m_log.Detail(L"Updating %s = %s\n", name.c_str(), value.c_str());
-			SetEnvironmentVariableW(name.c_str(), value.c_str());
+			m_log.Detail(L"Updating %s = %s\n", change.name.c_str(), change.value.c_str());
+			SetEnvironmentVariableW(change.name.c_str(), change.value.c_str());
+			changed = true;
 		}
-
 	}
 
+	return changed;
 }
@@ -1,4 +1,7 @@
 #pragma once
+#include "EnvironmentRegistry.h"
+#include "EnvironmentSnapshot.h"
+
 #include <functional>
 
 namespace sgrottel {
@@ -10,6 +13,9 @@ class MainWindow
 public:
 	static constexpr const wchar_t* c_WindowName = L"GlobalHotKeys";
 
+	// installers often broadcast environment changes many times in a row
+	static constexpr const uint32_t c_environmentDebounceMs = 300;
+
 	MainWindow(HINSTANCE hInstance, sgrottel::ISimpleLog& log);
 	~MainWindow();
 
@@ -36,15 +42,33 @@ public:
 	{
 		m_refreshNotifyIconCallback = std::move(cb);
 	}
-	inline void SetHotKeyCallback(std::function<void(uint32_t)> cb)
+	/// <summary>
+	/// Called with the id, the `MOD_*` modifiers and the virtual key code of a triggered hot key
+	/// </summary>
+	inline void SetHotKeyCallback(std::function<void(uint32_t, uint32_t, uint32_t)> cb)
 	{
 		m_hotKeyCallback = std::move(cb);
 	}
+	inline void SetConfigFileChangedCallback(std::function<void()> cb)
+	{
+		m_configFileChangedCallback = std::move(cb);
+	}
+	inline void SetEnvironmentChangedCallback(std::function<void()> cb)
+	{
+		m_environmentChangedCallback = std::move(cb);
+	}
 
 private:
 	static LRESULT CALLBACK wndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
-	void ReloadEnvironment();
+	static constexpr UINT_PTR c_environmentTimerId = 1;
+
+	/// <summary>
+	/// Updates the environment variables of this process from the system settings.
+	/// Only the variables which changed since the previous reload are set or unset.
+	/// Returns true if any variable changed.
+	/// </summary>
+	bool ReloadEnvironment();
 
 	HINSTANCE m_hInstance;
 	sgrottel::ISimpleLog& m_log;
@@ -54,6 +78,12 @@ private:
 	std::function<void()> m_notifyCallback;
 	std::function<void(WORD)> m_menuItemCallback;
 	std::function<void()> m_refreshNotifyIconCallback;
-	std::function<void(uint32_t)> m_hotKeyCallback;
+	std::function<void(uint32_t, uint32_t, uint32_t)> m_hotKeyCallback;
+	std::function<void()> m_configFileChangedCallback;
+	std::function<void()> m_environmentChangedCallback;
+
+	EnvironmentRegistry m_environmentRegistry;
+	EnvironmentSnapshot m_environment;
+	std::vector<EnvironmentSnapshot::Change> m_environmentChanges;
 };
 
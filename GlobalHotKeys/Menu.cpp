@@ -119,6 +119,10 @@ void Menu::Call(WORD menuItemID)
 		break;
 	}
 
+	case MI_SHOW_STATS:
+		m_onShowStats();
+		break;
+
 	case MI_EXIT:
 		PostQuitMessage(0);
 		break;
@@ -18,6 +18,7 @@ class Menu
 	static constexpr int MI_SHOW_ABOUT = 1007;
 	static constexpr int MI_REG_AUTOSTART = 1008;
 	static constexpr int MI_UNREG_AUTOSTART = 1009;
+	static constexpr int MI_SHOW_STATS = 1010;
 
 public:
 	Menu(sgrottel::ISimpleLog& log, HINSTANCE hInstance);
@@ -72,6 +73,10 @@ public:
 	{
 		m_onUnregAutostart = std::move(callback);
 	}
+	inline void SetOnShowStatsCallback(std::function<void()> callback)
+	{
+		m_onShowStats = std::move(callback);
+	}
 
 private:
 	sgrottel::ISimpleLog& m_log;
@@ -88,5 +93,6 @@ private:
 	std::function<void()> m_onShowAbout;
 	std::function<void()> m_onRegAutostart;
 	std::function<void()> m_onUnregAutostart;
+	std::function<void()> m_onShowStats;
 };
 
@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "PathProbe.h"
+
+#include <algorithm>
+
+namespace
+{
+	// calls a `GetSystemDirectoryW` style function, which returns the required size if the buffer is too small
+	std::filesystem::path GetDirectory(UINT(WINAPI* get)(LPWSTR, UINT))
+	{
+		std::wstring dir(MAX_PATH, L'\0');
+		UINT len = get(dir.data(), static_cast<UINT>(dir.size()));
+		if (len >= dir.size())
+		{
+			dir.resize(len);
+			len = get(dir.data(), static_cast<UINT>(dir.size()));
+		}
+		dir.resize((len < dir.size()) ? len : 0);
+		return dir;
+	}
+
+	std::filesystem::path GetApplicationDirectory()
+	{
+		std::wstring file(MAX_PATH, L'\0');
+		for (;;)
+		{
+			const DWORD len = GetModuleFileNameW(NULL, file.data(), static_cast<DWORD>(file.size()));
+			if (len == 0) return {};
+			if (len < file.size())
+			{
+				file.resize(len);
+				return std::filesystem::path{ file }.parent_path();
+			}
+			file.resize(file.size() * 2);
+		}
+	}
+}
+
+IPathProbe::Kind PathProbe::Query(std::filesystem::path const& path)
+{
+	const DWORD attr = GetFileAttributesW(path.c_str());
+	if (attr == INVALID_FILE_ATTRIBUTES)
+	{
+		const DWORD err = GetLastError();
+		return (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND || err == ERROR_INVALID_NAME || err == ERROR_BAD_NETPATH)
+			? Kind::Missing
+			: Kind::Inaccessible;
+	}
+	return ((attr & FILE_ATTRIBUTE_DIRECTORY) != 0) ? Kind::Directory : Kind::File;
+}
+
+std::filesystem::path PathProbe::Search(wchar_t const* dir, std::filesystem::path const& exe)
+{
+	std::vector<wchar_t> p(MAX_PATH, L'\0');
+
+	DWORD res = SearchPathW(dir, exe.wstring().c_str(), NULL, static_cast<DWORD>(p.size()), p.data(), NULL);
+	if (res == 0) return {};
+	if (res > p.size())
+	{
+		p.resize(res, L'\0');
+		res = SearchPathW(dir, exe.wstring().c_str(), NULL, static_cast<DWORD>(p.size()), p.data(), NULL);
+		if (res == 0) return {};
+	}
+
+	return std::filesystem::path{ p.begin(), p.begin() + res };
+}
+
+std::vector<std::filesystem::path> PathProbe::GetSearchDirs()
+{
+	std::vector<std::filesystem::path> dirs;
+	auto addDir = [&dirs](std::filesystem::path dir)
+		{
+			if (dir.is_absolute()) dirs.push_back(std::move(dir));
+		};
+
+	addDir(GetApplicationDirectory());
+	std::error_code ec;
+	addDir(std::filesystem::current_path(ec));
+	addDir(GetDirectory(&GetSystemDirectoryW));
+	const std::filesystem::path windowsDir = GetDirectory(&GetWindowsDirectoryW);
+	if (!windowsDir.empty())
+	{
+		// the 16-bit system directory
+		addDir(windowsDir / L"System");
+	}
+	addDir(windowsDir);
+
+	const DWORD size = GetEnvironmentVariableW(L"PATH", nullptr, 0);
+	if (size == 0) return dirs;
+	std::wstring path(size, L'\0');
+	const DWORD len = GetEnvironmentVariableW(L"PATH", path.data(), size);
+	path.resize(std::min<DWORD>(len, size));
+
+	size_t start = 0;
+	while (start < path.size())
+	{
+		size_t end = path.find(L';', start);
+		if (end == std::wstring::npos) end = path.size();
+		if (end > start)
+		{
+			addDir(path.substr(start, end - start));
+		}
+		start = end + 1;
+	}
+
+	return dirs;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "ConfigValidator.h"
+#include "LaunchPlan.h"
+
+/// <summary>
+/// Queries the file system via `GetFileAttributesW`, and searches executables via `SearchPathW`.
+/// Has no state, so it can be used from any thread.
+/// </summary>
+class PathProbe : public IPathProbe, public IExecutableSearch
+{
+public:
+	Kind Query(std::filesystem::path const& path) override;
+
+	std::filesystem::path Search(wchar_t const* dir, std::filesystem::path const& exe) override;
+
+	/// <summary>
+	/// The directories `SearchPathW` searches for a file name without path, in its default order:
+	/// the application directory, the current directory, the system directories, the Windows directory, and `PATH`
+	/// </summary>
+	static std::vector<std::filesystem::path> GetSearchDirs();
+};
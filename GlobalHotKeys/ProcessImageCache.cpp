@@ -0,0 +1,44 @@
+#include "pch.h"
+#include "ProcessImageCache.h"
+
+#include "ProfileResolver.h"
+
+ProcessImageCache::ProcessImageCache(IProcessInfo& info, size_t capacity)
+	: m_info{ info }, m_capacity{ capacity > 0 ? capacity : 1 }
+{
+}
+
+std::wstring const& ProcessImageCache::Lookup(uint32_t processId)
+{
+	uint64_t creationTime;
+	if (!m_info.GetCreationTime(processId, creationTime))
+	{
+		m_entries.erase(processId);
+		return m_unknown;
+	}
+
+	auto it = m_entries.find(processId);
+	if (it != m_entries.end() && it->second.creationTime == creationTime)
+	{
+		m_hits++;
+		return it->second.imageName;
+	}
+
+	m_misses++;
+	std::wstring path;
+	if (!m_info.GetImagePath(processId, path))
+	{
+		if (it != m_entries.end()) m_entries.erase(it);
+		return m_unknown;
+	}
+
+	if (it == m_entries.end())
+	{
+		// processes come and go; dropping all entries is simpler than tracking their use, and rare
+		if (m_entries.size() >= m_capacity) m_entries.clear();
+		it = m_entries.insert(std::make_pair(processId, Entry{})).first;
+	}
+	it->second.creationTime = creationTime;
+	it->second.imageName = ProfileResolver::NormalizeImageName(path);
+	return it->second.imageName;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/// <summary>
+/// Process queries used by `ProcessImageCache`
+/// </summary>
+class IProcessInfo
+{
+public:
+	virtual ~IProcessInfo() = default;
+
+	/// <summary>
+	/// The creation time of the process, in any unit; false if the process cannot be queried
+	/// </summary>
+	virtual bool GetCreationTime(uint32_t processId, uint64_t& outTime) = 0;
+
+	/// <summary>
+	/// The full path of the executable of the process; false if the process cannot be queried
+	/// </summary>
+	virtual bool GetImagePath(uint32_t processId, std::wstring& outPath) = 0;
+};
+
+/// <summary>
+/// Caches the normalized image names of processes by process id.
+/// A cached name is only used while the creation time of the process matches, so reused ids are detected.
+/// Not thread-safe.
+/// Has no platform dependencies.
+/// </summary>
+class ProcessImageCache
+{
+public:
+	static constexpr const size_t c_defaultCapacity = 256;
+
+	ProcessImageCache(IProcessInfo& info, size_t capacity = c_defaultCapacity);
+
+	/// <summary>
+	/// The image name of the process, normalized by `ProfileResolver::NormalizeImageName`;
+	/// empty if the process cannot be queried.
+	/// The reference is valid until the next call.
+	/// </summary>
+	std::wstring const& Lookup(uint32_t processId);
+
+	inline uint64_t GetHitCount() const noexcept
+	{
+		return m_hits;
+	}
+
+	inline uint64_t GetMissCount() const noexcept
+	{
+		return m_misses;
+	}
+
+private:
+	struct Entry
+	{
+		uint64_t creationTime;
+		std::wstring imageName;
+	};
+
+	IProcessInfo& m_info;
+	size_t m_capacity;
+	std::unordered_map<uint32_t, Entry> m_entries{};
+	std::wstring m_unknown{};
+	uint64_t m_hits{ 0 };
+	uint64_t m_misses{ 0 };
+};
@@ -0,0 +1,31 @@
+#include "pch.h"
+#include "ProcessInfo.h"
+
+bool ProcessInfo::GetCreationTime(uint32_t processId, uint64_t& outTime)
+{
+	HANDLE proc = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+	if (proc == NULL) return false;
+
+	FILETIME creation, exit, kernel, user;
+	const BOOL ok = GetProcessTimes(proc, &creation, &exit, &kernel, &user);
+	CloseHandle(proc);
+	if (!ok) return false;
+
+	outTime = (static_cast<uint64_t>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+	return true;
+}
+
+bool ProcessInfo::GetImagePath(uint32_t processId, std::wstring& outPath)
+{
+	HANDLE proc = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+	if (proc == NULL) return false;
+
+	wchar_t path[MAX_PATH * 2];
+	DWORD size = MAX_PATH * 2;
+	const BOOL ok = QueryFullProcessImageNameW(proc, 0, path, &size);
+	CloseHandle(proc);
+	if (!ok) return false;
+
+	outPath.assign(path, size);
+	return true;
+}
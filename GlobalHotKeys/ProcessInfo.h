@@ -0,0 +1,13 @@
+#pragma once
+
+#include "ProcessImageCache.h"
+
+/// <summary>
+/// Queries processes via `OpenProcess` with limited query rights
+/// </summary>
+class ProcessInfo : public IProcessInfo
+{
+public:
+	bool GetCreationTime(uint32_t processId, uint64_t& outTime) override;
+	bool GetImagePath(uint32_t processId, std::wstring& outPath) override;
+};
@@ -0,0 +1,45 @@
+#include "pch.h"
+#include "ProfileResolver.h"
+
+#include <cwctype>
+
+void ProfileResolver::Build(std::vector<HotKeyProfile> const& profiles)
+{
+	m_byName.clear();
+	m_byApplication.clear();
+	m_conflicts.clear();
+
+	for (size_t i = 0; i < profiles.size(); ++i)
+	{
+		const uint32_t id = static_cast<uint32_t>(i + 1);
+		m_byName.insert(std::make_pair(profiles[i].name, id));
+		for (std::wstring const& app : profiles[i].applications)
+		{
+			std::wstring name = NormalizeImageName(app);
+			if (name.empty()) continue;
+			auto it = m_byApplication.insert(std::make_pair(name, id));
+			if (!it.second && it.first->second != id)
+			{
+				m_conflicts.push_back(name + L" " + profiles[i].name);
+			}
+		}
+	}
+}
+
+uint32_t ProfileResolver::GetProfileId(std::wstring const& name) const
+{
+	if (name.empty()) return c_noProfile;
+	auto it = m_byName.find(name);
+	return (it != m_byName.end()) ? it->second : c_noProfile;
+}
+
+std::wstring ProfileResolver::NormalizeImageName(std::wstring const& path)
+{
+	const size_t sep = path.find_last_of(L"\\/");
+	std::wstring name = (sep == std::wstring::npos) ? path : path.substr(sep + 1);
+	for (wchar_t& c : name)
+	{
+		c = static_cast<wchar_t>(std::towlower(c));
+	}
+	return name;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "HotKeyConfig.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// Maps the image name of the foreground process to the hot key profile listing it.
+/// The index is built once per configuration, so resolving a trigger is one hash lookup.
+/// Has no platform dependencies.
+/// </summary>
+class ProfileResolver
+{
+public:
+	// profile id of hot keys used in all applications
+	static constexpr const uint32_t c_noProfile = 0;
+
+	/// <summary>
+	/// Builds the index; profile ids are the 1-based positions in `profiles`.
+	/// An application listed by several profiles is used by the first one, and reported by `GetConflicts`.
+	/// </summary>
+	void Build(std::vector<HotKeyProfile> const& profiles);
+
+	/// <summary>
+	/// The id of the named profile, or `c_noProfile` if the name is empty or unknown
+	/// </summary>
+	uint32_t GetProfileId(std::wstring const& name) const;
+
+	/// <summary>
+	/// The id of the profile listing the application; `imageName` must be normalized by `NormalizeImageName`
+	/// </summary>
+	inline uint32_t Resolve(std::wstring const& imageName) const
+	{
+		auto it = m_byApplication.find(imageName);
+		return (it != m_byApplication.end()) ? it->second : c_noProfile;
+	}
+
+	inline bool IsEmpty() const noexcept
+	{
+		return m_byApplication.empty();
+	}
+
+	/// <summary>
+	/// The lower-case file name of an executable path, e.g. `notepad.exe` for `C:\Windows\NOTEPAD.EXE`
+	/// </summary>
+	static std::wstring NormalizeImageName(std::wstring const& path);
+
+	/// <summary>
+	/// Applications listed by more than one profile, as `application profile`
+	/// </summary>
+	inline std::vector<std::wstring> const& GetConflicts() const noexcept
+	{
+		return m_conflicts;
+	}
+
+private:
+	std::unordered_map<std::wstring, uint32_t> m_byName{};
+	std::unordered_map<std::wstring, uint32_t> m_byApplication{};
+	std::vector<std::wstring> m_conflicts{};
+};
@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "ReloadDebouncer.h"
+
+#include <algorithm>
+#include <chrono>
+
+ReloadDebouncer::ReloadDebouncer(IFileChangeSource& source, std::filesystem::path const& path)
+	: ReloadDebouncer{ source, path, []()
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count());
+		} }
+{
+	// intentionally empty
+}
+
+ReloadDebouncer::ReloadDebouncer(IFileChangeSource& source, std::filesystem::path const& path, Clock clock, uint32_t debounceMs, uint32_t maxDelayMs)
+	: m_source{ source },
+	m_path{ path },
+	m_clock{ std::move(clock) },
+	m_debounceMs{ debounceMs },
+	m_maxDelayMs{ maxDelayMs },
+	m_lastStamp{ GetStamp(path) }
+{
+	// intentionally empty
+}
+
+bool ReloadDebouncer::WaitForChange()
+{
+	for (;;)
+	{
+		IFileChangeSource::WaitResult res = m_source.Wait(IFileChangeSource::c_infinite);
+		if (res != IFileChangeSource::WaitResult::Changed) return false;
+
+		res = WaitForQuiet();
+		if (res != IFileChangeSource::WaitResult::Timeout) return false;
+
+		// the directory change might have been about any other file, e.g. our own cache file
+		const FileStamp stamp = GetStamp(m_path);
+		if (stamp == m_lastStamp) continue;
+		m_lastStamp = stamp;
+		if (stamp.exists) return true;
+	}
+}
+
+IFileChangeSource::WaitResult ReloadDebouncer::WaitForQuiet()
+{
+	const uint64_t first = m_clock();
+	uint64_t last = first;
+	for (;;)
+	{
+		const uint64_t deadline = std::min(last + m_debounceMs, first + m_maxDelayMs);
+		const uint64_t now = m_clock();
+		if (now >= deadline) return IFileChangeSource::WaitResult::Timeout;
+
+		const IFileChangeSource::WaitResult res = m_source.Wait(static_cast<uint32_t>(deadline - now));
+		if (res == IFileChangeSource::WaitResult::Changed)
+		{
+			last = m_clock();
+		}
+		else if (res != IFileChangeSource::WaitResult::Timeout)
+		{
+			return res;
+		}
+	}
+}
+
+ReloadDebouncer::FileStamp ReloadDebouncer::GetStamp(std::filesystem::path const& path)
+{
+	FileStamp stamp;
+	std::error_code ec;
+	stamp.size = std::filesystem::file_size(path, ec);
+	if (ec) return FileStamp{};
+	stamp.lastWriteTime = std::filesystem::last_write_time(path, ec);
+	if (ec) return FileStamp{};
+	stamp.exists = true;
+	return stamp;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+/// <summary>
+/// Platform backend signaling changes within a directory
+/// </summary>
+class IFileChangeSource
+{
+public:
+	static constexpr const uint32_t c_infinite = 0xffffffffu;
+
+	enum class WaitResult
+	{
+		Changed,
+		Timeout,
+		Stopped,
+		Failed
+	};
+
+	virtual ~IFileChangeSource() = default;
+
+	virtual bool Start(std::filesystem::path const& directory) = 0;
+
+	/// <summary>
+	/// Blocks until a change happened, the timeout elapsed, or `Stop` was called
+	/// </summary>
+	virtual WaitResult Wait(uint32_t timeoutMs) = 0;
+
+	/// <summary>
+	/// Wakes up `Wait`; can be called from any thread
+	/// </summary>
+	virtual void Stop() = 0;
+};
+
+/// <summary>
+/// Waits for changes of one file, signaled by a change source watching its directory.
+/// Bursts of changes are coalesced, e.g. from editors saving in multiple steps,
+/// and changes of other files in the directory are ignored.
+/// Has no platform dependencies.
+/// </summary>
+class ReloadDebouncer
+{
+public:
+	/// <summary>
+	/// Monotonic time in milliseconds
+	/// </summary>
+	using Clock = std::function<uint64_t()>;
+
+	/// <summary>
+	/// Quiet time after the last change before the file is reported changed
+	/// </summary>
+	static constexpr const uint32_t c_debounceMs = 300;
+
+	/// <summary>
+	/// Longest delay after the first change of a burst, so a steady stream of changes still reports the file
+	/// </summary>
+	static constexpr const uint32_t c_maxDelayMs = 3000;
+
+	ReloadDebouncer(IFileChangeSource& source, std::filesystem::path const& path);
+	ReloadDebouncer(IFileChangeSource& source, std::filesystem::path const& path, Clock clock, uint32_t debounceMs = c_debounceMs, uint32_t maxDelayMs = c_maxDelayMs);
+
+	/// <summary>
+	/// Blocks until the file changed and exists.
+	/// Returns false if the source was stopped or failed.
+	/// </summary>
+	bool WaitForChange();
+
+private:
+	struct FileStamp
+	{
+		bool exists{ false };
+		uintmax_t size{ 0 };
+		std::filesystem::file_time_type lastWriteTime{};
+
+		inline bool operator==(FileStamp const& other) const
+		{
+			return exists == other.exists && size == other.size && lastWriteTime == other.lastWriteTime;
+		}
+		inline bool operator!=(FileStamp const& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	static FileStamp GetStamp(std::filesystem::path const& path);
+
+	/// <summary>
+	/// Waits until the burst of changes started by a change ended
+	/// </summary>
+	IFileChangeSource::WaitResult WaitForQuiet();
+
+	IFileChangeSource& m_source;
+	std::filesystem::path m_path;
+	Clock m_clock;
+	uint32_t m_debounceMs;
+	uint32_t m_maxDelayMs;
+	FileStamp m_lastStamp;
+};
@@ -1,21 +1,109 @@
 #include "pch.h"
 #include "StringUtils.h"
 
-std::wstring ToW(char const* utf8)
+#include <cstring>
+
+namespace
 {
-	if (utf8 == nullptr) return L"";
-	if (*utf8 == 0) return L"";
+	constexpr const char32_t c_replacement = 0xFFFD;
 
-	int rv = MultiByteToWideChar(CP_UTF8, 0, utf8, -1, NULL, 0);
-	if (rv == 0) return L"";
+	/// <summary>
+	/// Decodes the code point at `pos` and advances `pos`.
+	/// Malformed sequences, surrogates, and overlong forms decode as U+FFFD, like `MultiByteToWideChar` does.
+	/// </summary>
+	char32_t DecodeUtf8(unsigned char const* str, size_t len, size_t& pos)
+	{
+		const unsigned char lead = str[pos++];
+		if (lead < 0x80) return lead;
+
+		size_t count = 0;
+		char32_t min = 0;
+		if ((lead & 0xE0) == 0xC0)
+		{
+			count = 1;
+			min = 0x80;
+		}
+		else if ((lead & 0xF0) == 0xE0)
+		{
+			count = 2;
+			min = 0x800;
+		}
+		else if ((lead & 0xF8) == 0xF0)
+		{
+			count = 3;
+			min = 0x10000;
+		}
+		else
+		{
+			return c_replacement;
+		}
 
-	std::wstring str(rv, L'\0');
+		char32_t cp = lead & (0x3F >> count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (pos >= len || (str[pos] & 0xC0) != 0x80) return c_replacement;
+			cp = (cp << 6) | (str[pos++] & 0x3F);
+		}
+		if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return c_replacement;
+		return cp;
+	}
 
-	rv = MultiByteToWideChar(CP_UTF8, 0, utf8, -1, str.data(), static_cast<int>(str.size()));
-	if (rv == 0) return L"";
+	void AppendWide(std::wstring& str, char32_t cp)
+	{
+		if constexpr (sizeof(wchar_t) == 2)
+		{
+			if (cp >= 0x10000)
+			{
+				cp -= 0x10000;
+				str.push_back(static_cast<wchar_t>(0xD800 + (cp >> 10)));
+				str.push_back(static_cast<wchar_t>(0xDC00 + (cp & 0x3FF)));
+				return;
+			}
+		}
+		str.push_back(static_cast<wchar_t>(cp));
+	}
 
-	if (!str.empty() && str.back() == L'\0') str.resize(str.size() - 1);
-	return std::move(str);
+	void AppendUtf8(std::string& str, char32_t cp)
+	{
+		if (cp < 0x80)
+		{
+			str.push_back(static_cast<char>(cp));
+		}
+		else if (cp < 0x800)
+		{
+			str.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+			str.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+		}
+		else if (cp < 0x10000)
+		{
+			str.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+			str.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+			str.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+		}
+		else
+		{
+			str.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+			str.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+			str.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+			str.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+		}
+	}
+}
+
+// The conversions are portable, so the configuration binder also builds in the tests on Linux
+std::wstring ToW(char const* utf8)
+{
+	if (utf8 == nullptr) return L"";
+
+	auto const* str = reinterpret_cast<unsigned char const*>(utf8);
+	const size_t len = std::strlen(utf8);
+	std::wstring w;
+	w.reserve(len);
+	for (size_t pos = 0; pos < len;)
+	{
+		AppendWide(w, DecodeUtf8(str, len, pos));
+	}
+	return w;
 }
 
 std::string ToA(std::wstring const& w)
@@ -28,3 +116,24 @@ std::string ToA(std::wstring const& w)
 	}
 	return s;
 }
+
+std::string ToUtf8(std::wstring const& w)
+{
+	std::string str;
+	str.reserve(w.size());
+	for (size_t i = 0; i < w.size(); ++i)
+	{
+		char32_t cp = static_cast<char32_t>(w[i]);
+		if constexpr (sizeof(wchar_t) == 2)
+		{
+			if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < w.size() && w[i + 1] >= 0xDC00 && w[i + 1] <= 0xDFFF)
+			{
+				cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<char32_t>(w[++i]) - 0xDC00);
+			}
+		}
+		// unpaired surrogates and values beyond Unicode are replaced, like `WideCharToMultiByte` does
+		if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) cp = c_replacement;
+		AppendUtf8(str, cp);
+	}
+	return str;
+}
@@ -9,3 +9,5 @@ inline std::wstring ToW(unsigned char const* utf8)
 }
 
 std::string ToA(std::wstring const& w);
+
+std::string ToUtf8(std::wstring const& w);
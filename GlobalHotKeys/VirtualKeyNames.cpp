@@ -0,0 +1,367 @@
+#include "pch.h"
+#include "VirtualKeyNames.h"
+
+#include <array>
+#include <iterator>
+
+namespace
+{
+	using Entry = VirtualKeyNames::Entry;
+
+	// generated by `collect_virtual_key_codes.ps1`
+	constexpr const Entry c_entries[] = {
+		{ L"lbutton", 0x01 },
+		{ L"rbutton", 0x02 },
+		{ L"cancel", 0x03 },
+		{ L"mbutton", 0x04 },
+		{ L"xbutton1", 0x05 },
+		{ L"xbutton2", 0x06 },
+		{ L"back", 0x08 },
+		{ L"tab", 0x09 },
+		{ L"clear", 0x0C },
+		{ L"return", 0x0D },
+		{ L"shift", 0x10 },
+		{ L"control", 0x11 },
+		{ L"menu", 0x12 },
+		{ L"pause", 0x13 },
+		{ L"capital", 0x14 },
+		{ L"kana", 0x15 },
+		{ L"hangeul", 0x15 },
+		{ L"hangul", 0x15 },
+		{ L"ime_on", 0x16 },
+		{ L"junja", 0x17 },
+		{ L"final", 0x18 },
+		{ L"hanja", 0x19 },
+		{ L"kanji", 0x19 },
+		{ L"ime_off", 0x1A },
+		{ L"escape", 0x1B },
+		{ L"convert", 0x1C },
+		{ L"nonconvert", 0x1D },
+		{ L"accept", 0x1E },
+		{ L"modechange", 0x1F },
+		{ L"space", 0x20 },
+		{ L"prior", 0x21 },
+		{ L"next", 0x22 },
+		{ L"end", 0x23 },
+		{ L"home", 0x24 },
+		{ L"left", 0x25 },
+		{ L"up", 0x26 },
+		{ L"right", 0x27 },
+		{ L"down", 0x28 },
+		{ L"select", 0x29 },
+		{ L"print", 0x2A },
+		{ L"execute", 0x2B },
+		{ L"snapshot", 0x2C },
+		{ L"insert", 0x2D },
+		{ L"delete", 0x2E },
+		{ L"help", 0x2F },
+		{ L"lwin", 0x5B },
+		{ L"rwin", 0x5C },
+		{ L"apps", 0x5D },
+		{ L"sleep", 0x5F },
+		{ L"numpad0", 0x60 },
+		{ L"numpad1", 0x61 },
+		{ L"numpad2", 0x62 },
+		{ L"numpad3", 0x63 },
+		{ L"numpad4", 0x64 },
+		{ L"numpad5", 0x65 },
+		{ L"numpad6", 0x66 },
+		{ L"numpad7", 0x67 },
+		{ L"numpad8", 0x68 },
+		{ L"numpad9", 0x69 },
+		{ L"multiply", 0x6A },
+		{ L"add", 0x6B },
+		{ L"separator", 0x6C },
+		{ L"subtract", 0x6D },
+		{ L"decimal", 0x6E },
+		{ L"divide", 0x6F },
+		{ L"f1", 0x70 },
+		{ L"f2", 0x71 },
+		{ L"f3", 0x72 },
+		{ L"f4", 0x73 },
+		{ L"f5", 0x74 },
+		{ L"f6", 0x75 },
+		{ L"f7", 0x76 },
+		{ L"f8", 0x77 },
+		{ L"f9", 0x78 },
+		{ L"f10", 0x79 },
+		{ L"f11", 0x7A },
+		{ L"f12", 0x7B },
+		{ L"f13", 0x7C },
+		{ L"f14", 0x7D },
+		{ L"f15", 0x7E },
+		{ L"f16", 0x7F },
+		{ L"f17", 0x80 },
+		{ L"f18", 0x81 },
+		{ L"f19", 0x82 },
+		{ L"f20", 0x83 },
+		{ L"f21", 0x84 },
+		{ L"f22", 0x85 },
+		{ L"f23", 0x86 },
+		{ L"f24", 0x87 },
+		{ L"navigation_view", 0x88 },
+		{ L"navigation_menu", 0x89 },
+		{ L"navigation_up", 0x8A },
+		{ L"navigation_down", 0x8B },
+		{ L"navigation_left", 0x8C },
+		{ L"navigation_right", 0x8D },
+		{ L"navigation_accept", 0x8E },
+		{ L"navigation_cancel", 0x8F },
+		{ L"numlock", 0x90 },
+		{ L"scroll", 0x91 },
+		{ L"oem_nec_equal", 0x92 },
+		{ L"oem_fj_jisho", 0x92 },
+		{ L"oem_fj_masshou", 0x93 },
+		{ L"oem_fj_touroku", 0x94 },
+		{ L"oem_fj_loya", 0x95 },
+		{ L"oem_fj_roya", 0x96 },
+		{ L"lshift", 0xA0 },
+		{ L"rshift", 0xA1 },
+		{ L"lcontrol", 0xA2 },
+		{ L"rcontrol", 0xA3 },
+		{ L"lmenu", 0xA4 },
+		{ L"rmenu", 0xA5 },
+		{ L"browser_back", 0xA6 },
+		{ L"browser_forward", 0xA7 },
+		{ L"browser_refresh", 0xA8 },
+		{ L"browser_stop", 0xA9 },
+		{ L"browser_search", 0xAA },
+		{ L"browser_favorites", 0xAB },
+		{ L"browser_home", 0xAC },
+		{ L"volume_mute", 0xAD },
+		{ L"volume_down", 0xAE },
+		{ L"volume_up", 0xAF },
+		{ L"media_next_track", 0xB0 },
+		{ L"media_prev_track", 0xB1 },
+		{ L"media_stop", 0xB2 },
+		{ L"media_play_pause", 0xB3 },
+		{ L"launch_mail", 0xB4 },
+		{ L"launch_media_select", 0xB5 },
+		{ L"launch_app1", 0xB6 },
+		{ L"launch_app2", 0xB7 },
+		{ L"oem_1", 0xBA },
+		{ L"oem_plus", 0xBB },
+		{ L"oem_comma", 0xBC },
+		{ L"oem_minus", 0xBD },
+		{ L"oem_period", 0xBE },
+		{ L"oem_2", 0xBF },
+		{ L"oem_3", 0xC0 },
+		{ L"gamepad_a", 0xC3 },
+		{ L"gamepad_b", 0xC4 },
+		{ L"gamepad_x", 0xC5 },
+		{ L"gamepad_y", 0xC6 },
+		{ L"gamepad_right_shoulder", 0xC7 },
+		{ L"gamepad_left_shoulder", 0xC8 },
+		{ L"gamepad_left_trigger", 0xC9 },
+		{ L"gamepad_right_trigger", 0xCA },
+		{ L"gamepad_dpad_up", 0xCB },
+		{ L"gamepad_dpad_down", 0xCC },
+		{ L"gamepad_dpad_left", 0xCD },
+		{ L"gamepad_dpad_right", 0xCE },
+		{ L"gamepad_menu", 0xCF },
+		{ L"gamepad_view", 0xD0 },
+		{ L"gamepad_left_thumbstick_button", 0xD1 },
+		{ L"gamepad_right_thumbstick_button", 0xD2 },
+		{ L"gamepad_left_thumbstick_up", 0xD3 },
+		{ L"gamepad_left_thumbstick_down", 0xD4 },
+		{ L"gamepad_left_thumbstick_right", 0xD5 },
+		{ L"gamepad_left_thumbstick_left", 0xD6 },
+		{ L"gamepad_right_thumbstick_up", 0xD7 },
+		{ L"gamepad_right_thumbstick_down", 0xD8 },
+		{ L"gamepad_right_thumbstick_right", 0xD9 },
+		{ L"gamepad_right_thumbstick_left", 0xDA },
+		{ L"oem_4", 0xDB },
+		{ L"oem_5", 0xDC },
+		{ L"oem_6", 0xDD },
+		{ L"oem_7", 0xDE },
+		{ L"oem_8", 0xDF },
+		{ L"oem_ax", 0xE1 },
+		{ L"oem_102", 0xE2 },
+		{ L"ico_help", 0xE3 },
+		{ L"ico_00", 0xE4 },
+		{ L"processkey", 0xE5 },
+		{ L"ico_clear", 0xE6 },
+		{ L"packet", 0xE7 },
+		{ L"oem_reset", 0xE9 },
+		{ L"oem_jump", 0xEA },
+		{ L"oem_pa1", 0xEB },
+		{ L"oem_pa2", 0xEC },
+		{ L"oem_pa3", 0xED },
+		{ L"oem_wsctrl", 0xEE },
+		{ L"oem_cusel", 0xEF },
+		{ L"oem_attn", 0xF0 },
+		{ L"oem_finish", 0xF1 },
+		{ L"oem_copy", 0xF2 },
+		{ L"oem_auto", 0xF3 },
+		{ L"oem_enlw", 0xF4 },
+		{ L"oem_backtab", 0xF5 },
+		{ L"attn", 0xF6 },
+		{ L"crsel", 0xF7 },
+		{ L"exsel", 0xF8 },
+		{ L"ereof", 0xF9 },
+		{ L"play", 0xFA },
+		{ L"zoom", 0xFB },
+		{ L"noname", 0xFC },
+		{ L"pa1", 0xFD },
+		{ L"oem_clear", 0xFE },
+	};
+	constexpr const size_t c_entryCount = std::size(c_entries);
+
+	constexpr const size_t c_bucketCount = 64;
+	constexpr const size_t c_slotCount = 256;
+	constexpr const size_t c_maxBucketSize = 16;
+	constexpr const uint16_t c_emptySlot = 0xffff;
+	constexpr const size_t c_codeCount = 256;
+
+	static_assert(c_entryCount < c_slotCount, "Perfect hash table too small");
+	static_assert((c_slotCount & (c_slotCount - 1)) == 0, "Slot count must be a power of two");
+
+	constexpr uint32_t Hash(std::wstring_view str, uint32_t basis) noexcept
+	{
+		// FNV-1a
+		uint32_t h = basis;
+		for (wchar_t c : str)
+		{
+			h ^= static_cast<uint32_t>(c);
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+	constexpr uint32_t HashA(std::wstring_view str) noexcept
+	{
+		return Hash(str, 2166136261u);
+	}
+
+	constexpr uint32_t HashB(std::wstring_view str) noexcept
+	{
+		return Hash(str, 0x811c9dc5u ^ 0x5bd1e995u);
+	}
+
+	constexpr size_t GetSlot(uint32_t hashA, uint32_t hashB, uint32_t displacement) noexcept
+	{
+		// odd step, so displacements cycle through all slots
+		return (hashB + displacement * ((hashA >> 16) | 1u)) % c_slotCount;
+	}
+
+	/// <summary>
+	/// Hash and displace: keys are grouped into buckets by `HashA`,
+	/// and each bucket gets the displacement placing all its keys into free slots
+	/// </summary>
+	struct PerfectHash
+	{
+		std::array<uint16_t, c_bucketCount> displacement{};
+		std::array<uint16_t, c_slotCount> slots{};
+	};
+
+	constexpr PerfectHash BuildPerfectHash()
+	{
+		PerfectHash ph{};
+		for (auto& s : ph.slots) s = c_emptySlot;
+
+		std::array<uint32_t, c_entryCount> hashA{};
+		std::array<uint32_t, c_entryCount> hashB{};
+		std::array<uint16_t, c_bucketCount + 1> bucketStart{};
+		for (size_t i = 0; i < c_entryCount; ++i)
+		{
+			hashA[i] = HashA(c_entries[i].name);
+			hashB[i] = HashB(c_entries[i].name);
+			bucketStart[hashA[i] % c_bucketCount + 1]++;
+		}
+		for (size_t b = 0; b < c_bucketCount; ++b)
+		{
+			if (bucketStart[b + 1] > c_maxBucketSize) throw "Perfect hash bucket too large";
+			bucketStart[b + 1] += bucketStart[b];
+		}
+
+		// entry indices grouped by bucket
+		std::array<uint16_t, c_entryCount> order{};
+		std::array<uint16_t, c_bucketCount> fill{};
+		for (size_t i = 0; i < c_entryCount; ++i)
+		{
+			const size_t b = hashA[i] % c_bucketCount;
+			order[bucketStart[b] + fill[b]++] = static_cast<uint16_t>(i);
+		}
+
+		// place large buckets first, while most slots are still free
+		for (size_t size = c_maxBucketSize; size > 0; --size)
+		{
+			for (size_t b = 0; b < c_bucketCount; ++b)
+			{
+				if (static_cast<size_t>(bucketStart[b + 1] - bucketStart[b]) != size) continue;
+
+				for (uint32_t d = 0;; ++d)
+				{
+					if (d >= c_slotCount) throw "Perfect hash construction failed";
+
+					std::array<uint16_t, c_maxBucketSize> slots{};
+					bool ok = true;
+					for (size_t k = 0; k < size && ok; ++k)
+					{
+						const uint16_t i = order[bucketStart[b] + k];
+						const size_t slot = GetSlot(hashA[i], hashB[i], d);
+						if (ph.slots[slot] != c_emptySlot) ok = false;
+						for (size_t j = 0; j < k; ++j)
+						{
+							if (slots[j] == slot) ok = false;
+						}
+						slots[k] = static_cast<uint16_t>(slot);
+					}
+					if (!ok) continue;
+
+					for (size_t k = 0; k < size; ++k)
+					{
+						ph.slots[slots[k]] = order[bucketStart[b] + k];
+					}
+					ph.displacement[b] = static_cast<uint16_t>(d);
+					break;
+				}
+			}
+		}
+
+		return ph;
+	}
+
+	constexpr std::array<uint16_t, c_codeCount> BuildCodeTable()
+	{
+		std::array<uint16_t, c_codeCount> table{};
+		for (auto& t : table) t = c_emptySlot;
+		for (size_t i = 0; i < c_entryCount; ++i)
+		{
+			if (c_entries[i].code >= c_codeCount) throw "Virtual key code out of range";
+			if (table[c_entries[i].code] == c_emptySlot)
+			{
+				table[c_entries[i].code] = static_cast<uint16_t>(i);
+			}
+		}
+		return table;
+	}
+
+	constexpr const PerfectHash c_perfectHash = BuildPerfectHash();
+	constexpr const std::array<uint16_t, c_codeCount> c_byCode = BuildCodeTable();
+}
+
+uint32_t VirtualKeyNames::Find(std::wstring_view name) noexcept
+{
+	const uint32_t hA = HashA(name);
+	const size_t slot = GetSlot(hA, HashB(name), c_perfectHash.displacement[hA % c_bucketCount]);
+	const uint16_t index = c_perfectHash.slots[slot];
+	if (index == c_emptySlot || c_entries[index].name != name) return c_invalid;
+	return c_entries[index].code;
+}
+
+VirtualKeyNames::Entry const* VirtualKeyNames::FindByCode(uint32_t code) noexcept
+{
+	if (code >= c_codeCount || c_byCode[code] == c_emptySlot) return nullptr;
+	return &c_entries[c_byCode[code]];
+}
+
+size_t VirtualKeyNames::GetCount() noexcept
+{
+	return c_entryCount;
+}
+
+VirtualKeyNames::Entry const& VirtualKeyNames::GetEntry(size_t index) noexcept
+{
+	return c_entries[index];
+}
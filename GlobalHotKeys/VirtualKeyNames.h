@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/// <summary>
+/// Names of virtual key codes, as generated by `collect_virtual_key_codes.ps1`.
+/// Names are found via a compile-time perfect hash, codes via a direct-indexed table.
+/// </summary>
+class VirtualKeyNames
+{
+public:
+	static constexpr const uint32_t c_invalid = 0xffffffffu;
+
+	struct Entry
+	{
+		std::wstring_view name;
+		uint32_t code;
+
+		/// <summary>
+		/// OEM key names are only used if the key does not map to a character
+		/// </summary>
+		constexpr bool IsOem() const noexcept
+		{
+			return name.substr(0, 4) == L"oem_";
+		}
+	};
+
+	/// <summary>
+	/// Returns the code of the lower-case key name, or `c_invalid`
+	/// </summary>
+	static uint32_t Find(std::wstring_view name) noexcept;
+
+	/// <summary>
+	/// Returns the entry of the code, or nullptr.
+	/// For codes with multiple names, the first one listed is returned.
+	/// </summary>
+	static Entry const* FindByCode(uint32_t code) noexcept;
+
+	static size_t GetCount() noexcept;
+	static Entry const& GetEntry(size_t index) noexcept;
+};
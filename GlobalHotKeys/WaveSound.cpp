@@ -0,0 +1,215 @@
+#include "pch.h"
+#include "WaveSound.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	constexpr const uint16_t c_formatPcm = 1;
+	constexpr const uint16_t c_formatFloat = 3;
+	constexpr const uint16_t c_formatExtensible = 0xFFFE;
+
+	inline uint16_t ReadU16(const uint8_t* p)
+	{
+		return static_cast<uint16_t>(p[0] | (p[1] << 8));
+	}
+
+	inline uint32_t ReadU32(const uint8_t* p)
+	{
+		return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+	}
+
+	inline bool IsTag(const uint8_t* p, const char* tag)
+	{
+		return std::memcmp(p, tag, 4) == 0;
+	}
+
+	inline int32_t ReadSample(const uint8_t* p, uint16_t bytes)
+	{
+		switch (bytes)
+		{
+		case 1: return static_cast<int32_t>(p[0]) - 128;
+		case 2: return static_cast<int16_t>(ReadU16(p));
+		case 3: return static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+		default: return static_cast<int32_t>(ReadU32(p));
+		}
+	}
+
+	inline void WriteSample(uint8_t* p, uint16_t bytes, int32_t v)
+	{
+		switch (bytes)
+		{
+		case 1:
+			p[0] = static_cast<uint8_t>(v + 128);
+			break;
+		case 2:
+		case 3:
+		case 4:
+			for (uint16_t i = 0; i < bytes; ++i)
+			{
+				p[i] = static_cast<uint8_t>(static_cast<uint32_t>(v) >> (8 * i));
+			}
+			break;
+		}
+	}
+}
+
+bool WaveSound::Load(std::vector<uint8_t>&& image, std::string& error)
+{
+	Clear();
+
+	const uint8_t* data = image.data();
+	const size_t size = image.size();
+	if (size < 12 || !IsTag(data, "RIFF") || !IsTag(data + 8, "WAVE"))
+	{
+		error = "not a RIFF WAVE file";
+		return false;
+	}
+	const uint64_t riffEnd = 8ull + ReadU32(data + 4);
+	if (riffEnd > size)
+	{
+		error = "file is truncated";
+		return false;
+	}
+
+	Format format;
+	bool hasFormat = false;
+	size_t dataOffset = 0;
+	size_t dataSize = 0;
+	bool hasData = false;
+
+	uint64_t pos = 12;
+	while (pos + 8 <= riffEnd)
+	{
+		const uint8_t* chunk = data + pos;
+		const uint64_t chunkSize = ReadU32(chunk + 4);
+		if (pos + 8 + chunkSize > riffEnd)
+		{
+			error = "chunk exceeds file size";
+			return false;
+		}
+
+		if (IsTag(chunk, "fmt "))
+		{
+			if (chunkSize < 16)
+			{
+				error = "format chunk too small";
+				return false;
+			}
+			uint16_t tag = ReadU16(chunk + 8);
+			format.channels = ReadU16(chunk + 10);
+			format.sampleRate = ReadU32(chunk + 12);
+			format.blockAlign = ReadU16(chunk + 20);
+			format.bitsPerSample = ReadU16(chunk + 22);
+			if (tag == c_formatExtensible)
+			{
+				// the sub format guid starts with the format tag
+				if (chunkSize < 40)
+				{
+					error = "extensible format chunk too small";
+					return false;
+				}
+				tag = ReadU16(chunk + 32);
+			}
+			if (tag == c_formatPcm)
+			{
+				format.sampleFormat = SampleFormat::Pcm;
+				if (format.bitsPerSample != 8 && format.bitsPerSample != 16 && format.bitsPerSample != 24 && format.bitsPerSample != 32)
+				{
+					error = "unsupported sample size";
+					return false;
+				}
+			}
+			else if (tag == c_formatFloat)
+			{
+				format.sampleFormat = SampleFormat::Float;
+				if (format.bitsPerSample != 32)
+				{
+					error = "unsupported sample size";
+					return false;
+				}
+			}
+			else
+			{
+				error = "unsupported sample format; only PCM and float are supported";
+				return false;
+			}
+			if (format.channels == 0 || format.sampleRate == 0
+				|| format.blockAlign != format.channels * (format.bitsPerSample / 8))
+			{
+				error = "invalid format chunk";
+				return false;
+			}
+			hasFormat = true;
+		}
+		else if (IsTag(chunk, "data"))
+		{
+			if (!hasFormat)
+			{
+				error = "data chunk before format chunk";
+				return false;
+			}
+			dataOffset = static_cast<size_t>(pos + 8);
+			dataSize = static_cast<size_t>(chunkSize);
+			hasData = true;
+		}
+
+		// chunks are padded to even sizes
+		pos += 8 + chunkSize + (chunkSize & 1);
+	}
+
+	if (!hasFormat || !hasData)
+	{
+		error = hasFormat ? "data chunk missing" : "format chunk missing";
+		return false;
+	}
+	if (dataSize == 0 || dataSize % format.blockAlign != 0)
+	{
+		error = "data size does not match the format";
+		return false;
+	}
+
+	m_image = std::move(image);
+	m_format = format;
+	m_dataOffset = dataOffset;
+	m_dataSize = dataSize;
+	return true;
+}
+
+void WaveSound::ScaleVolume(float volume)
+{
+	volume = std::clamp(volume, 0.0f, 1.0f);
+	if (m_image.empty() || volume >= 1.0f) return;
+
+	uint8_t* p = m_image.data() + m_dataOffset;
+	uint8_t* const end = p + m_dataSize;
+	const uint16_t bytes = m_format.bitsPerSample / 8;
+
+	if (m_format.sampleFormat == SampleFormat::Float)
+	{
+		for (; p < end; p += 4)
+		{
+			float v;
+			std::memcpy(&v, p, 4);
+			v *= volume;
+			std::memcpy(p, &v, 4);
+		}
+		return;
+	}
+
+	for (; p < end; p += bytes)
+	{
+		const double v = static_cast<double>(ReadSample(p, bytes)) * volume;
+		WriteSample(p, bytes, static_cast<int32_t>(std::lround(v)));
+	}
+}
+
+void WaveSound::Clear()
+{
+	m_image.clear();
+	m_format = Format{};
+	m_dataOffset = 0;
+	m_dataSize = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// In-memory image of a RIFF WAVE file, validated once, so it can be played repeatedly without file access.
+/// Has no platform dependencies.
+/// </summary>
+class WaveSound
+{
+public:
+	enum class SampleFormat
+	{
+		Pcm,
+		Float
+	};
+
+	struct Format
+	{
+		SampleFormat sampleFormat{ SampleFormat::Pcm };
+		uint16_t channels{ 0 };
+		uint32_t sampleRate{ 0 };
+		uint16_t bitsPerSample{ 0 };
+		uint16_t blockAlign{ 0 };
+	};
+
+	/// <summary>
+	/// Validates the image and takes ownership of it.
+	/// On failure, the object is left empty and `error` describes the problem.
+	/// </summary>
+	bool Load(std::vector<uint8_t>&& image, std::string& error);
+
+	/// <summary>
+	/// Scales all samples by `volume`, clamped to [0, 1]
+	/// </summary>
+	void ScaleVolume(float volume);
+
+	void Clear();
+
+	inline bool IsEmpty() const noexcept
+	{
+		return m_image.empty();
+	}
+
+	inline std::vector<uint8_t> const& GetImage() const noexcept
+	{
+		return m_image;
+	}
+
+	inline Format const& GetFormat() const noexcept
+	{
+		return m_format;
+	}
+
+	/// <summary>
+	/// Size of the sample data in bytes
+	/// </summary>
+	inline size_t GetDataSize() const noexcept
+	{
+		return m_dataSize;
+	}
+
+private:
+	std::vector<uint8_t> m_image;
+	Format m_format;
+	size_t m_dataOffset{ 0 };
+	size_t m_dataSize{ 0 };
+};
@@ -0,0 +1,559 @@
+#include "pch.h"
+#include "YamlConfigBinder.h"
+#include "StringUtils.h"
+#include "SimpleLog/SimpleLog.hpp"
+
+#include <yaml.h>
+
+#include <algorithm>
+#include <string_view>
+
+namespace
+{
+
+	class YamlParser
+	{
+	public:
+		YamlParser(sgrottel::ISimpleLog& log)
+			: m_init{ false }
+		{
+			if (yaml_parser_initialize(&m_parser) == 0)
+			{
+				log.Error("Failed to yaml_parser_initialize");
+				return;
+			}
+			m_init = true;
+		}
+
+		~YamlParser()
+		{
+			if (m_init)
+			{
+				yaml_parser_delete(&m_parser);
+			}
+		}
+
+		void SetInputString(const uint8_t* data, size_t size)
+		{
+			if (!m_init) throw std::logic_error("Parser not initialized");
+			static const unsigned char empty[1] = { 0 };
+			yaml_parser_set_input_string(&m_parser, (data != nullptr) ? data : empty, size);
+		}
+
+		inline yaml_parser_t& Get()
+		{
+			return m_parser;
+		}
+
+	private:
+		bool m_init;
+		yaml_parser_t m_parser;
+	};
+
+	/// <summary>
+	/// Pulls one event at a time from the parser. Only the current event is kept alive.
+	/// </summary>
+	class EventStream
+	{
+	public:
+		EventStream(yaml_parser_t& parser)
+			: m_parser{ parser }, m_valid{ false }
+		{
+			// intentionally empty
+		}
+
+		~EventStream()
+		{
+			Release();
+		}
+
+		yaml_event_t const& Next()
+		{
+			Release();
+			if (!yaml_parser_parse(&m_parser, &m_event))
+			{
+				ThrowParserError();
+			}
+			m_valid = true;
+
+			if (m_event.type == YAML_ALIAS_EVENT)
+			{
+				throw wruntime_error{
+					L"(line: "
+					+ std::to_wstring(m_event.start_mark.line + 1)
+					+ L", col: "
+					+ std::to_wstring(m_event.start_mark.column + 1)
+					+ L") Yaml anchors are not supported" };
+			}
+
+			return m_event;
+		}
+
+		inline yaml_event_t const& Current() const
+		{
+			return m_event;
+		}
+
+	private:
+		void Release()
+		{
+			if (m_valid)
+			{
+				yaml_event_delete(&m_event);
+				m_valid = false;
+			}
+		}
+
+		[[noreturn]] void ThrowParserError() const;
+
+		yaml_parser_t& m_parser;
+		yaml_event_t m_event;
+		bool m_valid;
+	};
+
+	void EventStream::ThrowParserError() const
+	{
+		std::wstring error;
+		switch (m_parser.error)
+		{
+		case YAML_NO_ERROR:
+			error += L"No error is produced.";
+			break;
+		case YAML_MEMORY_ERROR:
+			error += L"Cannot allocate or reallocate a block of memory.";
+			break;
+		case YAML_READER_ERROR:
+			error += L"Cannot read or decode the input stream.";
+			break;
+		case YAML_SCANNER_ERROR:
+			error += L"Cannot scan the input stream.";
+			break;
+		case YAML_PARSER_ERROR:
+			error += L"Cannot parse the input stream.";
+			break;
+		case YAML_COMPOSER_ERROR:
+			error += L"Cannot compose a YAML document.";
+			break;
+		case YAML_WRITER_ERROR:
+			error += L"Cannot write to the output stream.";
+			break;
+		case YAML_EMITTER_ERROR:
+			error += L"Cannot emit a YAML stream.";
+			break;
+		default:
+			error += L"Unspecific error";
+			break;
+		}
+		error += L"\n";
+		error += ToW(m_parser.problem);
+		error += L"\n\tat line "
+			+ std::to_wstring(m_parser.problem_mark.line + 1)
+			+ L", pos "
+			+ std::to_wstring(m_parser.problem_mark.column + 1);
+		throw wruntime_error{ error };
+	}
+
+	[[noreturn]] void ThrowAt(yaml_mark_t const& mark, std::string const& error)
+	{
+		throw YamlElementReferenceException{
+			mark.line + 1,
+			mark.column + 1,
+			std::invalid_argument(error)
+		};
+	}
+
+	inline std::string_view ScalarValue(yaml_event_t const& e)
+	{
+		return std::string_view{ reinterpret_cast<const char*>(e.data.scalar.value), e.data.scalar.length };
+	}
+
+	/// <summary>
+	/// Skips the value starting at the current event.
+	/// On return, the current event is the last event of that value.
+	/// </summary>
+	void SkipValue(EventStream& s)
+	{
+		int depth = 0;
+		for (;;)
+		{
+			switch (s.Current().type)
+			{
+			case YAML_SEQUENCE_START_EVENT:
+			case YAML_MAPPING_START_EVENT:
+				++depth;
+				break;
+			case YAML_SEQUENCE_END_EVENT:
+			case YAML_MAPPING_END_EVENT:
+				--depth;
+				break;
+			default:
+				break;
+			}
+			if (depth <= 0) return;
+			s.Next();
+		}
+	}
+
+	/// <summary>
+	/// Calls `onEntry(key)` for each entry of the mapping starting at the current event.
+	/// `onEntry` is called with the value's first event being current, and must consume the whole value.
+	/// </summary>
+	template<typename FN>
+	void ForEachMappingEntry(EventStream& s, FN&& onEntry)
+	{
+		while (s.Next().type != YAML_MAPPING_END_EVENT)
+		{
+			if (s.Current().type != YAML_SCALAR_EVENT) ThrowAt(s.Current().start_mark, "Expected scalar values for mapping key");
+			const std::string key{ ScalarValue(s.Current()) };
+			s.Next();
+			onEntry(key);
+		}
+	}
+
+	/// <summary>
+	/// Calls `onItem()` for each item of the sequence starting at the current event.
+	/// </summary>
+	template<typename FN>
+	void ForEachSequenceItem(EventStream& s, FN&& onItem)
+	{
+		while (s.Next().type != YAML_SEQUENCE_END_EVENT)
+		{
+			onItem();
+		}
+	}
+
+	std::wstring ReadScalar(EventStream& s, const char* name)
+	{
+		if (s.Current().type != YAML_SCALAR_EVENT) ThrowAt(s.Current().start_mark, std::string{ name } + " must be a scalar value");
+		return ToW(s.Current().data.scalar.value);
+	}
+
+	bool ReadBool(EventStream& s, std::string const& key, bool defValue)
+	{
+		if (s.Current().type == YAML_SCALAR_EVENT)
+		{
+			std::string str{ ScalarValue(s.Current()) };
+			if (str.empty()) return defValue;
+
+			std::transform(str.begin(), str.end(), str.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+			if (str == "true") return true;
+			if (str == "false") return false;
+			if (str == "on") return true;
+			if (str == "off") return false;
+			if (str == "yes") return true;
+			if (str == "no") return false;
+			if (str == "0") return false;
+
+			bool isNonNullNumber = true;
+			bool allNull = true;
+			for (char c : str)
+			{
+				if (c < '0' || c > '9')
+				{
+					isNonNullNumber = false;
+					break;
+				}
+				else if (c != '0')
+				{
+					allNull = false;
+				}
+			}
+			if (allNull) isNonNullNumber = false;
+			if (isNonNullNumber) return true;
+		}
+
+		ThrowAt(s.Current().start_mark, "Entry `" + key + "` must be a boolean value");
+	}
+
+	uint32_t ReadUInt(EventStream& s, const char* name)
+	{
+		const std::wstring str = ReadScalar(s, name);
+		wchar_t* strEnd = nullptr;
+		const unsigned long value = std::wcstoul(str.c_str(), &strEnd, 10);
+		if (str.empty() || str[0] < L'0' || str[0] > L'9'
+			|| strEnd == nullptr || *strEnd != L'\0' || value > UINT32_MAX)
+		{
+			ThrowAt(s.Current().start_mark, std::string{ name } + " must be a non-negative number");
+		}
+		return static_cast<uint32_t>(value);
+	}
+
+	void BindResolveArgPath(EventStream& s, HotKeyConfig& key)
+	{
+		if (s.Current().type != YAML_MAPPING_START_EVENT) ThrowAt(s.Current().start_mark, "Entry in`globalhotkeys.resolveargspaths` must be a mappings");
+		const yaml_mark_t entryMark = s.Current().start_mark;
+
+		bool hasPos = false;
+		uint32_t pos = 0;
+		HotKeyConfig::ResolveArgConfig cfg;
+
+		ForEachMappingEntry(s, [&](std::string const& k)
+			{
+				if (k == "pos")
+				{
+					const std::wstring posStr = ReadScalar(s, "`globalhotkeys.resolveargspaths[].pos`");
+					const wchar_t* str = posStr.c_str();
+					wchar_t* strEnd = nullptr;
+					pos = std::wcstoul(str, &strEnd, 10);
+					if (strEnd == nullptr || strEnd == str) ThrowAt(s.Current().start_mark, "`globalhotkeys.resolveargspaths[].pos` must be a number");
+					hasPos = true;
+				}
+				else if (k == "isrelexepath")
+				{
+					cfg.isRelPath = ReadBool(s, k, false);
+				}
+				else
+				{
+					SkipValue(s);
+				}
+			});
+
+		if (!hasPos) ThrowAt(entryMark, "Entry in`globalhotkeys.resolveargspaths` must have a `pos` entry");
+
+		key.resolveArgsPaths.insert(std::make_pair(pos, std::move(cfg)));
+	}
+
+	void BindHotKey(EventStream& s, std::vector<HotKeyConfig>& outHotKeys)
+	{
+		if (s.Current().type != YAML_MAPPING_START_EVENT) ThrowAt(s.Current().start_mark, "Entries in `globalhotkeys` must be mappings");
+		const yaml_mark_t entryMark = s.Current().start_mark;
+
+		HotKeyConfig key;
+		key.sourceLine = static_cast<uint32_t>(entryMark.line + 1);
+		key.sourceColumn = static_cast<uint32_t>(entryMark.column + 1);
+		bool hasCode = false;
+		bool hasExec = false;
+		bool hasAction = false;
+
+		ForEachMappingEntry(s, [&](std::string const& k)
+			{
+				if (k == "code")
+				{
+					const std::wstring codeStr = ReadScalar(s, "`globalhotkeys.code`");
+					uint32_t code = HotKeyConfig::ParseVirtualKeyCode(codeStr);
+					if (code == HotKeyConfig::c_invalidVirtualKeyCode)
+					{
+						ThrowAt(s.Current().start_mark,
+							"Failed to parse `globalhotkeys.code: "
+							+ ToA(codeStr)
+							+ "` as Virtual-Key code");
+					}
+					key.virtualKeyCode = code;
+					hasCode = true;
+				}
+				else if (k == "alt")
+				{
+					key.modAlt = ReadBool(s, k, false);
+				}
+				else if (k == "ctrl")
+				{
+					key.modCtrl = ReadBool(s, k, false);
+				}
+				else if (k == "shift")
+				{
+					key.modShift = ReadBool(s, k, false);
+				}
+				else if (k == "exec")
+				{
+					key.executable = ReadScalar(s, "`globalhotkeys.exec`");
+					hasExec = true;
+				}
+				else if (k == "action")
+				{
+					key.action = ReadScalar(s, "`globalhotkeys.action`");
+					hasAction = true;
+				}
+				else if (k == "workdir")
+				{
+					key.workingDirectory = ReadScalar(s, "`globalhotkeys.workdir`");
+				}
+				else if (k == "args")
+				{
+					if (s.Current().type != YAML_SEQUENCE_START_EVENT) ThrowAt(s.Current().start_mark, "`globalhotkeys.args` must be a sequence");
+					key.arguments.clear();
+					ForEachSequenceItem(s, [&]()
+						{
+							if (s.Current().type != YAML_SCALAR_EVENT) ThrowAt(s.Current().start_mark, "Entry in `globalhotkeys.args` must be a scalar value");
+							key.arguments.push_back(ToW(s.Current().data.scalar.value));
+						});
+				}
+				else if (k == "isrelexepath")
+				{
+					key.isRelExePath = ReadBool(s, k, false);
+				}
+				else if (k == "nofilecheck")
+				{
+					key.noFileCheck = ReadBool(s, k, false);
+				}
+				else if (k == "createnowindow")
+				{
+					key.createNoWindow = ReadBool(s, k, true);
+				}
+				else if (k == "cooldown")
+				{
+					key.cooldownMs = ReadUInt(s, "`globalhotkeys.cooldown`");
+				}
+				else if (k == "coalesce")
+				{
+					key.coalesce = ReadBool(s, k, false);
+				}
+				else if (k == "max-concurrent")
+				{
+					key.maxConcurrent = ReadUInt(s, "`globalhotkeys.max-concurrent`");
+				}
+				else if (k == "single-instance")
+				{
+					key.singleInstance = ReadBool(s, k, false);
+				}
+				else if (k == "resolveargspaths")
+				{
+					if (s.Current().type != YAML_SEQUENCE_START_EVENT) ThrowAt(s.Current().start_mark, "`globalhotkeys.resolveargspaths` must be a sequence");
+					key.resolveArgsPaths.clear();
+					ForEachSequenceItem(s, [&]() { BindResolveArgPath(s, key); });
+				}
+				else
+				{
+					SkipValue(s);
+				}
+			});
+
+		if (!hasCode) ThrowAt(entryMark, "Entry in `globalhotkeys` must contain `code`");
+		if (!hasExec && !hasAction) ThrowAt(entryMark, "Entry in `globalhotkeys` must contain `exec` or `action`");
+		if (hasExec && hasAction) ThrowAt(entryMark, "Entry in `globalhotkeys` must not contain both `exec` and `action`");
+
+		outHotKeys.push_back(std::move(key));
+	}
+
+	void BindProfile(EventStream& s, YamlConfigBinder::Result& result)
+	{
+		if (s.Current().type != YAML_MAPPING_START_EVENT) ThrowAt(s.Current().start_mark, "Entries in `profiles` must be mappings");
+		const yaml_mark_t entryMark = s.Current().start_mark;
+
+		HotKeyProfile profile;
+		std::vector<HotKeyConfig> hotKeys;
+
+		ForEachMappingEntry(s, [&](std::string const& k)
+			{
+				if (k == "name")
+				{
+					profile.name = ReadScalar(s, "`profiles.name`");
+				}
+				else if (k == "applications")
+				{
+					profile.applications.clear();
+					if (s.Current().type == YAML_SEQUENCE_START_EVENT)
+					{
+						ForEachSequenceItem(s, [&]() { profile.applications.push_back(ReadScalar(s, "Entry in `profiles.applications`")); });
+					}
+					else
+					{
+						profile.applications.push_back(ReadScalar(s, "`profiles.applications`"));
+					}
+				}
+				else if (k == "globalhotkeys")
+				{
+					if (s.Current().type != YAML_SEQUENCE_START_EVENT) ThrowAt(s.Current().start_mark, "`profiles.globalhotkeys` must be an array");
+					hotKeys.clear();
+					ForEachSequenceItem(s, [&]() { BindHotKey(s, hotKeys); });
+				}
+				else
+				{
+					SkipValue(s);
+				}
+			});
+
+		if (profile.name.empty()) ThrowAt(entryMark, "Entry in `profiles` must contain `name`");
+		for (HotKeyProfile const& p : result.profiles)
+		{
+			if (p.name == profile.name) ThrowAt(entryMark, "Profile name `" + ToA(profile.name) + "` is used more than once");
+		}
+
+		for (HotKeyConfig& hk : hotKeys)
+		{
+			hk.profile = profile.name;
+			result.hotKeys.push_back(std::move(hk));
+		}
+		result.profiles.push_back(std::move(profile));
+	}
+
+}
+
+YamlConfigBinder::YamlConfigBinder(sgrottel::ISimpleLog& log)
+	: m_log{ log }
+{
+	// intentionally empty
+}
+
+YamlConfigBinder::Result YamlConfigBinder::Bind(const uint8_t* data, size_t size)
+{
+	YamlParser parser{ m_log };
+	parser.SetInputString(data, size);
+
+	EventStream s{ parser.Get() };
+
+	// skip stream and document start; only the first document is used
+	while (s.Next().type == YAML_STREAM_START_EVENT || s.Current().type == YAML_DOCUMENT_START_EVENT)
+	{
+		// intentionally empty
+	}
+	if (s.Current().type == YAML_STREAM_END_EVENT) throw std::invalid_argument("Failed to parse configuration file: returned empty");
+	if (s.Current().type != YAML_MAPPING_START_EVENT) throw std::invalid_argument("Configuration file root element is expected to be a mapping");
+
+	Result result;
+	bool hasHotKeys = false;
+
+	ForEachMappingEntry(s, [&](std::string const& k)
+		{
+			if (k == "bell")
+			{
+				result.bell = ReadBool(s, k, true);
+			}
+			else if (k == "custom-bell-file")
+			{
+				result.customBellFile = ReadScalar(s, "`custom-bell-file`");
+			}
+			else if (k == "bell-volume")
+			{
+				const std::wstring str = ReadScalar(s, "`bell-volume`");
+				wchar_t* strEnd = nullptr;
+				const double volume = std::wcstod(str.c_str(), &strEnd);
+				if (str.empty() || strEnd == nullptr || *strEnd != L'\0' || !(volume >= 0.0 && volume <= 1.0))
+				{
+					ThrowAt(s.Current().start_mark, "`bell-volume` must be a number between 0 and 1");
+				}
+				result.bellVolume = static_cast<float>(volume);
+			}
+			else if (k == "globalhotkeys")
+			{
+				if (s.Current().type != YAML_SEQUENCE_START_EVENT) ThrowAt(s.Current().start_mark, "`globalhotkeys` must be an array");
+				ForEachSequenceItem(s, [&]() { BindHotKey(s, result.hotKeys); });
+				hasHotKeys = true;
+			}
+			else if (k == "profiles")
+			{
+				if (s.Current().type != YAML_SEQUENCE_START_EVENT) ThrowAt(s.Current().start_mark, "`profiles` must be an array");
+				ForEachSequenceItem(s, [&]() { BindProfile(s, result); });
+			}
+			else if (k == "include")
+			{
+				result.includes.clear();
+				if (s.Current().type == YAML_SEQUENCE_START_EVENT)
+				{
+					ForEachSequenceItem(s, [&]() { result.includes.push_back(ReadScalar(s, "Entry in `include`")); });
+				}
+				else
+				{
+					result.includes.push_back(ReadScalar(s, "`include`"));
+				}
+			}
+			else
+			{
+				SkipValue(s);
+			}
+		});
+
+	// a file only including fragments, or only defining profiles, does not need own hot keys
+	if (!hasHotKeys && result.profiles.empty() && result.includes.empty()) throw std::invalid_argument("Entry `globalhotkeys` not found");
+
+	return result;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "HotKeyConfig.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sgrottel {
+	class ISimpleLog;
+}
+
+class wruntime_error : public std::runtime_error {
+public:
+	wruntime_error(const std::wstring& msg) : std::runtime_error("Error!"), message(msg) {};
+	~wruntime_error() throw() {};
+
+	std::wstring const& get_message() const { return message; }
+
+private:
+	std::wstring message;
+};
+
+/// <summary>
+/// Error referencing a position within the yaml input (1-based)
+/// </summary>
+struct YamlElementReferenceException
+{
+	size_t line;
+	size_t column;
+	// not sliced to `std::exception`, which only keeps the message with the MSVC runtime
+	std::invalid_argument innerException;
+};
+
+/// <summary>
+/// Binds the libyaml event stream of a configuration file directly into `HotKeyConfig` objects,
+/// without building an intermediate document tree.
+/// </summary>
+class YamlConfigBinder
+{
+public:
+	struct Result
+	{
+		bool bell{ true };
+		std::filesystem::path customBellFile{};
+		// scale of the custom bell sound, [0, 1]
+		float bellVolume{ 1.0f };
+		std::vector<HotKeyConfig> hotKeys{};
+		std::vector<HotKeyProfile> profiles{};
+		// files or globbed directories listed in `include`, as written
+		std::vector<std::wstring> includes{};
+	};
+
+	YamlConfigBinder(sgrottel::ISimpleLog& log);
+
+	/// <summary>
+	/// Parses the yaml document from the memory buffer.
+	/// Entries of `include` are only collected, not loaded; see `ConfigFragments`.
+	/// Throws `YamlElementReferenceException`, `wruntime_error`, or `std::exception` on errors.
+	/// </summary>
+	Result Bind(const uint8_t* data, size_t size);
+
+private:
+	sgrottel::ISimpleLog& m_log;
+};
@@ -7,28 +7,9 @@ $file = Get-Content $WinUserH -Raw
 $selection = $file | Select-String '(?smi)#ifndef\s+NOVIRTUALKEYCODES(.+)#endif\s*/\*\s*!NOVIRTUALKEYCODES\s*\*/' -AllMatches | ForEach-Object { $_.Matches.Groups[1].Value } | Out-String
 $lines = $selection.Split([Environment]::NewLine) | Where-Object {$_.Trim().StartsWith('#')}
 
-# generate content for `ParseVirtualKeyCode` 1
+# generate content for the `c_entries` table in `VirtualKeyNames.cpp`;
+# codes are written as literals, so the table builds without `Winuser.h`
+# and does not depend on the `_WIN32_WINNT` conditions around them
 Write-Host
-$lines | ForEach-Object { if ($_ -match "#define\s+VK_(\S+)\s+(\S+)\s*") { "`tif (str == L`"$($matches[1].ToLower())`") { return VK_$($matches[1]); }" } else { $_ } }
-Write-Host
-
-# generate content for `ParseVirtualKeyCode` 2
-Write-Host
-$lines | ForEach-Object { if ($_ -match "#define\s+VK_(\S+)\s+(\S+)\s*") { if ($matches[1].StartsWith("OEM_")) { `
-	"if (static_cast<wchar_t>(MapVirtualKeyW(VK_$($matches[1]), MAPVK_VK_TO_CHAR)) == str[0]) { return VK_$($matches[1]); }" `
-} } else { $_ } }
-Write-Host
-
-# generate content for `GetKeyWString` 1
-Write-Host
-$lines | ForEach-Object { if ($_ -match "#define\s+VK_(\S+)\s+(\S+)\s*") { if (-not ($matches[1].StartsWith("OEM_"))) { `
-	"case VK_$($matches[1]): str = L`"$($matches[1].ToLower())`"; break;" `
-} } else { $_ } }
-Write-Host
-
-# generate content for `GetKeyWString` 2
-Write-Host
-$lines | ForEach-Object { if ($_ -match "#define\s+VK_(\S+)\s+(\S+)\s*") { if ($matches[1].StartsWith("OEM_")) { `
-	"case VK_$($matches[1]): str = L`"$($matches[1].ToLower())`"; break;" `
-} } else { $_ } }
+$lines | ForEach-Object { if ($_ -match "#define\s+VK_(\S+)\s+(\S+)\s*") { "`t`t{ L`"$($matches[1].ToLower())`", $($matches[2]) }," } }
 Write-Host
@@ -1,8 +1,11 @@
 #pragma once
 
+// sources without platform dependencies are also built by the tests in `../tests`
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #define VC_EXTRALEAN
 #include <Windows.h>
+#endif
 
 #include "SimpleLog/SimpleLog.hpp"
 
@@ -17,6 +17,8 @@
 //
 #include "BringHWndToFront.h"
 
+#include "../_shared/WindowQuery/WindowQuery.h"
+
 #define VC_EXTRALEAN
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
@@ -175,96 +177,84 @@ struct PreStartInfo* PrepareMainWndDetectionA(const char* executable)
 	return rv;
 }
 
-struct WindowOfProcessImageNameSearch
+#define MAX_PROCESSIDS_SIZE 1024
+
+struct WindowOfProcessIdSearch
 {
-	const wchar_t* path;
-	struct WindowList* windows;
+	uint32_t processIds[MAX_PROCESSIDS_SIZE];
+	unsigned int processIdsCount;
+	HWND hWnd;
 };
 
-static BOOL FindWindowsForProcess(HWND hWnd, struct WindowOfProcessImageNameSearch* search)
+struct PreStartInfo* PrepareMainWndDetectionW(const wchar_t* executable)
 {
-	DWORD procId;
-	HANDLE proc;
-	wchar_t moduleName[MAX_PATH + 1];
-	DWORD moduleNameLen;
+	struct WQSnapshot snapshot;
+	struct WQQuery query;
+	WQWindow* found;
+	size_t foundCount, i;
+	struct WindowList* windows = NULL;
+	struct WindowList* w;
 
-	if (!IsWindowVisible(hWnd))
+	// enumerate top-level windows
+	if (!WQSnapshotTake(&snapshot, WQGetWin32Provider(), 0))
 	{
-		// skip invisible windows, as they are not for user interaction
-		return TRUE;
+		WQSnapshotFree(&snapshot);
+		return NULL;
 	}
 
-	GetWindowThreadProcessId(hWnd, &procId);
-	proc = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_VM_READ, FALSE, procId);
-	if (proc == NULL)
+	// skip invisible windows, as they are not for user interaction;
+	// the process image is only queried for visible windows, once per process
+	WQQueryInit(&query);
+	WQQueryVisible(&query);
+	WQQueryProcessImage(&query, executable);
+
+	found = (WQWindow*)malloc((snapshot.count + 1) * sizeof(WQWindow));
+	if (found == NULL)
 	{
-		return TRUE;
+		WQSnapshotFree(&snapshot);
+		return NULL;
 	}
+	foundCount = WQQueryRun(&query, &snapshot, found, snapshot.count);
+	WQSnapshotFree(&snapshot);
 
-	moduleNameLen = sizeof(moduleName);
-	if (QueryFullProcessImageNameW(proc, 0, moduleName, &moduleNameLen))
+	for (i = 0; i < foundCount; ++i)
 	{
-		moduleName[moduleNameLen] = 0;
-		if (_wcsicmp(moduleName, search->path) == 0)
-		{
-			struct WindowList* w = (struct WindowList*)malloc(sizeof(struct WindowList));
-			w->hWnd = hWnd;
-			w->depth = WindowZ(hWnd);
-			memset(w->title, 0, MAX_PATH + 1 * sizeof(wchar_t));
-			GetWindowTextW(hWnd, w->title, MAX_PATH);
-			w->next = search->windows;
-			search->windows = w;
-		}
+		w = (struct WindowList*)malloc(sizeof(struct WindowList));
+		if (w == NULL) break;
+		w->hWnd = (HWND)found[i];
+		w->depth = WindowZ(w->hWnd);
+		memset(w->title, 0, (MAX_PATH + 1) * sizeof(wchar_t));
+		GetWindowTextW(w->hWnd, w->title, MAX_PATH);
+		w->next = windows;
+		windows = w;
 	}
+	free(found);
 
-	CloseHandle(proc);
-	return TRUE;
-}
-
-#define MAX_PROCESSIDS_SIZE 1024
-
-struct WindowOfProcessIdSearch
-{
-	DWORD processIds[MAX_PROCESSIDS_SIZE];
-	unsigned int processIdsCount;
-	HWND hWnd;
-};
+	struct PreStartInfo* retval;
+	retval = (struct PreStartInfo*)malloc(sizeof(struct PreStartInfo));
+	retval->windows = windows;
 
-static BOOL FindWindowsForProcessId(HWND hWnd, struct WindowOfProcessIdSearch* search)
-{
-	DWORD procId;
-	unsigned int i;
-	if (!IsWindowVisible(hWnd))
-	{
-		// skip invisible windows, as they are not for user interaction
-		return TRUE;
-	}
-	GetWindowThreadProcessId(hWnd, &procId);
-	for (i = 0; i < search->processIdsCount; ++i)
-	{
-		if (procId == search->processIds[i])
-		{
-			search->hWnd = hWnd;
-			return FALSE;
-		}
-	}
-	return TRUE;
+	return retval;
 }
 
-struct PreStartInfo* PrepareMainWndDetectionW(const wchar_t* executable)
+static HWND FindWindowOfProcessIds(const struct WindowOfProcessIdSearch* search)
 {
-	struct WindowOfProcessImageNameSearch searchInfo;
-	searchInfo.path = executable;
-	searchInfo.windows = NULL;
+	struct WQSnapshot snapshot;
+	struct WQQuery query;
+	WQWindow found = 0;
 
-	// enumerate top-level windows
-	EnumWindows((WNDENUMPROC)&FindWindowsForProcess, (LPARAM)&searchInfo);
+	// skip invisible windows, as they are not for user interaction
+	WQQueryInit(&query);
+	WQQueryProcessIdIn(&query, search->processIds, search->processIdsCount);
+	WQQueryVisible(&query);
 
-	struct PreStartInfo* retval;
-	retval = (struct PreStartInfo*)malloc(sizeof(struct PreStartInfo));
-	retval->windows = searchInfo.windows;
+	if (WQSnapshotTake(&snapshot, WQGetWin32Provider(), 0))
+	{
+		WQQueryRun(&query, &snapshot, &found, 1);
+	}
+	WQSnapshotFree(&snapshot);
 
-	return retval;
+	return (HWND)found;
 }
 
 HWND DetectNewMainWnd(unsigned int processId, struct PreStartInfo* preStart, int timeOutMs)
@@ -292,8 +282,7 @@ HWND DetectNewMainWnd(unsigned int processId, struct PreStartInfo* preStart, int
 		Sleep(sleepTimeMs);
 
 		// check for visible main window of new process
-		procIdWndSearch.hWnd = NULL;
-		EnumWindows((WNDENUMPROC)&FindWindowsForProcessId, (LPARAM)&procIdWndSearch);
+		procIdWndSearch.hWnd = FindWindowOfProcessIds(&procIdWndSearch);
 		if (procIdWndSearch.hWnd != NULL)
 		{
 			hWnd = procIdWndSearch.hWnd;
@@ -0,0 +1,103 @@
+// HWndToFront
+// Freely available via Apache License, v2.0; see LICENSE file
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "CmdLine.h"
+
+#include "../_shared/CommandLine/CommandLine.h"
+
+#include <stdlib.h>
+#include <wctype.h>
+
+wchar_t* BuildCmdLine(const wchar_t* cmd, const wchar_t* const* args, int argsCnt)
+{
+	const wchar_t* exeStr;
+	size_t exeLen;
+	size_t len;
+	size_t fullLen;
+	size_t j;
+	int i;
+	int hasSpace;
+	wchar_t* str;
+	wchar_t* pos;
+
+	// extract cmd file name
+	if (cmd == NULL)
+	{
+		return NULL;
+	}
+	len = wcslen(cmd);
+	exeStr = cmd;
+	exeLen = len;
+
+	for (j = 0; j + 1 < len; ++j)
+	{
+		if (cmd[j] == L'\\' || cmd[j] == L'/')
+		{
+			exeStr = cmd + j + 1;
+			exeLen = len - j - 1;
+		}
+	}
+
+	// the program name ends at whitespace outside of quotes; file names cannot contain quotes
+	hasSpace = 0;
+	for (j = 0; j < exeLen; ++j)
+	{
+		if (iswspace(exeStr[j]))
+		{
+			hasSpace = 1;
+			break;
+		}
+	}
+
+	// calc length of full command line, then write it in one pass
+	fullLen = exeLen + (hasSpace ? 2 : 0);
+	for (i = 0; i < argsCnt; i++)
+	{
+		fullLen += 1 + CLArgumentLength(args[i], wcslen(args[i]));
+	}
+	fullLen++;
+
+	str = (wchar_t*)malloc(fullLen * sizeof(wchar_t));
+	if (str == NULL)
+	{
+		return NULL;
+	}
+	pos = str;
+
+	if (hasSpace)
+	{
+		*pos = L'"';
+		pos++;
+	}
+	wmemcpy(pos, exeStr, exeLen);
+	pos += exeLen;
+	if (hasSpace)
+	{
+		*pos = L'"';
+		pos++;
+	}
+
+	for (i = 0; i < argsCnt; i++)
+	{
+		*pos = L' ';
+		pos++;
+		pos = CLWriteArgument(args[i], wcslen(args[i]), pos);
+	}
+	*pos = 0;
+
+	return str;
+}
@@ -0,0 +1,37 @@
+// HWndToFront
+// Freely available via Apache License, v2.0; see LICENSE file
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _CmdLine_h_included_
+#define _CmdLine_h_included_
+#pragma once
+
+#include <wchar.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Builds the command line for `CreateProcessW` from the file name of `cmd` and the arguments,
+// quoted by `CLWriteArgument`, so the C runtime and `CommandLineToArgvW` split them back into exactly these arguments.
+// Has no platform dependencies. Returns a string allocated with `malloc`, or NULL.
+wchar_t* BuildCmdLine(const wchar_t* cmd, const wchar_t* const* args, int argsCnt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CmdLine_h_included_ */
@@ -16,6 +16,7 @@
 // limitations under the License.
 //
 #include "BringHWndToFront.h"
+#include "CmdLine.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -172,169 +173,6 @@ BOOL parseArg(int argc, wchar_t const* argv[], struct Config* outConfig)
 	return TRUE;
 }
 
-wchar_t* BuildCmdLine(const struct Config* config)
-{
-	const wchar_t* exeStr = L"dummy";
-	size_t exeLen = 5;
-	size_t len;
-	size_t fullLen;
-	size_t j;
-	int i;
-	int cntEsc;
-	BOOL hasSpace;
-	wchar_t c;
-	wchar_t* str;
-	wchar_t* pos;
-
-	// extract cmd file name
-	if (config->cmd == NULL)
-	{
-		return NULL;
-	}
-	len = wcslen(config->cmd);
-	exeStr = config->cmd;
-
-	hasSpace = FALSE;
-	cntEsc = 0;
-
-	for (j = 0; j < len - 1; ++j)
-	{
-		c = config->cmd[j];
-		if (c == L'\\' || c == L'/')
-		{
-			exeStr = config->cmd + j + 1;
-			exeLen = len - j - 1;
-			hasSpace = FALSE;
-			cntEsc = 0;
-		}
-		else if (iswspace(c))
-		{
-			hasSpace = TRUE;
-		}
-		else if (c == L'"')
-		{
-			hasSpace = TRUE;
-			cntEsc++;
-		}
-	}
-
-	fullLen = exeLen;
-	if (hasSpace)
-	{
-		fullLen += 2 + cntEsc;
-	}
-
-	// calc length of argument list
-	for (i = 0; i < config->argsCnt; i++)
-	{
-		len = wcslen(config->args[i]);
-
-		hasSpace = FALSE;
-		cntEsc = 0;
-
-		for (j = 0; j < len; ++j)
-		{
-			c = config->args[i][j];
-			if (iswspace(c))
-			{
-				hasSpace = TRUE;
-			}
-			else if (c == L'"')
-			{
-				hasSpace = TRUE;
-				cntEsc++;
-			}
-		}
-
-		fullLen += 1 + len;
-		if (hasSpace)
-		{
-			fullLen += 2 + cntEsc;
-		}
-
-	}
-
-	fullLen++;
-	str = (wchar_t*)malloc(fullLen * sizeof(wchar_t));
-	if (str == NULL)
-	{
-		return NULL;
-	}
-	memset(str, 0, fullLen * sizeof(wchar_t));
-	pos = str;
-
-	hasSpace = FALSE;
-	for (j = 0; j < exeLen; ++j)
-	{
-		if (iswspace(exeStr[j]))
-		{
-			hasSpace = TRUE;
-			break;
-		}
-	}
-
-	if (hasSpace)
-	{
-		*pos = L'"';
-		pos++;
-	}
-	for (j = 0; j < exeLen; ++j)
-	{
-		if (exeStr[j] == L'"')
-		{
-			*pos = L'\\';
-			pos++;
-		}
-		*pos = exeStr[j];
-		pos++;
-	}
-	if (hasSpace)
-	{
-		*pos = L'"';
-		pos++;
-	}
-
-	for (i = 0; i < config->argsCnt; i++)
-	{
-		len = wcslen(config->args[i]);
-		hasSpace = FALSE;
-		for (j = 0; j < len; ++j)
-		{
-			if (iswspace(config->args[i][j]))
-			{
-				hasSpace = TRUE;
-				break;
-			}
-		}
-
-		*pos = L' ';
-		pos++;
-		if (hasSpace)
-		{
-			*pos = L'"';
-			pos++;
-		}
-		for (j = 0; j < len; ++j)
-		{
-			if (config->args[i][j] == L'"')
-			{
-				*pos = L'\\';
-				pos++;
-			}
-			*pos = config->args[i][j];
-			pos++;
-		}
-		if (hasSpace)
-		{
-			*pos = L'"';
-			pos++;
-		}
-
-	}
-
-	return str;
-}
-
 unsigned int Start(const struct Config* config)
 {
 	STARTUPINFOW si;
@@ -352,7 +190,7 @@ unsigned int Start(const struct Config* config)
 
 	ZeroMemory(&pi, sizeof(PROCESS_INFORMATION));
 
-	cmdLine = BuildCmdLine(config);
+	cmdLine = BuildCmdLine(config->cmd, config->args, config->argsCnt);
 
 	BOOL cpr = CreateProcessW(
 		config->cmd,
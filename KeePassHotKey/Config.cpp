@@ -16,6 +16,7 @@
 // limitations under the License.
 //
 #include "Config.h"
+#include "InstanceControl.h"
 
 #include "TraceFile.h"
 
@@ -94,6 +95,16 @@ namespace {
 		return b != false;
 	}
 
+	bool getRegistryWriteTime(const TCHAR* keyName, FILETIME& outTime) {
+		HKEY key;
+		if (RegOpenKeyEx(HKEY_CURRENT_USER, keyName, 0, KEY_QUERY_VALUE, &key) != ERROR_SUCCESS) {
+			return false;
+		}
+		LSTATUS rr = RegQueryInfoKey(key, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, &outTime);
+		RegCloseKey(key);
+		return rr == ERROR_SUCCESS;
+	}
+
 }
 
 void Config::init(const TCHAR* cmdLine) {
@@ -217,13 +228,62 @@ void Config::init(const TCHAR* cmdLine) {
 	}
 #pragma endregion
 
+#pragma region -resident (off|on)
+	isMatch = std::regex_match(
+		cmdLine,
+		result,
+		std::basic_regex<TCHAR>{
+		_T(R"(\s*(?:-{1,2}|/)resident\s+(\S+).*)"),
+			std::regex_constants::ECMAScript | std::regex_constants::icase}
+	);
+	if (isMatch) {
+		_tstring flag = result[1].str();
+		if (_tcsicmp(flag.c_str(), _T("on")) == 0) {
+			m_resident = true;
+		}
+		else if (_tcsicmp(flag.c_str(), _T("off")) == 0) {
+			m_resident = false;
+		}
+		else {
+			throw std::runtime_error(toUtf8((_tstring{ _T("Invalid argument to configure resident: ") } + flag).c_str()));
+		}
+
+		writeToRegistry(cmdLine);
+		if (!m_resident) {
+			// a running resident instance exits right away, instead of at its next hot key press
+			InstanceControl::trySignalExisting(InstanceMessage::Quit);
+		}
+		MessageBox(NULL,
+			(_tstringstream{} << _T("Wrote resident configuration to Windows Registry: ")
+				<< (m_resident ? _T("on") : _T("off"))).str().c_str(),
+			k_caption,
+			MB_OK | MB_ICONINFORMATION);
+
+		m_continue = false;
+		return;
+	}
+#pragma endregion
+
 	throw std::runtime_error(toUtf8((_tstring{ _T("Unexpected command line:\n\"") } + cmdLine + _T("\"")).c_str()));
 }
 
+bool Config::reloadIfChanged() {
+	FILETIME writeTime;
+	if (!getRegistryWriteTime(REGKEY_APP_KEYNAME, writeTime) || CompareFileTime(&writeTime, &m_registryWriteTime) == 0) {
+		return false;
+	}
+
+	loadFromRegistry();
+	if (m_keePassExe.empty()) {
+		tryFindKeePassExe();
+	}
+	return true;
+}
+
 void Config::showHelp() {
 	MessageBox(NULL, _T(R"(Syntax:
 
-KeePassHotKey.exe (-help | -config <file> <exe> | -startsound (off|on) )
+KeePassHotKey.exe (-help | -config <file> <exe> | -startsound (off|on) | -resident (off|on) )
 
 Use '-help' to show this text.
 
@@ -231,6 +291,8 @@ Use '-config' to configure the kdbx file to open and (optionally) the KeePass ex
 
 Use '-startsound' to configure the tool to play or not to play a sound at normal start.
 
+Use '-resident' to configure the tool to stay running after the first start, so later starts only signal it.
+
 Use without any arguments to perform standard operation:
 - open the configured kdbx file if no KeePass instance is running, or
 - perform auto type of selected KeePass entry
@@ -281,15 +343,27 @@ void Config::tryFindKeePassExe() {
 }
 
 void Config::loadFromRegistry() {
+	// taken first, so writes while loading cause another reload
+	if (!getRegistryWriteTime(REGKEY_APP_KEYNAME, m_registryWriteTime)) {
+		m_registryWriteTime = FILETIME{};
+	}
+
 	// load file and keepass from config
 	TCHAR file[MAX_PATH + 1];
 	DWORD fileLen = MAX_PATH;
 
-	LSTATUS rr = RegGetValue(HKEY_CURRENT_USER, REGKEY_APP_KEYNAME, _T("tracefile"), RRF_RT_REG_SZ, NULL, file, &fileLen);
+	DWORD traceBinary = 0;
+	DWORD traceBinarySize = sizeof(DWORD);
+	LSTATUS rr = RegGetValue(HKEY_CURRENT_USER, REGKEY_APP_KEYNAME, _T("tracebinary"), RRF_RT_REG_DWORD, NULL, &traceBinary, &traceBinarySize);
+	if (rr != ERROR_SUCCESS) {
+		traceBinary = 0;
+	}
+
+	rr = RegGetValue(HKEY_CURRENT_USER, REGKEY_APP_KEYNAME, _T("tracefile"), RRF_RT_REG_SZ, NULL, file, &fileLen);
 	if (rr == ERROR_SUCCESS) {
 		if (fileLen > MAX_PATH) fileLen = MAX_PATH;
 		file[fileLen] = 0;
-		TraceFile::Instance().setFile(file);
+		TraceFile::Instance().setFile(file, traceBinary != 0);
 	}
 
 	rr = RegGetValue(HKEY_CURRENT_USER, REGKEY_APP_KEYNAME, _T("kdbx"), RRF_RT_REG_SZ, NULL, file, &fileLen);
@@ -322,6 +396,13 @@ void Config::loadFromRegistry() {
 	if (rr == ERROR_SUCCESS) {
 		m_playStartSound = dw != 0;
 	}
+
+	dw = 0;
+	dws = sizeof(DWORD);
+	rr = RegGetValue(HKEY_CURRENT_USER, REGKEY_APP_KEYNAME, _T("resident"), RRF_RT_REG_DWORD, NULL, &dw, &dws);
+	if (rr == ERROR_SUCCESS) {
+		m_resident = dw != 0;
+	}
 }
 
 void Config::writeToRegistry(const TCHAR* cmdLine)
@@ -371,6 +452,15 @@ void Config::writeToRegistry(const TCHAR* cmdLine)
 			accessDenied |= (rr == ERROR_ACCESS_DENIED);
 		}
 
+		dw = m_resident ? 1 : 0;
+		rr = RegSetValueExW(
+			appKey, _T("resident"), 0, REG_DWORD,
+			reinterpret_cast<const BYTE*>(&dw), sizeof(DWORD));
+		if (rr != ERROR_SUCCESS) {
+			error << _T("\nFailed to store resident settings flag: ") << rr;
+			accessDenied |= (rr == ERROR_ACCESS_DENIED);
+		}
+
 		RegCloseKey(appKey);
 	}
 	else {
@@ -413,6 +503,7 @@ void Config::writeToRegistry(const TCHAR* cmdLine)
 			<< _T("\nFile: ") << m_kdbxFile
 			<< _T("\nKeePass : ") << m_keePassExe
 			<< _T("\nStartSound: ") << (m_playStartSound ? _T("on") : _T("off"))
+			<< _T("\nResident: ") << (m_resident ? _T("on") : _T("off"))
 			).str().c_str()) };
 		throw std::runtime_error(msg.c_str());
 	}
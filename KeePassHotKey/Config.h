@@ -30,6 +30,10 @@ public:
 	inline bool needConfirmationForAutoType() const { return m_needConfirmationForAutoType; }
 	inline bool continueProgram() const { return m_continue; }
 	inline bool playStartSound() const { return m_playStartSound; }
+	inline bool isResident() const { return m_resident; }
+
+	// reloads the configuration from the registry if it was written since it was loaded
+	bool reloadIfChanged();
 
 private:
 	constexpr static const TCHAR* REGKEY_APP_KEYNAME = _T("SOFTWARE\\SGrottel\\KeePassHotKey");
@@ -45,5 +49,7 @@ private:
 	bool m_continue = false;
 	bool m_needConfirmationForAutoType = true;
 	bool m_playStartSound = false;
+	bool m_resident = false;
+	FILETIME m_registryWriteTime{};
 };
 
@@ -49,7 +49,7 @@ namespace {
 		case TDN_CREATED:
 			data->m_instanceControl.clearSignaled();
 			{
-				TraceFile::Instance().log(_T("ConfirmationDialog::TDN_CREATED"));
+				TraceFile::Instance().event(TraceEvent::ConfirmationDialogCreated);
 				LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
 				exStyle |= WS_EX_TOPMOST;
 				SetWindowLongPtr(hwnd, GWL_EXSTYLE, exStyle);
@@ -89,7 +89,7 @@ ConfirmationDialog::ConfirmationDialog(const Config& config, InstanceControl& in
 }
 
 bool ConfirmationDialog::confirm(HINSTANCE hinst) {
-	TraceFile::Instance().log(_T("Asking for confirmation"));
+	TraceFile::Instance().event(TraceEvent::AskingConfirmation);
 
 	CallbackData data{
 		m_instanceControl
@@ -113,7 +113,7 @@ bool ConfirmationDialog::confirm(HINSTANCE hinst) {
 		throw std::runtime_error("Failed to open confirmation UI");
 	}
 
-	TraceFile::Instance().log() << "Confirmation Dialog closed with " << btn;
+	TraceFile::Instance().event(TraceEvent::ConfirmationDialogClosed, { btn });
 
 	return btn == IDOK;
 }
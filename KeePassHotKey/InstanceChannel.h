@@ -0,0 +1,49 @@
+//
+// KeePassHotKey
+// InstanceChannel.h
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include <cstdint>
+
+// Messages from later instances of the app to the first one
+enum class InstanceMessage : uint8_t {
+	None = 0,
+	// the hot key was pressed again
+	Activate = 1,
+	// the resident instance should exit
+	Quit = 2,
+};
+
+// Connection between the first instance of the app and later ones.
+// Implemented with named kernel objects on Windows by `InstanceControl`,
+// and with a Unix domain socket by `UnixSocketChannel`, so the resident mode can be tested on other platforms.
+class IInstanceChannel {
+public:
+	virtual ~IInstanceChannel() = default;
+
+	// becomes the first instance and returns true,
+	// or sends `msg` to the first instance and returns false
+	virtual bool initOrSignal(InstanceMessage msg) = 0;
+
+	// waits up to `timeoutMs` for a message; `None` on timeout.
+	// `Quit` stays received: once received, all further calls return `Quit`.
+	virtual InstanceMessage receive(uint32_t timeoutMs) = 0;
+
+	// drops all `Activate` messages received so far
+	virtual void clearSignaled() = 0;
+};
@@ -20,14 +20,44 @@
 
 #include "TraceFile.h"
 
+namespace {
+
+	constexpr const TCHAR* k_semaphoreName = _T("sgrottel_keepasshotkey_instance_handle_lock");
+	constexpr const TCHAR* k_quitEventName = _T("sgrottel_keepasshotkey_resident_quit");
+
+	bool signal(HANDLE semaphore, InstanceMessage msg) {
+		if (msg == InstanceMessage::Quit) {
+			HANDLE quitEvent = OpenEvent(EVENT_MODIFY_STATE, FALSE, k_quitEventName);
+			if (quitEvent == NULL) return false;
+			BOOL ser = SetEvent(quitEvent);
+			CloseHandle(quitEvent);
+			return ser != FALSE;
+		}
+
+		TraceFile::Instance().event(TraceEvent::ReleaseSemaphore);
+		BOOL rsr = ReleaseSemaphore(semaphore, 1, NULL);
+		TraceFile::Instance().event(TraceEvent::ReleaseSemaphoreResult, { rsr });
+		return rsr != FALSE;
+	}
+
+}
+
 InstanceControl::~InstanceControl() {
 	deinit();
 }
 
-bool InstanceControl::initOrSignal() {
+bool InstanceControl::trySignalExisting(InstanceMessage msg) {
+	HANDLE semaphore = OpenSemaphore(SEMAPHORE_MODIFY_STATE, FALSE, k_semaphoreName);
+	if (semaphore == NULL) return false;
+	signal(semaphore, msg);
+	CloseHandle(semaphore);
+	return true;
+}
+
+bool InstanceControl::initOrSignal(InstanceMessage msg) {
 	if (m_instanceSemaphore != INVALID_HANDLE_VALUE) return true; // already locked
 
-	m_instanceSemaphore = CreateSemaphore(NULL, 0, 1, _T("sgrottel_keepasshotkey_instance_handle_lock"));
+	m_instanceSemaphore = CreateSemaphore(NULL, 0, 1, k_semaphoreName);
 
 	if (m_instanceSemaphore == NULL) {
 		m_instanceSemaphore = INVALID_HANDLE_VALUE;
@@ -36,22 +66,48 @@ bool InstanceControl::initOrSignal() {
 
 	DWORD le = GetLastError();
 	if (le == ERROR_ALREADY_EXISTS) {
-		TraceFile::Instance().log(_T("ReleaseSemaphore(m_instanceSemaphore)"));
-		BOOL rsr = ReleaseSemaphore(m_instanceSemaphore, 1, NULL);
-		TraceFile::Instance().log() << _T("\t") << rsr;
+		signal(m_instanceSemaphore, msg);
 		return false;
 	}
 
+	m_quitEvent = CreateEvent(NULL, TRUE, FALSE, k_quitEventName);
+	if (m_quitEvent == NULL) {
+		throw std::runtime_error("Failed to create instance quit event");
+	}
+	// an event left signaled by a previous `Quit` no one received
+	ResetEvent(m_quitEvent);
+
 	return true;
 }
 
 void InstanceControl::deinit() {
+	if (m_quitEvent != NULL) {
+		CloseHandle(m_quitEvent);
+		m_quitEvent = NULL;
+	}
 	if (m_instanceSemaphore != INVALID_HANDLE_VALUE) {
 		CloseHandle(m_instanceSemaphore);
 		m_instanceSemaphore = INVALID_HANDLE_VALUE;
 	}
 }
 
+InstanceMessage InstanceControl::receive(uint32_t timeoutMs) {
+	if (m_instanceSemaphore == INVALID_HANDLE_VALUE || m_quitEvent == NULL) {
+		throw std::logic_error("Cannot receive when semaphore is not initialized");
+	}
+
+	// the quit event comes first, so it wins if both are signaled
+	HANDLE handles[2] = { m_quitEvent, m_instanceSemaphore };
+	DWORD rv = WaitForMultipleObjects(2, handles, FALSE, timeoutMs);
+	if (rv == WAIT_FAILED) {
+		throw std::runtime_error("Failed to wait on instance semaphore");
+	}
+
+	if (rv == WAIT_OBJECT_0) return InstanceMessage::Quit;
+	if (rv == WAIT_OBJECT_0 + 1) return InstanceMessage::Activate;
+	return InstanceMessage::None;
+}
+
 void InstanceControl::clearSignaled() {
 	if (m_instanceSemaphore == INVALID_HANDLE_VALUE) return;
 
@@ -19,18 +19,25 @@
 #pragma once
 
 #include "Common.h"
+#include "InstanceChannel.h"
 
-class InstanceControl
+// `Activate` is signaled through the instance semaphore, `Quit` through a manual-reset event
+class InstanceControl : public IInstanceChannel
 {
 public:
 	~InstanceControl();
 
-	bool initOrSignal();
+	// sends `msg` if another instance exists, without creating any object; returns false if there is none
+	static bool trySignalExisting(InstanceMessage msg);
+
+	bool initOrSignal(InstanceMessage msg) override;
 	void deinit();
 
-	void clearSignaled();
+	InstanceMessage receive(uint32_t timeoutMs) override;
+	void clearSignaled() override;
 	bool tryGetSignaled();
 
 private:
 	HANDLE m_instanceSemaphore = INVALID_HANDLE_VALUE;
+	HANDLE m_quitEvent = NULL;
 };
@@ -21,155 +21,115 @@
 #include "Common.h"
 #include "Config.h"
 
-#include <psapi.h>
 #include <Commctrl.h>
+#include <tlhelp32.h>
 
-#include <functional>
 #include <vector>
-#include <regex>
 
 namespace {
 
-	struct WndInfo {
-		HWND hwnd;
-		_tstring caption;
-		_tstring classname;
-		_tstring process;
-	};
-
-	struct SearchWindowCallback {
-		std::function<bool(WndInfo&)> callback;
-	};
-
-	_tstring _tGetClassName(HWND hwnd) {
-		constexpr const int k_strBufLen = 200;
-		TCHAR classname[k_strBufLen + 1];
-		DWORD len = GetClassName(hwnd, classname, k_strBufLen);
-		if (len > k_strBufLen) len = k_strBufLen;
-		classname[len] = 0;
-		return classname;
-	}
-
-	BOOL CALLBACK detectKeePassMainWindow(HWND hwnd, LPARAM lParam) {
-		SearchWindowCallback* cb = reinterpret_cast<SearchWindowCallback*>(lParam);
-		WndInfo info{ hwnd };
+	// the desktop of the current session, accessed only as needed by `KeePassWindowFinder`
+	class Win32Desktop : public KeePassWindowFinder::Desktop {
+	public:
+		void getProcesses(std::vector<KeePassWindowFinder::ProcessInfo>& outProcesses) override {
+			HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+			if (snapshot == INVALID_HANDLE_VALUE) return;
 
-		constexpr const int k_strBufLen = 200;
+			PROCESSENTRY32W entry{ sizeof(PROCESSENTRY32W) };
+			for (BOOL more = Process32FirstW(snapshot, &entry); more; more = Process32NextW(snapshot, &entry)) {
+				outProcesses.push_back({ entry.th32ProcessID, entry.szExeFile });
+			}
 
-		TCHAR caption[k_strBufLen + 1];
-		DWORD len = GetWindowText(hwnd, caption, k_strBufLen);
-		if (len > k_strBufLen) len = k_strBufLen;
-		caption[len] = 0;
-		info.caption = caption;
+			CloseHandle(snapshot);
+		}
 
-		info.classname = _tGetClassName(hwnd);
+		uint64_t getProcessCreationTime(uint32_t processId) override {
+			HANDLE hPro = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+			if (hPro == NULL) return 0;
 
-		DWORD pid = 0;
-		DWORD tid = GetWindowThreadProcessId(hwnd, &pid);
-		HANDLE hPro = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
-		if (hPro != INVALID_HANDLE_VALUE) {
-			TCHAR path[MAX_PATH + 1];
-			len = GetModuleFileNameEx(hPro, 0, path, MAX_PATH);
-			if (len > MAX_PATH) len = MAX_PATH;
-			path[len] = 0;
-			info.process = path;
+			FILETIME creation, exit, kernel, user;
+			uint64_t time = 0;
+			if (GetProcessTimes(hPro, &creation, &exit, &kernel, &user)) {
+				time = (static_cast<uint64_t>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+			}
 
 			CloseHandle(hPro);
-		}
-		else
-		{
-			info.process.clear();
+			return time;
 		}
 
-		bool rv = cb->callback(info);
+		std::wstring getProcessImagePath(uint32_t processId) override {
+			HANDLE hPro = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+			if (hPro == NULL) return {};
 
-		return rv ? TRUE : FALSE; // continue search
-	}
+			WCHAR path[MAX_PATH + 1];
+			DWORD len = MAX_PATH;
+			if (!QueryFullProcessImageNameW(hPro, 0, path, &len)) len = 0;
 
-	_tstring getFilename(const _tstring& path) {
-		auto pos = path.find_last_of(_T('\\'));
-		if (pos == _tstring::npos) return path;
-		return path.substr(pos + 1);
-	}
-
-	struct SearchListViewCallback {
-		std::vector<HWND> listViews;
-		std::basic_regex<TCHAR> classReg = std::basic_regex<TCHAR>{
-			_T(R"(.*ListView32.*)"),
-			std::regex_constants::ECMAScript | std::regex_constants::icase };
-	};
-
-	BOOL CALLBACK detectKeePassListView(HWND hwnd, LPARAM lParam) {
-		SearchListViewCallback* cb = reinterpret_cast<SearchListViewCallback*>(lParam);
-
-		_tstring className = _tGetClassName(hwnd);
-		bool isMatch = std::regex_match(className, cb->classReg);
-		if (isMatch) {
-			cb->listViews.push_back(hwnd);
+			CloseHandle(hPro);
+			return std::wstring(path, len);
 		}
-
-		//OutputDebugStringW((std::wstringstream{}
-		//	<< (isMatch ? "!" : "")
-		//	<< "[" << reinterpret_cast<unsigned long long>(hwnd) << "] "
-		//	<< "<" << reinterpret_cast<unsigned long long>(GetParent(hwnd)) << "> "
-		//	<< className << "\n").str().c_str());
-		return TRUE;
-	}
+	};
 
 }
 
 KeePassDetector::KeePassDetector(const Config& config) 
 	: m_config{ config },
-	m_result{ Result::Unknown } {
+	m_result{ Result::Unknown },
+	m_desktop{ std::make_unique<Win32Desktop>() },
+	m_finder{ *m_desktop, *WQGetWin32Provider() } {
 	// intentionally empty
 }
 
-void KeePassDetector::Detect() {
-	m_result = Result::Unknown;
-
-	WndInfo window{ 0 };
-
-	_tstring keePassPath{ m_config.getKeePassExe() };
-	_tstring keePassName{ getFilename(keePassPath) };
+void KeePassDetector::invalidate() {
+	m_window = 0;
+	m_windowProcessId = 0;
+	m_listViews.clear();
+}
 
-	SearchWindowCallback windowSearcher{
-		[&keePassPath, &keePassName, &window](WndInfo& wi) {
-			bool procFilenameMatch = 0 == _tcsicmp(getFilename(wi.process).c_str(), keePassName.c_str());
+bool KeePassDetector::isCachedWindowValid() const {
+	if (m_window == 0 || !IsWindow(m_window)) return false;
 
-			if (procFilenameMatch) {
-				// there will be several top-level windows (message only, tooltips, etc.)
-				bool isVisible = IsWindowVisible(wi.hwnd) != FALSE;
-				bool noOwner = GetWindow(wi.hwnd, GW_OWNER) == 0;
-				bool procPathMatch = 0 == _tcsicmp(wi.process.c_str(), keePassPath.c_str());
+	// window handles are reused, so the process must still be the same
+	DWORD pid = 0;
+	GetWindowThreadProcessId(m_window, &pid);
+	return pid == m_windowProcessId
+		&& IsWindowVisible(m_window) != FALSE
+		&& GetWindow(m_window, GW_OWNER) == 0;
+}
 
-				if (isVisible && noOwner) {
-					// most likely the process' main window
+bool KeePassDetector::areCachedListViewsValid() const {
+	if (m_listViews.empty()) return false;
+	for (HWND hListView : m_listViews) {
+		if (!IsWindow(hListView) || GetAncestor(hListView, GA_ROOT) != m_window) return false;
+	}
+	return true;
+}
 
-					window = wi;
+void KeePassDetector::Detect() {
+	m_result = Result::Unknown;
 
-					if (procPathMatch) return false; // and really the real executable. Stop searching
-				}
-			}
-			return true; // continue search
+	if (isCachedWindowValid()) {
+		if (!areCachedListViewsValid()) {
+			findListViews();
 		}
-	};
-	EnumWindows(&detectKeePassMainWindow, reinterpret_cast<LPARAM>(&windowSearcher));
+	}
+	else {
+		invalidate();
+		detectWindows();
+	}
 
-	if (window.hwnd == 0) {
+	if (m_window == 0) {
 		m_result = Result::WindowNotFound;
 		return;
 	}
-
-	SearchListViewCallback cb{};
-	EnumChildWindows(window.hwnd, &detectKeePassListView, reinterpret_cast<LPARAM>(&cb));
-	if (cb.listViews.empty()) {
+	if (m_listViews.empty()) {
 		m_result = Result::ListViewNotFound;
 		return;
 	}
 
 	// check that each detected listview (which should only be one), has at least one selected item
 	bool allListViewsHaveSelectedItems = true;
-	for (HWND hListView : cb.listViews) {
+	for (HWND hListView : m_listViews) {
 		LRESULT res = SendMessage(hListView, LVM_GETNEXTITEM, -1, LVNI_FOCUSED | LVNI_SELECTED);
 		if (res < 0) {
 			allListViewsHaveSelectedItems = false;
@@ -185,3 +145,32 @@ void KeePassDetector::Detect() {
 	// all tests succeeded!
 	m_result = Result::FoundOk;
 }
+
+void KeePassDetector::detectWindows() {
+	KeePassWindowFinder::Match match = m_finder.find(m_config.getKeePassExe());
+	if (match.window == 0) {
+		return;
+	}
+	m_window = reinterpret_cast<HWND>(match.window);
+	m_windowProcessId = match.processId;
+
+	findListViews();
+}
+
+void KeePassDetector::findListViews() {
+	m_listViews.clear();
+
+	WQQuery query;
+	WQQueryInit(&query);
+	WQQueryClassContains(&query, L"ListView32");
+
+	WQSnapshot snapshot;
+	if (WQSnapshotTake(&snapshot, WQGetWin32Provider(), reinterpret_cast<WQWindow>(m_window))) {
+		std::vector<WQWindow> found(snapshot.count);
+		found.resize(WQQueryRun(&query, &snapshot, found.data(), found.size()));
+		for (WQWindow w : found) {
+			m_listViews.push_back(reinterpret_cast<HWND>(w));
+		}
+	}
+	WQSnapshotFree(&snapshot);
+}
@@ -18,6 +18,12 @@
 //
 #pragma once
 
+#include "Common.h"
+#include "KeePassWindowFinder.h"
+
+#include <memory>
+#include <vector>
+
 class Config;
 
 class KeePassDetector
@@ -33,12 +39,30 @@ public:
 
 	KeePassDetector(const Config& config);
 
+	// reuses the windows found by the previous call while they are still valid,
+	// so a resident instance does not enumerate all windows on each press
 	void Detect();
 
+	// forgets the windows found before, e.g. after the configuration changed.
+	// The image paths of the KeePass processes stay cached.
+	void invalidate();
+
 	inline Result getResult() const { return m_result; }
 
 private:
+	void detectWindows();
+	void findListViews();
+	bool isCachedWindowValid() const;
+	bool areCachedListViewsValid() const;
+
 	const Config& m_config;
 	Result m_result;
+
+	std::unique_ptr<KeePassWindowFinder::Desktop> m_desktop;
+	KeePassWindowFinder m_finder;
+
+	HWND m_window = 0;
+	DWORD m_windowProcessId = 0;
+	std::vector<HWND> m_listViews;
 };
 
@@ -23,6 +23,7 @@
 #include "KeePassRunner.h"
 #include "InstanceControl.h"
 #include "ConfirmationDialog.h"
+#include "ResidentLoop.h"
 #include "TraceFile.h"
 
 void reportException(std::string const& msgUtf8) {
@@ -37,51 +38,102 @@ void reportException(std::string const& msgUtf8) {
 		MB_ICONERROR | MB_OK | MB_APPLMODAL);
 }
 
+namespace {
+
+	// handles one hot key press; kept alive between presses in resident mode
+	class HotKeyPress : public ResidentLoop::Actions {
+	public:
+		HotKeyPress(HINSTANCE hInstance, Config& config, InstanceControl& instCtrl)
+			: m_hInstance{ hInstance }, m_config{ config }, m_instCtrl{ instCtrl }, m_detector{ config } {
+			// intentionally empty
+		}
+
+		bool press() override {
+			try {
+				if (m_pressCount++ > 0) {
+					if (m_config.reloadIfChanged()) {
+						m_detector.invalidate();
+					}
+				}
+				handlePress();
+			}
+			catch (std::exception const& ex) {
+				reportException(ex.what());
+			}
+			catch (...) {
+				reportException("Unexpected Exception");
+			}
+			// a resident instance may wait a long time for its next press, so do not keep this one's records batched
+			TraceFile::Instance().flush();
+			return m_config.isResident();
+		}
+
+	private:
+		void handlePress() {
+			if (m_config.playStartSound()) {
+				::MessageBeep(MB_OK);
+			}
+
+			m_detector.Detect();
+
+			KeePassRunner runner{ m_config };
+
+			if (m_detector.getResult() == KeePassDetector::Result::FoundOk)
+			{
+				TraceFile::Instance().event(TraceEvent::KeePassFound);
+				if (m_config.needConfirmationForAutoType()) {
+					ConfirmationDialog cDlg{ m_config, m_instCtrl };
+					if (!cDlg.confirm(m_hInstance)) {
+						return;
+					}
+
+				}
+
+				runner.RunAutoTypeSelected();
+			}
+			else
+			{
+				TraceFile::Instance().event(TraceEvent::KeePassNotFound, { static_cast<uint32_t>(m_detector.getResult()) });
+				runner.OpenKdbx();
+			}
+		}
+
+		HINSTANCE m_hInstance;
+		Config& m_config;
+		InstanceControl& m_instCtrl;
+		KeePassDetector m_detector;
+		uint64_t m_pressCount = 0;
+	};
+
+}
+
 int APIENTRY _tWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR lpCmdLine, int nCmdShow) {
+	// a plain hot key press while another instance runs only needs to wake that instance,
+	// so skip parsing the configuration and everything else
+	if (lpCmdLine[0] == 0 && InstanceControl::trySignalExisting(InstanceMessage::Activate)) {
+		return 0;
+	}
+
 	Config config;
 	InstanceControl instCtrl;
 	try {
-		TraceFile::Instance().log() << _T("KeePass'HotKey started");
+		TraceFile::Instance().event(TraceEvent::Started);
 
 		config.init(lpCmdLine);
 		if (!config.continueProgram()) {
-			TraceFile::Instance().log() << _T("config.continueProgram == false");
+			TraceFile::Instance().event(TraceEvent::ConfigNoContinue);
 			return 0;
 		}
 
-		bool isMainInst = instCtrl.initOrSignal();
+		bool isMainInst = instCtrl.initOrSignal(InstanceMessage::Activate);
 		if (!isMainInst) {
-			TraceFile::Instance().log() << _T("(isMainInst = instCtrl.initOrSignal() ) == false");
+			TraceFile::Instance().event(TraceEvent::NotMainInstance);
 			return 0;
 		}
 
-		if (config.playStartSound()) {
-			::MessageBeep(MB_OK);
-		}
-
-		KeePassDetector detector{ config };
-		detector.Detect();
-
-		KeePassRunner runner{ config };
-
-		if (detector.getResult() == KeePassDetector::Result::FoundOk)
-		{
-			TraceFile::Instance().log() << _T("detector.getResult() == KeePassDetector::Result::FoundOk");
-			if (config.needConfirmationForAutoType()) {
-				ConfirmationDialog cDlg{ config, instCtrl };
-				if (!cDlg.confirm(hInstance)) {
-					return 0;
-				}
-
-			}
-
-			runner.RunAutoTypeSelected();
-		}
-		else
-		{
-			TraceFile::Instance().log() << _T("detector.getResult() != KeePassDetector::Result::FoundOk\n")
-				<< _T("\tinstead: ") << static_cast<uint32_t>(detector.getResult());
-			runner.OpenKdbx();
+		HotKeyPress hotKeyPress{ hInstance, config, instCtrl };
+		if (hotKeyPress.press()) {
+			ResidentLoop{ instCtrl, hotKeyPress }.run();
 		}
 
 	}
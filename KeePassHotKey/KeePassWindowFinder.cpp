@@ -0,0 +1,114 @@
+//
+// KeePassHotKey
+// KeePassWindowFinder.cpp
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "KeePassWindowFinder.h"
+
+#include <algorithm>
+#include <cwctype>
+
+namespace {
+
+	std::wstring_view getFilename(std::wstring_view path) {
+		auto pos = path.find_last_of(L'\\');
+		if (pos == std::wstring_view::npos) return path;
+		return path.substr(pos + 1);
+	}
+
+	bool equalsNoCase(std::wstring_view a, std::wstring_view b) {
+		if (a.size() != b.size()) return false;
+		for (size_t i = 0; i < a.size(); ++i) {
+			if (a[i] != b[i] && std::towlower(a[i]) != std::towlower(b[i])) return false;
+		}
+		return true;
+	}
+
+	const std::wstring k_noPath;
+
+}
+
+KeePassWindowFinder::KeePassWindowFinder(Desktop& desktop, const WQProvider& windows)
+	: m_desktop{ desktop }, m_windows{ windows } {
+	// intentionally empty
+}
+
+KeePassWindowFinder::Match KeePassWindowFinder::find(std::wstring const& keePassPath) {
+	const std::wstring_view keePassName = getFilename(keePassPath);
+
+	m_processes.clear();
+	m_desktop.getProcesses(m_processes);
+
+	m_candidates.clear();
+	m_candidateIds.clear();
+	for (ProcessInfo const& process : m_processes) {
+		if (!equalsNoCase(process.exeName, keePassName)) continue;
+		m_candidates.push_back({ process.processId, equalsNoCase(getImagePath(process.processId), keePassPath) });
+		m_candidateIds.push_back(process.processId);
+	}
+
+	// forget processes which have ended
+	if (m_imageCache.size() > m_candidates.size()) {
+		std::erase_if(m_imageCache, [this](auto const& entry) {
+			return std::none_of(m_candidates.begin(), m_candidates.end(),
+				[&entry](Candidate const& c) { return c.processId == entry.first; });
+			});
+	}
+
+	Match match;
+	if (m_candidates.empty()) return match;
+
+	// there will be several top-level windows (message only, tooltips, etc.)
+	WQQuery query;
+	WQQueryInit(&query);
+	WQQueryProcessIdIn(&query, m_candidateIds.data(), m_candidateIds.size());
+	WQQueryVisible(&query);
+	WQQueryTopLevel(&query);
+	WQQueryCompile(&query);
+
+	WQSnapshot snapshot;
+	if (WQSnapshotTake(&snapshot, &m_windows, 0)) {
+		for (size_t i = 0; i < snapshot.count; ++i) {
+			if (!WQQueryMatches(&query, &snapshot, i)) continue;
+
+			// most likely the process' main window
+			match.window = snapshot.windows[i].window;
+			match.processId = snapshot.windows[i].processId;
+
+			auto candidate = std::find_if(m_candidates.begin(), m_candidates.end(),
+				[&match](Candidate const& c) { return c.processId == match.processId; });
+			if (candidate->pathMatch) break; // and really the real executable. Stop searching
+		}
+	}
+	WQSnapshotFree(&snapshot);
+
+	return match;
+}
+
+std::wstring const& KeePassWindowFinder::getImagePath(uint32_t processId) {
+	const uint64_t creationTime = m_desktop.getProcessCreationTime(processId);
+	if (creationTime == 0) return k_noPath;
+
+	auto it = m_imageCache.find(processId);
+	if (it != m_imageCache.end() && it->second.creationTime == creationTime) {
+		return it->second.path;
+	}
+
+	CachedImage& image = m_imageCache[processId];
+	image.creationTime = creationTime;
+	image.path = m_desktop.getProcessImagePath(processId);
+	return image.path;
+}
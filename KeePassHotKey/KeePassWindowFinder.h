@@ -0,0 +1,93 @@
+//
+// KeePassHotKey
+// KeePassWindowFinder.h
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "../_shared/WindowQuery/WindowQuery.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Finds the main window of KeePass by first selecting the processes with the file name of the KeePass executable,
+// and then only looking at the windows of these processes, so no process is opened per window.
+// The desktop is only accessed through interfaces, processes through `Desktop` and windows through `WQProvider`,
+// so this class does not depend on Windows.
+class KeePassWindowFinder
+{
+public:
+	typedef WQWindow WindowHandle;
+
+	struct ProcessInfo {
+		uint32_t processId;
+		// file name of the executable, without path
+		std::wstring exeName;
+	};
+
+	class Desktop {
+	public:
+		virtual ~Desktop() = default;
+
+		// fills `outProcesses` with all running processes
+		virtual void getProcesses(std::vector<ProcessInfo>& outProcesses) = 0;
+
+		// identifies the process together with its id, which is reused; 0 if the process cannot be opened
+		virtual uint64_t getProcessCreationTime(uint32_t processId) = 0;
+
+		// full path of the process' executable; empty if the process cannot be opened
+		virtual std::wstring getProcessImagePath(uint32_t processId) = 0;
+	};
+
+	struct Match {
+		WindowHandle window = 0;
+		uint32_t processId = 0;
+	};
+
+	KeePassWindowFinder(Desktop& desktop, const WQProvider& windows);
+
+	// returns the main window of a process with the same file name as `keePassPath`, compared case-insensitive.
+	// Prefers a process with the same full path; otherwise the last candidate window in z-order is returned.
+	Match find(std::wstring const& keePassPath);
+
+	// number of processes which image path is cached
+	inline size_t getCachedImageCount() const { return m_imageCache.size(); }
+
+private:
+	struct CachedImage {
+		uint64_t creationTime;
+		std::wstring path;
+	};
+
+	// cached by process id and creation time; empty if the process cannot be opened
+	std::wstring const& getImagePath(uint32_t processId);
+
+	Desktop& m_desktop;
+	const WQProvider& m_windows;
+	std::unordered_map<uint32_t, CachedImage> m_imageCache;
+
+	std::vector<ProcessInfo> m_processes;
+	std::vector<uint32_t> m_candidateIds;
+
+	struct Candidate {
+		uint32_t processId;
+		bool pathMatch;
+	};
+	std::vector<Candidate> m_candidates;
+};
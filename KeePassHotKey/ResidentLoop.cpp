@@ -0,0 +1,56 @@
+//
+// KeePassHotKey
+// ResidentLoop.cpp
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "ResidentLoop.h"
+
+ResidentLoop::ResidentLoop(IInstanceChannel& channel, Actions& actions)
+	: m_channel{ channel }, m_actions{ actions }
+{
+	// intentionally empty
+}
+
+void ResidentLoop::run() {
+	while (step(c_waitMs)) {
+		// intentionally empty
+	}
+}
+
+bool ResidentLoop::step(uint32_t timeoutMs) {
+	if (m_state == State::Stopped) return false;
+
+	switch (m_channel.receive(timeoutMs)) {
+	case InstanceMessage::Quit:
+		m_state = State::Stopped;
+		return false;
+
+	case InstanceMessage::Activate: {
+		m_state = State::Pressed;
+		m_pressCount++;
+		const bool stayResident = m_actions.press();
+
+		// presses while handling this one, e.g. confirming the dialog, belong to it
+		m_channel.clearSignaled();
+
+		m_state = stayResident ? State::Idle : State::Stopped;
+		return stayResident;
+	}
+
+	default:
+		return true;
+	}
+}
@@ -0,0 +1,65 @@
+//
+// KeePassHotKey
+// ResidentLoop.h
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "InstanceChannel.h"
+
+#include <cstdint>
+
+// Keeps the first instance of the app alive after it handled its hot key press,
+// and handles the presses signaled by later instances, which then exit right away.
+// Does not depend on Windows.
+class ResidentLoop
+{
+public:
+
+	class Actions {
+	public:
+		virtual ~Actions() = default;
+
+		// handles one hot key press; returns false to stop being resident
+		virtual bool press() = 0;
+	};
+
+	enum class State {
+		Idle,
+		Pressed,
+		Stopped,
+	};
+
+	// the loop wakes up at least this often, e.g. to notice the channel failing
+	static constexpr uint32_t c_waitMs = 60 * 1000;
+
+	ResidentLoop(IInstanceChannel& channel, Actions& actions);
+
+	// handles messages until `Quit` is received or a press stops the resident mode
+	void run();
+
+	// waits up to `timeoutMs` and handles at most one message; returns false once stopped
+	bool step(uint32_t timeoutMs);
+
+	inline State getState() const { return m_state; }
+	inline uint64_t getPressCount() const { return m_pressCount; }
+
+private:
+	IInstanceChannel& m_channel;
+	Actions& m_actions;
+	State m_state = State::Idle;
+	uint64_t m_pressCount = 0;
+};
@@ -0,0 +1,79 @@
+//
+// KeePassHotKey
+// TraceDecode.cpp
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+// Converts a binary trace file of KeePassHotKey into the text layout of text trace files.
+// Has no platform dependencies, so traces can be decoded on any machine:
+//
+//   c++ -std=c++17 -O2 TraceDecode.cpp ../TraceEvents.cpp -o TraceDecode
+//
+#include "../TraceEvents.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+namespace {
+
+	void localTime(std::time_t time, std::tm& outTm) {
+#ifdef _WIN32
+		localtime_s(&outTm, &time);
+#else
+		localtime_r(&time, &outTm);
+#endif
+	}
+
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2 || argc > 3) {
+		std::cerr << "Usage: TraceDecode <binary trace file> [<text output file>]" << std::endl;
+		return 2;
+	}
+
+	std::ifstream in{ argv[1], std::ios::binary };
+	if (!in) {
+		std::cerr << "Failed to open " << argv[1] << std::endl;
+		return 1;
+	}
+	const std::string data{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+
+	std::string text;
+	std::string error;
+	const bool ok = decodeTrace(data, &localTime, text, error);
+
+	// the lines decoded before an error are still written
+	if (argc == 3) {
+		std::ofstream out{ argv[2], std::ios::binary };
+		if (!out) {
+			std::cerr << "Failed to create " << argv[2] << std::endl;
+			return 1;
+		}
+		out << text;
+	}
+	else {
+		std::cout << text;
+	}
+
+	if (!ok) {
+		std::cerr << argv[1] << ": " << error << std::endl;
+		return 1;
+	}
+	return 0;
+}
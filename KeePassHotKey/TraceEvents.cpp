@@ -0,0 +1,164 @@
+//
+// KeePassHotKey
+// TraceEvents.cpp
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "TraceEvents.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+	// `{}` is replaced by the next argument
+	constexpr const char* c_formats[] = {
+		"{}",
+		"KeePass'HotKey started",
+		"config.continueProgram == false",
+		"(isMainInst = instCtrl.initOrSignal() ) == false",
+		"ReleaseSemaphore(m_instanceSemaphore)",
+		"\t{}",
+		"detector.getResult() == KeePassDetector::Result::FoundOk",
+		"detector.getResult() != KeePassDetector::Result::FoundOk\n\tinstead: {}",
+		"ConfirmationDialog::TDN_CREATED",
+		"Asking for confirmation",
+		"Confirmation Dialog closed with {}",
+	};
+	static_assert(sizeof(c_formats) / sizeof(c_formats[0]) == static_cast<size_t>(TraceEvent::Count), "one format per event");
+
+	constexpr size_t c_recordSize = sizeof(TraceRecord);
+
+	void appendRecord(TraceRecord const& rec, std::string& out) {
+		out.append(reinterpret_cast<const char*>(&rec), c_recordSize);
+	}
+
+	void appendInt(int64_t value, std::string& out) {
+		char buf[24];
+		const int len = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+		out.append(buf, static_cast<size_t>(len));
+	}
+
+}
+
+void formatTraceEvent(TraceEvent event, const int64_t* args, size_t argCount, std::string& out) {
+	const size_t index = static_cast<size_t>(event);
+	if (index >= static_cast<size_t>(TraceEvent::Count)) {
+		out += "unknown trace event ";
+		appendInt(static_cast<int64_t>(index), out);
+		return;
+	}
+
+	size_t arg = 0;
+	for (const char* c = c_formats[index]; *c != 0; ++c) {
+		if (c[0] == '{' && c[1] == '}') {
+			if (arg < argCount) {
+				appendInt(args[arg++], out);
+			}
+			++c;
+			continue;
+		}
+		out += *c;
+	}
+}
+
+void formatTraceStamp(std::tm const& tm, uint32_t processId, std::string& out) {
+	char buf[48];
+	size_t len = std::strftime(buf, sizeof(buf), "%Y.%m.%dT%H:%M:%S|", &tm);
+	len += static_cast<size_t>(std::snprintf(buf + len, sizeof(buf) - len, "%08x| ", static_cast<unsigned int>(processId)));
+	out.append(buf, len);
+}
+
+void encodeTraceEvent(uint64_t timeUs, uint32_t processId, TraceEvent event, const int64_t* args, size_t argCount, std::string& out) {
+	TraceRecord rec{};
+	rec.timeUs = timeUs;
+	rec.processId = processId;
+	rec.event = static_cast<uint16_t>(event);
+	rec.argCount = static_cast<uint8_t>(argCount < TraceRecord::c_maxArgs ? argCount : TraceRecord::c_maxArgs);
+	for (size_t i = 0; i < rec.argCount; ++i) {
+		rec.args[i] = args[i];
+	}
+	appendRecord(rec, out);
+}
+
+void encodeTraceText(uint64_t timeUs, uint32_t processId, std::string_view textUtf8, std::string& out) {
+	TraceRecord rec{};
+	rec.timeUs = timeUs;
+	rec.processId = processId;
+	rec.event = static_cast<uint16_t>(TraceEvent::Text);
+	rec.argCount = 1;
+	rec.argTypes = static_cast<uint8_t>(TraceArgType::Text);
+	rec.args[0] = static_cast<int64_t>(textUtf8.size());
+	appendRecord(rec, out);
+
+	// padded with zeros to whole records
+	const size_t pos = out.size();
+	out.resize(pos + getTraceTextSize(textUtf8.size()) - c_recordSize, 0);
+	std::memcpy(out.data() + pos, textUtf8.data(), textUtf8.size());
+}
+
+size_t getTraceTextSize(size_t textSize) {
+	return c_recordSize * (1 + (textSize + c_recordSize - 1) / c_recordSize);
+}
+
+bool decodeTrace(std::string_view data, TraceLocalTimeFunc localTime, std::string& out, std::string& outError) {
+	if (data.size() % c_recordSize != 0) {
+		outError = "size is not a multiple of the record size " + std::to_string(c_recordSize);
+		return false;
+	}
+
+	std::string message;
+	size_t pos = 0;
+	while (pos < data.size()) {
+		TraceRecord rec;
+		std::memcpy(&rec, data.data() + pos, c_recordSize);
+		const size_t recPos = pos;
+		pos += c_recordSize;
+
+		if (rec.event >= static_cast<uint16_t>(TraceEvent::Count) || rec.argCount > TraceRecord::c_maxArgs) {
+			outError = "invalid record at offset " + std::to_string(recPos);
+			return false;
+		}
+
+		message.clear();
+		int64_t args[TraceRecord::c_maxArgs];
+		size_t argCount = 0;
+		for (size_t i = 0; i < rec.argCount; ++i) {
+			const TraceArgType type = static_cast<TraceArgType>((rec.argTypes >> (2 * i)) & 3);
+			if (type == TraceArgType::Int) {
+				args[argCount++] = rec.args[i];
+				continue;
+			}
+			if (type != TraceArgType::Text || rec.args[i] < 0 || static_cast<uint64_t>(rec.args[i]) > data.size() - pos) {
+				outError = "invalid argument in record at offset " + std::to_string(recPos);
+				return false;
+			}
+			// only text messages have text arguments, which form the message
+			const size_t len = static_cast<size_t>(rec.args[i]);
+			message.assign(data.data() + pos, len);
+			pos += getTraceTextSize(len) - c_recordSize;
+		}
+		if (rec.event != static_cast<uint16_t>(TraceEvent::Text)) {
+			formatTraceEvent(static_cast<TraceEvent>(rec.event), args, argCount, message);
+		}
+
+		std::tm tm{};
+		localTime(static_cast<std::time_t>(rec.timeUs / 1000000), tm);
+		formatTraceStamp(tm, rec.processId, out);
+		out += message;
+		out += '\n';
+	}
+	return true;
+}
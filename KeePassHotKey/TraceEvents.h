@@ -0,0 +1,82 @@
+//
+// KeePassHotKey
+// TraceEvents.h
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+// Trace messages with fixed text; the numbers are stored in binary traces and must not change
+enum class TraceEvent : uint16_t {
+	Text = 0,
+	Started = 1,
+	ConfigNoContinue = 2,
+	NotMainInstance = 3,
+	ReleaseSemaphore = 4,
+	ReleaseSemaphoreResult = 5,
+	KeePassFound = 6,
+	KeePassNotFound = 7,
+	ConfirmationDialogCreated = 8,
+	AskingConfirmation = 9,
+	ConfirmationDialogClosed = 10,
+
+	Count
+};
+
+enum class TraceArgType : uint8_t {
+	Int = 0,
+	// the value is the length of the UTF-8 text, stored in the records following this one
+	Text = 1
+};
+
+// One record of a binary trace, written and read as is, in little endian byte order
+struct TraceRecord {
+	static constexpr size_t c_maxArgs = 2;
+
+	// microseconds since 1970-01-01 UTC, from a monotonic clock started once per process
+	uint64_t timeUs;
+	uint32_t processId;
+	uint16_t event;
+	uint8_t argCount;
+	// `TraceArgType` of each argument, 2 bits each, starting with the lowest bits
+	uint8_t argTypes;
+	int64_t args[c_maxArgs];
+};
+static_assert(sizeof(TraceRecord) == 32, "trace records are stored with a fixed size");
+
+typedef void (*TraceLocalTimeFunc)(std::time_t time, std::tm& outTm);
+
+// appends the text of the event, as written to text traces
+void formatTraceEvent(TraceEvent event, const int64_t* args, size_t argCount, std::string& out);
+
+// appends the start of a text trace line: timestamp and process id
+void formatTraceStamp(std::tm const& tm, uint32_t processId, std::string& out);
+
+// appends the record of the event to a binary trace
+void encodeTraceEvent(uint64_t timeUs, uint32_t processId, TraceEvent event, const int64_t* args, size_t argCount, std::string& out);
+
+// appends the records of a free text message to a binary trace
+void encodeTraceText(uint64_t timeUs, uint32_t processId, std::string_view textUtf8, std::string& out);
+
+// number of bytes `encodeTraceText` appends
+size_t getTraceTextSize(size_t textSize);
+
+// converts a binary trace into the lines of a text trace; returns false and sets `outError` if the data is malformed
+bool decodeTrace(std::string_view data, TraceLocalTimeFunc localTime, std::string& out, std::string& outError);
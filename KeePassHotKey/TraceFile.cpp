@@ -18,32 +18,88 @@
 //
 #include "TraceFile.h"
 
-#include <iomanip>
-#include <ctime>
+#include <stdexcept>
 
 namespace {
-	void appendLine(_tstring const& file, _tstring const& msg, std::string const& prefix) {
-		HANDLE hFile = CreateFile(file.c_str(), GENERIC_WRITE, FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, 0, NULL);
-		if (hFile == INVALID_HANDLE_VALUE) {
-			throw std::runtime_error((std::stringstream{} << "Failed to create specified trace file:\n" << toUtf8(file.c_str())).str());
+
+	void localTime(std::time_t time, std::tm& outTm) {
+		localtime_s(&outTm, &time);
+	}
+
+	// the system time at startup, advanced by the performance counter, so timestamps are monotonic
+	struct ClockAnchor {
+		LARGE_INTEGER frequency;
+		LARGE_INTEGER counter;
+		uint64_t timeUs;
+
+		ClockAnchor() {
+			QueryPerformanceFrequency(&frequency);
+			QueryPerformanceCounter(&counter);
+			FILETIME ft;
+			GetSystemTimePreciseAsFileTime(&ft);
+			// FILETIME counts 100 ns since 1601-01-01
+			timeUs = (((static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) - 116444736000000000ull) / 10;
 		}
-		SetFilePointer(hFile, 0, 0, FILE_END);
-
-		std::stringstream pre;
-		std::time_t t = std::time(nullptr);
-		std::tm tm;
-		localtime_s(&tm, &t);
-		pre << std::put_time(&tm, "%Y.%m.%dT%T") << "|";
-		std::string pp = pre.str();
-		WriteFile(hFile, pp.c_str(), static_cast<DWORD>(pp.size()), NULL, NULL);
-
-		WriteFile(hFile, prefix.c_str(), static_cast<DWORD>(prefix.size()), NULL, NULL);
-		std::string msgBuf = toUtf8(msg.c_str());
-		WriteFile(hFile, msgBuf.c_str(), static_cast<DWORD>(msgBuf.size()), NULL, NULL);
-		WriteFile(hFile, "\n", 1, NULL, NULL);
-
-		CloseHandle(hFile);
+	};
+
+	uint64_t clockUs() {
+		static const ClockAnchor anchor;
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		const uint64_t ticks = static_cast<uint64_t>(now.QuadPart - anchor.counter.QuadPart);
+		const uint64_t freq = static_cast<uint64_t>(anchor.frequency.QuadPart);
+		return anchor.timeUs + (ticks / freq) * 1000000 + (ticks % freq) * 1000000 / freq;
 	}
+
+	class FileOutput : public TraceWriter::Output {
+	public:
+		FileOutput(_tstring const& path) : m_path(path) {
+			open();
+		}
+
+		~FileOutput() {
+			close();
+		}
+
+		bool isOpen() const { return m_hFile != INVALID_HANDLE_VALUE; }
+
+		uint64_t size() const {
+			LARGE_INTEGER size;
+			if (!isOpen() || !GetFileSizeEx(m_hFile, &size)) return 0;
+			return static_cast<uint64_t>(size.QuadPart);
+		}
+
+		bool write(const char* data, size_t size) override {
+			if (!isOpen()) return false;
+			DWORD written = 0;
+			return WriteFile(m_hFile, data, static_cast<DWORD>(size), &written, NULL) && written == size;
+		}
+
+		bool rotate() override {
+			close();
+			// other instances may have the file open, which they allow by sharing delete access
+			MoveFileEx(m_path.c_str(), (m_path + _T(".1")).c_str(), MOVEFILE_REPLACE_EXISTING);
+			open();
+			return isOpen();
+		}
+
+	private:
+		void open() {
+			// append mode makes each write atomic with respect to other instances writing the same file
+			m_hFile = CreateFile(m_path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		}
+
+		void close() {
+			if (isOpen()) {
+				CloseHandle(m_hFile);
+				m_hFile = INVALID_HANDLE_VALUE;
+			}
+		}
+
+		_tstring m_path;
+		HANDLE m_hFile = INVALID_HANDLE_VALUE;
+	};
+
 }
 
 TraceFile::LogStream::LogStream(TraceFile &owner) : _tstringstream(), m_owner(owner) {
@@ -59,16 +115,28 @@ TraceFile& TraceFile::Instance() {
 	return inst;
 }
 
-void TraceFile::setFile(_tstring const& path) {
-	m_file = path;
+TraceFile::TraceFile() : m_writer(&localTime, &clockUs) {
+	m_writer.setProcessId(GetCurrentProcessId());
+}
+
+TraceFile::~TraceFile() {
+	m_writer.flush();
+	m_writer.setOutput(nullptr, 0);
+}
 
-	std::stringstream pre;
-	pre << std::hex << std::setw(8) << std::setfill('0') << GetCurrentProcessId() << "| ";
-	m_prefix = pre.str();
+void TraceFile::setFile(_tstring const& path, bool binary) {
+	m_writer.flush();
+	m_writer.setOutput(nullptr, 0);
+	m_writer.setBinary(binary);
 
-	for (_tstring& s : m_lineBuf) {
-		appendLine(m_file, s, m_prefix);
+	auto output = std::make_unique<FileOutput>(path);
+	if (!output->isOpen()) {
+		m_output.reset();
+		throw std::runtime_error((std::stringstream{} << "Failed to create specified trace file:\n" << toUtf8(path.c_str())).str());
 	}
+	const uint64_t size = output->size();
+	m_output = std::move(output);
+	m_writer.setOutput(m_output.get(), size);
 }
 
 TraceFile::LogStream TraceFile::log() {
@@ -76,9 +144,12 @@ TraceFile::LogStream TraceFile::log() {
 }
 
 void TraceFile::log(_tstring const& msg) {
-	if (m_file.empty()) {
-		m_lineBuf.push_back(msg);
-		return;
-	}
-	appendLine(m_file, msg, m_prefix);
+#ifdef _UNICODE
+	// converted into a reused buffer, so logging does not allocate
+	m_utf8.resize(msg.size() * 3);
+	int len = msg.empty() ? 0 : WideCharToMultiByte(CP_UTF8, 0, msg.data(), static_cast<int>(msg.size()), m_utf8.data(), static_cast<int>(m_utf8.size()), NULL, NULL);
+	m_writer.log(std::string_view{ m_utf8.data(), static_cast<size_t>(len) });
+#else /* _UNICODE */
+	m_writer.log(msg);
+#endif /* _UNICODE */
 }
@@ -19,7 +19,9 @@
 #pragma once
 
 #include "Common.h"
-#include <vector>
+#include "TraceWriter.h"
+
+#include <memory>
 
 
 class TraceFile
@@ -43,15 +45,28 @@ public:
 
 	static TraceFile& Instance();
 
-	void setFile(_tstring const& path);
+	// opens the file for appending and keeps it open; rotates it to `<path>.1` when it grows too large.
+	// If `binary`, writes fixed-size records, which are written in batches and must be decoded by `TraceDecode`.
+	void setFile(_tstring const& path, bool binary);
 
 	LogStream log();
 	void log(_tstring const& msg);
 
+	inline void event(TraceEvent event, std::initializer_list<int64_t> args = {}) {
+		m_writer.logEvent(event, args);
+	}
+
+	// writes batched binary records; e.g. before waiting for the next press in resident mode
+	inline void flush() {
+		m_writer.flush();
+	}
+
 private:
+	TraceFile();
+	~TraceFile();
 
-	std::string m_prefix;
-	_tstring m_file;
-	std::vector<_tstring> m_lineBuf;
+	TraceWriter m_writer;
+	std::unique_ptr<TraceWriter::Output> m_output;
+	std::string m_utf8;
 };
 
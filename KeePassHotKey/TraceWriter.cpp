@@ -0,0 +1,134 @@
+//
+// KeePassHotKey
+// TraceWriter.cpp
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "TraceWriter.h"
+
+TraceWriter::TraceWriter(TraceLocalTimeFunc localTime, ClockFunc clock) : m_localTime(localTime), m_clock(clock) {
+	m_buffer.reserve(c_binaryBatchBytes);
+}
+
+void TraceWriter::setProcessId(uint32_t processId) {
+	m_processId = processId;
+	m_stampTime = -1;
+}
+
+void TraceWriter::setOutput(Output* output, uint64_t size) {
+	m_output = output;
+	m_size = size;
+	if (m_output == nullptr) {
+		return;
+	}
+
+	if (m_dropped > 0) {
+		encodeTraceText(m_clock(), m_processId, std::to_string(m_dropped) + " trace lines dropped before the trace file was set", m_pending);
+		m_dropped = 0;
+	}
+	if (m_binary) {
+		m_buffer += m_pending;
+	}
+	else {
+		std::string error;
+		decodeTrace(m_pending, m_localTime, m_buffer, error);
+	}
+	m_pending.clear();
+	flush();
+}
+
+void TraceWriter::log(std::string_view msgUtf8) {
+	if (m_output == nullptr) {
+		if (reservePending(getTraceTextSize(msgUtf8.size()))) {
+			encodeTraceText(m_clock(), m_processId, msgUtf8, m_pending);
+		}
+		return;
+	}
+
+	if (m_binary) {
+		encodeTraceText(m_clock(), m_processId, msgUtf8, m_buffer);
+	}
+	else {
+		appendLine(m_clock(), msgUtf8);
+	}
+	written();
+}
+
+void TraceWriter::logEvent(TraceEvent event, std::initializer_list<int64_t> args) {
+	if (m_output == nullptr) {
+		if (reservePending(sizeof(TraceRecord))) {
+			encodeTraceEvent(m_clock(), m_processId, event, args.begin(), args.size(), m_pending);
+		}
+		return;
+	}
+
+	if (m_binary) {
+		encodeTraceEvent(m_clock(), m_processId, event, args.begin(), args.size(), m_buffer);
+	}
+	else {
+		m_message.clear();
+		formatTraceEvent(event, args.begin(), args.size(), m_message);
+		appendLine(m_clock(), m_message);
+	}
+	written();
+}
+
+bool TraceWriter::reservePending(size_t size) {
+	if (m_pending.size() + size > c_maxPendingBytes) {
+		m_dropped++;
+		return false;
+	}
+	return true;
+}
+
+void TraceWriter::appendLine(uint64_t timeUs, std::string_view msgUtf8) {
+	const std::time_t now = static_cast<std::time_t>(timeUs / 1000000);
+	if (now != m_stampTime) {
+		std::tm tm{};
+		m_localTime(now, tm);
+		m_stamp.clear();
+		formatTraceStamp(tm, m_processId, m_stamp);
+		m_stampTime = now;
+	}
+
+	m_buffer += m_stamp;
+	m_buffer += msgUtf8;
+	m_buffer += '\n';
+}
+
+void TraceWriter::written() {
+	// text lines are written right away, to be readable while the application runs
+	if (!m_binary || m_buffer.size() >= c_binaryBatchBytes) {
+		flush();
+	}
+}
+
+void TraceWriter::flush() {
+	if (m_output == nullptr || m_buffer.empty()) {
+		return;
+	}
+
+	if (m_maxFileSize > 0 && m_size > 0 && m_size + m_buffer.size() > m_maxFileSize) {
+		if (m_output->rotate()) {
+			m_size = 0;
+		}
+	}
+
+	if (m_output->write(m_buffer.data(), m_buffer.size())) {
+		m_size += m_buffer.size();
+	}
+	// a failing trace file must not stop the application, so the lines are dropped
+	m_buffer.clear();
+}
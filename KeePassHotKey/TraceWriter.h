@@ -0,0 +1,108 @@
+//
+// KeePassHotKey
+// TraceWriter.h
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "TraceEvents.h"
+
+#include <cstdint>
+#include <ctime>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+// Formats trace lines, or encodes binary trace records, and writes them to an output,
+// which is only an interface, so this class does not depend on Windows.
+// Lines logged before the output is set are kept as binary records, up to `c_maxPendingBytes`,
+// and are converted to text when the output is set in text mode.
+class TraceWriter
+{
+public:
+
+	class Output {
+	public:
+		virtual ~Output() = default;
+
+		// appends all bytes with a single call
+		virtual bool write(const char* data, size_t size) = 0;
+
+		// moves the current file aside and continues writing to a new, empty file
+		virtual bool rotate() = 0;
+	};
+
+	// microseconds since 1970-01-01 UTC
+	typedef uint64_t (*ClockFunc)();
+
+	static constexpr size_t c_maxPendingBytes = 64 * 1024;
+	static constexpr uint64_t c_defaultMaxFileSize = 1024 * 1024;
+
+	// binary records are collected up to this size before they are written
+	static constexpr size_t c_binaryBatchBytes = 4 * 1024;
+
+	TraceWriter(TraceLocalTimeFunc localTime, ClockFunc clock);
+
+	// written with each line
+	void setProcessId(uint32_t processId);
+
+	// writes fixed-size records, see `TraceRecord`, instead of text lines; decoded by `decodeTrace`
+	inline void setBinary(bool binary) { m_binary = binary; }
+	inline bool isBinary() const { return m_binary; }
+
+	// starts writing to `output`, which already holds `size` bytes; writes the pending lines first
+	void setOutput(Output* output, uint64_t size);
+
+	// the output is rotated before it would grow beyond this size; 0 disables rotation
+	inline void setMaxFileSize(uint64_t size) { m_maxFileSize = size; }
+
+	void log(std::string_view msgUtf8);
+
+	// in binary mode only copies the record into the batch
+	void logEvent(TraceEvent event, std::initializer_list<int64_t> args = {});
+
+	// writes all collected lines or records
+	void flush();
+
+	inline uint64_t getDroppedCount() const { return m_dropped; }
+
+private:
+	bool reservePending(size_t size);
+	void appendLine(uint64_t timeUs, std::string_view msgUtf8);
+	void written();
+
+	TraceLocalTimeFunc m_localTime;
+	ClockFunc m_clock;
+	Output* m_output = nullptr;
+	uint64_t m_size = 0;
+	uint64_t m_maxFileSize = c_defaultMaxFileSize;
+	uint64_t m_dropped = 0;
+	uint32_t m_processId = 0;
+	bool m_binary = false;
+
+	// timestamp and process id, formatted once per second
+	std::time_t m_stampTime = -1;
+	std::string m_stamp;
+
+	// text of the event being logged; reused between events
+	std::string m_message;
+
+	// formatted lines or records not yet written; reused between writes
+	std::string m_buffer;
+
+	// records logged before the output is set
+	std::string m_pending;
+};
@@ -0,0 +1,122 @@
+//
+// KeePassHotKey
+// UnixSocketChannel.cpp
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "UnixSocketChannel.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+	sockaddr_un makeAddress(std::string const& path) {
+		sockaddr_un addr{};
+		addr.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(addr.sun_path)) {
+			throw std::runtime_error("Socket path too long");
+		}
+		std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+		return addr;
+	}
+
+}
+
+UnixSocketChannel::UnixSocketChannel(std::string const& path) : m_path{ path } {
+	// intentionally empty
+}
+
+UnixSocketChannel::~UnixSocketChannel() {
+	if (m_socket >= 0) {
+		close(m_socket);
+		unlink(m_path.c_str());
+	}
+}
+
+bool UnixSocketChannel::initOrSignal(InstanceMessage msg) {
+	if (m_socket >= 0) return true; // already first instance
+
+	if (trySend(msg)) return false;
+
+	// nobody is listening; a socket file left by a crashed instance is replaced
+	unlink(m_path.c_str());
+
+	int s = socket(AF_UNIX, SOCK_DGRAM, 0);
+	if (s < 0) {
+		throw std::runtime_error("Failed to create instance socket");
+	}
+	const sockaddr_un addr = makeAddress(m_path);
+	if (bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+		close(s);
+		// another instance won the race
+		if (errno == EADDRINUSE && trySend(msg)) return false;
+		throw std::runtime_error("Failed to bind instance socket");
+	}
+
+	m_socket = s;
+	return true;
+}
+
+bool UnixSocketChannel::trySend(InstanceMessage msg) {
+	int s = socket(AF_UNIX, SOCK_DGRAM, 0);
+	if (s < 0) return false;
+	const sockaddr_un addr = makeAddress(m_path);
+	const uint8_t data = static_cast<uint8_t>(msg);
+	const ssize_t sent = sendto(s, &data, 1, 0, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+	close(s);
+	return sent == 1;
+}
+
+InstanceMessage UnixSocketChannel::receive(uint32_t timeoutMs) {
+	if (m_quit) return InstanceMessage::Quit;
+	if (m_socket < 0) {
+		throw std::logic_error("Cannot receive when not the first instance");
+	}
+
+	pollfd pfd{ m_socket, POLLIN, 0 };
+	if (poll(&pfd, 1, static_cast<int>(timeoutMs)) <= 0) return InstanceMessage::None;
+
+	uint8_t data = 0;
+	if (recv(m_socket, &data, 1, MSG_DONTWAIT) != 1) return InstanceMessage::None;
+
+	switch (static_cast<InstanceMessage>(data)) {
+	case InstanceMessage::Quit:
+		m_quit = true;
+		return InstanceMessage::Quit;
+	case InstanceMessage::Activate:
+		return InstanceMessage::Activate;
+	default:
+		// unknown messages, e.g. from newer versions, are ignored
+		return InstanceMessage::None;
+	}
+}
+
+void UnixSocketChannel::clearSignaled() {
+	if (m_socket < 0) return;
+
+	uint8_t data = 0;
+	while (recv(m_socket, &data, 1, MSG_DONTWAIT) == 1) {
+		if (static_cast<InstanceMessage>(data) == InstanceMessage::Quit) {
+			m_quit = true;
+		}
+	}
+}
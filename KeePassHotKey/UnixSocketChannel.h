@@ -0,0 +1,43 @@
+//
+// KeePassHotKey
+// UnixSocketChannel.h
+//
+// Copyright 2022 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "InstanceChannel.h"
+
+#include <string>
+
+// `IInstanceChannel` over a Unix domain datagram socket, one byte per message.
+// Not part of the Windows build; allows to run the resident mode on other platforms, e.g. for tests.
+class UnixSocketChannel : public IInstanceChannel
+{
+public:
+	UnixSocketChannel(std::string const& path);
+	~UnixSocketChannel();
+
+	bool initOrSignal(InstanceMessage msg) override;
+	InstanceMessage receive(uint32_t timeoutMs) override;
+	void clearSignaled() override;
+
+private:
+	bool trySend(InstanceMessage msg);
+
+	std::string m_path;
+	int m_socket = -1;
+	bool m_quit = false;
+};
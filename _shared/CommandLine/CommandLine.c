@@ -0,0 +1,182 @@
+// CommandLine
+// Freely available via Apache License, v2.0; see LICENSE file in the repository root
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "CommandLine.h"
+
+static int IsSpace(wchar_t c)
+{
+	return c == L' ' || c == L'\t';
+}
+
+static int NeedsQuotes(const wchar_t* arg, size_t len)
+{
+	size_t i;
+	if (len == 0) return 1;
+	for (i = 0; i < len; ++i)
+	{
+		const wchar_t c = arg[i];
+		if (c == L' ' || c == L'\t' || c == L'\n' || c == L'\v' || c == L'"') return 1;
+	}
+	return 0;
+}
+
+static wchar_t* Fill(wchar_t* out, wchar_t c, size_t count)
+{
+	while (count-- > 0) *out++ = c;
+	return out;
+}
+
+size_t CLArgumentLength(const wchar_t* arg, size_t len)
+{
+	size_t result;
+	size_t backslashes = 0;
+	size_t i;
+
+	if (!NeedsQuotes(arg, len)) return len;
+
+	result = len + 2;
+	for (i = 0; i < len; ++i)
+	{
+		if (arg[i] == L'\\')
+		{
+			++backslashes;
+			continue;
+		}
+		if (arg[i] == L'"')
+		{
+			// the run of backslashes is doubled, and one more escapes the quote
+			result += backslashes + 1;
+		}
+		backslashes = 0;
+	}
+	// a run before the closing quote is doubled
+	return result + backslashes;
+}
+
+wchar_t* CLWriteArgument(const wchar_t* arg, size_t len, wchar_t* out)
+{
+	const wchar_t* pos = arg;
+	const wchar_t* const end = arg + len;
+
+	if (!NeedsQuotes(arg, len))
+	{
+		wmemcpy(out, arg, len);
+		return out + len;
+	}
+
+	*out++ = L'"';
+	while (pos != end)
+	{
+		// copy the run of characters which need no escaping at once
+		const wchar_t* special = pos;
+		size_t backslashes;
+		while (special != end && *special != L'\\' && *special != L'"') ++special;
+		wmemcpy(out, pos, (size_t)(special - pos));
+		out += special - pos;
+
+		pos = special;
+		while (pos != end && *pos == L'\\') ++pos;
+		backslashes = (size_t)(pos - special);
+		if (pos == end)
+		{
+			// a run before the closing quote is doubled
+			out = Fill(out, L'\\', backslashes * 2);
+		}
+		else if (*pos == L'"')
+		{
+			// the run of backslashes is doubled, and one more escapes the quote
+			out = Fill(out, L'\\', backslashes * 2 + 1);
+			*out++ = L'"';
+			++pos;
+		}
+		else
+		{
+			out = Fill(out, L'\\', backslashes);
+		}
+	}
+	*out++ = L'"';
+	return out;
+}
+
+const wchar_t* CLParseProgramName(const wchar_t* pos, const wchar_t* end, wchar_t* out, size_t* outLen)
+{
+	int quoted = 0;
+	size_t len = 0;
+	for (; pos != end; ++pos)
+	{
+		if (*pos == L'"')
+		{
+			quoted = !quoted;
+		}
+		else if (IsSpace(*pos) && !quoted)
+		{
+			break;
+		}
+		else
+		{
+			out[len++] = *pos;
+		}
+	}
+	*outLen = len;
+	return pos;
+}
+
+const wchar_t* CLParseArgument(const wchar_t* pos, const wchar_t* end, wchar_t* out, size_t* outLen)
+{
+	int quoted = 0;
+	size_t len = 0;
+
+	while (pos != end && IsSpace(*pos)) ++pos;
+	if (pos == end) return NULL;
+
+	while (pos != end)
+	{
+		size_t backslashes = 0;
+		while (pos != end && *pos == L'\\')
+		{
+			++backslashes;
+			++pos;
+		}
+
+		if (pos != end && *pos == L'"')
+		{
+			len = (size_t)(Fill(out + len, L'\\', backslashes / 2) - out);
+			if (backslashes % 2 == 1)
+			{
+				out[len++] = L'"';
+			}
+			else if (quoted && pos + 1 != end && pos[1] == L'"')
+			{
+				// `""` inside quotes is a literal quote
+				out[len++] = L'"';
+				++pos;
+			}
+			else
+			{
+				quoted = !quoted;
+			}
+			++pos;
+			continue;
+		}
+
+		len = (size_t)(Fill(out + len, L'\\', backslashes) - out);
+		if (pos == end || (IsSpace(*pos) && !quoted)) break;
+		out[len++] = *pos++;
+	}
+	*outLen = len;
+	return pos;
+}
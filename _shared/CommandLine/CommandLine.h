@@ -0,0 +1,58 @@
+// CommandLine
+// Freely available via Apache License, v2.0; see LICENSE file in the repository root
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _CommandLine_h_included_
+#define _CommandLine_h_included_
+#pragma once
+
+// Command line quoting and splitting, shared by the tools of this repository which start processes.
+//
+// Arguments are written such that the Microsoft C runtime and `CommandLineToArgvW` split them back unchanged,
+// and are split with the same rules, as the C runtime does since 2008.
+// An argument is quoted if it is empty or contains whitespace or quotes.
+// Inside quotes, a quote is escaped by a backslash, and backslashes are only doubled if they precede a quote.
+// Strings are passed with their length and need not be zero-terminated; nothing is allocated.
+
+#include <stddef.h>
+#include <wchar.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// number of characters `CLWriteArgument` writes for the argument
+size_t CLArgumentLength(const wchar_t* arg, size_t len);
+
+// writes the argument, quoted if needed, and returns the end of the written characters;
+// `out` must hold `CLArgumentLength(arg, len)` characters
+wchar_t* CLWriteArgument(const wchar_t* arg, size_t len, wchar_t* out);
+
+// splits the program name off the start of a command line: it ends at whitespace outside of quotes,
+// and backslashes do not escape quotes.
+// Writes it to `out`, which must hold `end - pos` characters, sets `outLen`, and returns the position after it.
+const wchar_t* CLParseProgramName(const wchar_t* pos, const wchar_t* end, wchar_t* out, size_t* outLen);
+
+// skips whitespace and splits off the next argument.
+// Writes it to `out`, which must hold `end - pos` characters, sets `outLen`, and returns the position after it;
+// returns NULL if there is no further argument.
+const wchar_t* CLParseArgument(const wchar_t* pos, const wchar_t* end, wchar_t* out, size_t* outLen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CommandLine_h_included_ */
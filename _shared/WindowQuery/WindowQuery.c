@@ -0,0 +1,390 @@
+// WindowQuery
+// Freely available via Apache License, v2.0; see LICENSE file in the repository root
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "WindowQuery.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <wctype.h>
+
+#define WQ_KNOWN_VISIBLE 0x01
+#define WQ_KNOWN_OWNER 0x02
+#define WQ_KNOWN_CLASS 0x04
+#define WQ_KNOWN_PROCESS 0x08
+
+static const wchar_t* const emptyString = L"";
+
+static int AddWindow(struct WQSnapshot* snapshot, WQWindow window, uint32_t processId)
+{
+	struct WQWindowEntry* w;
+	if (snapshot->count == snapshot->capacity)
+	{
+		size_t capacity = (snapshot->capacity == 0) ? 256 : (snapshot->capacity * 2);
+		w = (struct WQWindowEntry*)realloc(snapshot->windows, capacity * sizeof(struct WQWindowEntry));
+		if (w == NULL)
+		{
+			snapshot->outOfMemory = 1;
+			return 0;
+		}
+		snapshot->windows = w;
+		snapshot->capacity = capacity;
+	}
+
+	w = &snapshot->windows[snapshot->count++];
+	memset(w, 0, sizeof(struct WQWindowEntry));
+	w->window = window;
+	w->processId = processId;
+	return 1;
+}
+
+int WQSnapshotTake(struct WQSnapshot* snapshot, const struct WQProvider* provider, WQWindow parent)
+{
+	memset(snapshot, 0, sizeof(struct WQSnapshot));
+	snapshot->provider = provider;
+	provider->enumWindows(provider->context, parent, &AddWindow, snapshot);
+	return !snapshot->outOfMemory;
+}
+
+void WQSnapshotFree(struct WQSnapshot* snapshot)
+{
+	size_t i;
+	for (i = 0; i < snapshot->count; ++i)
+	{
+		if (snapshot->windows[i].className != emptyString)
+		{
+			free(snapshot->windows[i].className);
+		}
+	}
+	for (i = 0; i < snapshot->processCount; ++i)
+	{
+		if (snapshot->processes[i].image != emptyString)
+		{
+			free(snapshot->processes[i].image);
+		}
+	}
+	free(snapshot->windows);
+	free(snapshot->processes);
+	free(snapshot->processIndex);
+	memset(snapshot, 0, sizeof(struct WQSnapshot));
+}
+
+int WQSnapshotIsVisible(struct WQSnapshot* snapshot, size_t index)
+{
+	struct WQWindowEntry* w = &snapshot->windows[index];
+	if ((w->known & WQ_KNOWN_VISIBLE) == 0)
+	{
+		if (snapshot->provider->isVisible(snapshot->provider->context, w->window))
+		{
+			w->flags |= WQ_KNOWN_VISIBLE;
+		}
+		w->known |= WQ_KNOWN_VISIBLE;
+	}
+	return (w->flags & WQ_KNOWN_VISIBLE) != 0;
+}
+
+int WQSnapshotHasOwner(struct WQSnapshot* snapshot, size_t index)
+{
+	struct WQWindowEntry* w = &snapshot->windows[index];
+	if ((w->known & WQ_KNOWN_OWNER) == 0)
+	{
+		if (snapshot->provider->hasOwner(snapshot->provider->context, w->window))
+		{
+			w->flags |= WQ_KNOWN_OWNER;
+		}
+		w->known |= WQ_KNOWN_OWNER;
+	}
+	return (w->flags & WQ_KNOWN_OWNER) != 0;
+}
+
+static wchar_t* CopyString(const wchar_t* str, size_t len)
+{
+	wchar_t* copy;
+	if (len == 0)
+	{
+		return (wchar_t*)emptyString;
+	}
+	copy = (wchar_t*)malloc((len + 1) * sizeof(wchar_t));
+	if (copy == NULL)
+	{
+		return (wchar_t*)emptyString;
+	}
+	memcpy(copy, str, len * sizeof(wchar_t));
+	copy[len] = 0;
+	return copy;
+}
+
+const wchar_t* WQSnapshotClassName(struct WQSnapshot* snapshot, size_t index)
+{
+	wchar_t buf[WQ_MAX_NAME_LEN + 1];
+	size_t len;
+	struct WQWindowEntry* w = &snapshot->windows[index];
+	if ((w->known & WQ_KNOWN_CLASS) == 0)
+	{
+		len = snapshot->provider->getClassName(snapshot->provider->context, w->window, buf, WQ_MAX_NAME_LEN);
+		w->className = CopyString(buf, (len > WQ_MAX_NAME_LEN) ? WQ_MAX_NAME_LEN : len);
+		w->known |= WQ_KNOWN_CLASS;
+	}
+	return w->className;
+}
+
+static size_t ProcessSlot(const struct WQSnapshot* snapshot, uint32_t processId)
+{
+	// process ids are multiples of four on Windows
+	size_t mask = snapshot->processIndexSize - 1;
+	size_t slot = ((processId >> 2) * 2654435761u) & mask;
+	uint32_t entry;
+	while ((entry = snapshot->processIndex[slot]) != 0 && snapshot->processes[entry - 1].processId != processId)
+	{
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+static int GrowProcesses(struct WQSnapshot* snapshot)
+{
+	size_t capacity = (snapshot->processCapacity == 0) ? 16 : (snapshot->processCapacity * 2);
+	size_t i;
+	struct WQProcessEntry* p;
+	uint32_t* index;
+
+	p = (struct WQProcessEntry*)realloc(snapshot->processes, capacity * sizeof(struct WQProcessEntry));
+	if (p == NULL)
+	{
+		return 0;
+	}
+	snapshot->processes = p;
+	snapshot->processCapacity = capacity;
+
+	// at most half full, so probing stays short
+	index = (uint32_t*)calloc(capacity * 2, sizeof(uint32_t));
+	if (index == NULL)
+	{
+		return 0;
+	}
+	free(snapshot->processIndex);
+	snapshot->processIndex = index;
+	snapshot->processIndexSize = capacity * 2;
+	for (i = 0; i < snapshot->processCount; ++i)
+	{
+		index[ProcessSlot(snapshot, snapshot->processes[i].processId)] = (uint32_t)(i + 1);
+	}
+	return 1;
+}
+
+static uint32_t FindOrAddProcess(struct WQSnapshot* snapshot, uint32_t processId, uint32_t hint)
+{
+	wchar_t buf[WQ_MAX_NAME_LEN + 1];
+	size_t slot, len;
+	struct WQProcessEntry* p;
+
+	// windows of one process are often next to each other
+	if (hint < snapshot->processCount && snapshot->processes[hint].processId == processId)
+	{
+		return hint;
+	}
+	if (snapshot->processIndexSize > 0)
+	{
+		slot = ProcessSlot(snapshot, processId);
+		if (snapshot->processIndex[slot] != 0)
+		{
+			return snapshot->processIndex[slot] - 1;
+		}
+	}
+
+	if (snapshot->processCount == snapshot->processCapacity)
+	{
+		if (!GrowProcesses(snapshot))
+		{
+			snapshot->outOfMemory = 1;
+			return UINT32_MAX;
+		}
+	}
+
+	len = snapshot->provider->getProcessImage(snapshot->provider->context, processId, buf, WQ_MAX_NAME_LEN);
+	p = &snapshot->processes[snapshot->processCount];
+	p->processId = processId;
+	p->image = CopyString(buf, (len > WQ_MAX_NAME_LEN) ? WQ_MAX_NAME_LEN : len);
+	snapshot->processIndex[ProcessSlot(snapshot, processId)] = (uint32_t)(snapshot->processCount + 1);
+	return (uint32_t)(snapshot->processCount++);
+}
+
+const wchar_t* WQSnapshotProcessImage(struct WQSnapshot* snapshot, size_t index)
+{
+	struct WQWindowEntry* w = &snapshot->windows[index];
+	if ((w->known & WQ_KNOWN_PROCESS) == 0)
+	{
+		uint32_t hint = (index > 0) ? snapshot->windows[index - 1].process : 0;
+		w->process = FindOrAddProcess(snapshot, w->processId, hint);
+		if (w->process == UINT32_MAX)
+		{
+			return emptyString;
+		}
+		w->known |= WQ_KNOWN_PROCESS;
+	}
+	return snapshot->processes[w->process].image;
+}
+
+void WQQueryInit(struct WQQuery* query)
+{
+	memset(query, 0, sizeof(struct WQQuery));
+}
+
+static int AddPredicate(struct WQQuery* query, enum WQPredicateKind kind, const uint32_t* processIds, size_t processIdCount, const wchar_t* text)
+{
+	struct WQPredicate* p;
+	if (query->count >= WQ_MAX_PREDICATES)
+	{
+		return 0;
+	}
+	p = &query->predicates[query->count++];
+	p->kind = kind;
+	p->processIds = processIds;
+	p->processIdCount = processIdCount;
+	p->text = text;
+	query->compiled = 0;
+	return 1;
+}
+
+int WQQueryProcessIdIn(struct WQQuery* query, const uint32_t* processIds, size_t count)
+{
+	return AddPredicate(query, WQ_PROCESS_ID_IN, processIds, count, NULL);
+}
+
+int WQQueryVisible(struct WQQuery* query)
+{
+	return AddPredicate(query, WQ_VISIBLE, NULL, 0, NULL);
+}
+
+int WQQueryTopLevel(struct WQQuery* query)
+{
+	return AddPredicate(query, WQ_TOP_LEVEL, NULL, 0, NULL);
+}
+
+int WQQueryClassContains(struct WQQuery* query, const wchar_t* text)
+{
+	return AddPredicate(query, WQ_CLASS_CONTAINS, NULL, 0, text);
+}
+
+int WQQueryProcessImage(struct WQQuery* query, const wchar_t* path)
+{
+	return AddPredicate(query, WQ_PROCESS_IMAGE, NULL, 0, path);
+}
+
+void WQQueryCompile(struct WQQuery* query)
+{
+	unsigned int i, j;
+	struct WQPredicate p;
+
+	// stable insertion sort, the plan is only a handful of predicates
+	for (i = 1; i < query->count; ++i)
+	{
+		p = query->predicates[i];
+		for (j = i; j > 0 && query->predicates[j - 1].kind > p.kind; --j)
+		{
+			query->predicates[j] = query->predicates[j - 1];
+		}
+		query->predicates[j] = p;
+	}
+	query->compiled = 1;
+}
+
+static int EqualsNoCase(const wchar_t* a, const wchar_t* b)
+{
+	for (; *a != 0 && *b != 0; ++a, ++b)
+	{
+		if (*a != *b && towlower(*a) != towlower(*b))
+		{
+			return 0;
+		}
+	}
+	return *a == *b;
+}
+
+static int ContainsNoCase(const wchar_t* str, const wchar_t* text)
+{
+	const wchar_t* s;
+	const wchar_t* t;
+	if (*text == 0)
+	{
+		return 1;
+	}
+	for (; *str != 0; ++str)
+	{
+		for (s = str, t = text; *s != 0 && *t != 0 && towlower(*s) == towlower(*t); ++s, ++t);
+		if (*t == 0)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int PredicateMatches(const struct WQPredicate* p, struct WQSnapshot* snapshot, size_t index)
+{
+	size_t i;
+	switch (p->kind)
+	{
+	case WQ_PROCESS_ID_IN:
+		for (i = 0; i < p->processIdCount; ++i)
+		{
+			if (p->processIds[i] == snapshot->windows[index].processId)
+			{
+				return 1;
+			}
+		}
+		return 0;
+	case WQ_VISIBLE:
+		return WQSnapshotIsVisible(snapshot, index);
+	case WQ_TOP_LEVEL:
+		return !WQSnapshotHasOwner(snapshot, index);
+	case WQ_CLASS_CONTAINS:
+		return ContainsNoCase(WQSnapshotClassName(snapshot, index), p->text);
+	case WQ_PROCESS_IMAGE:
+		return EqualsNoCase(WQSnapshotProcessImage(snapshot, index), p->text);
+	}
+	return 0;
+}
+
+int WQQueryMatches(const struct WQQuery* query, struct WQSnapshot* snapshot, size_t index)
+{
+	unsigned int i;
+	for (i = 0; i < query->count; ++i)
+	{
+		if (!PredicateMatches(&query->predicates[i], snapshot, index))
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+size_t WQQueryRun(struct WQQuery* query, struct WQSnapshot* snapshot, WQWindow* out, size_t maxCount)
+{
+	size_t i, found = 0;
+	if (!query->compiled)
+	{
+		WQQueryCompile(query);
+	}
+	for (i = 0; i < snapshot->count && found < maxCount; ++i)
+	{
+		if (WQQueryMatches(query, snapshot, i))
+		{
+			out[found++] = snapshot->windows[i].window;
+		}
+	}
+	return found;
+}
@@ -0,0 +1,177 @@
+// WindowQuery
+// Freely available via Apache License, v2.0; see LICENSE file in the repository root
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _WindowQuery_h_included_
+#define _WindowQuery_h_included_
+#pragma once
+
+// Declarative queries for windows, shared by the window-finding tools of this repository.
+//
+// A query is a set of predicates, which is compiled once into a plan checking the cheap attributes first.
+// It runs against a snapshot of one window enumeration, which fetches each attribute of a window,
+// and the image path of each process, at most once, no matter how many queries run against the snapshot.
+// Windows are only accessed through a `WQProvider`, so this code does not depend on Windows.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// a window handle, i.e. a `HWND` on Windows
+typedef uintptr_t WQWindow;
+
+struct WQSnapshot;
+
+// adds one window to the snapshot being taken; returns zero to stop the enumeration
+typedef int (*WQAddWindowFunc)(struct WQSnapshot* snapshot, WQWindow window, uint32_t processId);
+
+struct WQProvider
+{
+	void* context;
+
+	// calls `add` for each top-level window in z-order if `parent` is zero, otherwise for each descendant of `parent`
+	void (*enumWindows)(void* context, WQWindow parent, WQAddWindowFunc add, struct WQSnapshot* snapshot);
+
+	int (*isVisible)(void* context, WQWindow window);
+
+	int (*hasOwner)(void* context, WQWindow window);
+
+	// writes the zero-terminated class name, truncated to `size` characters; returns its length
+	size_t (*getClassName)(void* context, WQWindow window, wchar_t* buf, size_t size);
+
+	// writes the zero-terminated full path of the process' executable; returns its length, zero on failure
+	size_t (*getProcessImage)(void* context, uint32_t processId, wchar_t* buf, size_t size);
+};
+
+// the provider of the current desktop; only available in the Windows build
+const struct WQProvider* WQGetWin32Provider(void);
+
+#define WQ_MAX_NAME_LEN 260
+
+struct WQWindowEntry
+{
+	WQWindow window;
+	uint32_t processId;
+	// bits of the attributes fetched so far, and their values
+	uint8_t known;
+	uint8_t flags;
+	// index into `WQSnapshot.processes`, valid once the image is known
+	uint32_t process;
+	wchar_t* className;
+};
+
+struct WQProcessEntry
+{
+	uint32_t processId;
+	// empty if the process could not be opened
+	wchar_t* image;
+};
+
+struct WQSnapshot
+{
+	const struct WQProvider* provider;
+
+	struct WQWindowEntry* windows;
+	size_t count;
+	size_t capacity;
+
+	struct WQProcessEntry* processes;
+	size_t processCount;
+	size_t processCapacity;
+	// open addressing hash of `processes` by process id, holding index + 1, zero for empty slots
+	uint32_t* processIndex;
+	size_t processIndexSize;
+
+	int outOfMemory;
+};
+
+// enumerates the windows, see `WQProvider.enumWindows`; returns zero if out of memory
+int WQSnapshotTake(struct WQSnapshot* snapshot, const struct WQProvider* provider, WQWindow parent);
+
+void WQSnapshotFree(struct WQSnapshot* snapshot);
+
+int WQSnapshotIsVisible(struct WQSnapshot* snapshot, size_t index);
+
+int WQSnapshotHasOwner(struct WQSnapshot* snapshot, size_t index);
+
+// never NULL
+const wchar_t* WQSnapshotClassName(struct WQSnapshot* snapshot, size_t index);
+
+// never NULL; empty if the process could not be opened
+const wchar_t* WQSnapshotProcessImage(struct WQSnapshot* snapshot, size_t index);
+
+enum WQPredicateKind
+{
+	// ordered by cost, which is the order of the compiled plan
+	WQ_PROCESS_ID_IN,
+	WQ_VISIBLE,
+	WQ_TOP_LEVEL,
+	WQ_CLASS_CONTAINS,
+	WQ_PROCESS_IMAGE,
+};
+
+#define WQ_MAX_PREDICATES 8
+
+struct WQPredicate
+{
+	enum WQPredicateKind kind;
+	// not copied, must stay valid while the query is used
+	const uint32_t* processIds;
+	size_t processIdCount;
+	const wchar_t* text;
+};
+
+struct WQQuery
+{
+	struct WQPredicate predicates[WQ_MAX_PREDICATES];
+	unsigned int count;
+	int compiled;
+};
+
+void WQQueryInit(struct WQQuery* query);
+
+// the process id is one of `processIds`
+int WQQueryProcessIdIn(struct WQQuery* query, const uint32_t* processIds, size_t count);
+
+int WQQueryVisible(struct WQQuery* query);
+
+// the window has no owner, as main windows do; tool tips and dialogs have one
+int WQQueryTopLevel(struct WQQuery* query);
+
+// the class name contains `text`, compared case-insensitive
+int WQQueryClassContains(struct WQQuery* query, const wchar_t* text);
+
+// the full path of the process' executable equals `path`, compared case-insensitive
+int WQQueryProcessImage(struct WQQuery* query, const wchar_t* path);
+
+// orders the predicates by cost; called by `WQQueryRun` if needed
+void WQQueryCompile(struct WQQuery* query);
+
+int WQQueryMatches(const struct WQQuery* query, struct WQSnapshot* snapshot, size_t index);
+
+// writes up to `maxCount` matching windows to `out` in z-order, and returns their number;
+// stops at the `maxCount`-th match
+size_t WQQueryRun(struct WQQuery* query, struct WQSnapshot* snapshot, WQWindow* out, size_t maxCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _WindowQuery_h_included_ */
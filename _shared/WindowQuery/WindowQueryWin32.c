@@ -0,0 +1,106 @@
+// WindowQuery
+// Freely available via Apache License, v2.0; see LICENSE file in the repository root
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "WindowQuery.h"
+
+#define VC_EXTRALEAN
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+struct EnumContext
+{
+	WQAddWindowFunc add;
+	struct WQSnapshot* snapshot;
+};
+
+static BOOL CALLBACK AddEnumeratedWindow(HWND hWnd, LPARAM lParam)
+{
+	struct EnumContext* context = (struct EnumContext*)lParam;
+	DWORD processId = 0;
+	GetWindowThreadProcessId(hWnd, &processId);
+	return context->add(context->snapshot, (WQWindow)hWnd, processId) ? TRUE : FALSE;
+}
+
+static void Win32EnumWindows(void* context, WQWindow parent, WQAddWindowFunc add, struct WQSnapshot* snapshot)
+{
+	struct EnumContext enumContext;
+	enumContext.add = add;
+	enumContext.snapshot = snapshot;
+	if (parent == 0)
+	{
+		EnumWindows(&AddEnumeratedWindow, (LPARAM)&enumContext);
+	}
+	else
+	{
+		EnumChildWindows((HWND)parent, &AddEnumeratedWindow, (LPARAM)&enumContext);
+	}
+}
+
+static int Win32IsVisible(void* context, WQWindow window)
+{
+	return IsWindowVisible((HWND)window) != FALSE;
+}
+
+static int Win32HasOwner(void* context, WQWindow window)
+{
+	return GetWindow((HWND)window, GW_OWNER) != NULL;
+}
+
+static size_t Win32GetClassName(void* context, WQWindow window, wchar_t* buf, size_t size)
+{
+	int len = GetClassNameW((HWND)window, buf, (int)size + 1);
+	if (len <= 0)
+	{
+		len = 0;
+	}
+	buf[len] = 0;
+	return (size_t)len;
+}
+
+static size_t Win32GetProcessImage(void* context, uint32_t processId, wchar_t* buf, size_t size)
+{
+	HANDLE proc;
+	DWORD len = (DWORD)size + 1;
+
+	proc = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+	if (proc == NULL)
+	{
+		buf[0] = 0;
+		return 0;
+	}
+	if (!QueryFullProcessImageNameW(proc, 0, buf, &len))
+	{
+		len = 0;
+	}
+	buf[len] = 0;
+	CloseHandle(proc);
+	return len;
+}
+
+static const struct WQProvider win32Provider = {
+	NULL,
+	&Win32EnumWindows,
+	&Win32IsVisible,
+	&Win32HasOwner,
+	&Win32GetClassName,
+	&Win32GetProcessImage
+};
+
+const struct WQProvider* WQGetWin32Provider(void)
+{
+	return &win32Provider;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+/// <summary>
+/// Times a benchmark body; with `--smoke`, as passed by ctest, each body runs once,
+/// so the benchmark is only checked to build and work
+/// </summary>
+class Benchmark
+{
+public:
+	Benchmark(int argc, char** argv)
+		: m_smoke(argc > 1 && std::strcmp(argv[1], "--smoke") == 0)
+	{
+	}
+
+	bool IsSmoke() const { return m_smoke; }
+
+	/// <summary>
+	/// Calls `body(i)` for `iterations` indexes per round,
+	/// prints the time per iteration of the fastest round, and returns it in nanoseconds
+	/// </summary>
+	template <typename Body>
+	double Run(char const* name, size_t iterations, Body&& body)
+	{
+		if (m_smoke) iterations = 1;
+		const int rounds = m_smoke ? 1 : c_rounds;
+
+		double best = std::numeric_limits<double>::max();
+		for (int round = 0; round < rounds; ++round)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				body(i);
+			}
+			const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+			best = std::min(best, elapsed.count() / static_cast<double>(iterations));
+		}
+
+		if (best >= 1e6) std::printf("%-48s %12.2f ms\n", name, best / 1e6);
+		else if (best >= 1e4) std::printf("%-48s %12.2f us\n", name, best / 1e3);
+		else std::printf("%-48s %12.1f ns\n", name, best);
+		return best;
+	}
+
+private:
+	static constexpr int c_rounds = 5;
+
+	bool m_smoke;
+};
+
+// Keeps the compiler from dropping the computation of an unused result
+template <typename T>
+inline void DoNotOptimize(T const& value)
+{
+	asm volatile("" : : "r"(&value) : "memory");
+}
@@ -0,0 +1,174 @@
+#include "ActionRegistry.h"
+#include "TestUtils.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	using Param = ActionRegistry::Parameter;
+
+	struct Calls
+	{
+		std::vector<std::vector<std::wstring>> beep;
+		std::vector<std::vector<std::wstring>> fail;
+	};
+
+	void RegisterTestActions(ActionRegistry& registry, Calls& calls)
+	{
+		CHECK(registry.Register(L"beep",
+			{
+				{ L"tone", L"Asterisk", false, { L"Asterisk", L"Exclamation", L"Hand" } },
+				{ L"repeat", L"1" },
+			},
+			[&calls](std::vector<std::wstring> const& args, std::wstring&)
+			{
+				calls.beep.push_back(args);
+				return true;
+			}));
+		CHECK(registry.Register(L"fail",
+			{
+				{ L"message", {}, true },
+				{ L"code" },
+			},
+			[&calls](std::vector<std::wstring> const& args, std::wstring& outError)
+			{
+				calls.fail.push_back(args);
+				outError = args[0];
+				return false;
+			}));
+		CHECK(registry.Register(L"none", {}, [](std::vector<std::wstring> const& args, std::wstring&) { return args.empty(); }));
+	}
+
+	void TestRegister()
+	{
+		ActionRegistry registry;
+		Calls calls;
+		RegisterTestActions(registry, calls);
+		CHECK(registry.Contains(L"beep"));
+		CHECK(registry.Contains(L"none"));
+		// names are case-sensitive
+		CHECK(!registry.Contains(L"Beep"));
+
+		auto handler = [](std::vector<std::wstring> const&, std::wstring&) { return true; };
+		CHECK(!registry.Register(L"beep", {}, handler));
+		CHECK(!registry.Register(L"", {}, handler));
+		CHECK(!registry.Register(L"empty", {}, nullptr));
+		CHECK(!registry.Contains(L"empty"));
+	}
+
+	void TestBindDefaults()
+	{
+		ActionRegistry registry;
+		Calls calls;
+		RegisterTestActions(registry, calls);
+		ActionRegistry::Binding binding;
+		std::wstring error;
+
+		CHECK(!binding.IsValid());
+		CHECK(registry.Bind(L"beep", {}, binding, error));
+		CHECK(binding.IsValid());
+		CHECK(binding.GetArguments() == (std::vector<std::wstring>{ L"Asterisk", L"1" }));
+
+		CHECK(registry.Bind(L"beep", { L"Hand" }, binding, error));
+		CHECK(binding.GetArguments() == (std::vector<std::wstring>{ L"Hand", L"1" }));
+
+		CHECK(registry.Bind(L"beep", { L"Hand", L"3" }, binding, error));
+		CHECK(binding.GetArguments() == (std::vector<std::wstring>{ L"Hand", L"3" }));
+
+		// optional parameters without a default bind to empty arguments
+		CHECK(registry.Bind(L"fail", { L"oops" }, binding, error));
+		CHECK(binding.GetArguments() == (std::vector<std::wstring>{ L"oops", L"" }));
+
+		CHECK(registry.Bind(L"none", {}, binding, error));
+		CHECK(binding.GetArguments().empty());
+	}
+
+	void TestBindChoices()
+	{
+		ActionRegistry registry;
+		Calls calls;
+		RegisterTestActions(registry, calls);
+		ActionRegistry::Binding binding;
+		std::wstring error;
+
+		// choices match ignoring case, and bind in their registered spelling
+		CHECK(registry.Bind(L"beep", { L"exclamation" }, binding, error));
+		CHECK(binding.GetArguments()[0] == L"Exclamation");
+		CHECK(registry.Bind(L"beep", { L"HAND" }, binding, error));
+		CHECK(binding.GetArguments()[0] == L"Hand");
+
+		CHECK(!registry.Bind(L"beep", { L"Question" }, binding, error));
+		CHECK(!binding.IsValid());
+		CHECK(error == L"action `beep` argument `tone` must be one of Asterisk Exclamation Hand, but is Question");
+		// a prefix of a choice is no match
+		CHECK(!registry.Bind(L"beep", { L"Hans" }, binding, error));
+		CHECK(!registry.Bind(L"beep", { L"" }, binding, error));
+
+		// parameters without choices take any value
+		CHECK(registry.Bind(L"beep", { L"Hand", L"anything" }, binding, error));
+	}
+
+	void TestBindErrors()
+	{
+		ActionRegistry registry;
+		Calls calls;
+		RegisterTestActions(registry, calls);
+		ActionRegistry::Binding binding;
+		std::wstring error;
+
+		// a failed bind invalidates a previous binding
+		CHECK(registry.Bind(L"beep", {}, binding, error));
+		CHECK(!registry.Bind(L"boop", {}, binding, error));
+		CHECK(!binding.IsValid());
+		CHECK(error == L"action `boop` is unknown; available actions are beep fail none");
+
+		CHECK(!registry.Bind(L"beep", { L"Hand", L"1", L"extra" }, binding, error));
+		CHECK(error == L"action `beep` takes at most 2 arguments, but 3 are given");
+		CHECK(!registry.Bind(L"none", { L"x" }, binding, error));
+		CHECK(error == L"action `none` takes at most 0 arguments, but 1 are given");
+
+		CHECK(!registry.Bind(L"fail", {}, binding, error));
+		CHECK(error == L"action `fail` requires argument `message`");
+	}
+
+	void TestInvoke()
+	{
+		ActionRegistry registry;
+		Calls calls;
+		RegisterTestActions(registry, calls);
+		ActionRegistry::Binding binding;
+		std::wstring error;
+
+		CHECK(!registry.Invoke(binding, error));
+		CHECK(error == L"action is not bound");
+		CHECK(calls.beep.empty());
+
+		CHECK(registry.Bind(L"beep", { L"hand" }, binding, error));
+		error.clear();
+		CHECK(registry.Invoke(binding, error));
+		CHECK(registry.Invoke(binding, error));
+		CHECK(error.empty());
+		CHECK(calls.beep.size() == 2);
+		CHECK(calls.beep[1] == (std::vector<std::wstring>{ L"Hand", L"1" }));
+
+		CHECK(registry.Bind(L"fail", { L"broken", L"7" }, binding, error));
+		CHECK(!registry.Invoke(binding, error));
+		CHECK(error == L"broken");
+		CHECK(calls.fail.size() == 1);
+		CHECK(calls.fail[0] == (std::vector<std::wstring>{ L"broken", L"7" }));
+
+		CHECK(registry.Bind(L"none", {}, binding, error));
+		CHECK(registry.Invoke(binding, error));
+	}
+}
+
+int main()
+{
+	TestRegister();
+	TestBindDefaults();
+	TestBindChoices();
+	TestBindErrors();
+	TestInvoke();
+	return 0;
+}
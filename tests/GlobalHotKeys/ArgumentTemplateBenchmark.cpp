@@ -0,0 +1,94 @@
+#include "ArgumentTemplate.h"
+#include "BenchUtils.h"
+#include "TestUtils.h"
+
+#include <string>
+
+namespace
+{
+	class BenchSource : public IArgumentSource
+	{
+	public:
+		bool GetEnvironmentValue(std::wstring const& name, std::wstring& outValue) override
+		{
+			if (name == L"USERPROFILE") outValue = L"C:\\Users\\bob";
+			else if (name == L"USER") outValue = L"bob";
+			else return false;
+			return true;
+		}
+
+		bool GetClipboardText(std::wstring& outText) override
+		{
+			outText = L"https://www.sgrottel.de";
+			return true;
+		}
+
+		std::tm GetNow() override
+		{
+			std::tm t{};
+			t.tm_year = 126;
+			t.tm_mon = 9;
+			t.tm_mday = 17;
+			return t;
+		}
+	};
+}
+
+// Evaluating an argument per trigger: compiled once, and folded at load, against parsing it on every trigger
+int main(int argc, char** argv)
+{
+	Benchmark bench{ argc, argv };
+
+	const std::wstring source = L"--out=${env:USERPROFILE}\\Notes\\${date:%Y-%m-%d}-${env:USER}.md --config=${configdir} --url=${clipboard}";
+	const std::filesystem::path configDir = L"C:\\Users\\bob\\AppData\\Roaming\\GlobalHotKeys";
+	BenchSource src;
+	std::wstring error, warning;
+	std::wstring out;
+	size_t length = 0;
+
+	bench.Run("Compile and Evaluate per trigger", 100000, [&](size_t)
+		{
+			ArgumentTemplate t;
+			t.Compile(source, error, warning);
+			out.clear();
+			t.Evaluate(src, configDir, out);
+			length += out.size();
+		});
+	const std::wstring expected = out;
+
+	ArgumentTemplate compiled;
+	CHECK(compiled.Compile(source, error, warning));
+	CHECK(warning.empty());
+	bench.Run("Evaluate, compiled", 100000, [&](size_t)
+		{
+			out.clear();
+			compiled.Evaluate(src, configDir, out);
+			length += out.size();
+		});
+	CHECK(out == expected);
+
+	const ArgumentTemplate folded = compiled.Fold(src, configDir);
+	CHECK(!folded.DependsOnEnvironment());
+	bench.Run("Evaluate, folded at load", 100000, [&](size_t)
+		{
+			out.clear();
+			folded.Evaluate(src, configDir, out);
+			length += out.size();
+		});
+	CHECK(out == expected);
+
+	ArgumentTemplate constant;
+	CHECK(constant.Compile(L"--user=${env:USER}", error, warning));
+	const ArgumentTemplate foldedConstant = constant.Fold(src, configDir);
+	CHECK(foldedConstant.IsConstant());
+	bench.Run("Evaluate, folded to a constant", 100000, [&](size_t)
+		{
+			out.clear();
+			foldedConstant.Evaluate(src, configDir, out);
+			length += out.size();
+		});
+	CHECK(out == L"--user=bob");
+
+	DoNotOptimize(length);
+	return 0;
+}
@@ -0,0 +1,169 @@
+#include "ArgumentTemplate.h"
+#include "TestUtils.h"
+
+#include <map>
+#include <random>
+
+namespace
+{
+	class TestSource : public IArgumentSource
+	{
+	public:
+		bool GetEnvironmentValue(std::wstring const& name, std::wstring& outValue) override
+		{
+			auto it = env.find(name);
+			if (it == env.end()) return false;
+			outValue = it->second;
+			return true;
+		}
+
+		bool GetClipboardText(std::wstring& outText) override
+		{
+			outText = L"CLIP";
+			return true;
+		}
+
+		std::tm GetNow() override
+		{
+			std::tm t{};
+			t.tm_year = 126;
+			t.tm_mon = 9;
+			t.tm_mday = 17;
+			t.tm_hour = 8;
+			t.tm_wday = 6;
+			return t;
+		}
+
+		std::map<std::wstring, std::wstring> env{ { L"USER", L"bob" } };
+	};
+
+	// the value, or the error prefixed by `error: `; the warning, if any, is appended after ` | `
+	std::wstring Eval(std::wstring const& source)
+	{
+		TestSource src;
+		ArgumentTemplate t;
+		std::wstring error, warning;
+		if (!t.Compile(source, error, warning))
+		{
+			CHECK(t.GetTokens().empty());
+			return L"error: " + error;
+		}
+		std::wstring out;
+		t.Evaluate(src, L"/cfg", out);
+		return warning.empty() ? out : (out + L" | " + warning);
+	}
+
+	void TestPlaceholders()
+	{
+		CHECK(Eval(L"") == L"");
+		CHECK(Eval(L"plain") == L"plain");
+		CHECK(Eval(L"a${env:USER}b") == L"abobb");
+		CHECK(Eval(L"${env:MISSING}x") == L"x");
+		CHECK(Eval(L"${date}") == L"2026-10-17");
+		CHECK(Eval(L"${date:%H-%Y}") == L"08-2026");
+		CHECK(Eval(L"${configdir}/x ${clipboard}") == L"/cfg/x CLIP");
+		CHECK(Eval(L"$$ $x ${$}{env:USER}") == L"$$ $x ${env:USER}");
+	}
+
+	// text which is no known placeholder keeps its value, as before placeholders existed
+	void TestKeptAsText()
+	{
+		CHECK(Eval(L"${nope}") == L"${nope} | unknown placeholder `${nope}` kept as text");
+		CHECK(Eval(L"${env:}") == L"${env:} | unknown placeholder `${env:}` kept as text");
+		CHECK(Eval(L"a${x}${env:USER}") == L"a${x}bob | unknown placeholder `${x}` kept as text");
+		CHECK(Eval(L"ab${env:X") == L"ab${env:X | placeholder at position 3 is not closed by `}`, kept as text");
+		CHECK(Eval(L"${a}${b}") == L"${a}${b} | unknown placeholder `${a}` kept as text; unknown placeholder `${b}` kept as text");
+	}
+
+	void TestDateFormats()
+	{
+		std::wstring error;
+		CHECK(ArgumentTemplate::IsValidDateFormat(ArgumentTemplate::c_defaultDateFormat, error));
+		CHECK(ArgumentTemplate::IsValidDateFormat(L"%A, %d. %B %Y %H:%M:%S %Z %%", error));
+		CHECK(ArgumentTemplate::IsValidDateFormat(L"no conversion", error));
+
+		CHECK(!ArgumentTemplate::IsValidDateFormat(L"%Y%", error));
+		CHECK(error == L"date format `%Y%` ends with `%`");
+		CHECK(!ArgumentTemplate::IsValidDateFormat(L"%Ey", error));
+		CHECK(!ArgumentTemplate::IsValidDateFormat(L"%#d", error));
+		CHECK(!ArgumentTemplate::IsValidDateFormat(L"%Q", error));
+		CHECK(error == L"date format `%Q` has unsupported conversion `%Q`");
+		CHECK(!ArgumentTemplate::IsValidDateFormat(L"%c %c %c %c", error));
+		CHECK(!ArgumentTemplate::IsValidDateFormat(std::wstring(256, L'x'), error));
+		CHECK(ArgumentTemplate::IsValidDateFormat(std::wstring(255, L'x'), error));
+
+		CHECK(Eval(L"x${date:%Q}") == L"error: date format `%Q` has unsupported conversion `%Q`");
+		CHECK(Eval(L"${date:" + std::wstring(255, L'y') + L"}") == std::wstring(255, L'y'));
+	}
+
+	void TestFold()
+	{
+		TestSource src;
+		std::wstring error, warning;
+		ArgumentTemplate t;
+		CHECK(t.Compile(L"x ${env:USER} ${configdir} ${date}", error, warning));
+		const ArgumentTemplate folded = t.Fold(src, L"/c");
+		CHECK(t.DependsOnEnvironment());
+		CHECK(!folded.IsConstant());
+		CHECK(!folded.DependsOnEnvironment());
+		CHECK(folded.GetTokens().size() == 2);
+		CHECK(folded.GetTokens()[0].text == L"x bob /c ");
+
+		CHECK(t.Compile(L"x ${env:USER}", error, warning));
+		CHECK(t.Fold(src, L"/c").IsConstant());
+		CHECK(t.Fold(src, L"/c").GetLiteral() == L"x bob");
+	}
+
+	// random fragments: compiled templates round-trip through ToString, folding keeps the value,
+	// adjacent literals are merged, and only date formats fail
+	void TestRandom()
+	{
+		TestSource src;
+		const wchar_t alphabet[] = L"${}$:envdatclipbrdonfgX%Y ";
+		const wchar_t* fragments[] = { L"${", L"}", L"${env:", L"${date:", L"${configdir}", L"${clipboard}", L"${$}", L"$", L"{", L"env:", L"%Y", L"%" };
+		std::mt19937 rng{ 42 };
+		for (int iteration = 0; iteration < 100000; ++iteration)
+		{
+			std::wstring source;
+			for (int n = rng() % 12; n > 0; --n)
+			{
+				if (rng() % 2 != 0) source += fragments[rng() % std::size(fragments)];
+				else source += alphabet[rng() % (std::size(alphabet) - 1)];
+			}
+
+			ArgumentTemplate t;
+			std::wstring error, warning;
+			if (!t.Compile(source, error, warning))
+			{
+				CHECK(error.compare(0, 12, L"date format ") == 0);
+				continue;
+			}
+
+			ArgumentTemplate t2;
+			std::wstring error2, warning2;
+			CHECK(t2.Compile(t.ToString(), error2, warning2));
+			CHECK(warning2.empty());
+			CHECK(t2.GetTokens() == t.GetTokens());
+
+			std::wstring value, foldedValue;
+			t.Evaluate(src, L"/c", value);
+			t.Fold(src, L"/c").Evaluate(src, L"/c", foldedValue);
+			CHECK(value == foldedValue);
+
+			for (size_t k = 1; k < t.GetTokens().size(); ++k)
+			{
+				CHECK(t.GetTokens()[k].op != ArgumentTemplate::Op::Literal || t.GetTokens()[k - 1].op != ArgumentTemplate::Op::Literal);
+			}
+		}
+	}
+}
+
+int main()
+{
+	TestPlaceholders();
+	TestKeptAsText();
+	TestDateFormats();
+	TestFold();
+	TestRandom();
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include "AsyncLog.h"
+#include "BenchUtils.h"
+#include "TestUtils.h"
+
+#include <atomic>
+#include <cwchar>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// formats on the calling thread and writes under a lock, as the log did before the ring buffer
+	class SyncLog
+	{
+	public:
+		explicit SyncLog(AsyncLog::Sink sink) : m_sink{ std::move(sink) } {}
+
+		void Write(const wchar_t* format, unsigned int id, const wchar_t* exe, int pid, double ms)
+		{
+			wchar_t buf[512];
+			const int len = std::swprintf(buf, std::size(buf), format, id, exe, pid, ms);
+			std::lock_guard<std::mutex> lock{ m_lock };
+			m_sink(AsyncLog::Level::Write, std::wstring(buf, static_cast<size_t>(len)));
+		}
+
+	private:
+		std::mutex m_lock;
+		AsyncLog::Sink m_sink;
+	};
+
+	// stands in for the log file: keeps a line, and costs what appending it costs
+	class CountingSink
+	{
+	public:
+		AsyncLog::Sink Get()
+		{
+			return [this](AsyncLog::Level, std::wstring const& message)
+				{
+					m_last = message;
+					m_chars.fetch_add(message.size(), std::memory_order_relaxed);
+				};
+		}
+
+		size_t GetChars() const { return m_chars.load(); }
+
+	private:
+		std::wstring m_last;
+		std::atomic<size_t> m_chars{ 0 };
+	};
+
+	constexpr const wchar_t* c_exe = L"C:\\Program Files\\Tool\\tool.exe";
+
+	// time per message of `threads` threads each writing `iterations` messages
+	template <typename Write>
+	double RunThreads(Benchmark& bench, char const* name, int threads, size_t iterations, Write&& write)
+	{
+		const double perMessage = bench.Run(name, 1, [&](size_t)
+			{
+				std::vector<std::thread> workers;
+				for (int t = 0; t < threads; ++t)
+				{
+					workers.emplace_back([&write, iterations, t]()
+						{
+							for (size_t i = 0; i < iterations; ++i)
+							{
+								write(static_cast<unsigned int>(i), t);
+							}
+						});
+				}
+				for (std::thread& w : workers) w.join();
+			}) / static_cast<double>(threads * iterations);
+		std::printf("%-48s %12.1f ns\n", "  per message", perMessage);
+		return perMessage;
+	}
+}
+
+// Cost on the hot path of logging a trigger through the ring buffer, against formatting and writing under a lock
+int main(int argc, char** argv)
+{
+	Benchmark bench{ argc, argv };
+	// all rounds fit into the ring buffer, so no message is dropped and only the hot path is timed
+	const size_t iterations = bench.IsSmoke() ? 10 : 4000;
+
+	CountingSink asyncSink;
+	uint64_t dropped = 0;
+	{
+		AsyncLog log{ asyncSink.Get(), 1 << 16 };
+		bench.Run("AsyncLog::Write, 1 thread", iterations, [&](size_t i)
+			{
+				log.Write(L"HotKey(%u) started %s as %d in %.1f ms", static_cast<unsigned int>(i), c_exe, 7, 1.5);
+			});
+		CHECK(log.Flush());
+		RunThreads(bench, "AsyncLog::Write, 4 threads", 4, iterations / 2, [&log](unsigned int i, int t)
+			{
+				log.Write(L"HotKey(%u) started %s as %d in %.1f ms", i, c_exe, t, 1.5);
+			});
+		CHECK(log.Flush());
+		dropped = log.GetDroppedCount();
+	}
+	CHECK(dropped == 0);
+	CHECK(asyncSink.GetChars() > 0);
+
+	CountingSink syncSink;
+	SyncLog sync{ syncSink.Get() };
+	bench.Run("format and write under lock, 1 thread", iterations, [&](size_t i)
+		{
+			sync.Write(L"HotKey(%u) started %ls as %d in %.1f ms", static_cast<unsigned int>(i), c_exe, 7, 1.5);
+		});
+	RunThreads(bench, "format and write under lock, 4 threads", 4, iterations / 2, [&sync](unsigned int i, int t)
+		{
+			sync.Write(L"HotKey(%u) started %ls as %d in %.1f ms", i, c_exe, t, 1.5);
+		});
+	CHECK(syncSink.GetChars() > 0);
+
+	// the crash path drains without the worker
+	CountingSink drainSink;
+	{
+		AsyncLog log{ drainSink.Get(), 1024 };
+		bench.Run("512 x AsyncLog::Write, then TryDrain", 200, [&](size_t i)
+			{
+				for (unsigned int m = 0; m < 512; ++m)
+				{
+					log.Write(L"HotKey(%u) started %s as %d in %.1f ms", m, c_exe, static_cast<int>(i), 1.5);
+				}
+				while (!log.TryDrain())
+				{
+					std::this_thread::yield();
+				}
+			});
+		CHECK(log.Flush());
+	}
+	CHECK(drainSink.GetChars() > 0);
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include "AsyncLog.h"
+#include "TestUtils.h"
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	class Recorder
+	{
+	public:
+		AsyncLog::Sink GetSink()
+		{
+			return [this](AsyncLog::Level, std::wstring const& message)
+				{
+					std::lock_guard<std::mutex> lock{ m_lock };
+					m_messages.push_back(message);
+				};
+		}
+
+		std::vector<std::wstring> GetMessages()
+		{
+			std::lock_guard<std::mutex> lock{ m_lock };
+			return m_messages;
+		}
+
+	private:
+		std::mutex m_lock;
+		std::vector<std::wstring> m_messages;
+	};
+
+	constexpr wchar_t c_ellipsis = L'\u2026';
+
+	void TestFormat()
+	{
+		Recorder recorder;
+		{
+			AsyncLog log{ recorder.GetSink() };
+			log.Write("HotKey(%u) %s %d %.1f", 42u, "ok", -3, 2.5);
+			log.Write(L"args: %s", L"a b");
+			CHECK(log.Flush());
+		}
+		const std::vector<std::wstring> messages = recorder.GetMessages();
+		CHECK(messages.size() == 2);
+		CHECK(messages[0] == L"HotKey(42) ok -3 2.5");
+		CHECK(messages[1] == L"args: a b");
+	}
+
+	// a string which fills the buffer exactly is complete; longer ones are cut and marked
+	void TestTruncation()
+	{
+		const std::wstring fits(AsyncLog::c_maxStringChars - 1, L'x');
+		const std::wstring tooLong(AsyncLog::c_maxStringChars + 100, L'y');
+
+		Recorder recorder;
+		{
+			AsyncLog log{ recorder.GetSink() };
+			log.Write(L"%s", fits.c_str());
+			log.Write(L"%s|", tooLong.c_str());
+			// no space is left for the second string
+			log.Write(L"%s|%s|", fits.c_str(), L"z");
+			log.Write(L"%s|%s|", fits.c_str(), L"");
+			CHECK(log.Flush());
+		}
+		const std::vector<std::wstring> messages = recorder.GetMessages();
+		CHECK(messages.size() == 4);
+		CHECK(messages[0] == fits);
+		CHECK(messages[1] == std::wstring(AsyncLog::c_maxStringChars - 1, L'y') + c_ellipsis + L'|');
+		CHECK(messages[2] == fits + L'|' + c_ellipsis + L'|');
+		CHECK(messages[3] == fits + L"||");
+	}
+
+	// draining does not wait for a worker busy in the sink, and delivers each message once, in order
+	void TestTryDrain()
+	{
+		Recorder recorder;
+		std::promise<void> entered;
+		std::promise<void> release;
+		std::shared_future<void> released = release.get_future().share();
+		bool first = true;
+		AsyncLog::Sink sink = recorder.GetSink();
+		{
+			AsyncLog log{ [&](AsyncLog::Level level, std::wstring const& message)
+				{
+					if (first)
+					{
+						first = false;
+						entered.set_value();
+						released.wait();
+					}
+					sink(level, message);
+				} };
+			log.Write("blocked");
+			entered.get_future().wait();
+			log.Write("queued");
+
+			const auto start = std::chrono::steady_clock::now();
+			CHECK(!log.TryDrain());
+			CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds{ 500 });
+			release.set_value();
+
+			for (int i = 0; i < 100; ++i)
+			{
+				log.Write("message %d", i);
+			}
+			while (!log.TryDrain())
+			{
+				std::this_thread::yield();
+			}
+			CHECK(log.Flush());
+		}
+		const std::vector<std::wstring> messages = recorder.GetMessages();
+		CHECK(messages.size() == 102);
+		CHECK(messages[0] == L"blocked");
+		CHECK(messages[1] == L"queued");
+		for (int i = 0; i < 100 && static_cast<size_t>(i) + 2 < messages.size(); ++i)
+		{
+			CHECK(messages[i + 2] == L"message " + std::to_wstring(i));
+		}
+	}
+}
+
+int main()
+{
+	TestFormat();
+	TestTruncation();
+	TestTryDrain();
+	return 0;
+}
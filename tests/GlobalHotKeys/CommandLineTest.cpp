@@ -0,0 +1,84 @@
+#include "CommandLine.h"
+#include "TestUtils.h"
+
+#include <cwchar>
+#include <random>
+
+namespace
+{
+	std::wstring BuildString(std::vector<std::wstring> const& args)
+	{
+		std::vector<wchar_t> cmdLine;
+		CommandLine::Build(args, cmdLine);
+		CHECK(!cmdLine.empty() && cmdLine.back() == 0);
+		CHECK(std::wcslen(cmdLine.data()) + 1 == cmdLine.size());
+		return cmdLine.data();
+	}
+
+	void TestBuild()
+	{
+		CHECK(BuildString({}) == L"");
+		CHECK(BuildString({ L"plain", L"C:\\dir\\file.txt" }) == L" plain C:\\dir\\file.txt");
+		CHECK(BuildString({ L"a b", L"" }) == L" \"a b\" \"\"");
+		// backslashes are only doubled before a quote, or before the closing quote
+		CHECK(BuildString({ L"c\\\"d" }) == L" \"c\\\\\\\"d\"");
+		CHECK(BuildString({ L"e\\" }) == L" e\\");
+		CHECK(BuildString({ L"f\\ g\\" }) == L" \"f\\ g\\\\\"");
+
+		for (std::wstring const& arg : { std::wstring{}, std::wstring{ L"x\\\"y z\\" } })
+		{
+			std::vector<wchar_t> out(CommandLine::GetArgumentLength(arg));
+			CHECK(CommandLine::WriteArgument(arg, out.data()) == out.data() + out.size());
+		}
+	}
+
+	void TestParse()
+	{
+		const std::vector<std::wstring> args = CommandLine::Parse(L"\"C:\\Program Files\\x.exe\" a\\\\\\\"b \"c\"\"d\" e\\\\f", true);
+		CHECK(args.size() == 4);
+		CHECK(args[0] == L"C:\\Program Files\\x.exe");
+		CHECK(args[1] == L"a\\\"b");
+		CHECK(args[2] == L"c\"d");
+		CHECK(args[3] == L"e\\\\f");
+
+		// backslashes do not escape quotes in the program name
+		const std::vector<std::wstring> program = CommandLine::Parse(L"C:\\a\\\"b c\" d", true);
+		CHECK(program.size() == 2);
+		CHECK(program[0] == L"C:\\a\\b c");
+		CHECK(program[1] == L"d");
+	}
+
+	// random arguments of the characters with special meaning survive Build and Parse unchanged
+	void TestRoundTrip()
+	{
+		const wchar_t alphabet[] = L"ab \\\"\t\x00e4/";
+		std::mt19937 rng{ 42 };
+		for (int iteration = 0; iteration < 100000; ++iteration)
+		{
+			std::vector<std::wstring> args(rng() % 5);
+			for (std::wstring& arg : args)
+			{
+				for (size_t n = rng() % 12; n > 0; --n)
+				{
+					arg += alphabet[rng() % (std::size(alphabet) - 1)];
+				}
+			}
+
+			const std::vector<std::wstring> parsed = CommandLine::Parse(BuildString(args), true);
+			CHECK(parsed.size() == args.size() + 1);
+			CHECK(parsed[0].empty());
+			for (size_t i = 0; i < args.size(); ++i)
+			{
+				CHECK(parsed[i + 1] == args[i]);
+			}
+		}
+	}
+}
+
+int main()
+{
+	TestBuild();
+	TestParse();
+	TestRoundTrip();
+	return 0;
+}
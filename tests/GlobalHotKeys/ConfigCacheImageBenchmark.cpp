@@ -0,0 +1,116 @@
+#include "ConfigCacheImage.h"
+#include "BenchUtils.h"
+#include "TestUtils.h"
+
+#include "SimpleLog/SimpleLog.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Startup with a configuration of 5k hot keys: parsing the yaml on a cache miss,
+// against loading the cache image, once read into a buffer and once mapped and read in place
+namespace
+{
+	std::string MakeConfig(size_t count)
+	{
+		std::string yaml = "globalhotkeys:\n";
+		for (size_t i = 0; i < count; ++i)
+		{
+			yaml += "  - code: f" + std::to_string(1 + i % 24) + "\n";
+			yaml += (i % 2 == 0) ? "    ctrl: true\n" : "    alt: true\n";
+			yaml += "    exec: C:\\Tools\\tool" + std::to_string(i) + ".exe\n";
+			yaml += "    args: [ \"--id\", \"" + std::to_string(i) + "\", \"{file}\" ]\n";
+			yaml += "    workdir: C:\\Work\\dir" + std::to_string(i % 100) + "\n";
+		}
+		return yaml;
+	}
+
+	std::vector<uint8_t> ReadFile(std::string const& path)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		return std::vector<uint8_t>{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+	}
+
+	void WriteFile(std::string const& path, const void* data, size_t size)
+	{
+		std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+		file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+		CHECK(file.good());
+	}
+
+	YamlConfigBinder::Result LoadMapped(std::string const& path, ConfigCacheImage::SourceKey const& key)
+	{
+		YamlConfigBinder::Result result;
+		const int fd = open(path.c_str(), O_RDONLY);
+		CHECK(fd >= 0);
+		struct stat st;
+		CHECK(fstat(fd, &st) == 0);
+		void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		CHECK(view != MAP_FAILED);
+		CHECK(ConfigCacheImage::Deserialize(static_cast<const uint8_t*>(view), static_cast<size_t>(st.st_size), key, result));
+		munmap(view, static_cast<size_t>(st.st_size));
+		close(fd);
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Benchmark bench{ argc, argv };
+
+	const size_t count = bench.IsSmoke() ? 100 : 5000;
+	char dir[] = "/tmp/ConfigCacheImageBenchmark.XXXXXX";
+	CHECK(mkdtemp(dir) != nullptr);
+	const std::string yamlPath = std::string{ dir } + "/config.yaml";
+	const std::string cachePath = yamlPath + ".cache";
+
+	const std::string yaml = MakeConfig(count);
+	WriteFile(yamlPath, yaml.data(), yaml.size());
+
+	sgrottel::SimpleLog log;
+	ConfigCacheImage::SourceKey key{ yaml.size(), 1, 0, 0x0409 };
+	key.contentHash = ConfigCacheImage::Hash(reinterpret_cast<const uint8_t*>(yaml.data()), yaml.size());
+	{
+		const std::vector<uint8_t> image = ConfigCacheImage::Serialize(key, YamlConfigBinder{ log }.Bind(reinterpret_cast<const uint8_t*>(yaml.data()), yaml.size()));
+		WriteFile(cachePath, image.data(), image.size());
+	}
+	CHECK(LoadMapped(cachePath, key).hotKeys.size() == count);
+
+	// both paths hash the yaml content to find the cache key
+	const double miss = bench.Run("cache miss: read, hash, bind yaml", 3, [&](size_t)
+		{
+			const std::vector<uint8_t> data = ReadFile(yamlPath);
+			DoNotOptimize(ConfigCacheImage::Hash(data.data(), data.size()));
+			DoNotOptimize(YamlConfigBinder{ log }.Bind(data.data(), data.size()));
+		});
+	const double copied = bench.Run("cache hit: read, hash, image from buffer", 3, [&](size_t)
+		{
+			const std::vector<uint8_t> data = ReadFile(yamlPath);
+			DoNotOptimize(ConfigCacheImage::Hash(data.data(), data.size()));
+			const std::vector<uint8_t> image = ReadFile(cachePath);
+			YamlConfigBinder::Result result;
+			CHECK(ConfigCacheImage::Deserialize(image.data(), image.size(), key, result));
+			DoNotOptimize(result);
+		});
+	const double mapped = bench.Run("cache hit: read, hash, image mapped in place", 3, [&](size_t)
+		{
+			const std::vector<uint8_t> data = ReadFile(yamlPath);
+			DoNotOptimize(ConfigCacheImage::Hash(data.data(), data.size()));
+			DoNotOptimize(LoadMapped(cachePath, key));
+		});
+
+	std::printf("speedup over the cache miss: %.2fx from buffer, %.2fx mapped\n", miss / copied, miss / mapped);
+
+	std::remove(cachePath.c_str());
+	std::remove(yamlPath.c_str());
+	rmdir(dir);
+	return 0;
+}
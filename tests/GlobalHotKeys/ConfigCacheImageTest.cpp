@@ -0,0 +1,217 @@
+#include "ConfigCacheImage.h"
+#include "TestUtils.h"
+
+#include <cstring>
+
+namespace
+{
+	// offsets within the image, see `Header` and `HotKeyRecord` in ConfigCacheImage.cpp
+	constexpr size_t c_headerSize = 112;
+	constexpr size_t c_versionOffset = 8;
+	constexpr size_t c_payloadHashOffset = 56;
+	constexpr size_t c_headerHashOffset = 108;
+	constexpr size_t c_hotKeyExecutableOffset = 8;
+
+	ConfigCacheImage::SourceKey MakeKey()
+	{
+		return { 1234, 0x01d9f00dcafe0000ull, 0x0123456789abcdefull, 0x04070407ull };
+	}
+
+	YamlConfigBinder::Result MakeResult()
+	{
+		YamlConfigBinder::Result r;
+		r.bell = false;
+		r.customBellFile = L"C:\\sounds\\ding.wav";
+		r.bellVolume = 0.5f;
+		r.includes = { L"hotkeys.d", L"more.yaml" };
+		r.profiles.push_back({ L"editors", { L"notepad.exe", L"code.exe" } });
+
+		HotKeyConfig a;
+		a.virtualKeyCode = 0x41;
+		a.modCtrl = true;
+		a.modAlt = true;
+		a.executable = L"cmd.exe";
+		a.workingDirectory = L"C:\\temp";
+		a.arguments = { L"/k", L"echo ${date}", L"", L"Gr\u00FC\u00DFe \U0001F600" };
+		a.resolveArgsPaths[1] = HotKeyConfig::ResolveArgConfig{ true };
+		a.createNoWindow = false;
+		a.cooldownMs = 250;
+		a.coalesce = true;
+		a.sourceLine = 12;
+		a.sourceColumn = 3;
+		r.hotKeys.push_back(a);
+
+		HotKeyConfig b;
+		b.virtualKeyCode = 0x70;
+		b.modShift = true;
+		b.action = L"toggle-bell";
+		b.profile = L"editors";
+		b.maxConcurrent = 2;
+		b.singleInstance = true;
+		r.hotKeys.push_back(b);
+
+		return r;
+	}
+
+	bool Equal(HotKeyConfig const& a, HotKeyConfig const& b)
+	{
+		if (a.resolveArgsPaths.size() != b.resolveArgsPaths.size()) return false;
+		for (auto const& ra : a.resolveArgsPaths)
+		{
+			auto it = b.resolveArgsPaths.find(ra.first);
+			if (it == b.resolveArgsPaths.end() || it->second.isRelPath != ra.second.isRelPath) return false;
+		}
+		return a.GetChord() == b.GetChord()
+			&& a.executable == b.executable
+			&& a.action == b.action
+			&& a.workingDirectory == b.workingDirectory
+			&& a.arguments == b.arguments
+			&& a.isRelExePath == b.isRelExePath
+			&& a.noFileCheck == b.noFileCheck
+			&& a.createNoWindow == b.createNoWindow
+			&& a.cooldownMs == b.cooldownMs
+			&& a.coalesce == b.coalesce
+			&& a.maxConcurrent == b.maxConcurrent
+			&& a.singleInstance == b.singleInstance
+			&& a.profile == b.profile
+			&& a.sourceLine == b.sourceLine
+			&& a.sourceColumn == b.sourceColumn;
+	}
+
+	bool Equal(YamlConfigBinder::Result const& a, YamlConfigBinder::Result const& b)
+	{
+		if (a.bell != b.bell || a.customBellFile != b.customBellFile || a.bellVolume != b.bellVolume) return false;
+		if (a.includes != b.includes || a.hotKeys.size() != b.hotKeys.size() || a.profiles.size() != b.profiles.size()) return false;
+		for (size_t i = 0; i < a.hotKeys.size(); ++i)
+		{
+			if (!Equal(a.hotKeys[i], b.hotKeys[i])) return false;
+		}
+		for (size_t i = 0; i < a.profiles.size(); ++i)
+		{
+			if (a.profiles[i].name != b.profiles[i].name || a.profiles[i].applications != b.profiles[i].applications) return false;
+		}
+		return true;
+	}
+
+	// deserializes from a copy in a fresh allocation, so reads beyond `size` are caught by the sanitizers
+	bool TryDeserialize(std::vector<uint8_t> const& image, size_t size, YamlConfigBinder::Result& outResult)
+	{
+		std::vector<uint32_t> aligned((size + 3) / 4);
+		if (size > 0) std::memcpy(aligned.data(), image.data(), size);
+		return ConfigCacheImage::Deserialize(reinterpret_cast<const uint8_t*>(aligned.data()), size, MakeKey(), outResult);
+	}
+
+	// recomputes the hashes after the image was edited on purpose
+	void Rehash(std::vector<uint8_t>& image)
+	{
+		const uint64_t payloadHash = ConfigCacheImage::Hash(image.data() + c_headerSize, image.size() - c_headerSize);
+		std::memcpy(image.data() + c_payloadHashOffset, &payloadHash, sizeof(payloadHash));
+		std::memset(image.data() + c_headerHashOffset, 0, sizeof(uint32_t));
+		const uint32_t headerHash = static_cast<uint32_t>(ConfigCacheImage::Hash(image.data(), c_headerSize));
+		std::memcpy(image.data() + c_headerHashOffset, &headerHash, sizeof(headerHash));
+	}
+
+	void TestRoundTrip()
+	{
+		const YamlConfigBinder::Result source = MakeResult();
+		const std::vector<uint8_t> image = ConfigCacheImage::Serialize(MakeKey(), source);
+		YamlConfigBinder::Result loaded;
+		CHECK(TryDeserialize(image, image.size(), loaded));
+		CHECK(Equal(source, loaded));
+
+		const std::vector<uint8_t> emptyImage = ConfigCacheImage::Serialize(MakeKey(), YamlConfigBinder::Result{});
+		CHECK(TryDeserialize(emptyImage, emptyImage.size(), loaded));
+		CHECK(Equal(YamlConfigBinder::Result{}, loaded));
+	}
+
+	// strings are stored as UTF-16, whatever the size of `wchar_t`, so images are identical on all platforms
+	void TestFixedLayout()
+	{
+		YamlConfigBinder::Result r;
+		r.hotKeys.emplace_back();
+		r.hotKeys[0].arguments = { L"a\U0001F600" };
+		const std::vector<uint8_t> image = ConfigCacheImage::Serialize(MakeKey(), r);
+
+		// header, hot key record, argument reference, string pool
+		CHECK(image.size() == c_headerSize + 72 + 8 + 3 * sizeof(char16_t));
+		const uint8_t pool[] = { 0x61, 0x00, 0x3D, 0xD8, 0x00, 0xDE };
+		CHECK(std::memcmp(image.data() + image.size() - sizeof(pool), pool, sizeof(pool)) == 0);
+
+		// little-endian version, at its fixed offset
+		CHECK(image[c_versionOffset] == 7 && image[c_versionOffset + 1] == 0);
+
+		YamlConfigBinder::Result loaded;
+		CHECK(TryDeserialize(image, image.size(), loaded));
+		CHECK(loaded.hotKeys.size() == 1 && loaded.hotKeys[0].arguments == r.hotKeys[0].arguments);
+	}
+
+	void TestTruncated()
+	{
+		const std::vector<uint8_t> image = ConfigCacheImage::Serialize(MakeKey(), MakeResult());
+		for (size_t size = 0; size < image.size(); ++size)
+		{
+			YamlConfigBinder::Result loaded;
+			CHECK(!TryDeserialize(image, size, loaded));
+		}
+	}
+
+	void TestBitFlips()
+	{
+		const std::vector<uint8_t> image = ConfigCacheImage::Serialize(MakeKey(), MakeResult());
+		std::vector<uint8_t> corrupt{ image };
+		for (size_t bit = 0; bit < image.size() * 8; ++bit)
+		{
+			corrupt[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+			YamlConfigBinder::Result loaded;
+			CHECK(!TryDeserialize(corrupt, corrupt.size(), loaded));
+			corrupt[bit / 8] = image[bit / 8];
+		}
+	}
+
+	void TestStaleVersion()
+	{
+		std::vector<uint8_t> image = ConfigCacheImage::Serialize(MakeKey(), MakeResult());
+		YamlConfigBinder::Result loaded;
+		Rehash(image);
+		CHECK(TryDeserialize(image, image.size(), loaded));
+
+		uint32_t version;
+		std::memcpy(&version, image.data() + c_versionOffset, sizeof(version));
+		version--;
+		std::memcpy(image.data() + c_versionOffset, &version, sizeof(version));
+		Rehash(image);
+		CHECK(!TryDeserialize(image, image.size(), loaded));
+	}
+
+	void TestOtherSource()
+	{
+		const std::vector<uint8_t> image = ConfigCacheImage::Serialize(MakeKey(), MakeResult());
+		ConfigCacheImage::SourceKey key = MakeKey();
+		key.keyboardLayout++;
+		YamlConfigBinder::Result loaded;
+		CHECK(!ConfigCacheImage::Deserialize(image.data(), image.size(), key, loaded));
+	}
+
+	void TestStringOutOfBounds()
+	{
+		// consistent hashes, but the executable of the first hot key references beyond the string pool
+		std::vector<uint8_t> image = ConfigCacheImage::Serialize(MakeKey(), MakeResult());
+		const uint32_t offset = 0x7ffffff0u;
+		std::memcpy(image.data() + c_headerSize + c_hotKeyExecutableOffset, &offset, sizeof(offset));
+		Rehash(image);
+		YamlConfigBinder::Result loaded;
+		CHECK(!TryDeserialize(image, image.size(), loaded));
+	}
+}
+
+int main()
+{
+	TestRoundTrip();
+	TestFixedLayout();
+	TestTruncated();
+	TestBitFlips();
+	TestStaleVersion();
+	TestOtherSource();
+	TestStringOutOfBounds();
+	return 0;
+}
@@ -0,0 +1,233 @@
+#include "ConfigFragments.h"
+#include "TestUtils.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// files by path, each holding the hot keys of one fragment
+	class FakeFiles : public IFragmentFiles
+	{
+	public:
+		bool IsDirectory(std::filesystem::path const& path) override
+		{
+			return dirs.count(path.wstring()) > 0;
+		}
+
+		std::vector<std::filesystem::path> ListFiles(std::filesystem::path const& dir) override
+		{
+			// deliberately not in name order
+			std::vector<std::filesystem::path> list;
+			for (auto it = fragments.rbegin(); it != fragments.rend(); ++it)
+			{
+				const std::filesystem::path p{ it->first };
+				if (p.parent_path() == dir) list.push_back(p);
+			}
+			return list;
+		}
+
+		std::vector<uint8_t> Read(std::filesystem::path const& path) override
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m_lock };
+				reads.push_back(path.wstring());
+			}
+			if (fragments.count(path.wstring()) == 0)
+			{
+				throw std::runtime_error("missing " + path.string());
+			}
+			const std::wstring& name = path.wstring();
+			return std::vector<uint8_t>(name.begin(), name.end());
+		}
+
+		std::map<std::wstring, YamlConfigBinder::Result> fragments;
+		std::map<std::wstring, bool> dirs;
+		std::vector<std::wstring> reads;
+
+	private:
+		std::mutex m_lock;
+	};
+
+	HotKeyConfig Key(uint32_t code, std::wstring const& exe, std::wstring const& profile = {}, uint32_t line = 1)
+	{
+		HotKeyConfig hk;
+		hk.virtualKeyCode = code;
+		hk.modCtrl = true;
+		hk.executable = exe;
+		hk.profile = profile;
+		hk.sourceLine = line;
+		hk.sourceColumn = 3;
+		return hk;
+	}
+
+	// returns the fragment of the file; earlier files take longer, so parsing finishes in reverse order
+	ConfigFragments::Parser MakeParser(FakeFiles& files)
+	{
+		return [&files](std::filesystem::path const& path, std::vector<uint8_t> const& data)
+			{
+				CHECK(std::wstring(data.begin(), data.end()) == path.wstring());
+				const size_t index = static_cast<size_t>(std::distance(files.fragments.begin(), files.fragments.find(path.wstring())));
+				std::this_thread::sleep_for(std::chrono::milliseconds(2 * (files.fragments.size() - index)));
+				YamlConfigBinder::Result r = files.fragments.at(path.wstring());
+				if (r.hotKeys.empty()) throw std::invalid_argument("bad " + path.filename().string());
+				return r;
+			};
+	}
+
+	std::vector<std::wstring> Executables(YamlConfigBinder::Result const& config)
+	{
+		std::vector<std::wstring> exes;
+		for (auto const& hk : config.hotKeys) exes.push_back(hk.executable);
+		return exes;
+	}
+
+	void TestMatchPattern()
+	{
+		CHECK(ConfigFragments::MatchPattern(L"*.yaml", L"keys.yaml"));
+		CHECK(ConfigFragments::MatchPattern(L"*.yaml", L"KEYS.YAML"));
+		CHECK(!ConfigFragments::MatchPattern(L"*.yaml", L"keys.yaml.bak"));
+		CHECK(ConfigFragments::MatchPattern(L"k?ys*.y*ml", L"keys-work.yml"));
+		CHECK(ConfigFragments::MatchPattern(L"*", L""));
+		CHECK(!ConfigFragments::MatchPattern(L"?", L""));
+		CHECK(ConfigFragments::MatchPattern(L"a*b*c", L"abxbc"));
+		CHECK(!ConfigFragments::MatchPattern(L"a*b*c", L"abxbcd"));
+	}
+
+	void TestResolve()
+	{
+		FakeFiles files;
+		files.dirs[L"/cfg/keys.d"] = true;
+		files.fragments[L"/cfg/keys.d/b.yaml"] = {};
+		files.fragments[L"/cfg/keys.d/A.yml"] = {};
+		files.fragments[L"/cfg/keys.d/c.txt"] = {};
+		files.fragments[L"/cfg/extra/x1.yaml"] = {};
+		files.fragments[L"/cfg/extra/x2.yaml"] = {};
+		ConfigFragments fragments{ files, MakeParser(files) };
+
+		// entries as listed, files of one entry sorted by name ignoring case, each file once
+		const std::vector<std::filesystem::path> paths = fragments.Resolve(
+			{ L"extra/x2.yaml", L"keys.d", L"extra/x?.yaml", L"/abs/missing.yaml", L"keys.d/../keys.d/b.yaml" },
+			L"/cfg");
+		const std::vector<std::filesystem::path> expected{
+			L"/cfg/extra/x2.yaml", L"/cfg/keys.d/A.yml", L"/cfg/keys.d/b.yaml", L"/cfg/extra/x1.yaml", L"/abs/missing.yaml" };
+		CHECK(paths == expected);
+	}
+
+	void TestMergeOrder(size_t threadCount)
+	{
+		FakeFiles files;
+		files.dirs[L"/cfg/keys.d"] = true;
+		files.fragments[L"/cfg/keys.d/10-tools.yaml"].hotKeys = { Key(0x41, L"tools-a"), Key(0x42, L"tools-b") };
+		files.fragments[L"/cfg/keys.d/20-work.yaml"].hotKeys = { Key(0x43, L"work-c", L"work") };
+		files.fragments[L"/cfg/keys.d/20-work.yaml"].profiles = { { L"work", { L"excel.exe" } } };
+		files.fragments[L"/cfg/keys.d/30-more.yaml"].hotKeys = { Key(0x44, L"more-d", L"work") };
+		files.fragments[L"/cfg/keys.d/30-more.yaml"].profiles = { { L"work", { L"word.exe" } }, { L"play", { L"game.exe" } } };
+		files.fragments[L"/cfg/late.yaml"].hotKeys = { Key(0x45, L"late-e") };
+
+		YamlConfigBinder::Result config;
+		config.hotKeys = { Key(0x5a, L"main-z") };
+		config.profiles = { { L"work", { L"outlook.exe" } } };
+		// the main file is not merged twice, even if an include matches it
+		config.includes = { L"keys.d", L"late.yaml", L"main.yaml" };
+
+		ConfigFragments fragments{ files, MakeParser(files), threadCount };
+		fragments.LoadAndMerge(L"/cfg/main.yaml", config);
+
+		CHECK(fragments.GetFragmentCount() == 4);
+		CHECK(fragments.GetDuplicates().empty());
+		CHECK(Executables(config) == (std::vector<std::wstring>{ L"main-z", L"tools-a", L"tools-b", L"work-c", L"more-d", L"late-e" }));
+
+		// profiles of the same name are merged, in file order
+		CHECK(config.profiles.size() == 2);
+		CHECK(config.profiles[0].name == L"work");
+		CHECK(config.profiles[0].applications == (std::vector<std::wstring>{ L"outlook.exe", L"excel.exe", L"word.exe" }));
+		CHECK(config.profiles[1].name == L"play");
+	}
+
+	void TestConflicts(size_t threadCount)
+	{
+		FakeFiles files;
+		files.fragments[L"/cfg/a.yaml"].hotKeys = { Key(0x41, L"a-ctrl-a", {}, 4), Key(0x42, L"a-ctrl-b-work", L"work", 7) };
+		files.fragments[L"/cfg/b.yaml"].hotKeys = {
+			Key(0x41, L"b-ctrl-a", {}, 2),
+			Key(0x42, L"b-ctrl-b-work", L"work", 5),
+			// the same chord in another profile is no conflict
+			Key(0x42, L"b-ctrl-b-play", L"play", 9) };
+
+		YamlConfigBinder::Result config;
+		config.hotKeys = { Key(0x5a, L"main-z", {}, 1), Key(0x5a, L"main-z-again", {}, 8) };
+		config.includes = { L"b.yaml", L"a.yaml" };
+
+		ConfigFragments fragments{ files, MakeParser(files), threadCount };
+		fragments.LoadAndMerge(L"/cfg/main.yaml", config);
+
+		// the first hot key in merge order wins: include order, not file name order
+		CHECK(Executables(config) == (std::vector<std::wstring>{ L"main-z", L"b-ctrl-a", L"b-ctrl-b-work", L"b-ctrl-b-play" }));
+
+		auto const& dups = fragments.GetDuplicates();
+		CHECK(dups.size() == 3);
+		CHECK(dups[0].hotKey.executable == L"main-z-again");
+		CHECK(dups[0].file == L"/cfg/main.yaml" && dups[0].firstFile == L"/cfg/main.yaml");
+		CHECK(dups[0].firstLine == 1 && dups[0].firstColumn == 3);
+		CHECK(dups[1].hotKey.executable == L"a-ctrl-a");
+		CHECK(dups[1].file == L"/cfg/a.yaml" && dups[1].firstFile == L"/cfg/b.yaml" && dups[1].firstLine == 2);
+		CHECK(dups[2].hotKey.executable == L"a-ctrl-b-work");
+		CHECK(dups[2].firstFile == L"/cfg/b.yaml" && dups[2].firstLine == 5);
+
+		// loading again starts over
+		YamlConfigBinder::Result empty;
+		fragments.LoadAndMerge(L"/cfg/main.yaml", empty);
+		CHECK(fragments.GetDuplicates().empty());
+		CHECK(fragments.GetFragmentCount() == 0);
+	}
+
+	void TestErrors(size_t threadCount)
+	{
+		FakeFiles files;
+		files.fragments[L"/cfg/a.yaml"].hotKeys = { Key(0x41, L"a") };
+		// parsed into an error by `MakeParser`
+		files.fragments[L"/cfg/b.yaml"] = {};
+		files.fragments[L"/cfg/c.yaml"].hotKeys = { Key(0x43, L"c") };
+
+		// the first failing fragment in merge order is reported, whichever failed first
+		for (auto const& includes : { std::vector<std::wstring>{ L"a.yaml", L"missing.yaml", L"b.yaml" }, std::vector<std::wstring>{ L"b.yaml", L"missing.yaml" } })
+		{
+			YamlConfigBinder::Result config;
+			config.hotKeys = { Key(0x5a, L"main") };
+			config.includes = includes;
+			ConfigFragments fragments{ files, MakeParser(files), threadCount };
+			std::string error;
+			try
+			{
+				fragments.LoadAndMerge(L"/cfg/main.yaml", config);
+			}
+			catch (std::exception const& ex)
+			{
+				error = ex.what();
+			}
+			CHECK(error == (includes[0] == L"a.yaml" ? "missing /cfg/missing.yaml" : "bad b.yaml"));
+			// all fragments were still read
+			CHECK(files.reads.size() == includes.size());
+			files.reads.clear();
+		}
+	}
+}
+
+int main()
+{
+	TestMatchPattern();
+	TestResolve();
+	for (size_t threadCount : { 1, 8 })
+	{
+		TestMergeOrder(threadCount);
+		TestConflicts(threadCount);
+		TestErrors(threadCount);
+	}
+	return 0;
+}
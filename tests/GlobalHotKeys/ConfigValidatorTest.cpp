@@ -0,0 +1,109 @@
+#include "ConfigValidator.h"
+#include "TestUtils.h"
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// files and directories listed up front; records all queried paths
+	class FakeProbe : public IPathProbe
+	{
+	public:
+		std::set<std::filesystem::path> files;
+		std::set<std::filesystem::path> directories;
+		std::vector<std::filesystem::path> queries;
+
+		Kind Query(std::filesystem::path const& path) override
+		{
+			std::lock_guard<std::mutex> lock{ m_lock };
+			queries.push_back(path);
+			if (files.count(path) > 0) return Kind::File;
+			if (directories.count(path) > 0) return Kind::Directory;
+			return Kind::Missing;
+		}
+
+	private:
+		std::mutex m_lock;
+	};
+
+	ConfigValidator::Context MakeContext()
+	{
+		ConfigValidator::Context context;
+		context.configDir = "/config";
+		context.currentDir = "/current";
+		// as from `PathProbe::GetSearchDirs`: application directory, current directory, system directories, `PATH`
+		context.searchDirs = { "/app", "/current", "/windows/system32", "/windows", "/tools" };
+		return context;
+	}
+
+	HotKeyConfig MakeHotKey(std::wstring const& exe)
+	{
+		HotKeyConfig hk;
+		hk.executable = exe;
+		return hk;
+	}
+
+	// an executable next to the application is found, as `SearchPathW` looks there first
+	void TestApplicationDirectory()
+	{
+		FakeProbe probe;
+		probe.files.insert("/app/tool.exe");
+		std::vector<HotKeyConfig> hotKeys{ MakeHotKey(L"tool.exe"), MakeHotKey(L"missing.exe") };
+
+		ConfigValidator validator{ probe, 1 };
+		validator.Validate(hotKeys, MakeContext());
+
+		CHECK(hotKeys[0].validation == HotKeyConfig::Validation::Valid);
+		CHECK(hotKeys[1].validation == HotKeyConfig::Validation::Invalid);
+		CHECK(hotKeys[1].validationMessage == L"executable missing.exe not found");
+	}
+
+	// candidates are probed in search order, the current directory only once
+	void TestSearchOrder()
+	{
+		FakeProbe probe;
+		std::vector<HotKeyConfig> hotKeys{ MakeHotKey(L"tool.exe") };
+
+		ConfigValidator validator{ probe, 1 };
+		validator.Validate(hotKeys, MakeContext());
+
+		const std::vector<std::filesystem::path> expected{ "/app/tool.exe", "/current/tool.exe", "/windows/system32/tool.exe", "/windows/tool.exe", "/tools/tool.exe" };
+		CHECK(probe.queries == expected);
+	}
+
+	// distinct paths are queried once per call, and again by the next call
+	void TestQueriesPerCall()
+	{
+		FakeProbe probe;
+		probe.files.insert("/tools/tool.exe");
+		probe.directories.insert("/work");
+		std::vector<HotKeyConfig> hotKeys(3, MakeHotKey(L"tool.exe"));
+		hotKeys[2].workingDirectory = L"/work";
+
+		ConfigValidator validator{ probe, 4 };
+		validator.Validate(hotKeys, MakeContext());
+		// five search directories, the working directory, and the executable in it
+		CHECK(validator.GetQueryCount() == 7);
+		CHECK(probe.queries.size() == 7);
+		for (auto const& hk : hotKeys)
+		{
+			CHECK(hk.validation == HotKeyConfig::Validation::Valid);
+		}
+
+		probe.files.clear();
+		validator.Validate(hotKeys, MakeContext());
+		CHECK(probe.queries.size() == 14);
+		CHECK(hotKeys[0].validation == HotKeyConfig::Validation::Invalid);
+	}
+}
+
+int main()
+{
+	TestApplicationDirectory();
+	TestSearchOrder();
+	TestQueriesPerCall();
+	return 0;
+}
@@ -0,0 +1,219 @@
+#include "EnvironmentSnapshot.h"
+#include "TestUtils.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using Root = IEnvironmentRegistry::Root;
+	using Value = IEnvironmentRegistry::Value;
+
+	class FakeRegistry : public IEnvironmentRegistry
+	{
+	public:
+		bool Read(Root root, std::vector<Value>& outValues) override
+		{
+			const size_t i = static_cast<size_t>(root);
+			++reads[i];
+			if (failing[i]) return false;
+			outValues = values[i];
+			return true;
+		}
+
+		// replaces `%VAR%` with values of `processEnv`; unknown references stay as they are, like `ExpandEnvironmentStringsW`
+		std::wstring Expand(std::wstring const& data) override
+		{
+			++expands;
+			std::wstring out;
+			size_t pos = 0;
+			for (;;)
+			{
+				const size_t start = data.find(L'%', pos);
+				const size_t end = (start == std::wstring::npos) ? std::wstring::npos : data.find(L'%', start + 1);
+				if (end == std::wstring::npos)
+				{
+					out.append(data, pos, std::wstring::npos);
+					return out;
+				}
+				out.append(data, pos, start - pos);
+				auto var = processEnv.find(data.substr(start + 1, end - start - 1));
+				out += (var != processEnv.end()) ? var->second : data.substr(start, end - start + 1);
+				pos = end + 1;
+			}
+		}
+
+		std::vector<Value>& Machine()
+		{
+			return values[static_cast<size_t>(Root::Machine)];
+		}
+
+		std::vector<Value>& User()
+		{
+			return values[static_cast<size_t>(Root::User)];
+		}
+
+		std::vector<Value> values[c_rootCount];
+		bool failing[c_rootCount]{};
+		size_t reads[c_rootCount]{};
+		size_t expands{ 0 };
+		std::map<std::wstring, std::wstring> processEnv{ { L"SystemRoot", L"C:\\Windows" } };
+	};
+
+	// the process environment, with the changes applied as the caller does
+	void Apply(std::vector<EnvironmentSnapshot::Change> const& changes, std::map<std::wstring, std::wstring>& env)
+	{
+		for (auto const& c : changes)
+		{
+			if (c.unset)
+			{
+				CHECK(c.value.empty());
+				CHECK(env.erase(c.name) == 1);
+			}
+			else
+			{
+				env[c.name] = c.value;
+			}
+		}
+	}
+
+	void TestFirstRefresh()
+	{
+		FakeRegistry reg;
+		reg.Machine() = {
+			{ L"Path", L"%SystemRoot%\\system32", true },
+			{ L"TEMP", L"C:\\Temp", false },
+			{ L"USERNAME", L"SYSTEM", false } };
+		reg.User() = {
+			{ L"PATH", L"C:\\Users\\bob\\bin", false },
+			{ L"TEMP", L"C:\\Users\\bob\\Temp", false },
+			{ L"Editor", L"notepad", false } };
+
+		EnvironmentSnapshot snapshot;
+		std::vector<EnvironmentSnapshot::Change> changes;
+		CHECK(snapshot.Refresh(reg, changes));
+
+		// ordered by name; paths are concatenated, the user root overrides, the user name is kept
+		CHECK(changes.size() == 3);
+		CHECK(changes[0].name == L"Editor" && changes[0].value == L"notepad" && !changes[0].unset);
+		CHECK(changes[1].name == L"Path" && changes[1].value == L"C:\\Windows\\system32;C:\\Users\\bob\\bin");
+		CHECK(changes[2].name == L"TEMP" && changes[2].value == L"C:\\Users\\bob\\Temp");
+		CHECK(snapshot.GetUnchangedCount() == 0);
+	}
+
+	void TestChanges()
+	{
+		FakeRegistry reg;
+		reg.Machine() = { { L"Path", L"C:\\bin", false }, { L"OLD", L"1", false } };
+		reg.User() = { { L"Editor", L"notepad", false }, { L"Shell", L"cmd", false } };
+
+		EnvironmentSnapshot snapshot;
+		std::vector<EnvironmentSnapshot::Change> changes;
+		CHECK(snapshot.Refresh(reg, changes));
+		std::map<std::wstring, std::wstring> env;
+		Apply(changes, env);
+		CHECK(env.size() == 4);
+
+		// an unchanged refresh reads each root once and does not expand or merge
+		const size_t expands = reg.expands;
+		CHECK(!snapshot.Refresh(reg, changes));
+		CHECK(changes.empty());
+		CHECK(snapshot.GetUnchangedCount() == 1);
+		CHECK(reg.reads[0] == 2 && reg.reads[1] == 2);
+		CHECK(reg.expands == expands);
+
+		// added, changed, and removed variables
+		reg.Machine() = { { L"Path", L"C:\\bin", false }, { L"NEW", L"2", false } };
+		reg.User() = { { L"Editor", L"vim", false }, { L"Shell", L"cmd", false } };
+		CHECK(snapshot.Refresh(reg, changes));
+		CHECK(changes.size() == 3);
+		CHECK(changes[0].name == L"Editor" && changes[0].value == L"vim" && !changes[0].unset);
+		CHECK(changes[1].name == L"NEW" && changes[1].value == L"2" && !changes[1].unset);
+		CHECK(changes[2].name == L"OLD" && changes[2].unset);
+		Apply(changes, env);
+		CHECK(env == (std::map<std::wstring, std::wstring>{
+			{ L"Editor", L"vim" }, { L"NEW", L"2" }, { L"Path", L"C:\\bin" }, { L"Shell", L"cmd" } }));
+
+		// a value moving between roots with the same result is no change
+		reg.Machine().push_back({ L"Shell", L"cmd", false });
+		reg.User().pop_back();
+		CHECK(!snapshot.Refresh(reg, changes));
+		CHECK(changes.empty());
+
+		// names are case-insensitive; removing the last of several spellings unsets it
+		reg.Machine().pop_back();
+		reg.User().push_back({ L"SHELL", L"pwsh", false });
+		CHECK(snapshot.Refresh(reg, changes));
+		CHECK(changes.size() == 1);
+		CHECK(changes[0].name == L"SHELL" && changes[0].value == L"pwsh");
+		reg.User().pop_back();
+		CHECK(snapshot.Refresh(reg, changes));
+		CHECK(changes.size() == 1);
+		CHECK(changes[0].name == L"SHELL" && changes[0].unset);
+	}
+
+	void TestExpandReference()
+	{
+		FakeRegistry reg;
+		reg.Machine() = { { L"Tools", L"%SystemRoot%\\tools", true }, { L"Literal", L"%SystemRoot%", false } };
+
+		EnvironmentSnapshot snapshot;
+		std::vector<EnvironmentSnapshot::Change> changes;
+		CHECK(snapshot.Refresh(reg, changes));
+		CHECK(changes.size() == 2);
+		CHECK(changes[0].name == L"Literal" && changes[0].value == L"%SystemRoot%");
+		CHECK(changes[1].name == L"Tools" && changes[1].value == L"C:\\Windows\\tools");
+
+		// switching the expand flag alone changes the hash
+		reg.Machine()[1].expand = true;
+		CHECK(snapshot.Refresh(reg, changes));
+		CHECK(changes.size() == 1);
+		CHECK(changes[0].name == L"Literal" && changes[0].value == L"C:\\Windows");
+	}
+
+	void TestUnreadableRoot()
+	{
+		FakeRegistry reg;
+		reg.Machine() = { { L"A", L"1", false } };
+		reg.User() = { { L"B", L"2", false } };
+
+		EnvironmentSnapshot snapshot;
+		std::vector<EnvironmentSnapshot::Change> changes;
+		CHECK(snapshot.Refresh(reg, changes));
+		CHECK(changes.size() == 2);
+
+		// the unreadable root keeps its values, instead of unsetting them
+		reg.failing[static_cast<size_t>(Root::User)] = true;
+		reg.Machine()[0].data = L"3";
+		reg.User().clear();
+		CHECK(snapshot.Refresh(reg, changes));
+		CHECK(changes.size() == 1);
+		CHECK(changes[0].name == L"A" && changes[0].value == L"3");
+
+		reg.failing[static_cast<size_t>(Root::User)] = false;
+		CHECK(snapshot.Refresh(reg, changes));
+		CHECK(changes.size() == 1);
+		CHECK(changes[0].name == L"B" && changes[0].unset);
+	}
+
+	void TestHash()
+	{
+		// different splits of the same text
+		CHECK(EnvironmentSnapshot::Hash({ { L"AB", L"C", false } }) != EnvironmentSnapshot::Hash({ { L"A", L"BC", false } }));
+		CHECK(EnvironmentSnapshot::Hash({ { L"A", L"B", false } }) != EnvironmentSnapshot::Hash({ { L"A", L"B", true } }));
+		CHECK(EnvironmentSnapshot::Hash({ { L"A", L"1", false }, { L"B", L"2", false } })
+			!= EnvironmentSnapshot::Hash({ { L"B", L"2", false }, { L"A", L"1", false } }));
+		CHECK(EnvironmentSnapshot::Hash({}) == EnvironmentSnapshot::Hash({}));
+	}
+}
+
+int main()
+{
+	TestFirstRefresh();
+	TestChanges();
+	TestExpandReference();
+	TestUnreadableRoot();
+	TestHash();
+	return 0;
+}
@@ -0,0 +1,84 @@
+#include "HotKeyIdAllocator.h"
+#include "TestUtils.h"
+
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+	void TestExhaustion()
+	{
+		HotKeyIdAllocator ids{ 1, 130 };
+		for (uint32_t i = 1; i <= 130; ++i)
+		{
+			CHECK(ids.Allocate() == i);
+		}
+		CHECK(ids.Allocate() == HotKeyIdAllocator::c_invalidId);
+		CHECK(ids.GetAllocatedCount() == 130);
+
+		ids.Release(0);
+		ids.Release(131);
+		CHECK(ids.GetAllocatedCount() == 130);
+		ids.Release(70);
+		ids.Release(70);
+		CHECK(ids.GetAllocatedCount() == 129);
+		CHECK(ids.Allocate() == 70);
+	}
+
+	// 100k random allocations and releases against a set of the free ids
+	void TestChurn()
+	{
+		constexpr uint32_t firstId = 0x10;
+		constexpr uint32_t lastId = 0x10 + 999;
+		HotKeyIdAllocator ids{ firstId, lastId };
+		std::set<uint32_t> free;
+		for (uint32_t id = firstId; id <= lastId; ++id)
+		{
+			free.insert(id);
+		}
+		std::vector<uint32_t> used;
+
+		std::mt19937 rng{ 10 };
+		for (int step = 0; step < 100000; ++step)
+		{
+			// drift between nearly empty and nearly full
+			const bool allocate = used.empty() || (rng() % 1000) < ((step / 5000) % 2 == 0 ? 700u : 300u);
+			if (allocate)
+			{
+				const uint32_t id = ids.Allocate();
+				if (free.empty())
+				{
+					CHECK(id == HotKeyIdAllocator::c_invalidId);
+					continue;
+				}
+				CHECK(id == *free.begin());
+				free.erase(free.begin());
+				used.push_back(id);
+			}
+			else
+			{
+				const size_t i = rng() % used.size();
+				const uint32_t id = used[i];
+				used[i] = used.back();
+				used.pop_back();
+				CHECK(ids.IsAllocated(id));
+				ids.Release(id);
+				CHECK(!ids.IsAllocated(id));
+				free.insert(id);
+			}
+			CHECK(ids.GetAllocatedCount() == used.size());
+		}
+		for (uint32_t id = firstId - 1; id <= lastId + 1; ++id)
+		{
+			CHECK(ids.IsAllocated(id) == (id >= firstId && id <= lastId && free.count(id) == 0));
+		}
+	}
+}
+
+int main()
+{
+	TestExhaustion();
+	TestChurn();
+	return 0;
+}
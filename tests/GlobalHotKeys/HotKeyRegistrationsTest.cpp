@@ -0,0 +1,213 @@
+#include "HotKeyRegistrations.h"
+#include "HotKeyRegistrar.h"
+#include "TestUtils.h"
+
+#include "SimpleLog/SimpleLog.hpp"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct Registration
+	{
+		uint32_t modifiers;
+		uint32_t virtualKeyCode;
+	};
+
+	// the registrations of the fake operating system, and all calls made to it
+	struct FakeSystem
+	{
+		std::map<uint32_t, Registration> registered;
+		std::vector<std::string> calls;
+		// virtual key codes failing to register, e.g. as used by another application
+		std::set<uint32_t> taken;
+	};
+
+	class FakeRegistrar : public IHotKeyRegistrar
+	{
+	public:
+		FakeRegistrar(FakeSystem& system)
+			: m_system{ system }
+		{
+		}
+
+		bool Register(uint32_t id, uint32_t modifiers, uint32_t virtualKeyCode) override
+		{
+			m_system.calls.push_back("register " + std::to_string(id));
+			CHECK(m_system.registered.count(id) == 0);
+			if (m_system.taken.count(virtualKeyCode) > 0) return false;
+			m_system.registered[id] = { modifiers, virtualKeyCode };
+			return true;
+		}
+
+		void Unregister(uint32_t id) override
+		{
+			m_system.calls.push_back("unregister " + std::to_string(id));
+			CHECK(m_system.registered.erase(id) == 1);
+		}
+
+		int GetLastErrorCode() const override
+		{
+			return 1409; // ERROR_HOTKEY_ALREADY_REGISTERED
+		}
+
+	private:
+		FakeSystem& m_system;
+	};
+
+	constexpr uint64_t c_alt = 1ull << 32;
+	constexpr uint64_t c_ctrl = 1ull << 33;
+	constexpr uint64_t c_shift = 1ull << 34;
+
+	constexpr uint64_t A = 'A' | c_ctrl;
+	constexpr uint64_t B = 'B' | c_ctrl;
+	constexpr uint64_t C = 'C' | c_alt;
+	constexpr uint64_t D = 'D' | c_alt;
+
+	// unchanged chords keep their ids, removed chords are unregistered, added ones registered
+	void TestUpdate()
+	{
+		FakeSystem system;
+		sgrottel::SimpleLog log;
+		HotKeyRegistrations registrations{ log, std::make_unique<FakeRegistrar>(system), 10, 100 };
+		CHECK(registrations.IsEmpty());
+
+		auto changes = registrations.Update({ A, B, C }, true);
+		CHECK(changes.kept == 0 && changes.removed.empty());
+		CHECK(registrations.GetId(A) == 10 && registrations.GetId(B) == 11 && registrations.GetId(C) == 12);
+		CHECK(system.registered.size() == 3);
+
+		system.calls.clear();
+		changes = registrations.Update({ C, D, B }, true);
+		CHECK(changes.kept == 2);
+		CHECK(changes.removed.size() == 1 && changes.removed[0].first == A && changes.removed[0].second == 10);
+		CHECK(registrations.GetId(A) == 0);
+		CHECK(registrations.GetId(B) == 11 && registrations.GetId(C) == 12);
+		// the freed id is recycled
+		CHECK(registrations.GetId(D) == 10);
+		CHECK((system.calls == std::vector<std::string>{ "unregister 10", "register 10" }));
+		CHECK(system.registered.at(10).virtualKeyCode == 'D');
+
+		// unchanged configuration: no calls at all
+		system.calls.clear();
+		changes = registrations.Update({ B, C, D }, true);
+		CHECK(changes.kept == 3 && changes.removed.empty());
+		CHECK(system.calls.empty());
+
+		changes = registrations.Update({}, true);
+		CHECK(changes.removed.size() == 3);
+		CHECK(system.registered.empty());
+		CHECK(registrations.IsEmpty());
+	}
+
+	// hot keys of several profiles share a chord, which is registered once
+	void TestDuplicates()
+	{
+		FakeSystem system;
+		sgrottel::SimpleLog log;
+		HotKeyRegistrations registrations{ log, std::make_unique<FakeRegistrar>(system), 10, 100 };
+
+		registrations.Update({ A, A, B, A }, true);
+		CHECK(system.registered.size() == 2);
+		CHECK(registrations.GetId(A) == 10 && registrations.GetId(B) == 11);
+	}
+
+	void TestModifiers()
+	{
+		FakeSystem system;
+		sgrottel::SimpleLog log;
+		HotKeyRegistrations registrations{ log, std::make_unique<FakeRegistrar>(system), 10, 100 };
+
+		registrations.Update({ 0x70 | c_alt | c_ctrl | c_shift, 0x71 | c_shift, 0x72 }, true);
+		CHECK(system.registered.at(10).modifiers == (IHotKeyRegistrar::c_modAlt | IHotKeyRegistrar::c_modControl | IHotKeyRegistrar::c_modShift));
+		CHECK(system.registered.at(10).virtualKeyCode == 0x70);
+		CHECK(system.registered.at(11).modifiers == IHotKeyRegistrar::c_modShift);
+		CHECK(system.registered.at(12).modifiers == 0);
+	}
+
+	// while the user disabled all hot keys, updates do not register anything
+	void TestDisabled()
+	{
+		FakeSystem system;
+		sgrottel::SimpleLog log;
+		HotKeyRegistrations registrations{ log, std::make_unique<FakeRegistrar>(system), 10, 100 };
+
+		registrations.Update({ A, B }, true);
+		registrations.UnregisterAll();
+		CHECK(system.registered.empty());
+		CHECK(!registrations.HasRegistered() && registrations.HasUnregistered());
+		CHECK(!registrations.IsEmpty());
+
+		system.calls.clear();
+		auto changes = registrations.Update({ B, C }, false);
+		CHECK(changes.kept == 0 && changes.removed.empty());
+		CHECK(system.calls.empty());
+		CHECK(registrations.GetId(B) == 0 && registrations.GetId(C) == 0);
+
+		registrations.RegisterAll();
+		CHECK(registrations.GetId(B) == 10 && registrations.GetId(C) == 11);
+		CHECK(registrations.HasRegistered() && !registrations.HasUnregistered());
+	}
+
+	// chords failing to register stay listed, and are retried when registering all
+	void TestFailure()
+	{
+		FakeSystem system;
+		system.taken.insert('B');
+		sgrottel::SimpleLog log;
+		HotKeyRegistrations registrations{ log, std::make_unique<FakeRegistrar>(system), 10, 100 };
+
+		registrations.Update({ A, B, C }, true);
+		CHECK(registrations.GetId(A) == 10 && registrations.GetId(B) == 0 && registrations.GetId(C) == 11);
+		CHECK(registrations.HasUnregistered());
+		CHECK(log.Count(sgrottel::ISimpleLog::Level::Error) == 1);
+
+		system.taken.clear();
+		registrations.RegisterAll();
+		CHECK(registrations.GetId(B) == 12);
+	}
+
+	void TestIdLimit()
+	{
+		FakeSystem system;
+		sgrottel::SimpleLog log;
+		HotKeyRegistrations registrations{ log, std::make_unique<FakeRegistrar>(system), 10, 11 };
+
+		registrations.Update({ A, B, C, D }, true);
+		CHECK(system.registered.size() == 2);
+		CHECK(registrations.GetId(C) == 0 && registrations.GetId(D) == 0);
+		// aborted after the first failure
+		CHECK(log.Count(sgrottel::ISimpleLog::Level::Error) == 1);
+
+		registrations.Update({ C, D }, true);
+		CHECK(registrations.GetId(C) == 10 && registrations.GetId(D) == 11);
+	}
+
+	void TestDestruction()
+	{
+		FakeSystem system;
+		sgrottel::SimpleLog log;
+		{
+			HotKeyRegistrations registrations{ log, std::make_unique<FakeRegistrar>(system), 10, 100 };
+			registrations.Update({ A, B }, true);
+			CHECK(system.registered.size() == 2);
+		}
+		CHECK(system.registered.empty());
+	}
+}
+
+int main()
+{
+	TestUpdate();
+	TestDuplicates();
+	TestModifiers();
+	TestDisabled();
+	TestFailure();
+	TestIdLimit();
+	TestDestruction();
+	return 0;
+}
@@ -0,0 +1,51 @@
+#include "InotifyFileChangeSource.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+InotifyFileChangeSource::InotifyFileChangeSource()
+	: m_inotify{ inotify_init1(IN_NONBLOCK | IN_CLOEXEC) }, m_watch{ -1 }, m_stop{ eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) }
+{
+}
+
+InotifyFileChangeSource::~InotifyFileChangeSource()
+{
+	if (m_inotify >= 0) close(m_inotify);
+	if (m_stop >= 0) close(m_stop);
+}
+
+bool InotifyFileChangeSource::Start(std::filesystem::path const& directory)
+{
+	if (m_inotify < 0 || m_stop < 0 || m_watch >= 0) return false;
+	// same events as the Windows source: file names, sizes and write times
+	m_watch = inotify_add_watch(m_inotify, directory.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_ATTRIB);
+	return m_watch >= 0;
+}
+
+IFileChangeSource::WaitResult InotifyFileChangeSource::Wait(uint32_t timeoutMs)
+{
+	if (m_watch < 0) return WaitResult::Failed;
+
+	pollfd fds[2] = { { m_stop, POLLIN, 0 }, { m_inotify, POLLIN, 0 } };
+	const int res = poll(fds, 2, (timeoutMs == c_infinite) ? -1 : static_cast<int>(timeoutMs));
+	if (res < 0) return WaitResult::Failed;
+	if (res == 0) return WaitResult::Timeout;
+	if (fds[0].revents != 0) return WaitResult::Stopped;
+
+	// like `FindNextChangeNotification`, all events queued so far are one change
+	alignas(inotify_event) char buf[4096];
+	while (read(m_inotify, buf, sizeof(buf)) > 0) {}
+	return WaitResult::Changed;
+}
+
+void InotifyFileChangeSource::Stop()
+{
+	if (m_stop < 0) return;
+	const uint64_t one = 1;
+	const ssize_t written = write(m_stop, &one, sizeof(one));
+	(void)written;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ReloadDebouncer.h"
+
+/// <summary>
+/// Change source using inotify, to test `ReloadDebouncer` with real file system events on Linux
+/// </summary>
+class InotifyFileChangeSource : public IFileChangeSource
+{
+public:
+	InotifyFileChangeSource();
+	~InotifyFileChangeSource();
+
+	bool Start(std::filesystem::path const& directory) override;
+	WaitResult Wait(uint32_t timeoutMs) override;
+	void Stop() override;
+
+private:
+	int m_inotify;
+	int m_watch;
+	// written by `Stop` to wake up `Wait`
+	int m_stop;
+};
@@ -0,0 +1,187 @@
+#include "LatencyHistogram.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using H = LatencyHistogram;
+
+	void TestBucketBoundaries()
+	{
+		// one bucket per value below the sub-bucket count
+		for (uint32_t v = 0; v < H::c_subBucketCount; ++v)
+		{
+			CHECK(H::BucketIndex(v) == v);
+			CHECK(H::BucketUpperBound(v) == v);
+		}
+		// the buckets of [8, 16) are one wide, of [16, 32) two wide
+		CHECK(H::BucketIndex(8) == 8);
+		CHECK(H::BucketIndex(15) == 15);
+		CHECK(H::BucketIndex(16) == 16);
+		CHECK(H::BucketIndex(17) == 16);
+		CHECK(H::BucketIndex(18) == 17);
+		CHECK(H::BucketUpperBound(16) == 17);
+		CHECK(H::BucketIndex(UINT64_MAX) == H::c_bucketCount - 1);
+		CHECK(H::BucketUpperBound(H::c_bucketCount - 1) == UINT64_MAX);
+
+		// buckets are contiguous: each starts right after the upper bound of the previous one
+		for (uint32_t i = 1; i < H::c_bucketCount; ++i)
+		{
+			const uint64_t lower = H::BucketUpperBound(i - 1) + 1;
+			const uint64_t upper = H::BucketUpperBound(i);
+			CHECK(lower <= upper);
+			CHECK(H::BucketIndex(lower) == i);
+			CHECK(H::BucketIndex(upper) == i);
+			// the width bounds the relative error
+			CHECK((upper - lower) / H::c_subBucketCount <= lower / (H::c_subBucketCount * H::c_subBucketCount) + 1);
+		}
+
+		// every power of two starts a bucket
+		for (uint32_t bit = H::c_subBucketBits; bit < 64; ++bit)
+		{
+			const uint64_t p = 1ull << bit;
+			CHECK(H::BucketIndex(p) == H::BucketIndex(p - 1) + 1);
+		}
+	}
+
+	void TestSnapshot()
+	{
+		H h;
+		H::Snapshot empty = h.GetSnapshot();
+		CHECK(empty.count == 0 && empty.min == 0 && empty.max == 0);
+		CHECK(empty.Mean() == 0.0);
+		CHECK(empty.ValueAtPercentile(50.0) == 0);
+
+		h.Record(5);
+		h.Record(100);
+		h.Record(1000);
+		H::Snapshot s = h.GetSnapshot();
+		CHECK(s.count == 3);
+		CHECK(s.sum == 1105);
+		CHECK(s.min == 5);
+		CHECK(s.max == 1000);
+		CHECK(s.buckets[H::BucketIndex(100)] == 1);
+
+		h.Reset();
+		s = h.GetSnapshot();
+		CHECK(s.count == 0 && s.sum == 0 && s.min == 0 && s.max == 0);
+		for (uint64_t b : s.buckets) CHECK(b == 0);
+	}
+
+	void TestPercentiles()
+	{
+		H h;
+		for (uint64_t v = 1; v <= 100; ++v)
+		{
+			h.Record(v);
+		}
+		const H::Snapshot s = h.GetSnapshot();
+		// values are reported as the upper bound of their bucket
+		CHECK(s.ValueAtPercentile(0.0) == 1);
+		CHECK(s.ValueAtPercentile(1.0) == 1);
+		CHECK(s.ValueAtPercentile(50.0) == H::BucketUpperBound(H::BucketIndex(50)));
+		CHECK(s.ValueAtPercentile(90.0) == H::BucketUpperBound(H::BucketIndex(90)));
+		// clamped to the maximum, also beyond 100
+		CHECK(s.ValueAtPercentile(100.0) == 100);
+		CHECK(s.ValueAtPercentile(250.0) == 100);
+		CHECK(s.ValueAtPercentile(-1.0) == 1);
+
+		// the reported value is within the relative error of the exact one
+		H wide;
+		std::mt19937_64 rng{ 42 };
+		std::vector<uint64_t> values;
+		for (int i = 0; i < 10000; ++i)
+		{
+			values.push_back(rng() % 10000000);
+			wide.Record(values.back());
+		}
+		std::sort(values.begin(), values.end());
+		const H::Snapshot ws = wide.GetSnapshot();
+		for (double p : { 10.0, 50.0, 90.0, 99.0, 99.9 })
+		{
+			const uint64_t exact = values[static_cast<size_t>(p / 100.0 * values.size() + 0.5) - 1];
+			const uint64_t reported = ws.ValueAtPercentile(p);
+			CHECK(reported >= exact);
+			CHECK(reported - exact <= exact / H::c_subBucketCount + 1);
+		}
+	}
+
+	void TestMerge()
+	{
+		H a;
+		H b;
+		H both;
+		for (uint64_t v : { 3, 70, 900 })
+		{
+			a.Record(v);
+			both.Record(v);
+		}
+		for (uint64_t v : { 1, 70, 50000 })
+		{
+			b.Record(v);
+			both.Record(v);
+		}
+
+		H::Snapshot merged = a.GetSnapshot();
+		merged.Merge(b.GetSnapshot());
+		const H::Snapshot expected = both.GetSnapshot();
+		CHECK(merged.count == expected.count);
+		CHECK(merged.sum == expected.sum);
+		CHECK(merged.min == 1);
+		CHECK(merged.max == 50000);
+		CHECK(merged.buckets == expected.buckets);
+		CHECK(merged.ValueAtPercentile(50.0) == expected.ValueAtPercentile(50.0));
+
+		// empty snapshots do not contribute their zero min, in either direction
+		H::Snapshot total;
+		total.Merge(H::Snapshot{});
+		CHECK(total.count == 0 && total.min == 0);
+		total.Merge(a.GetSnapshot());
+		CHECK(total.min == 3 && total.max == 900);
+		total.Merge(H{}.GetSnapshot());
+		CHECK(total.min == 3 && total.count == 3);
+	}
+
+	void TestConcurrentRecord()
+	{
+		constexpr uint32_t c_threads = 8;
+		constexpr uint64_t c_perThread = 20000;
+		H h;
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0; t < c_threads; ++t)
+		{
+			threads.emplace_back([&h, t]()
+				{
+					for (uint64_t i = 0; i < c_perThread; ++i)
+					{
+						h.Record(t * c_perThread + i);
+					}
+				});
+		}
+		for (auto& t : threads) t.join();
+
+		const H::Snapshot s = h.GetSnapshot();
+		const uint64_t n = c_threads * c_perThread;
+		CHECK(s.count == n);
+		CHECK(s.sum == n * (n - 1) / 2);
+		CHECK(s.min == 0);
+		CHECK(s.max == n - 1);
+		uint64_t total = 0;
+		for (uint64_t b : s.buckets) total += b;
+		CHECK(total == n);
+	}
+}
+
+int main()
+{
+	TestBucketBoundaries();
+	TestSnapshot();
+	TestPercentiles();
+	TestMerge();
+	TestConcurrentRecord();
+	return 0;
+}
@@ -0,0 +1,136 @@
+#include "LaunchPlan.h"
+#include "BenchUtils.h"
+#include "HotKeyConfig.h"
+#include "TestUtils.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	class BenchSource : public IArgumentSource
+	{
+	public:
+		bool GetEnvironmentValue(std::wstring const& name, std::wstring& outValue) override
+		{
+			if (name != L"USER") return false;
+			outValue = L"bob";
+			return true;
+		}
+
+		bool GetClipboardText(std::wstring& outText) override
+		{
+			outText = L"CLIP";
+			return true;
+		}
+
+		std::tm GetNow() override
+		{
+			std::tm t{};
+			t.tm_year = 126;
+			t.tm_mon = 9;
+			t.tm_mday = 17;
+			return t;
+		}
+	};
+
+	// probes the directories like `SearchPathW` does for a name without path
+	class DirSearch : public IExecutableSearch
+	{
+	public:
+		std::filesystem::path Search(wchar_t const* dir, std::filesystem::path const& exe) override
+		{
+			if (dir != nullptr)
+			{
+				return Probe(dir, exe);
+			}
+			for (std::filesystem::path const& d : dirs)
+			{
+				std::filesystem::path p = Probe(d, exe);
+				if (!p.empty()) return p;
+			}
+			return {};
+		}
+
+		std::vector<std::filesystem::path> dirs;
+
+	private:
+		static std::filesystem::path Probe(std::filesystem::path const& dir, std::filesystem::path const& exe)
+		{
+			std::filesystem::path p = dir / exe;
+			std::error_code ec;
+			return std::filesystem::is_regular_file(p, ec) ? p : std::filesystem::path{};
+		}
+	};
+}
+
+// Launching from a plan built once, against resolving the configuration on every trigger as before plans existed
+int main(int argc, char** argv)
+{
+	Benchmark bench{ argc, argv };
+
+	const std::filesystem::path root = std::filesystem::temp_directory_path() / "LaunchPlanBenchmark";
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root / "config");
+	std::filesystem::create_directories(root / "bin");
+	std::filesystem::create_directories(root / "work");
+	for (int i = 0; i < 8; ++i)
+	{
+		std::filesystem::create_directories(root / ("path" + std::to_string(i)));
+	}
+	std::ofstream{ root / "bin" / "tool.exe" } << "MZ";
+	std::ofstream{ root / "config" / "notes.txt" } << "notes";
+
+	DirSearch search;
+	for (int i = 0; i < 8; ++i)
+	{
+		search.dirs.push_back(root / ("path" + std::to_string(i)));
+	}
+	search.dirs.push_back(root / "bin");
+	BenchSource source;
+
+	HotKeyConfig config;
+	config.executable = L"tool.exe";
+	config.workingDirectory = (root / "work").wstring();
+	config.arguments = { L"--user", L"${env:USER}", L"--notes", L"notes.txt", L"--config", L"${configdir}" };
+	config.resolveArgsPaths[3].isRelPath = true;
+	const std::filesystem::path configDir = root / "config";
+
+	LaunchPlan plan;
+	plan.Compile(config);
+	bench.Run("LaunchPlan::Build, resolved per trigger", 2000, [&](size_t)
+		{
+			plan.Build(config, configDir, source, search);
+		});
+	CHECK(plan.IsValid());
+	CHECK(plan.GetExecutable() == (root / "bin" / "tool.exe").wstring());
+	CHECK(!plan.IsStale());
+
+	LaunchPlan::Buffers buffers;
+	size_t length = 0;
+	bench.Run("LaunchPlan::PrepareCommandLine, constant", 200000, [&](size_t)
+		{
+			length += std::wcslen(plan.PrepareCommandLine(source, buffers));
+		});
+	const std::wstring cmdLine = buffers.commandLine.data();
+	CHECK(cmdLine.find((root / "config" / "notes.txt").wstring()) != std::wstring::npos);
+	CHECK(cmdLine.find(L"bob") != std::wstring::npos);
+
+	config.arguments.push_back(L"--date");
+	config.arguments.push_back(L"${date:%Y-%m-%d}");
+	LaunchPlan datedPlan;
+	datedPlan.Compile(config);
+	datedPlan.Build(config, configDir, source, search);
+	CHECK(datedPlan.IsValid());
+	bench.Run("LaunchPlan::PrepareCommandLine, ${date}", 200000, [&](size_t)
+		{
+			length += std::wcslen(datedPlan.PrepareCommandLine(source, buffers));
+		});
+	CHECK(std::wstring{ buffers.commandLine.data() }.find(L"2026-10-17") != std::wstring::npos);
+
+	DoNotOptimize(length);
+	std::filesystem::remove_all(root);
+	return 0;
+}
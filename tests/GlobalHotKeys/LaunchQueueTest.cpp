@@ -0,0 +1,108 @@
+#include "LaunchQueue.h"
+#include "TestUtils.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t c_producers = 8;
+	constexpr uint32_t c_itemsPerProducer = 20000;
+
+	uint64_t GetChord(uint32_t id)
+	{
+		return (1ull << 33) | (0x41 + id);
+	}
+
+	// producers push concurrently: each accepted item is handled exactly once, in push order per producer, with its chord
+	void TestStress(size_t capacity, bool slowHandler)
+	{
+		std::vector<std::vector<uint32_t>> handled(c_producers);
+		std::atomic<uint32_t> handledCount{ 0 };
+		std::atomic<uint32_t> chordMismatches{ 0 };
+		LaunchQueue queue{ [&](LaunchQueue::Item const& item)
+			{
+				// only the worker thread calls the handler
+				handled[item.id].push_back(item.processId);
+				if (item.chord != GetChord(item.id))
+				{
+					chordMismatches++;
+				}
+				handledCount++;
+				if (slowHandler && item.processId % 64 == 0)
+				{
+					std::this_thread::yield();
+				}
+			}, capacity };
+
+		std::vector<std::vector<uint32_t>> accepted(c_producers);
+		std::vector<std::thread> producers;
+		for (uint32_t p = 0; p < c_producers; ++p)
+		{
+			producers.emplace_back([&queue, &accepted, p]()
+				{
+					for (uint32_t seq = 0; seq < c_itemsPerProducer; ++seq)
+					{
+						if (queue.TryPush(p, GetChord(p), seq))
+						{
+							accepted[p].push_back(seq);
+						}
+					}
+				});
+		}
+		for (std::thread& t : producers)
+		{
+			t.join();
+		}
+		queue.WaitIdle();
+
+		size_t acceptedCount = 0;
+		for (uint32_t p = 0; p < c_producers; ++p)
+		{
+			CHECK(handled[p] == accepted[p]);
+			acceptedCount += accepted[p].size();
+		}
+		CHECK(handledCount == acceptedCount);
+		CHECK(chordMismatches == 0);
+		CHECK(queue.GetRejectedCount() + acceptedCount == c_producers * c_itemsPerProducer);
+	}
+
+	void TestStop()
+	{
+		std::atomic<bool> entered{ false };
+		std::atomic<bool> release{ false };
+		std::atomic<int> handledCount{ 0 };
+		LaunchQueue queue{ [&](LaunchQueue::Item const&)
+			{
+				entered = true;
+				while (!release) std::this_thread::yield();
+				handledCount++;
+			}, 4 };
+
+		CHECK(queue.TryPush(1, GetChord(1)));
+		while (!entered) std::this_thread::yield();
+		// the worker blocks on the first item, so the ring fills up
+		while (queue.TryPush(2, GetChord(2))) {}
+		CHECK(queue.GetRejectedCount() == 1);
+
+		std::thread stopper{ [&queue]() { queue.Stop(); } };
+		// returns once stopped, as the worker is still busy
+		queue.WaitIdle();
+		release = true;
+		stopper.join();
+		// queued items are discarded
+		CHECK(handledCount == 1);
+		CHECK(!queue.TryPush(3, GetChord(3)));
+		queue.WaitIdle();
+	}
+}
+
+int main()
+{
+	TestStress(LaunchQueue::c_defaultCapacity, false);
+	TestStress(4, true);
+	TestStress(1 << 20, false);
+	TestStop();
+	return 0;
+}
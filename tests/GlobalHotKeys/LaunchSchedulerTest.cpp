@@ -0,0 +1,196 @@
+#include "LaunchScheduler.h"
+#include "TestUtils.h"
+
+#include <memory>
+
+namespace
+{
+	using Decision = LaunchScheduler::Decision;
+
+	constexpr uint64_t c_keyA = (1ull << 33) | 0x41;
+	constexpr uint64_t c_keyB = (1ull << 33) | 0x42;
+
+	// runs until the test clears the shared flag
+	class FakeChild : public IChildProcess
+	{
+	public:
+		explicit FakeChild(std::shared_ptr<bool> running)
+			: m_running{ std::move(running) }
+		{
+		}
+
+		bool IsRunning() override
+		{
+			return *m_running;
+		}
+
+	private:
+		std::shared_ptr<bool> m_running;
+	};
+
+	struct FakeClock
+	{
+		uint64_t now{ 1000 };
+
+		LaunchScheduler::Clock Get()
+		{
+			return [this]() { return now; };
+		}
+	};
+
+	// starts a process for a trigger the way `HotKeyManager` does, if the scheduler lets it
+	Decision Trigger(LaunchScheduler& scheduler, uint64_t key, LaunchPolicy const& policy, std::shared_ptr<bool> running = {})
+	{
+		Decision d = scheduler.OnTriggered(key, policy);
+		if (d != Decision::Launch) return d;
+		d = scheduler.BeginLaunch(key, policy);
+		if (d == Decision::Launch && running)
+		{
+			scheduler.AddChild(key, std::make_unique<FakeChild>(running));
+		}
+		return d;
+	}
+
+	void TestUnlimited()
+	{
+		FakeClock clock;
+		LaunchScheduler scheduler{ clock.Get() };
+		LaunchPolicy policy;
+		for (int i = 0; i < 10; ++i)
+		{
+			CHECK(Trigger(scheduler, c_keyA, policy, std::make_shared<bool>(true)) == Decision::Launch);
+		}
+		CHECK(scheduler.GetRunningCount(c_keyA) == 10);
+		CHECK(scheduler.GetRunningCount(c_keyB) == 0);
+	}
+
+	void TestCoalesce()
+	{
+		FakeClock clock;
+		LaunchScheduler scheduler{ clock.Get() };
+		LaunchPolicy policy;
+		policy.coalesce = true;
+
+		// triggers are coalesced while one is queued, per key
+		CHECK(scheduler.OnTriggered(c_keyA, policy) == Decision::Launch);
+		CHECK(scheduler.OnTriggered(c_keyA, policy) == Decision::Coalesced);
+		CHECK(scheduler.OnTriggered(c_keyB, policy) == Decision::Launch);
+		CHECK(scheduler.BeginLaunch(c_keyA, policy) == Decision::Launch);
+		CHECK(scheduler.OnTriggered(c_keyA, policy) == Decision::Launch);
+
+		// a trigger which could not be queued does not block the next one
+		scheduler.OnTriggerDropped(c_keyA);
+		CHECK(scheduler.OnTriggered(c_keyA, policy) == Decision::Launch);
+
+		// without coalescing, triggers queue up
+		LaunchPolicy queueing;
+		CHECK(scheduler.OnTriggered(c_keyA, queueing) == Decision::Launch);
+		CHECK(scheduler.OnTriggered(c_keyA, queueing) == Decision::Launch);
+	}
+
+	void TestResetPending()
+	{
+		FakeClock clock;
+		LaunchScheduler scheduler{ clock.Get() };
+		LaunchPolicy policy;
+		policy.coalesce = true;
+
+		CHECK(scheduler.OnTriggered(c_keyA, policy) == Decision::Launch);
+		CHECK(scheduler.OnTriggered(c_keyB, policy) == Decision::Launch);
+
+		// the queued trigger of A will not reach `BeginLaunch`; B keeps its pending trigger
+		scheduler.ResetPending(c_keyA);
+		CHECK(scheduler.OnTriggered(c_keyA, policy) == Decision::Launch);
+		CHECK(scheduler.OnTriggered(c_keyB, policy) == Decision::Coalesced);
+
+		// unknown keys are ignored
+		scheduler.ResetPending(0x43);
+		scheduler.OnTriggerDropped(0x43);
+		CHECK(scheduler.OnTriggered(0x43, policy) == Decision::Launch);
+	}
+
+	void TestCooldown()
+	{
+		FakeClock clock;
+		LaunchScheduler scheduler{ clock.Get() };
+		LaunchPolicy policy;
+		policy.cooldownMs = 500;
+
+		// the first launch is not cooled down, even at time zero
+		clock.now = 0;
+		CHECK(Trigger(scheduler, c_keyA, policy) == Decision::Launch);
+		clock.now = 499;
+		CHECK(Trigger(scheduler, c_keyA, policy) == Decision::Cooldown);
+		CHECK(Trigger(scheduler, c_keyB, policy) == Decision::Launch);
+
+		// suppressed triggers do not extend the cooldown
+		clock.now = 500;
+		CHECK(Trigger(scheduler, c_keyA, policy) == Decision::Launch);
+		clock.now = 999;
+		CHECK(Trigger(scheduler, c_keyA, policy) == Decision::Cooldown);
+		clock.now = 1000;
+		CHECK(Trigger(scheduler, c_keyA, policy) == Decision::Launch);
+
+		// a suppressed trigger is no longer pending
+		policy.coalesce = true;
+		CHECK(Trigger(scheduler, c_keyA, policy) == Decision::Cooldown);
+		CHECK(scheduler.OnTriggered(c_keyA, policy) == Decision::Launch);
+	}
+
+	void TestConcurrencyLimit()
+	{
+		FakeClock clock;
+		LaunchScheduler scheduler{ clock.Get() };
+		LaunchPolicy policy;
+		policy.maxConcurrent = 2;
+
+		auto first = std::make_shared<bool>(true);
+		auto second = std::make_shared<bool>(true);
+		CHECK(Trigger(scheduler, c_keyA, policy, first) == Decision::Launch);
+		CHECK(Trigger(scheduler, c_keyA, policy, second) == Decision::Launch);
+		CHECK(Trigger(scheduler, c_keyA, policy, std::make_shared<bool>(true)) == Decision::ConcurrencyLimit);
+		CHECK(scheduler.GetRunningCount(c_keyA) == 2);
+		CHECK(Trigger(scheduler, c_keyB, policy, std::make_shared<bool>(true)) == Decision::Launch);
+
+		// exited processes free their slot
+		*first = false;
+		CHECK(scheduler.GetRunningCount(c_keyA) == 1);
+		auto third = std::make_shared<bool>(true);
+		CHECK(Trigger(scheduler, c_keyA, policy, third) == Decision::Launch);
+		CHECK(Trigger(scheduler, c_keyA, policy, std::make_shared<bool>(true)) == Decision::ConcurrencyLimit);
+
+		*second = false;
+		*third = false;
+		CHECK(scheduler.GetRunningCount(c_keyA) == 0);
+		CHECK(Trigger(scheduler, c_keyA, policy, std::make_shared<bool>(true)) == Decision::Launch);
+	}
+
+	void TestCooldownBeforeLimit()
+	{
+		FakeClock clock;
+		LaunchScheduler scheduler{ clock.Get() };
+		LaunchPolicy policy;
+		policy.cooldownMs = 100;
+		policy.maxConcurrent = 1;
+
+		CHECK(Trigger(scheduler, c_keyA, policy, std::make_shared<bool>(true)) == Decision::Launch);
+		clock.now += 50;
+		CHECK(Trigger(scheduler, c_keyA, policy) == Decision::Cooldown);
+		clock.now += 50;
+		CHECK(Trigger(scheduler, c_keyA, policy) == Decision::ConcurrencyLimit);
+
+		// a launch suppressed by the limit does not start a cooldown
+		CHECK(Trigger(scheduler, c_keyA, policy) == Decision::ConcurrencyLimit);
+	}
+}
+
+int main()
+{
+	TestUnlimited();
+	TestCoalesce();
+	TestResetPending();
+	TestCooldown();
+	TestConcurrencyLimit();
+	TestCooldownBeforeLimit();
+	return 0;
+}
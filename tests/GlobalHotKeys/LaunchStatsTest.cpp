@@ -0,0 +1,86 @@
+#include "LaunchStats.h"
+#include "TestUtils.h"
+
+#include <string>
+
+namespace
+{
+	using namespace std::chrono_literals;
+	using Phase = LaunchStats::Phase;
+	using Failure = LaunchStats::Failure;
+
+	void TestRecord()
+	{
+		LaunchStats stats;
+		stats.Record(Phase::Lookup, 1500us);
+		stats.Record(Phase::Lookup, 2ms);
+		// clock steps back are recorded as zero
+		stats.Record(Phase::Total, -5ms);
+		stats.CountFailure(Failure::Cooldown);
+		stats.CountFailure(Failure::Cooldown);
+
+		const LatencyHistogram::Snapshot lookup = stats.GetHistogram(Phase::Lookup).GetSnapshot();
+		CHECK(lookup.count == 2);
+		CHECK(lookup.sum == 3500);
+		CHECK(stats.GetHistogram(Phase::Total).GetSnapshot().max == 0);
+		CHECK(stats.GetHistogram(Phase::Queue).GetSnapshot().count == 0);
+		CHECK(stats.GetFailureCount(Failure::Cooldown) == 2);
+		CHECK(stats.GetFailureCount(Failure::NotFound) == 0);
+
+		const LaunchStats::Snapshot s = stats.GetSnapshot();
+		CHECK(s.phases[static_cast<uint32_t>(Phase::Lookup)].count == 2);
+		CHECK(s.failures[static_cast<uint32_t>(Failure::Cooldown)] == 2);
+	}
+
+	void TestMerge()
+	{
+		LaunchStats a;
+		LaunchStats b;
+		a.Record(Phase::CreateProcess, 10ms);
+		b.Record(Phase::CreateProcess, 30ms);
+		b.Record(Phase::Bell, 1ms);
+		a.CountFailure(Failure::QueueFull);
+		b.CountFailure(Failure::QueueFull);
+		b.CountFailure(Failure::ActionFailed);
+
+		LaunchStats::Snapshot total;
+		total.Merge(a.GetSnapshot());
+		total.Merge(b.GetSnapshot());
+		LatencyHistogram::Snapshot const& create = total.phases[static_cast<uint32_t>(Phase::CreateProcess)];
+		CHECK(create.count == 2);
+		CHECK(create.min == 10000 && create.max == 30000);
+		CHECK(total.phases[static_cast<uint32_t>(Phase::Bell)].count == 1);
+		CHECK(total.failures[static_cast<uint32_t>(Failure::QueueFull)] == 2);
+		CHECK(total.failures[static_cast<uint32_t>(Failure::ActionFailed)] == 1);
+	}
+
+	void TestFormat()
+	{
+		LaunchStats stats;
+		stats.Record(Phase::Resolve, 1234us);
+		stats.CountFailure(Failure::ConcurrencyLimit);
+		std::wstring text;
+		stats.Format(text);
+
+		CHECK(text.find(L"max-concurrent 1") != std::wstring::npos);
+		CHECK(text.find(L"not-found 0") != std::wstring::npos);
+		// one line per phase, with values in milliseconds
+		for (uint32_t i = 0; i < LaunchStats::c_phaseCount; ++i)
+		{
+			CHECK(text.find(std::wstring{ L"  " } + LaunchStats::GetName(static_cast<Phase>(i)) + L" ") != std::wstring::npos);
+		}
+		const size_t resolve = text.find(L"  resolve ");
+		CHECK(resolve != std::wstring::npos);
+		const std::wstring line = text.substr(resolve, text.find(L'\n', resolve) - resolve);
+		CHECK(line.find(L" 1 ") != std::wstring::npos);
+		CHECK(line.find(L"1.234") != std::wstring::npos);
+	}
+}
+
+int main()
+{
+	TestRecord();
+	TestMerge();
+	TestFormat();
+	return 0;
+}
@@ -0,0 +1,174 @@
+#include "ProfileResolver.h"
+#include "ProcessImageCache.h"
+#include "TestUtils.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// processes by id, with their creation time and image path
+	class FakeProcesses : public IProcessInfo
+	{
+	public:
+		struct Process
+		{
+			uint64_t creationTime;
+			std::wstring path;
+			// e.g. an elevated process, whose image cannot be queried with limited rights
+			bool hidesImage{ false };
+		};
+
+		bool GetCreationTime(uint32_t processId, uint64_t& outTime) override
+		{
+			auto it = processes.find(processId);
+			if (it == processes.end()) return false;
+			outTime = it->second.creationTime;
+			return true;
+		}
+
+		bool GetImagePath(uint32_t processId, std::wstring& outPath) override
+		{
+			++imageQueries;
+			auto it = processes.find(processId);
+			if (it == processes.end() || it->second.hidesImage) return false;
+			outPath = it->second.path;
+			return true;
+		}
+
+		std::map<uint32_t, Process> processes;
+		size_t imageQueries{ 0 };
+	};
+
+	std::vector<HotKeyProfile> Profiles()
+	{
+		return {
+			{ L"office", { L"WINWORD.EXE", L"C:\\Program Files\\Office\\excel.exe", L"" } },
+			{ L"dev", { L"code.exe", L"devenv.exe" } },
+			// listed by `office` already, so used there
+			{ L"sheets", { L"Excel.exe", L"calc.exe" } },
+		};
+	}
+
+	void TestNormalizeImageName()
+	{
+		CHECK(ProfileResolver::NormalizeImageName(L"C:\\Windows\\NOTEPAD.EXE") == L"notepad.exe");
+		CHECK(ProfileResolver::NormalizeImageName(L"C:/tools/Code.exe") == L"code.exe");
+		CHECK(ProfileResolver::NormalizeImageName(L"\\\\?\\D:\\a\\B.exe") == L"b.exe");
+		CHECK(ProfileResolver::NormalizeImageName(L"plain.EXE") == L"plain.exe");
+		CHECK(ProfileResolver::NormalizeImageName(L"C:\\dir\\") == L"");
+		CHECK(ProfileResolver::NormalizeImageName(L"") == L"");
+	}
+
+	void TestResolve()
+	{
+		ProfileResolver resolver;
+		CHECK(resolver.IsEmpty());
+		CHECK(resolver.Resolve(L"code.exe") == ProfileResolver::c_noProfile);
+
+		resolver.Build(Profiles());
+		CHECK(!resolver.IsEmpty());
+		CHECK(resolver.GetProfileId(L"office") == 1);
+		CHECK(resolver.GetProfileId(L"dev") == 2);
+		CHECK(resolver.GetProfileId(L"sheets") == 3);
+		CHECK(resolver.GetProfileId(L"Office") == ProfileResolver::c_noProfile);
+		CHECK(resolver.GetProfileId(L"") == ProfileResolver::c_noProfile);
+
+		CHECK(resolver.Resolve(L"winword.exe") == 1);
+		CHECK(resolver.Resolve(L"excel.exe") == 1);
+		CHECK(resolver.Resolve(L"devenv.exe") == 2);
+		CHECK(resolver.Resolve(L"calc.exe") == 3);
+		// applications without profile fall back to the hot keys without profile
+		CHECK(resolver.Resolve(L"notepad.exe") == ProfileResolver::c_noProfile);
+		CHECK(resolver.Resolve(L"") == ProfileResolver::c_noProfile);
+
+		// the first profile listing an application wins
+		CHECK(resolver.GetConflicts() == (std::vector<std::wstring>{ L"excel.exe sheets" }));
+
+		// rebuilding replaces the previous index
+		resolver.Build({ { L"dev", { L"code.exe", L"CODE.exe" } } });
+		CHECK(resolver.GetProfileId(L"office") == ProfileResolver::c_noProfile);
+		CHECK(resolver.Resolve(L"winword.exe") == ProfileResolver::c_noProfile);
+		CHECK(resolver.Resolve(L"code.exe") == 1);
+		// listing an application twice in the same profile is no conflict
+		CHECK(resolver.GetConflicts().empty());
+	}
+
+	void TestCache()
+	{
+		FakeProcesses procs;
+		procs.processes[100] = { 1, L"C:\\Program Files\\VS Code\\Code.exe" };
+		procs.processes[200] = { 2, L"C:\\Windows\\notepad.exe" };
+		ProcessImageCache cache{ procs };
+
+		CHECK(cache.Lookup(100) == L"code.exe");
+		CHECK(cache.Lookup(100) == L"code.exe");
+		CHECK(cache.Lookup(200) == L"notepad.exe");
+		CHECK(cache.GetMissCount() == 2);
+		CHECK(cache.GetHitCount() == 1);
+		CHECK(procs.imageQueries == 2);
+
+		// a reused process id is detected by its creation time
+		procs.processes[100] = { 3, L"C:\\Windows\\System32\\calc.exe" };
+		CHECK(cache.Lookup(100) == L"calc.exe");
+		CHECK(cache.GetMissCount() == 3);
+
+		// exited and unqueryable processes have no name, and are not cached
+		procs.processes.erase(200);
+		CHECK(cache.Lookup(200).empty());
+		procs.processes[200] = { 4, L"C:\\admin\\tool.exe", true };
+		CHECK(cache.Lookup(200).empty());
+		CHECK(cache.Lookup(200).empty());
+		CHECK(procs.imageQueries == 5);
+		CHECK(cache.Lookup(999).empty());
+
+		// a full cache starts over
+		ProcessImageCache small{ procs, 2 };
+		procs.processes[300] = { 5, L"a.exe" };
+		CHECK(small.Lookup(100) == L"calc.exe");
+		CHECK(small.Lookup(300) == L"a.exe");
+		procs.processes[400] = { 6, L"b.exe" };
+		CHECK(small.Lookup(400) == L"b.exe");
+		const uint64_t misses = small.GetMissCount();
+		CHECK(small.Lookup(400) == L"b.exe");
+		CHECK(small.Lookup(100) == L"calc.exe");
+		CHECK(small.GetMissCount() == misses + 1);
+	}
+
+	// the profile of the foreground process, as `HotKeyManager` selects the hot key to launch
+	void TestForeground()
+	{
+		FakeProcesses procs;
+		procs.processes[10] = { 1, L"C:\\Office\\WINWORD.EXE" };
+		procs.processes[11] = { 1, L"C:\\Windows\\explorer.exe" };
+		procs.processes[12] = { 1, L"C:\\Program Files\\Microsoft Visual Studio\\devenv.exe", true };
+		ProcessImageCache cache{ procs };
+		ProfileResolver resolver;
+		resolver.Build(Profiles());
+
+		auto foregroundProfile = [&](uint32_t processId)
+			{
+				return processId != 0 ? resolver.Resolve(cache.Lookup(processId)) : ProfileResolver::c_noProfile;
+			};
+		CHECK(foregroundProfile(10) == resolver.GetProfileId(L"office"));
+		// applications without profile, processes which cannot be queried, and no foreground window
+		// all fall back to the hot keys without profile
+		CHECK(foregroundProfile(11) == ProfileResolver::c_noProfile);
+		CHECK(foregroundProfile(12) == ProfileResolver::c_noProfile);
+		CHECK(foregroundProfile(0) == ProfileResolver::c_noProfile);
+
+		// once the process can be queried, e.g. after restarting it without elevation
+		procs.processes[12] = { 2, L"C:\\Program Files\\Microsoft Visual Studio\\devenv.exe" };
+		CHECK(foregroundProfile(12) == resolver.GetProfileId(L"dev"));
+	}
+}
+
+int main()
+{
+	TestNormalizeImageName();
+	TestResolve();
+	TestCache();
+	TestForeground();
+	return 0;
+}
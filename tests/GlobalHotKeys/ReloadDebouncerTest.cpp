@@ -0,0 +1,208 @@
+#include "ReloadDebouncer.h"
+#include "InotifyFileChangeSource.h"
+#include "TestUtils.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using WaitResult = IFileChangeSource::WaitResult;
+
+	// replays scripted results; waiting advances the fake clock, by the full timeout if it elapses before the scripted change
+	class ScriptedSource : public IFileChangeSource
+	{
+	public:
+		// `Changed` results arrive this long after waiting started
+		static constexpr uint64_t c_changeStepMs = 100;
+
+		ScriptedSource(uint64_t& now, std::vector<WaitResult> script, bool repeatLast = false)
+			: m_now{ now }, m_script{ std::move(script) }, m_repeatLast{ repeatLast }
+		{
+		}
+
+		bool Start(std::filesystem::path const&) override
+		{
+			return true;
+		}
+
+		WaitResult Wait(uint32_t timeoutMs) override
+		{
+			waits++;
+			WaitResult res = WaitResult::Stopped;
+			if (m_next < m_script.size())
+			{
+				res = m_script[m_next++];
+			}
+			else if (m_repeatLast && !m_script.empty())
+			{
+				res = m_script.back();
+			}
+
+			if (res == WaitResult::Changed && (timeoutMs == c_infinite || timeoutMs > c_changeStepMs))
+			{
+				m_now += c_changeStepMs;
+			}
+			else if (res == WaitResult::Changed || res == WaitResult::Timeout)
+			{
+				CHECK(timeoutMs != c_infinite);
+				m_now += timeoutMs;
+				res = WaitResult::Timeout;
+			}
+			return res;
+		}
+
+		void Stop() override
+		{
+		}
+
+		size_t waits{ 0 };
+
+	private:
+		uint64_t& m_now;
+		std::vector<WaitResult> m_script;
+		bool m_repeatLast;
+		size_t m_next{ 0 };
+	};
+
+	std::filesystem::path MakeTestDir(const char* name)
+	{
+		const std::filesystem::path dir = std::filesystem::temp_directory_path()
+			/ (std::string{ "ReloadDebouncerTest-" } + name + "-" + std::to_string(getpid()));
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directories(dir);
+		return dir;
+	}
+
+	void Append(std::filesystem::path const& path, const char* text)
+	{
+		std::ofstream file{ path, std::ios::binary | std::ios::app };
+		file << text;
+	}
+
+	// a burst of changes reports the file once, after it was quiet for the debounce time
+	void TestBurstCoalesced()
+	{
+		const std::filesystem::path dir = MakeTestDir("burst");
+		const std::filesystem::path file = dir / "config.yaml";
+		Append(file, "a");
+
+		uint64_t now = 1000;
+		ScriptedSource source{ now, { WaitResult::Changed, WaitResult::Changed, WaitResult::Changed, WaitResult::Timeout } };
+		ReloadDebouncer debouncer{ source, file, [&now]() { return now; } };
+		Append(file, "b");
+
+		CHECK(debouncer.WaitForChange());
+		CHECK(source.waits == 4);
+		// first change at 1100, last one at 1300, quiet until 1600
+		CHECK(now == 1300 + ReloadDebouncer::c_debounceMs);
+
+		// the script ended
+		CHECK(!debouncer.WaitForChange());
+		std::filesystem::remove_all(dir);
+	}
+
+	// a steady stream of changes still reports the file after the maximum delay
+	void TestMaxDelay()
+	{
+		const std::filesystem::path dir = MakeTestDir("stream");
+		const std::filesystem::path file = dir / "config.yaml";
+		Append(file, "a");
+
+		uint64_t now = 0;
+		ScriptedSource source{ now, { WaitResult::Changed }, true };
+		ReloadDebouncer debouncer{ source, file, [&now]() { return now; } };
+		Append(file, "b");
+
+		CHECK(debouncer.WaitForChange());
+		// the burst started with the first change at 100
+		CHECK(now == 100 + ReloadDebouncer::c_maxDelayMs);
+		std::filesystem::remove_all(dir);
+	}
+
+	// changes of other files, and deleting the file, are not reported
+	void TestIgnoredChanges(bool deleteFile)
+	{
+		const std::filesystem::path dir = MakeTestDir("ignored");
+		const std::filesystem::path file = dir / "config.yaml";
+		Append(file, "a");
+
+		uint64_t now = 0;
+		ScriptedSource source{ now, { WaitResult::Changed, WaitResult::Timeout } };
+		ReloadDebouncer debouncer{ source, file, [&now]() { return now; } };
+		Append(dir / "other.txt", "x");
+		if (deleteFile)
+		{
+			std::filesystem::remove(file);
+		}
+
+		// after the burst, waits for the next change, which ends the script
+		CHECK(!debouncer.WaitForChange());
+		CHECK(source.waits == 3);
+		std::filesystem::remove_all(dir);
+	}
+
+	void TestSourceFailure()
+	{
+		uint64_t now = 0;
+		ScriptedSource source{ now, { WaitResult::Changed, WaitResult::Failed } };
+		ReloadDebouncer debouncer{ source, "does-not-exist.yaml", [&now]() { return now; } };
+		CHECK(!debouncer.WaitForChange());
+		CHECK(source.waits == 2);
+	}
+
+	// real file system events: several saves and unrelated files in the directory reload the file once
+	void TestInotify()
+	{
+		const std::filesystem::path dir = MakeTestDir("inotify");
+		const std::filesystem::path file = dir / "config.yaml";
+		Append(file, "a");
+
+		InotifyFileChangeSource source;
+		CHECK(source.Start(dir));
+		ReloadDebouncer debouncer{ source, file };
+
+		std::atomic<int> reloads{ 0 };
+		std::thread watcher{ [&]()
+			{
+				while (debouncer.WaitForChange())
+				{
+					reloads++;
+				}
+			} };
+
+		for (int i = 0; i < 5; ++i)
+		{
+			Append(file, "b");
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(ReloadDebouncer::c_debounceMs + 1000));
+		CHECK(reloads == 1);
+
+		Append(dir / "other.txt", "x");
+		std::this_thread::sleep_for(std::chrono::milliseconds(ReloadDebouncer::c_debounceMs + 500));
+		CHECK(reloads == 1);
+
+		source.Stop();
+		watcher.join();
+		CHECK(reloads == 1);
+		std::filesystem::remove_all(dir);
+	}
+}
+
+int main()
+{
+	TestBurstCoalesced();
+	TestMaxDelay();
+	TestIgnoredChanges(false);
+	TestIgnoredChanges(true);
+	TestSourceFailure();
+	TestInotify();
+	return 0;
+}
@@ -0,0 +1,42 @@
+#include "KeyboardLayout.h"
+
+#include <mutex>
+
+// Stand-in for the Windows implementation, which asks the active keyboard layout via `MapVirtualKeyW`:
+// the US layout, with the characters and OEM keys `MapVirtualKeyW` reports for it
+std::shared_ptr<const KeyboardLayout> KeyboardLayout::GetCurrent()
+{
+	static std::once_flag once;
+	static std::shared_ptr<const KeyboardLayout> current;
+	std::call_once(once, []()
+		{
+			auto map = std::make_shared<KeyboardLayout>();
+			for (uint32_t vk : { 0x08u, 0x09u, 0x0Du, 0x1Bu, 0x20u })
+			{
+				map->identity.set(vk);
+				map->charByCode[vk] = static_cast<wchar_t>(vk);
+			}
+			for (uint32_t vk = '0'; vk <= '9'; ++vk)
+			{
+				map->identity.set(vk);
+				map->charByCode[vk] = static_cast<wchar_t>(vk);
+			}
+			for (uint32_t vk = 'A'; vk <= 'Z'; ++vk)
+			{
+				map->identity.set(vk);
+				map->charByCode[vk] = static_cast<wchar_t>(vk);
+			}
+
+			const std::pair<wchar_t, uint32_t> oem[] = {
+				{ L';', 0xBA }, { L'=', 0xBB }, { L',', 0xBC }, { L'-', 0xBD }, { L'.', 0xBE }, { L'/', 0xBF },
+				{ L'`', 0xC0 }, { L'[', 0xDB }, { L'\\', 0xDC }, { L']', 0xDD }, { L'\'', 0xDE }
+			};
+			for (auto const& o : oem)
+			{
+				map->oemByChar.insert(o);
+				map->charByCode[o.second] = o.first;
+			}
+			current = map;
+		});
+	return current;
+}
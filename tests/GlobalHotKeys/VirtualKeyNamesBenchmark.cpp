@@ -0,0 +1,61 @@
+#include "VirtualKeyNames.h"
+#include "BenchUtils.h"
+#include "TestUtils.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Parses key names of a config: the perfect hash against a linear scan of the table and a hash map
+int main(int argc, char** argv)
+{
+	Benchmark bench{ argc, argv };
+
+	// all names, plus as many unknown ones, which single-character keys are first looked up as
+	std::vector<std::wstring> names;
+	for (size_t i = 0; i < VirtualKeyNames::GetCount(); ++i)
+	{
+		names.emplace_back(VirtualKeyNames::GetEntry(i).name);
+		names.push_back(names.back() + L"x");
+	}
+
+	uint32_t sum = 0;
+	bench.Run("VirtualKeyNames::Find", names.size() * 1000, [&](size_t i)
+		{
+			sum += VirtualKeyNames::Find(names[i % names.size()]);
+		});
+	const uint32_t expected = sum;
+
+	sum = 0;
+	bench.Run("linear scan", names.size() * 1000, [&](size_t i)
+		{
+			std::wstring_view name = names[i % names.size()];
+			uint32_t code = VirtualKeyNames::c_invalid;
+			for (size_t e = 0; e < VirtualKeyNames::GetCount(); ++e)
+			{
+				if (VirtualKeyNames::GetEntry(e).name == name)
+				{
+					code = VirtualKeyNames::GetEntry(e).code;
+					break;
+				}
+			}
+			sum += code;
+		});
+	CHECK(sum == expected);
+
+	std::unordered_map<std::wstring_view, uint32_t> map;
+	for (size_t e = 0; e < VirtualKeyNames::GetCount(); ++e)
+	{
+		map.emplace(VirtualKeyNames::GetEntry(e).name, VirtualKeyNames::GetEntry(e).code);
+	}
+	sum = 0;
+	bench.Run("std::unordered_map", names.size() * 1000, [&](size_t i)
+		{
+			auto found = map.find(names[i % names.size()]);
+			sum += found != map.end() ? found->second : VirtualKeyNames::c_invalid;
+		});
+	CHECK(sum == expected);
+
+	DoNotOptimize(sum);
+	return 0;
+}
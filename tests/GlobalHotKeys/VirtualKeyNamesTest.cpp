@@ -0,0 +1,92 @@
+#include "VirtualKeyNames.h"
+#include "TestUtils.h"
+
+#include <cwctype>
+#include <set>
+#include <string>
+
+namespace
+{
+	// every name finds its code, and the code formats back to the first name listed for it
+	void TestRoundTrip()
+	{
+		CHECK(VirtualKeyNames::GetCount() > 150);
+		for (size_t i = 0; i < VirtualKeyNames::GetCount(); ++i)
+		{
+			auto const& entry = VirtualKeyNames::GetEntry(i);
+			CHECK(VirtualKeyNames::Find(entry.name) == entry.code);
+
+			auto const* formatted = VirtualKeyNames::FindByCode(entry.code);
+			CHECK(formatted != nullptr);
+			CHECK(formatted->code == entry.code);
+			CHECK(VirtualKeyNames::Find(formatted->name) == entry.code);
+
+			size_t first = 0;
+			while (VirtualKeyNames::GetEntry(first).code != entry.code) ++first;
+			CHECK(formatted == &VirtualKeyNames::GetEntry(first));
+		}
+	}
+
+	void TestNames()
+	{
+		std::set<std::wstring_view> names;
+		for (size_t i = 0; i < VirtualKeyNames::GetCount(); ++i)
+		{
+			auto const& entry = VirtualKeyNames::GetEntry(i);
+			CHECK(!entry.name.empty());
+			CHECK(names.insert(entry.name).second);
+			for (wchar_t c : entry.name)
+			{
+				CHECK(!std::iswupper(c));
+			}
+		}
+	}
+
+	// the literal codes of the table, checked against `Winuser.h` values
+	void TestCodes()
+	{
+		CHECK(VirtualKeyNames::Find(L"lbutton") == 0x01);
+		CHECK(VirtualKeyNames::Find(L"return") == 0x0D);
+		CHECK(VirtualKeyNames::Find(L"space") == 0x20);
+		CHECK(VirtualKeyNames::Find(L"lwin") == 0x5B);
+		CHECK(VirtualKeyNames::Find(L"numpad9") == 0x69);
+		CHECK(VirtualKeyNames::Find(L"f1") == 0x70);
+		CHECK(VirtualKeyNames::Find(L"f24") == 0x87);
+		CHECK(VirtualKeyNames::Find(L"media_play_pause") == 0xB3);
+		CHECK(VirtualKeyNames::Find(L"oem_plus") == 0xBB);
+		CHECK(VirtualKeyNames::Find(L"oem_102") == 0xE2);
+		CHECK(VirtualKeyNames::Find(L"oem_clear") == 0xFE);
+
+		CHECK(VirtualKeyNames::Find(L"hangul") == 0x15);
+		CHECK(VirtualKeyNames::FindByCode(0x15)->name == L"kana");
+		CHECK(VirtualKeyNames::FindByCode(0x19)->name == L"hanja");
+
+		CHECK(VirtualKeyNames::FindByCode(0xBB)->IsOem());
+		CHECK(!VirtualKeyNames::FindByCode(0x0D)->IsOem());
+	}
+
+	void TestUnknown()
+	{
+		CHECK(VirtualKeyNames::Find(L"") == VirtualKeyNames::c_invalid);
+		CHECK(VirtualKeyNames::Find(L"Return") == VirtualKeyNames::c_invalid);
+		CHECK(VirtualKeyNames::Find(L"returns") == VirtualKeyNames::c_invalid);
+		CHECK(VirtualKeyNames::Find(L"f25") == VirtualKeyNames::c_invalid);
+		CHECK(VirtualKeyNames::Find(L"a") == VirtualKeyNames::c_invalid);
+
+		// reserved and out of range codes
+		CHECK(VirtualKeyNames::FindByCode(0x00) == nullptr);
+		CHECK(VirtualKeyNames::FindByCode(0x07) == nullptr);
+		CHECK(VirtualKeyNames::FindByCode(0x41) == nullptr);
+		CHECK(VirtualKeyNames::FindByCode(0x100) == nullptr);
+		CHECK(VirtualKeyNames::FindByCode(VirtualKeyNames::c_invalid) == nullptr);
+	}
+}
+
+int main()
+{
+	TestRoundTrip();
+	TestNames();
+	TestCodes();
+	TestUnknown();
+	return 0;
+}
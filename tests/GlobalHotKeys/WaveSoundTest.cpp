@@ -0,0 +1,256 @@
+#include "WaveSound.h"
+#include "TestUtils.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr uint16_t c_pcm = 1;
+	constexpr uint16_t c_float = 3;
+	constexpr uint16_t c_extensible = 0xFFFE;
+
+	void PutU16(std::vector<uint8_t>& out, uint16_t v)
+	{
+		out.push_back(static_cast<uint8_t>(v));
+		out.push_back(static_cast<uint8_t>(v >> 8));
+	}
+
+	void PutU32(std::vector<uint8_t>& out, uint32_t v)
+	{
+		PutU16(out, static_cast<uint16_t>(v));
+		PutU16(out, static_cast<uint16_t>(v >> 16));
+	}
+
+	void PutChunk(std::vector<uint8_t>& out, const char* tag, std::vector<uint8_t> const& body)
+	{
+		out.insert(out.end(), tag, tag + 4);
+		PutU32(out, static_cast<uint32_t>(body.size()));
+		out.insert(out.end(), body.begin(), body.end());
+		if (body.size() & 1) out.push_back(0);
+	}
+
+	std::vector<uint8_t> FormatChunk(uint16_t tag, uint16_t channels, uint16_t bits, uint16_t subTag = 0)
+	{
+		std::vector<uint8_t> fmt;
+		PutU16(fmt, tag);
+		PutU16(fmt, channels);
+		PutU32(fmt, 44100);
+		PutU32(fmt, 44100u * channels * (bits / 8));
+		PutU16(fmt, static_cast<uint16_t>(channels * (bits / 8)));
+		PutU16(fmt, bits);
+		if (tag == c_extensible)
+		{
+			PutU16(fmt, 22);
+			PutU16(fmt, bits);
+			PutU32(fmt, 0);
+			// sub format guid, starting with the format tag
+			PutU16(fmt, subTag);
+			const uint8_t rest[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+			fmt.insert(fmt.end(), rest, rest + sizeof(rest));
+		}
+		return fmt;
+	}
+
+	std::vector<uint8_t> Riff(std::vector<uint8_t> const& chunks)
+	{
+		std::vector<uint8_t> file{ 'R', 'I', 'F', 'F' };
+		PutU32(file, static_cast<uint32_t>(4 + chunks.size()));
+		file.insert(file.end(), { 'W', 'A', 'V', 'E' });
+		file.insert(file.end(), chunks.begin(), chunks.end());
+		return file;
+	}
+
+	std::vector<uint8_t> Wave(uint16_t tag, uint16_t channels, uint16_t bits, std::vector<uint8_t> const& samples, uint16_t subTag = 0)
+	{
+		std::vector<uint8_t> chunks;
+		PutChunk(chunks, "fmt ", FormatChunk(tag, channels, bits, subTag));
+		PutChunk(chunks, "data", samples);
+		return Riff(chunks);
+	}
+
+	std::vector<uint8_t> Pcm16(std::vector<int16_t> const& samples)
+	{
+		std::vector<uint8_t> data;
+		for (int16_t s : samples) PutU16(data, static_cast<uint16_t>(s));
+		return data;
+	}
+
+	// the error of loading the image, or empty on success; a failed load leaves the sound empty
+	std::string LoadError(std::vector<uint8_t> image)
+	{
+		WaveSound sound;
+		std::string error;
+		if (sound.Load(std::move(image), error))
+		{
+			CHECK(!sound.IsEmpty());
+			return {};
+		}
+		CHECK(!error.empty());
+		CHECK(sound.IsEmpty());
+		CHECK(sound.GetDataSize() == 0);
+		return error;
+	}
+
+	void TestValid()
+	{
+		std::vector<uint8_t> image = Wave(c_pcm, 2, 16, Pcm16({ 1000, -1000, 32767, -32768 }));
+		const size_t imageSize = image.size();
+		WaveSound sound;
+		std::string error;
+		CHECK(sound.Load(std::move(image), error));
+		CHECK(sound.GetImage().size() == imageSize);
+		CHECK(sound.GetFormat().sampleFormat == WaveSound::SampleFormat::Pcm);
+		CHECK(sound.GetFormat().channels == 2);
+		CHECK(sound.GetFormat().sampleRate == 44100);
+		CHECK(sound.GetFormat().bitsPerSample == 16);
+		CHECK(sound.GetFormat().blockAlign == 4);
+		CHECK(sound.GetDataSize() == 8);
+
+		for (uint16_t bits : { 8, 24, 32 })
+		{
+			CHECK(LoadError(Wave(c_pcm, 1, bits, std::vector<uint8_t>(bits / 8 * 3, 0))).empty());
+		}
+		CHECK(LoadError(Wave(c_float, 1, 32, std::vector<uint8_t>(8, 0))).empty());
+		CHECK(LoadError(Wave(c_extensible, 2, 16, Pcm16({ 1, 2 }), c_pcm)).empty());
+
+		// unknown chunks are skipped, odd ones with their padding byte; the data chunk may come after them
+		std::vector<uint8_t> chunks;
+		PutChunk(chunks, "LIST", { 'a', 'b', 'c' });
+		PutChunk(chunks, "fmt ", FormatChunk(c_pcm, 1, 8));
+		PutChunk(chunks, "fact", { 1, 0, 0, 0 });
+		PutChunk(chunks, "data", { 128, 129, 130 });
+		CHECK(sound.Load(Riff(chunks), error));
+		CHECK(sound.GetDataSize() == 3);
+
+		sound.Clear();
+		CHECK(sound.IsEmpty());
+		CHECK(sound.GetFormat().channels == 0);
+	}
+
+	void TestTruncated()
+	{
+		const std::vector<uint8_t> valid = Wave(c_pcm, 1, 16, Pcm16({ 1, 2, 3, 4 }));
+		// every prefix fails without reading beyond it
+		for (size_t size = 0; size < valid.size(); ++size)
+		{
+			CHECK(!LoadError(std::vector<uint8_t>(valid.begin(), valid.begin() + size)).empty());
+		}
+		CHECK(LoadError(std::vector<uint8_t>(valid.begin(), valid.begin() + 11)) == "not a RIFF WAVE file");
+		CHECK(LoadError(std::vector<uint8_t>(valid.begin(), valid.end() - 1)) == "file is truncated");
+
+		// a chunk larger than the RIFF size
+		std::vector<uint8_t> chunks;
+		PutChunk(chunks, "fmt ", FormatChunk(c_pcm, 1, 16));
+		PutChunk(chunks, "data", Pcm16({ 1, 2 }));
+		std::vector<uint8_t> overlong = Riff(chunks);
+		overlong[overlong.size() - 8] = 0xFF;
+		CHECK(LoadError(overlong) == "chunk exceeds file size");
+
+		// trailing bytes after the RIFF chunk are ignored
+		std::vector<uint8_t> trailing = valid;
+		trailing.insert(trailing.end(), { 1, 2, 3 });
+		CHECK(LoadError(trailing).empty());
+	}
+
+	void TestMalformed()
+	{
+		std::vector<uint8_t> notWave = Wave(c_pcm, 1, 16, Pcm16({ 1 }));
+		std::memcpy(notWave.data() + 8, "AVI ", 4);
+		CHECK(LoadError(notWave) == "not a RIFF WAVE file");
+
+		CHECK(LoadError(Wave(c_pcm, 1, 12, std::vector<uint8_t>(4, 0))) == "unsupported sample size");
+		CHECK(LoadError(Wave(c_float, 1, 64, std::vector<uint8_t>(8, 0))) == "unsupported sample size");
+		CHECK(LoadError(Wave(2, 1, 16, Pcm16({ 1 }))) == "unsupported sample format; only PCM and float are supported");
+		CHECK(LoadError(Wave(c_extensible, 1, 16, Pcm16({ 1 }), 2)) == "unsupported sample format; only PCM and float are supported");
+		CHECK(LoadError(Wave(c_pcm, 0, 16, {})) == "invalid format chunk");
+		CHECK(LoadError(Wave(c_pcm, 2, 16, Pcm16({ 1, 2, 3 }))) == "data size does not match the format");
+		CHECK(LoadError(Wave(c_pcm, 1, 16, {})) == "data size does not match the format");
+
+		std::vector<uint8_t> badAlign = Wave(c_pcm, 2, 16, Pcm16({ 1, 2 }));
+		// block align of the format chunk, after the tags and sizes
+		badAlign[12 + 8 + 12] = 2;
+		CHECK(LoadError(badAlign) == "invalid format chunk");
+
+		std::vector<uint8_t> chunks;
+		PutChunk(chunks, "fmt ", std::vector<uint8_t>(14, 0));
+		CHECK(LoadError(Riff(chunks)) == "format chunk too small");
+
+		chunks.clear();
+		std::vector<uint8_t> shortExtensible = FormatChunk(c_pcm, 1, 16);
+		shortExtensible[0] = 0xFE;
+		shortExtensible[1] = 0xFF;
+		PutChunk(chunks, "fmt ", shortExtensible);
+		CHECK(LoadError(Riff(chunks)) == "extensible format chunk too small");
+
+		chunks.clear();
+		PutChunk(chunks, "data", Pcm16({ 1 }));
+		PutChunk(chunks, "fmt ", FormatChunk(c_pcm, 1, 16));
+		CHECK(LoadError(Riff(chunks)) == "data chunk before format chunk");
+
+		chunks.clear();
+		PutChunk(chunks, "fmt ", FormatChunk(c_pcm, 1, 16));
+		CHECK(LoadError(Riff(chunks)) == "data chunk missing");
+		CHECK(LoadError(Riff({})) == "format chunk missing");
+
+		// a failed load clears a previously loaded sound
+		WaveSound sound;
+		std::string error;
+		CHECK(sound.Load(Wave(c_pcm, 1, 16, Pcm16({ 1 })), error));
+		CHECK(!sound.Load(Riff({}), error));
+		CHECK(sound.IsEmpty());
+	}
+
+	void TestScaleVolume()
+	{
+		WaveSound sound;
+		std::string error;
+		CHECK(sound.Load(Wave(c_pcm, 1, 16, Pcm16({ 1000, -1000, 32767, -32768 })), error));
+		sound.ScaleVolume(0.5f);
+		const uint8_t* data = sound.GetImage().data() + sound.GetImage().size() - sound.GetDataSize();
+		CHECK(static_cast<int16_t>(data[0] | (data[1] << 8)) == 500);
+		CHECK(static_cast<int16_t>(data[2] | (data[3] << 8)) == -500);
+		CHECK(static_cast<int16_t>(data[4] | (data[5] << 8)) == 16384);
+		CHECK(static_cast<int16_t>(data[6] | (data[7] << 8)) == -16384);
+
+		// 8 bit samples are unsigned around 128
+		CHECK(sound.Load(Wave(c_pcm, 1, 8, { 0, 128, 255, 0 }), error));
+		sound.ScaleVolume(0.5f);
+		data = sound.GetImage().data() + sound.GetImage().size() - sound.GetDataSize();
+		CHECK(data[0] == 64 && data[1] == 128 && data[2] == 192);
+
+		// 24 bit samples keep their sign
+		CHECK(sound.Load(Wave(c_pcm, 1, 24, { 0x00, 0x00, 0x80, 0x00, 0x10, 0x00 }), error));
+		sound.ScaleVolume(0.25f);
+		data = sound.GetImage().data() + sound.GetImage().size() - sound.GetDataSize();
+		CHECK(data[0] == 0x00 && data[1] == 0x00 && data[2] == 0xE0);
+		CHECK(data[3] == 0x00 && data[4] == 0x04 && data[5] == 0x00);
+
+		std::vector<uint8_t> samples(8);
+		const float values[2] = { 1.0f, -0.5f };
+		std::memcpy(samples.data(), values, sizeof(values));
+		CHECK(sound.Load(Wave(c_float, 1, 32, samples), error));
+		sound.ScaleVolume(0.5f);
+		float scaled[2];
+		std::memcpy(scaled, sound.GetImage().data() + sound.GetImage().size() - 8, sizeof(scaled));
+		CHECK(scaled[0] == 0.5f && scaled[1] == -0.25f);
+
+		// volumes are clamped; full volume leaves the samples unchanged
+		CHECK(sound.Load(Wave(c_pcm, 1, 16, Pcm16({ 1000 })), error));
+		sound.ScaleVolume(2.0f);
+		data = sound.GetImage().data() + sound.GetImage().size() - 2;
+		CHECK(static_cast<int16_t>(data[0] | (data[1] << 8)) == 1000);
+		sound.ScaleVolume(-1.0f);
+		CHECK(data[0] == 0 && data[1] == 0);
+	}
+}
+
+int main()
+{
+	TestValid();
+	TestTruncated();
+	TestMalformed();
+	TestScaleVolume();
+	return 0;
+}
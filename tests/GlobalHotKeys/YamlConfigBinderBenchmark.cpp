@@ -0,0 +1,252 @@
+#include "YamlConfigBinder.h"
+#include "BenchUtils.h"
+#include "StringUtils.h"
+#include "TestUtils.h"
+
+#include "SimpleLog/SimpleLog.hpp"
+
+#include <yaml.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Loads a synthetic configuration of 10k hot keys in three ways:
+// - the `shared_ptr` tree `Configuration.cpp` built before the streaming binder, walked into `HotKeyConfig`
+// - libyaml's own document API, which keeps all nodes in one array, walked the same way
+// - `YamlConfigBinder`, which binds the parser events directly
+namespace
+{
+	std::string MakeConfig(size_t count)
+	{
+		static const char* const keys[] = { "a", "k", "z", "5", "f1", "f12", "numpad7", "space", ";" };
+		std::string yaml = "bell: true\nglobalhotkeys:\n";
+		for (size_t i = 0; i < count; ++i)
+		{
+			yaml += "  - code: \"" + std::string{ keys[i % std::size(keys)] } + "\"\n";
+			yaml += (i % 2 == 0) ? "    ctrl: true\n" : "    alt: true\n";
+			yaml += "    exec: C:\\Tools\\tool" + std::to_string(i) + ".exe\n";
+			yaml += "    args: [ \"--id\", \"" + std::to_string(i) + "\", \"{file}\" ]\n";
+			yaml += "    workdir: C:\\Work\\dir" + std::to_string(i % 100) + "\n";
+		}
+		return yaml;
+	}
+
+	void SetField(HotKeyConfig& key, std::wstring const& name, std::wstring const& value)
+	{
+		if (name == L"code") key.virtualKeyCode = HotKeyConfig::ParseVirtualKeyCode(value);
+		else if (name == L"ctrl") key.modCtrl = (value == L"true");
+		else if (name == L"alt") key.modAlt = (value == L"true");
+		else if (name == L"exec") key.executable = value;
+		else if (name == L"workdir") key.workingDirectory = value;
+	}
+
+	// The tree as built before: one `shared_ptr` per node, one `unordered_map` per mapping
+	struct Node
+	{
+		virtual ~Node() = default;
+	};
+
+	struct Scalar : Node
+	{
+		std::wstring value;
+	};
+
+	struct Mapping : Node
+	{
+		std::unordered_map<std::wstring, std::shared_ptr<Node>> map;
+	};
+
+	struct Sequence : Node
+	{
+		std::vector<std::shared_ptr<Node>> items;
+	};
+
+	std::shared_ptr<Node> ParseTree(yaml_parser_t& parser)
+	{
+		std::vector<std::shared_ptr<Node>> stack;
+		std::vector<std::wstring> keys;
+		std::shared_ptr<Node> root;
+
+		auto add = [&](std::shared_ptr<Node> node)
+			{
+				if (stack.empty())
+				{
+					root = node;
+				}
+				else if (auto seq = std::dynamic_pointer_cast<Sequence>(stack.back()))
+				{
+					seq->items.push_back(node);
+				}
+				else if (auto map = std::dynamic_pointer_cast<Mapping>(stack.back()))
+				{
+					if (keys.back().empty())
+					{
+						keys.back() = std::dynamic_pointer_cast<Scalar>(node)->value;
+					}
+					else
+					{
+						map->map[keys.back()] = node;
+						keys.back().clear();
+					}
+				}
+			};
+
+		yaml_event_t event;
+		for (bool done = false; !done;)
+		{
+			CHECK(yaml_parser_parse(&parser, &event));
+			switch (event.type)
+			{
+			case YAML_SCALAR_EVENT:
+			{
+				auto scalar = std::make_shared<Scalar>();
+				scalar->value = ToW(event.data.scalar.value);
+				add(scalar);
+				break;
+			}
+			case YAML_SEQUENCE_START_EVENT:
+			case YAML_MAPPING_START_EVENT:
+			{
+				std::shared_ptr<Node> node;
+				if (event.type == YAML_SEQUENCE_START_EVENT) node = std::make_shared<Sequence>();
+				else node = std::make_shared<Mapping>();
+				add(node);
+				stack.push_back(node);
+				keys.emplace_back();
+				break;
+			}
+			case YAML_SEQUENCE_END_EVENT:
+			case YAML_MAPPING_END_EVENT:
+				stack.pop_back();
+				keys.pop_back();
+				break;
+			case YAML_STREAM_END_EVENT:
+				done = true;
+				break;
+			default:
+				break;
+			}
+			yaml_event_delete(&event);
+		}
+		return root;
+	}
+
+	std::vector<HotKeyConfig> LoadTree(std::string const& yaml)
+	{
+		yaml_parser_t parser;
+		yaml_parser_initialize(&parser);
+		yaml_parser_set_input_string(&parser, reinterpret_cast<const unsigned char*>(yaml.data()), yaml.size());
+		const auto root = std::dynamic_pointer_cast<Mapping>(ParseTree(parser));
+		yaml_parser_delete(&parser);
+
+		std::vector<HotKeyConfig> hotKeys;
+		const auto entries = std::dynamic_pointer_cast<Sequence>(root->map.at(L"globalhotkeys"));
+		for (auto const& item : entries->items)
+		{
+			HotKeyConfig key;
+			for (auto const& field : std::dynamic_pointer_cast<Mapping>(item)->map)
+			{
+				if (auto scalar = std::dynamic_pointer_cast<Scalar>(field.second))
+				{
+					SetField(key, field.first, scalar->value);
+				}
+				else if (auto args = std::dynamic_pointer_cast<Sequence>(field.second))
+				{
+					for (auto const& arg : args->items)
+					{
+						key.arguments.push_back(std::dynamic_pointer_cast<Scalar>(arg)->value);
+					}
+				}
+			}
+			hotKeys.push_back(std::move(key));
+		}
+		return hotKeys;
+	}
+
+	std::wstring NodeString(yaml_node_t const* node)
+	{
+		return ToW(node->data.scalar.value);
+	}
+
+	std::vector<HotKeyConfig> LoadDocument(std::string const& yaml)
+	{
+		yaml_parser_t parser;
+		yaml_parser_initialize(&parser);
+		yaml_parser_set_input_string(&parser, reinterpret_cast<const unsigned char*>(yaml.data()), yaml.size());
+		yaml_document_t doc;
+		CHECK(yaml_parser_load(&parser, &doc));
+
+		std::vector<HotKeyConfig> hotKeys;
+		yaml_node_t* root = yaml_document_get_root_node(&doc);
+		for (auto* pair = root->data.mapping.pairs.start; pair < root->data.mapping.pairs.top; ++pair)
+		{
+			if (NodeString(yaml_document_get_node(&doc, pair->key)) != L"globalhotkeys") continue;
+			yaml_node_t* seq = yaml_document_get_node(&doc, pair->value);
+			for (auto* item = seq->data.sequence.items.start; item < seq->data.sequence.items.top; ++item)
+			{
+				HotKeyConfig key;
+				yaml_node_t* entry = yaml_document_get_node(&doc, *item);
+				for (auto* field = entry->data.mapping.pairs.start; field < entry->data.mapping.pairs.top; ++field)
+				{
+					const std::wstring name = NodeString(yaml_document_get_node(&doc, field->key));
+					yaml_node_t* value = yaml_document_get_node(&doc, field->value);
+					if (value->type == YAML_SCALAR_NODE)
+					{
+						SetField(key, name, NodeString(value));
+					}
+					else if (value->type == YAML_SEQUENCE_NODE)
+					{
+						for (auto* arg = value->data.sequence.items.start; arg < value->data.sequence.items.top; ++arg)
+						{
+							key.arguments.push_back(NodeString(yaml_document_get_node(&doc, *arg)));
+						}
+					}
+				}
+				hotKeys.push_back(std::move(key));
+			}
+		}
+
+		yaml_document_delete(&doc);
+		yaml_parser_delete(&parser);
+		return hotKeys;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Benchmark bench{ argc, argv };
+
+	const size_t count = bench.IsSmoke() ? 100 : 10000;
+	const std::string yaml = MakeConfig(count);
+	sgrottel::SimpleLog log;
+
+	const auto check = [&](std::vector<HotKeyConfig> const& hotKeys)
+		{
+			CHECK(hotKeys.size() == count);
+			CHECK(hotKeys[1].virtualKeyCode == 'K' && hotKeys[1].modAlt);
+			CHECK(hotKeys[5].virtualKeyCode == 0x7B && hotKeys[5].executable == L"C:\\Tools\\tool5.exe");
+			CHECK(hotKeys[8].virtualKeyCode == 0xBA && hotKeys[8].arguments.size() == 3);
+		};
+
+	check(LoadTree(yaml));
+	check(LoadDocument(yaml));
+	check(YamlConfigBinder{ log }.Bind(reinterpret_cast<const uint8_t*>(yaml.data()), yaml.size()).hotKeys);
+
+	const double tree = bench.Run("shared_ptr tree + walk (10k entries)", 3, [&](size_t)
+		{
+			DoNotOptimize(LoadTree(yaml));
+		});
+	const double document = bench.Run("libyaml document + walk (10k entries)", 3, [&](size_t)
+		{
+			DoNotOptimize(LoadDocument(yaml));
+		});
+	const double binder = bench.Run("YamlConfigBinder::Bind (10k entries)", 3, [&](size_t)
+		{
+			DoNotOptimize(YamlConfigBinder{ log }.Bind(reinterpret_cast<const uint8_t*>(yaml.data()), yaml.size()));
+		});
+
+	std::printf("binder speedup: %.2fx over the tree, %.2fx over the document\n", tree / binder, document / binder);
+	return 0;
+}
@@ -0,0 +1,364 @@
+#include "YamlConfigBinder.h"
+#include "TestUtils.h"
+
+#include "SimpleLog/SimpleLog.hpp"
+
+#include <string>
+
+namespace
+{
+	YamlConfigBinder::Result Bind(std::string const& yaml)
+	{
+		sgrottel::SimpleLog log;
+		YamlConfigBinder binder{ log };
+		return binder.Bind(reinterpret_cast<const uint8_t*>(yaml.data()), yaml.size());
+	}
+
+	struct ElementError
+	{
+		size_t line;
+		size_t column;
+		std::string message;
+	};
+
+	// binds the yaml, which must fail with an error referencing an element
+	ElementError BindElementError(std::string const& yaml)
+	{
+		try
+		{
+			Bind(yaml);
+		}
+		catch (YamlElementReferenceException const& ex)
+		{
+			return { ex.line, ex.column, ex.innerException.what() };
+		}
+		CHECK(false);
+		return {};
+	}
+
+	// binds the yaml, which must fail with a parser error
+	std::wstring BindParserError(std::string const& yaml)
+	{
+		try
+		{
+			Bind(yaml);
+		}
+		catch (wruntime_error const& ex)
+		{
+			return ex.get_message();
+		}
+		CHECK(false);
+		return {};
+	}
+
+	bool Contains(std::string const& str, char const* part)
+	{
+		return str.find(part) != std::string::npos;
+	}
+
+	void TestBind()
+	{
+		const auto result = Bind(
+			"bell: off\n"
+			"bell-volume: 0.25\n"
+			"custom-bell-file: ding.wav\n"
+			"include: fragments\n"
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    ctrl: yes\n"
+			"    alt: 1\n"
+			"    exec: notepad.exe\n"
+			"    args: [ \"{file}\", -n ]\n"
+			"    workdir: C:\\temp\n"
+			"    createnowindow: false\n"
+			"    cooldown: 500\n"
+			"    coalesce: on\n"
+			"    single-instance: true\n"
+			"    resolveargspaths:\n"
+			"      - pos: 0\n"
+			"        isrelexepath: true\n"
+			"  - code: F5\n"
+			"    shift: true\n"
+			"    action: reload-config\n"
+			"    max-concurrent: 2\n"
+			"profiles:\n"
+			"  - name: edit\n"
+			"    applications: [ notepad.exe, code.exe ]\n"
+			"    globalhotkeys:\n"
+			"      - code: ';'\n"
+			"        exec: cmd.exe\n"
+			"  - name: single\n"
+			"    applications: calc.exe\n");
+
+		CHECK(!result.bell);
+		CHECK(result.bellVolume == 0.25f);
+		CHECK(result.customBellFile == "ding.wav");
+		CHECK(result.includes == std::vector<std::wstring>{ L"fragments" });
+
+		CHECK(result.hotKeys.size() == 3);
+		HotKeyConfig const& a = result.hotKeys[0];
+		CHECK(a.virtualKeyCode == 'A');
+		CHECK(a.modCtrl && a.modAlt && !a.modShift);
+		CHECK(a.executable == L"notepad.exe");
+		CHECK((a.arguments == std::vector<std::wstring>{ L"{file}", L"-n" }));
+		CHECK(a.workingDirectory == L"C:\\temp");
+		CHECK(!a.createNoWindow);
+		CHECK(a.cooldownMs == 500);
+		CHECK(a.coalesce);
+		CHECK(a.singleInstance);
+		CHECK(a.resolveArgsPaths.size() == 1 && a.resolveArgsPaths.at(0).isRelPath);
+		CHECK(a.profile.empty());
+		CHECK(a.sourceLine == 6 && a.sourceColumn == 5);
+
+		HotKeyConfig const& f5 = result.hotKeys[1];
+		CHECK(f5.virtualKeyCode == 0x74);
+		CHECK(f5.modShift && !f5.modCtrl);
+		CHECK(f5.action == L"reload-config");
+		CHECK(f5.executable.empty());
+		CHECK(f5.maxConcurrent == 2);
+		CHECK(f5.createNoWindow);
+		CHECK(f5.sourceLine == 19);
+
+		HotKeyConfig const& oem = result.hotKeys[2];
+		CHECK(oem.virtualKeyCode == 0xBA);
+		CHECK(oem.profile == L"edit");
+		CHECK(oem.sourceLine == 27 && oem.sourceColumn == 9);
+
+		CHECK(result.profiles.size() == 2);
+		CHECK((result.profiles[0].applications == std::vector<std::wstring>{ L"notepad.exe", L"code.exe" }));
+		CHECK(result.profiles[1].name == L"single");
+		CHECK((result.profiles[1].applications == std::vector<std::wstring>{ L"calc.exe" }));
+	}
+
+	void TestUtf8()
+	{
+		const auto result = Bind(
+			"globalhotkeys:\n"
+			"  - code: b\n"
+			"    exec: \"C:\\\\Programme\\\\Gr\xC3\xBC\xC3\x9F" "e.exe\"\n"
+			"    args: [ \"\xF0\x9F\x98\x80\" ]\n");
+		CHECK(result.hotKeys.size() == 1);
+		CHECK(result.hotKeys[0].executable == L"C:\\Programme\\Gr\u00FC\u00DFe.exe");
+		CHECK(result.hotKeys[0].arguments.size() == 1);
+		CHECK(result.hotKeys[0].arguments[0] == std::wstring{ L"\U0001F600" });
+	}
+
+	// unknown keys are skipped with their whole value, at any level
+	void TestUnknownKeys()
+	{
+		const auto result = Bind(
+			"comment: { nested: [ 1, { deeper: 2 } ], more: x }\n"
+			"globalhotkeys:\n"
+			"  - code: c\n"
+			"    future-option: [ a, [ b, c ] ]\n"
+			"    exec: c.exe\n"
+			"    resolveargspaths:\n"
+			"      - pos: 1\n"
+			"        note: { x: y }\n"
+			"unknown-list:\n"
+			"  - globalhotkeys: ignored\n"
+			"bell: false\n");
+		CHECK(result.hotKeys.size() == 1);
+		CHECK(result.hotKeys[0].executable == L"c.exe");
+		CHECK(result.hotKeys[0].resolveArgsPaths.count(1) == 1);
+		CHECK(!result.bell);
+
+		// keys are case-sensitive
+		const auto upper = Bind(
+			"globalhotkeys:\n"
+			"  - code: d\n"
+			"    exec: d.exe\n"
+			"    Ctrl: true\n");
+		CHECK(!upper.hotKeys[0].modCtrl);
+	}
+
+	// errors reference the 1-based position of the offending element
+	void TestElementErrors()
+	{
+		ElementError e = BindElementError(
+			"globalhotkeys:\n"
+			"  - exec: a.exe\n");
+		CHECK(e.line == 2 && e.column == 5);
+		CHECK(Contains(e.message, "must contain `code`"));
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - code: nokey\n"
+			"    exec: a.exe\n");
+		CHECK(e.line == 2 && e.column == 11);
+		CHECK(Contains(e.message, "nokey"));
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    exec: a.exe\n"
+			"    action: reload-config\n");
+		CHECK(e.line == 2 && e.column == 5);
+		CHECK(Contains(e.message, "must not contain both"));
+
+		e = BindElementError(
+			"bell-volume: 2\n"
+			"globalhotkeys: []\n");
+		CHECK(e.line == 1 && e.column == 14);
+
+		e = BindElementError(
+			"profiles:\n"
+			"  - name: p\n"
+			"  - name: p\n");
+		CHECK(e.line == 3 && e.column == 5);
+		CHECK(Contains(e.message, "more than once"));
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    exec: a.exe\n"
+			"    resolveargspaths:\n"
+			"      - isrelexepath: true\n");
+		CHECK(e.line == 5 && e.column == 9);
+		CHECK(Contains(e.message, "`pos`"));
+	}
+
+	// scalars where sequences or mappings are expected, and the other way around
+	void TestTypeMismatches()
+	{
+		ElementError e = BindElementError(
+			"globalhotkeys: a.exe\n");
+		CHECK(e.line == 1 && e.column == 16);
+		CHECK(Contains(e.message, "must be an array"));
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - a.exe\n");
+		CHECK(e.line == 2 && e.column == 5);
+		CHECK(Contains(e.message, "must be mappings"));
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    exec: [ a.exe ]\n");
+		CHECK(e.line == 3 && e.column == 11);
+		CHECK(Contains(e.message, "must be a scalar"));
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    exec: a.exe\n"
+			"    args: -n\n");
+		CHECK(e.line == 4 && e.column == 11);
+		CHECK(Contains(e.message, "must be a sequence"));
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    exec: a.exe\n"
+			"    args: [ -n, [ nested ] ]\n");
+		CHECK(e.line == 4 && e.column == 17);
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    exec: a.exe\n"
+			"    ctrl: maybe\n");
+		CHECK(e.line == 4 && e.column == 11);
+		CHECK(Contains(e.message, "boolean"));
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    exec: a.exe\n"
+			"    alt: { x: y }\n");
+		CHECK(e.line == 4 && e.column == 10);
+
+		e = BindElementError(
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    exec: a.exe\n"
+			"    cooldown: -5\n");
+		CHECK(e.line == 4 && e.column == 15);
+		CHECK(Contains(e.message, "non-negative number"));
+
+		e = BindElementError(
+			"profiles:\n"
+			"  - name: p\n"
+			"    applications: { a: b }\n");
+		CHECK(e.line == 3 && e.column == 19);
+	}
+
+	void TestAliases()
+	{
+		// anchors alone are harmless
+		const auto anchored = Bind(
+			"globalhotkeys:\n"
+			"  - &first\n"
+			"    code: a\n"
+			"    exec: a.exe\n");
+		CHECK(anchored.hotKeys.size() == 1);
+
+		const std::wstring message = BindParserError(
+			"globalhotkeys:\n"
+			"  - &first\n"
+			"    code: a\n"
+			"    exec: a.exe\n"
+			"  - *first\n");
+		CHECK(message.find(L"(line: 5, col: 5)") != std::wstring::npos);
+		CHECK(message.find(L"anchors are not supported") != std::wstring::npos);
+	}
+
+	void TestParserErrors()
+	{
+		const std::wstring message = BindParserError(
+			"globalhotkeys:\n"
+			"  - code: a\n"
+			"    exec: 'a.exe\n");
+		CHECK(message.find(L"Cannot scan the input stream.") != std::wstring::npos);
+		CHECK(message.find(L"at line ") != std::wstring::npos);
+
+		bool thrown = false;
+		try
+		{
+			Bind("");
+		}
+		catch (std::invalid_argument const&)
+		{
+			thrown = true;
+		}
+		CHECK(thrown);
+
+		thrown = false;
+		try
+		{
+			Bind("- a\n- b\n");
+		}
+		catch (std::invalid_argument const& ex)
+		{
+			thrown = Contains(ex.what(), "root element");
+		}
+		CHECK(thrown);
+
+		thrown = false;
+		try
+		{
+			Bind("bell: true\n");
+		}
+		catch (std::invalid_argument const& ex)
+		{
+			thrown = Contains(ex.what(), "`globalhotkeys` not found");
+		}
+		CHECK(thrown);
+
+		// a file only including fragments needs no hot keys of its own
+		CHECK(Bind("include: [ a.yaml, b ]\n").includes.size() == 2);
+	}
+}
+
+int main()
+{
+	TestBind();
+	TestUtf8();
+	TestUnknownKeys();
+	TestElementErrors();
+	TestTypeMismatches();
+	TestAliases();
+	TestParserErrors();
+	return 0;
+}
@@ -0,0 +1,86 @@
+// HWndToFront
+// Freely available via Apache License, v2.0; see LICENSE file
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "CmdLine.h"
+#include "TestUtils.h"
+
+// the C runtime rules are implemented once, by the parser of GlobalHotKeys
+#include "../GlobalHotKeys/CommandLine.h"
+
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::vector<std::wstring> BuildAndParse(const wchar_t* cmd, std::vector<std::wstring> const& args)
+	{
+		std::vector<const wchar_t*> argPtrs;
+		for (std::wstring const& arg : args)
+		{
+			argPtrs.push_back(arg.c_str());
+		}
+		wchar_t* cmdLine = BuildCmdLine(cmd, argPtrs.data(), static_cast<int>(argPtrs.size()));
+		CHECK(cmdLine != nullptr);
+		std::vector<std::wstring> parsed = CommandLine::Parse(cmdLine, true);
+		std::free(cmdLine);
+		return parsed;
+	}
+
+	void TestProgramName()
+	{
+		CHECK(BuildCmdLine(nullptr, nullptr, 0) == nullptr);
+		CHECK(BuildAndParse(L"notepad.exe", {}) == std::vector<std::wstring>{ L"notepad.exe" });
+		CHECK(BuildAndParse(L"C:\\Program Files\\My App\\app one.exe", { L"x" }) == (std::vector<std::wstring>{ L"app one.exe", L"x" }));
+		CHECK(BuildAndParse(L"C:/tools/t.exe", {}) == std::vector<std::wstring>{ L"t.exe" });
+	}
+
+	// random arguments of the characters with special meaning survive BuildCmdLine and the C runtime rules unchanged
+	void TestRoundTrip()
+	{
+		const wchar_t alphabet[] = L"ab \\\"\t/";
+		std::mt19937 rng{ 7 };
+		for (int iteration = 0; iteration < 100000; ++iteration)
+		{
+			std::vector<std::wstring> args(rng() % 5);
+			for (std::wstring& arg : args)
+			{
+				for (size_t n = rng() % 10; n > 0; --n)
+				{
+					arg += alphabet[rng() % (std::size(alphabet) - 1)];
+				}
+			}
+			const bool hasSpace = (iteration % 2) != 0;
+
+			const std::vector<std::wstring> parsed = BuildAndParse(hasSpace ? L"C:\\Program Files\\My App\\app one.exe" : L"notepad.exe", args);
+			CHECK(parsed.size() == args.size() + 1);
+			CHECK(parsed[0] == (hasSpace ? L"app one.exe" : L"notepad.exe"));
+			for (size_t i = 0; i < args.size(); ++i)
+			{
+				CHECK(parsed[i + 1] == args[i]);
+			}
+		}
+	}
+}
+
+int main()
+{
+	TestProgramName();
+	TestRoundTrip();
+	return 0;
+}
@@ -0,0 +1,242 @@
+//
+// KeePassHotKey
+// KeePassWindowFinderTest.cpp
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "KeePassWindowFinder.h"
+#include "TestUtils.h"
+
+#include <cwctype>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+	const std::wstring k_keePass = L"C:\\Program Files\\KeePass Password Safe 2\\KeePass.exe";
+
+	struct FakeProcess {
+		uint64_t creationTime;
+		std::wstring path;
+	};
+
+	struct FakeWindow {
+		WQWindow handle;
+		uint32_t processId;
+		bool visible;
+		bool owned;
+	};
+
+	// processes and top-level windows in z-order, counting the queries
+	class FakeDesktop : public KeePassWindowFinder::Desktop {
+	public:
+		FakeDesktop() {
+			provider.context = this;
+			provider.enumWindows = [](void* context, WQWindow parent, WQAddWindowFunc add, WQSnapshot* snapshot) {
+				FakeDesktop* d = static_cast<FakeDesktop*>(context);
+				if (parent != 0) return;
+				for (FakeWindow const& w : d->windows) {
+					if (!add(snapshot, w.handle, w.processId)) return;
+				}
+			};
+			provider.isVisible = [](void* context, WQWindow window) {
+				return static_cast<FakeDesktop*>(context)->get(window).visible ? 1 : 0;
+			};
+			provider.hasOwner = [](void* context, WQWindow window) {
+				return static_cast<FakeDesktop*>(context)->get(window).owned ? 1 : 0;
+			};
+			provider.getClassName = [](void*, WQWindow, wchar_t* buf, size_t) -> size_t {
+				buf[0] = 0;
+				return 0;
+			};
+			provider.getProcessImage = [](void* context, uint32_t, wchar_t* buf, size_t) -> size_t {
+				// the finder only filters by process id
+				static_cast<FakeDesktop*>(context)->windowImageQueries++;
+				buf[0] = 0;
+				return 0;
+			};
+		}
+
+		FakeDesktop(FakeDesktop const&) = delete;
+		FakeDesktop& operator=(FakeDesktop const&) = delete;
+
+		void getProcesses(std::vector<KeePassWindowFinder::ProcessInfo>& outProcesses) override {
+			for (auto const& p : processes) {
+				const size_t sep = p.second.path.find_last_of(L'\\');
+				outProcesses.push_back({ p.first, p.second.path.substr(sep + 1) });
+			}
+		}
+
+		uint64_t getProcessCreationTime(uint32_t processId) override {
+			auto it = processes.find(processId);
+			return (it == processes.end() || denied.count(processId) > 0) ? 0 : it->second.creationTime;
+		}
+
+		std::wstring getProcessImagePath(uint32_t processId) override {
+			imageQueries.push_back(processId);
+			auto it = processes.find(processId);
+			return (it == processes.end() || denied.count(processId) > 0) ? std::wstring{} : it->second.path;
+		}
+
+		FakeWindow const& get(WQWindow window) const {
+			for (FakeWindow const& w : windows) {
+				if (w.handle == window) return w;
+			}
+			CHECK(false);
+			return windows.front();
+		}
+
+		std::map<uint32_t, FakeProcess> processes;
+		// processes which cannot be opened, e.g. of other users
+		std::map<uint32_t, bool> denied;
+		std::vector<FakeWindow> windows;
+		WQProvider provider{};
+		std::vector<uint32_t> imageQueries;
+		size_t windowImageQueries = 0;
+	};
+
+	void testNotRunning() {
+		FakeDesktop desktop;
+		desktop.processes[4] = { 1, L"C:\\Windows\\explorer.exe" };
+		desktop.windows = { { 0x100, 4, true, false } };
+		KeePassWindowFinder finder{ desktop, desktop.provider };
+
+		const KeePassWindowFinder::Match match = finder.find(k_keePass);
+		CHECK(match.window == 0);
+		CHECK(match.processId == 0);
+		// other processes are not opened
+		CHECK(desktop.imageQueries.empty());
+		CHECK(finder.getCachedImageCount() == 0);
+	}
+
+	void testPidFilter() {
+		FakeDesktop desktop;
+		desktop.processes[4] = { 1, L"C:\\Windows\\explorer.exe" };
+		desktop.processes[8] = { 2, k_keePass };
+		desktop.processes[12] = { 3, L"C:\\Tools\\notepad.exe" };
+		desktop.windows = {
+			// windows of other processes, above the KeePass window in z-order
+			{ 0x100, 4, true, false },
+			{ 0x104, 12, true, false },
+			// hidden and owned windows of KeePass, e.g. tool tips and dialogs
+			{ 0x108, 8, false, false },
+			{ 0x10c, 8, true, true },
+			{ 0x110, 8, true, false },
+			{ 0x114, 12, true, false },
+		};
+		KeePassWindowFinder finder{ desktop, desktop.provider };
+
+		const KeePassWindowFinder::Match match = finder.find(k_keePass);
+		CHECK(match.window == 0x110);
+		CHECK(match.processId == 8);
+		// only the KeePass process was opened, and no process per window
+		CHECK(desktop.imageQueries == std::vector<uint32_t>{ 8 });
+		CHECK(desktop.windowImageQueries == 0);
+
+		// the executable name is compared ignoring case
+		CHECK(finder.find(L"D:\\PortableApps\\KEEPASS.EXE").window == 0x110);
+
+		// a process without visible unowned top-level window is not found
+		desktop.windows.erase(desktop.windows.begin() + 4);
+		CHECK(finder.find(k_keePass).window == 0);
+	}
+
+	void testPrefersSamePath() {
+		FakeDesktop desktop;
+		desktop.processes[8] = { 1, L"D:\\Portable\\KeePass.exe" };
+		desktop.processes[12] = { 2, k_keePass };
+		desktop.processes[16] = { 3, L"E:\\Backup\\keepass.exe" };
+		desktop.windows = {
+			{ 0x100, 8, true, false },
+			{ 0x104, 16, true, false },
+			{ 0x108, 12, true, false },
+		};
+		KeePassWindowFinder finder{ desktop, desktop.provider };
+
+		KeePassWindowFinder::Match match = finder.find(k_keePass);
+		CHECK(match.window == 0x108);
+		CHECK(match.processId == 12);
+
+		// the configured path compares ignoring case
+		std::wstring upper = k_keePass;
+		for (wchar_t& c : upper) c = static_cast<wchar_t>(std::towupper(c));
+		CHECK(finder.find(upper).processId == 12);
+
+		// without a process of the same path, the last candidate window in z-order
+		match = finder.find(L"F:\\Other\\KeePass.exe");
+		CHECK(match.window == 0x108);
+
+		// a process which cannot be opened is still a candidate, but never matches the path
+		desktop.processes.erase(12);
+		desktop.denied[16] = true;
+		match = finder.find(L"E:\\Backup\\keepass.exe");
+		CHECK(match.window == 0x104);
+		CHECK(match.processId == 16);
+	}
+
+	void testImageCache() {
+		FakeDesktop desktop;
+		desktop.processes[8] = { 1, k_keePass };
+		desktop.processes[12] = { 2, L"D:\\Portable\\KeePass.exe" };
+		desktop.windows = { { 0x100, 8, true, false }, { 0x104, 12, true, false } };
+		KeePassWindowFinder finder{ desktop, desktop.provider };
+
+		CHECK(finder.find(k_keePass).processId == 8);
+		CHECK(finder.getCachedImageCount() == 2);
+		CHECK(desktop.imageQueries.size() == 2);
+
+		// image paths are queried once per process
+		CHECK(finder.find(k_keePass).processId == 8);
+		CHECK(finder.find(k_keePass).processId == 8);
+		CHECK(desktop.imageQueries.size() == 2);
+
+		// a reused process id is detected by its creation time
+		desktop.processes[8] = { 5, L"C:\\Temp\\KeePass.exe" };
+		CHECK(finder.find(k_keePass).processId == 12);
+		CHECK(desktop.imageQueries == (std::vector<uint32_t>{ 8, 12, 8 }));
+		CHECK(finder.getCachedImageCount() == 2);
+
+		// ended processes are evicted
+		desktop.processes.erase(12);
+		desktop.windows.pop_back();
+		CHECK(finder.find(k_keePass).processId == 8);
+		CHECK(finder.getCachedImageCount() == 1);
+
+		desktop.processes.clear();
+		desktop.windows.clear();
+		CHECK(finder.find(k_keePass).window == 0);
+		CHECK(finder.getCachedImageCount() == 0);
+
+		// a process which cannot be opened is not cached
+		desktop.processes[20] = { 9, k_keePass };
+		desktop.denied[20] = true;
+		desktop.windows = { { 0x200, 20, true, false } };
+		CHECK(finder.find(k_keePass).processId == 20);
+		CHECK(finder.getCachedImageCount() == 0);
+		desktop.denied.clear();
+		CHECK(finder.find(k_keePass).processId == 20);
+		CHECK(finder.getCachedImageCount() == 1);
+	}
+
+}
+
+int main() {
+	testNotRunning();
+	testPidFilter();
+	testPrefersSamePath();
+	testImageCache();
+	return 0;
+}
@@ -0,0 +1,179 @@
+//
+// KeePassHotKey
+// ResidentLoopTest.cpp
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "ResidentLoop.h"
+#include "UnixSocketChannel.h"
+#include "TestUtils.h"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+	std::string socketPath() {
+		return "/tmp/ResidentLoopTest-" + std::to_string(getpid()) + ".sock";
+	}
+
+	// a later instance of the app, which signals the first one and exits
+	void signal(InstanceMessage msg) {
+		UnixSocketChannel later{ socketPath() };
+		CHECK(!later.initOrSignal(msg));
+	}
+
+	class RecordingActions : public ResidentLoop::Actions {
+	public:
+		bool press() override {
+			if (onPress) onPress();
+			return stayResident;
+		}
+		std::function<void()> onPress;
+		bool stayResident = true;
+	};
+
+	void testActivate() {
+		UnixSocketChannel first{ socketPath() };
+		CHECK(first.initOrSignal(InstanceMessage::Activate));
+		// calling again keeps being the first instance
+		CHECK(first.initOrSignal(InstanceMessage::Activate));
+
+		RecordingActions actions;
+		ResidentLoop loop{ first, actions };
+		CHECK(loop.step(0));
+		CHECK(loop.getPressCount() == 0);
+
+		signal(InstanceMessage::Activate);
+		CHECK(loop.step(1000));
+		CHECK(loop.getPressCount() == 1);
+		CHECK(loop.getState() == ResidentLoop::State::Idle);
+
+		signal(InstanceMessage::Activate);
+		CHECK(loop.step(1000));
+		CHECK(loop.getPressCount() == 2);
+		CHECK(loop.step(0));
+		CHECK(loop.getPressCount() == 2);
+	}
+
+	void testPressesWhilePressedAreDropped() {
+		UnixSocketChannel first{ socketPath() };
+		CHECK(first.initOrSignal(InstanceMessage::Activate));
+
+		RecordingActions actions;
+		ResidentLoop loop{ first, actions };
+		actions.onPress = [&]() {
+			CHECK(loop.getState() == ResidentLoop::State::Pressed);
+			// e.g. pressing the hot key again while the confirmation dialog is shown
+			signal(InstanceMessage::Activate);
+			signal(InstanceMessage::Activate);
+		};
+
+		signal(InstanceMessage::Activate);
+		CHECK(loop.step(1000));
+		CHECK(loop.getPressCount() == 1);
+		CHECK(loop.step(0));
+		CHECK(loop.getPressCount() == 1);
+	}
+
+	void testQuit() {
+		UnixSocketChannel first{ socketPath() };
+		CHECK(first.initOrSignal(InstanceMessage::Activate));
+
+		RecordingActions actions;
+		ResidentLoop loop{ first, actions };
+		signal(InstanceMessage::Quit);
+		CHECK(!loop.step(1000));
+		CHECK(loop.getState() == ResidentLoop::State::Stopped);
+
+		// stays stopped, even if later instances still signal
+		signal(InstanceMessage::Activate);
+		CHECK(!loop.step(0));
+		CHECK(loop.getPressCount() == 0);
+		CHECK(first.receive(0) == InstanceMessage::Quit);
+	}
+
+	void testQuitWhilePressedIsKept() {
+		UnixSocketChannel first{ socketPath() };
+		CHECK(first.initOrSignal(InstanceMessage::Activate));
+
+		RecordingActions actions;
+		actions.onPress = []() {
+			signal(InstanceMessage::Activate);
+			signal(InstanceMessage::Quit);
+		};
+		ResidentLoop loop{ first, actions };
+
+		signal(InstanceMessage::Activate);
+		signal(InstanceMessage::Activate);
+		// handles the first press; dropping the presses signaled meanwhile keeps the quit
+		loop.run();
+		CHECK(loop.getPressCount() == 1);
+		CHECK(loop.getState() == ResidentLoop::State::Stopped);
+	}
+
+	void testPressStops() {
+		UnixSocketChannel first{ socketPath() };
+		CHECK(first.initOrSignal(InstanceMessage::Activate));
+
+		RecordingActions actions;
+		actions.stayResident = false;
+		ResidentLoop loop{ first, actions };
+
+		signal(InstanceMessage::Activate);
+		CHECK(!loop.step(1000));
+		CHECK(loop.getPressCount() == 1);
+		CHECK(loop.getState() == ResidentLoop::State::Stopped);
+		CHECK(!loop.step(0));
+	}
+
+	void testStaleSocketFile() {
+		// left behind by a crashed first instance
+		const std::string path = socketPath();
+		int s = socket(AF_UNIX, SOCK_DGRAM, 0);
+		CHECK(s >= 0);
+		sockaddr_un addr{};
+		addr.sun_family = AF_UNIX;
+		std::snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path.c_str());
+		CHECK(bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+		close(s);
+		CHECK(access(path.c_str(), F_OK) == 0);
+
+		{
+			UnixSocketChannel first{ path };
+			CHECK(first.initOrSignal(InstanceMessage::Activate));
+			signal(InstanceMessage::Activate);
+			CHECK(first.receive(1000) == InstanceMessage::Activate);
+		}
+		// the first instance removes its socket file when it exits
+		CHECK(access(path.c_str(), F_OK) != 0);
+	}
+
+}
+
+int main() {
+	testActivate();
+	testPressesWhilePressedAreDropped();
+	testQuit();
+	testQuitWhilePressedIsKept();
+	testPressStops();
+	testStaleSocketFile();
+	return 0;
+}
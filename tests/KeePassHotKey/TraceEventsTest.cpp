@@ -0,0 +1,121 @@
+//
+// KeePassHotKey
+// TraceEventsTest.cpp
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "TraceWriter.h"
+#include "TestUtils.h"
+
+#include <random>
+#include <string>
+
+namespace {
+
+	class MemoryOutput : public TraceWriter::Output {
+	public:
+		bool write(const char* data, size_t size) override {
+			this->data.append(data, size);
+			return true;
+		}
+		bool rotate() override {
+			return false;
+		}
+		std::string data;
+	};
+
+	// independent of the time zone of the test machine
+	void utcTime(std::time_t time, std::tm& outTm) {
+		outTm = *std::gmtime(&time);
+	}
+
+	uint64_t g_nowUs = 1700000000000000ull;
+
+	uint64_t testClock() {
+		return g_nowUs += 137;
+	}
+
+	// random sequences of events and text, logged before or after the output is set:
+	// each binary trace decodes to exactly the text trace
+	void testRoundTrip() {
+		std::mt19937 rng{ 3 };
+		for (int iteration = 0; iteration < 2000; ++iteration) {
+			TraceWriter text{ &utcTime, &testClock };
+			TraceWriter binary{ &utcTime, &testClock };
+			text.setProcessId(0x1234);
+			binary.setProcessId(0x1234);
+			binary.setBinary(true);
+			text.setMaxFileSize(0);
+			binary.setMaxFileSize(0);
+
+			MemoryOutput textOut, binaryOut;
+			const bool pendingFirst = (rng() % 2) != 0;
+			if (!pendingFirst) {
+				text.setOutput(&textOut, 0);
+				binary.setOutput(&binaryOut, 0);
+			}
+
+			for (int n = rng() % 40; n > 0; --n) {
+				const bool isText = (rng() % 3) == 0;
+				const TraceEvent event = static_cast<TraceEvent>(1 + rng() % (static_cast<unsigned>(TraceEvent::Count) - 1));
+				const int64_t arg = static_cast<int64_t>(rng()) - (1ll << 31);
+				std::string msg;
+				for (int c = rng() % 70; c > 0; --c) {
+					msg += "ab\tc\xc3\xa4|\n"[rng() % 9];
+				}
+
+				// both writers see the same time
+				const uint64_t now = g_nowUs;
+				if (isText) text.log(msg); else text.logEvent(event, { arg });
+				g_nowUs = now;
+				if (isText) binary.log(msg); else binary.logEvent(event, { arg });
+			}
+
+			if (pendingFirst) {
+				text.setOutput(&textOut, 0);
+				binary.setOutput(&binaryOut, 0);
+			}
+			text.flush();
+			binary.flush();
+
+			CHECK(binaryOut.data.size() % sizeof(TraceRecord) == 0);
+			std::string decoded, error;
+			CHECK(decodeTrace(binaryOut.data, &utcTime, decoded, error));
+			CHECK(decoded == textOut.data);
+		}
+	}
+
+	void testMalformed() {
+		std::string out, error;
+		CHECK(!decodeTrace(std::string(sizeof(TraceRecord) + 1, '\0'), &utcTime, out, error));
+
+		std::string unknownEvent(sizeof(TraceRecord), '\0');
+		unknownEvent[12] = 100;
+		CHECK(!decodeTrace(unknownEvent, &utcTime, out, error));
+
+		// a text argument longer than the records following it
+		std::string truncatedText;
+		encodeTraceText(g_nowUs, 1, std::string(100, 'x'), truncatedText);
+		truncatedText.resize(truncatedText.size() - sizeof(TraceRecord));
+		CHECK(!decodeTrace(truncatedText, &utcTime, out, error));
+	}
+
+}
+
+int main() {
+	testRoundTrip();
+	testMalformed();
+	return 0;
+}
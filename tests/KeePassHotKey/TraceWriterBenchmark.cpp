@@ -0,0 +1,144 @@
+//
+// KeePassHotKey
+// TraceWriterBenchmark.cpp
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "TraceWriter.h"
+#include "BenchUtils.h"
+#include "TestUtils.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace {
+
+	// the file kept open in append mode, as `TraceFile` does on Windows
+	class FileOutput : public TraceWriter::Output {
+	public:
+		FileOutput(std::string const& path) : m_path(path) {
+			m_fd = ::open(m_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+		}
+		~FileOutput() {
+			if (m_fd >= 0) ::close(m_fd);
+		}
+		bool write(const char* data, size_t size) override {
+			return m_fd >= 0 && ::write(m_fd, data, size) == static_cast<ssize_t>(size);
+		}
+		bool rotate() override {
+			return false;
+		}
+	private:
+		std::string m_path;
+		int m_fd = -1;
+	};
+
+	// as `TraceFile` wrote each line before `TraceWriter`: open, seek to the end, four writes, close
+	void appendLine(std::string const& path, std::string const& msg, std::string const& prefix) {
+		const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+		CHECK(fd >= 0);
+		::lseek(fd, 0, SEEK_END);
+
+		std::stringstream pre;
+		std::time_t t = std::time(nullptr);
+		std::tm tm;
+		localtime_r(&t, &tm);
+		pre << std::put_time(&tm, "%Y.%m.%dT%T") << "|";
+		std::string pp = pre.str();
+		DoNotOptimize(::write(fd, pp.c_str(), pp.size()));
+		DoNotOptimize(::write(fd, prefix.c_str(), prefix.size()));
+		DoNotOptimize(::write(fd, msg.c_str(), msg.size()));
+		DoNotOptimize(::write(fd, "\n", 1));
+
+		::close(fd);
+	}
+
+	void localTime(std::time_t time, std::tm& outTm) {
+		localtime_r(&time, &outTm);
+	}
+
+	uint64_t clockUs() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count());
+	}
+
+}
+
+// Writing trace lines through the open file, in text and binary mode, against opening and closing the file per line
+int main(int argc, char** argv) {
+	Benchmark bench{ argc, argv };
+
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "TraceWriterBenchmark";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	const std::string textPath = (dir / "text.log").string();
+	const std::string binaryPath = (dir / "binary.log").string();
+	const std::string basePath = (dir / "base.log").string();
+	const std::string msg = "Hot key triggered; searching KeePass main window";
+	const size_t lines = 20000;
+
+	{
+		TraceWriter writer{ &localTime, &clockUs };
+		writer.setProcessId(0x1234);
+		writer.setMaxFileSize(0);
+		FileOutput output{ textPath };
+		writer.setOutput(&output, 0);
+		bench.Run("TraceWriter::log, text", lines, [&](size_t) {
+			writer.log(msg);
+		});
+		bench.Run("TraceWriter::logEvent, text", lines, [&](size_t i) {
+			writer.logEvent(TraceEvent::KeePassFound, { static_cast<int64_t>(i), 0x4711 });
+		});
+		writer.flush();
+		writer.setOutput(nullptr, 0);
+	}
+
+	{
+		TraceWriter writer{ &localTime, &clockUs };
+		writer.setProcessId(0x1234);
+		writer.setBinary(true);
+		writer.setMaxFileSize(0);
+		FileOutput output{ binaryPath };
+		writer.setOutput(&output, 0);
+		bench.Run("TraceWriter::logEvent, binary", lines, [&](size_t i) {
+			writer.logEvent(TraceEvent::KeePassFound, { static_cast<int64_t>(i), 0x4711 });
+		});
+		writer.flush();
+		writer.setOutput(nullptr, 0);
+	}
+
+	const std::string prefix = "00001234| ";
+	bench.Run("open, write, close per line", lines, [&](size_t) {
+		appendLine(basePath, msg, prefix);
+	});
+
+	// the text lines equal the lines written before, up to the time stamp
+	std::string textLine, baseLine;
+	std::getline(std::ifstream{ textPath }, textLine);
+	std::getline(std::ifstream{ basePath }, baseLine);
+	CHECK(textLine.size() == baseLine.size());
+	CHECK(textLine.substr(textLine.size() - msg.size()) == msg);
+	CHECK(baseLine.substr(19) == textLine.substr(19));
+	CHECK(std::filesystem::file_size(binaryPath) > 0);
+
+	std::filesystem::remove_all(dir);
+	return 0;
+}
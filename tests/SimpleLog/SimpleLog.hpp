@@ -0,0 +1,84 @@
+#pragma once
+
+// Stand-in for the SGrottel.SimpleLog.Cpp NuGet package, which is only restored by the Windows builds.
+// Only the interface used by the tested sources is provided.
+// Messages are not formatted, as `%s` means a wide string in MSVC's wide printf functions only;
+// the format text is kept, so tests can check what was logged.
+
+#include <string>
+#include <vector>
+
+namespace sgrottel
+{
+	class ISimpleLog
+	{
+	public:
+		enum class Level
+		{
+			Detail,
+			Message,
+			Warning,
+			Error
+		};
+
+		struct Entry
+		{
+			Level level;
+			std::wstring format;
+		};
+
+		virtual ~ISimpleLog() = default;
+
+		template<typename C, typename... ARGS>
+		void Detail(const C* format, ARGS...)
+		{
+			Add(Level::Detail, format);
+		}
+
+		template<typename C, typename... ARGS>
+		void Write(const C* format, ARGS...)
+		{
+			Add(Level::Message, format);
+		}
+
+		template<typename C, typename... ARGS>
+		void Warning(const C* format, ARGS...)
+		{
+			Add(Level::Warning, format);
+		}
+
+		template<typename C, typename... ARGS>
+		void Error(const C* format, ARGS...)
+		{
+			Add(Level::Error, format);
+		}
+
+		size_t Count(Level level) const
+		{
+			size_t n = 0;
+			for (Entry const& e : entries)
+			{
+				if (e.level == level) n++;
+			}
+			return n;
+		}
+
+		std::vector<Entry> entries;
+
+	private:
+		template<typename C>
+		void Add(Level level, const C* format)
+		{
+			std::wstring f;
+			for (const C* c = format; *c != 0; ++c)
+			{
+				f += static_cast<wchar_t>(*c);
+			}
+			entries.push_back({ level, std::move(f) });
+		}
+	};
+
+	class SimpleLog : public ISimpleLog
+	{
+	};
+}
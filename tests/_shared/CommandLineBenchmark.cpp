@@ -0,0 +1,188 @@
+// CommandLine
+// Freely available via Apache License, v2.0; see LICENSE file in the repository root
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "CommandLine/CommandLine.h"
+#include "BenchUtils.h"
+#include "TestUtils.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// quotes each argument into a growing string, character by character
+	std::wstring NaiveBuild(std::vector<std::wstring> const& args)
+	{
+		std::wstring cmdLine;
+		for (std::wstring const& arg : args)
+		{
+			cmdLine += L' ';
+			if (!arg.empty() && arg.find_first_of(L" \t\n\v\"") == std::wstring::npos)
+			{
+				cmdLine += arg;
+				continue;
+			}
+			cmdLine += L'"';
+			size_t backslashes = 0;
+			for (wchar_t c : arg)
+			{
+				if (c == L'\\')
+				{
+					++backslashes;
+					continue;
+				}
+				cmdLine.append(c == L'"' ? backslashes * 2 + 1 : backslashes, L'\\');
+				backslashes = 0;
+				cmdLine += c;
+			}
+			cmdLine.append(backslashes * 2, L'\\');
+			cmdLine += L'"';
+		}
+		return cmdLine;
+	}
+
+	// splits into a new string per argument, character by character
+	std::vector<std::wstring> NaiveParse(std::wstring const& cmdLine)
+	{
+		std::vector<std::wstring> args;
+		size_t i = 0;
+		const size_t n = cmdLine.size();
+		while (true)
+		{
+			while (i < n && (cmdLine[i] == L' ' || cmdLine[i] == L'\t')) ++i;
+			if (i == n) break;
+			std::wstring arg;
+			bool quoted = false;
+			while (i < n && (quoted || (cmdLine[i] != L' ' && cmdLine[i] != L'\t')))
+			{
+				size_t backslashes = 0;
+				while (i < n && cmdLine[i] == L'\\')
+				{
+					++backslashes;
+					++i;
+				}
+				if (i < n && cmdLine[i] == L'"')
+				{
+					arg.append(backslashes / 2, L'\\');
+					if (backslashes % 2 == 1)
+					{
+						arg += L'"';
+					}
+					else if (quoted && i + 1 < n && cmdLine[i + 1] == L'"')
+					{
+						arg += L'"';
+						++i;
+					}
+					else
+					{
+						quoted = !quoted;
+					}
+					++i;
+					continue;
+				}
+				arg.append(backslashes, L'\\');
+				if (i < n && (quoted || (cmdLine[i] != L' ' && cmdLine[i] != L'\t')))
+				{
+					arg += cmdLine[i++];
+				}
+			}
+			args.push_back(std::move(arg));
+		}
+		return args;
+	}
+}
+
+// Quoting and splitting a typical launch command line with the shared code, against building strings per character
+int main(int argc, char** argv)
+{
+	Benchmark bench{ argc, argv };
+
+	const std::vector<std::wstring> args{
+		L"--config", L"C:\\Users\\bob\\AppData\\Roaming\\Tool\\settings.yaml",
+		L"--title", L"Meeting notes \"Q4\" draft",
+		L"--out", L"C:\\Program Files\\Tool\\Output Folder\\",
+		L"--flag", L"", L"--name", L"plain", L"--path", L"D:\\Data\\Sets\\2026\\October",
+	};
+	size_t chars = 0;
+	for (std::wstring const& arg : args) chars += arg.size();
+
+	std::vector<wchar_t> cmdLine;
+	size_t total = 0;
+	const double shared = bench.Run("CLWriteArgument, reused buffer", 200000, [&](size_t)
+		{
+			size_t len = 1;
+			for (std::wstring const& arg : args) len += 1 + CLArgumentLength(arg.data(), arg.size());
+			if (cmdLine.size() < len) cmdLine.resize(len);
+			wchar_t* pos = cmdLine.data();
+			for (std::wstring const& arg : args)
+			{
+				*pos++ = L' ';
+				pos = CLWriteArgument(arg.data(), arg.size(), pos);
+			}
+			*pos = 0;
+			total += static_cast<size_t>(pos - cmdLine.data());
+		});
+	const std::wstring built{ cmdLine.data() };
+	std::wstring naiveBuilt;
+	const double naive = bench.Run("naive std::wstring concatenation", 200000, [&](size_t)
+		{
+			naiveBuilt = NaiveBuild(args);
+			total += naiveBuilt.size();
+		});
+	CHECK(built == naiveBuilt);
+	std::printf("%-48s %12.0f MB/s vs %.0f MB/s\n", "build throughput",
+		chars * sizeof(wchar_t) * 1e3 / shared, chars * sizeof(wchar_t) * 1e3 / naive);
+
+	std::vector<wchar_t> buffer(built.size());
+	std::vector<std::wstring> parsed;
+	const double sharedParse = bench.Run("CLParseArgument, reused buffer", 200000, [&](size_t)
+		{
+			const wchar_t* pos = built.data();
+			const wchar_t* const end = pos + built.size();
+			size_t len = 0;
+			size_t count = 0;
+			while ((pos = CLParseArgument(pos, end, buffer.data(), &len)) != nullptr)
+			{
+				total += len;
+				++count;
+			}
+			total += count;
+		});
+	const double naiveParse = bench.Run("naive split into std::wstring", 200000, [&](size_t)
+		{
+			parsed = NaiveParse(built);
+			total += parsed.size();
+		});
+	CHECK(parsed == args);
+	std::printf("%-48s %12.0f MB/s vs %.0f MB/s\n", "parse throughput",
+		built.size() * sizeof(wchar_t) * 1e3 / sharedParse, built.size() * sizeof(wchar_t) * 1e3 / naiveParse);
+
+	// the shared parser splits the same arguments back
+	std::vector<std::wstring> split;
+	const wchar_t* pos = built.data();
+	const wchar_t* const end = pos + built.size();
+	size_t len = 0;
+	while ((pos = CLParseArgument(pos, end, buffer.data(), &len)) != nullptr)
+	{
+		split.emplace_back(buffer.data(), len);
+	}
+	CHECK(split == args);
+
+	DoNotOptimize(total);
+	return 0;
+}
@@ -0,0 +1,228 @@
+// WindowQuery
+// Freely available via Apache License, v2.0; see LICENSE file in the repository root
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "WindowQuery/WindowQuery.h"
+#include "BenchUtils.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cwctype>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	struct FakeWindow
+	{
+		WQWindow handle;
+		uint32_t processId;
+		bool visible;
+		bool owned;
+		std::wstring className;
+	};
+
+	// a desktop in memory, counting the attribute queries, each of which is a system call on Windows
+	class FakeDesktop
+	{
+	public:
+		FakeDesktop(unsigned windowCount, unsigned processCount)
+		{
+			static const wchar_t* classes[] = { L"SysListView32", L"WindowsForms10.Window.8.app.0.1", L"Button", L"#32770", L"tooltips_class32", L"Chrome_WidgetWin_1" };
+			std::mt19937 rng{ 11 };
+			// the other processes have ids from 12 on
+			for (uint32_t p = 3; p < processCount + 3; ++p)
+			{
+				images[p * 4] = L"C:\\Program Files\\Apps\\proc" + std::to_wstring(p) + L".exe";
+			}
+			images[8] = L"C:\\Program Files\\KeePass Password Safe 2\\KeePass.exe";
+			for (unsigned i = 0; i < windowCount; ++i)
+			{
+				windows.push_back({ 0x10000 + i * 2, static_cast<uint32_t>(rng() % processCount + 3) * 4, rng() % 3 == 0, rng() % 4 == 0, classes[rng() % 6] });
+			}
+			// the main window of KeePass, behind most others
+			windows.push_back({ 0x90000, 8, true, false, L"WindowsForms10.Window.8.app.0.2bf8098_r6_ad1" });
+			for (size_t i = 0; i < windows.size(); ++i)
+			{
+				m_index[windows[i].handle] = i;
+			}
+
+			provider.context = this;
+			provider.enumWindows = [](void* context, WQWindow parent, WQAddWindowFunc add, WQSnapshot* snapshot)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					if (parent != 0) return;
+					for (FakeWindow const& w : d->windows)
+					{
+						if (!add(snapshot, w.handle, w.processId)) return;
+					}
+				};
+			provider.isVisible = [](void* context, WQWindow window)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					d->calls++;
+					return d->Get(window).visible ? 1 : 0;
+				};
+			provider.hasOwner = [](void* context, WQWindow window)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					d->calls++;
+					return d->Get(window).owned ? 1 : 0;
+				};
+			provider.getClassName = [](void* context, WQWindow window, wchar_t* buf, size_t size)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					d->calls++;
+					return Copy(d->Get(window).className, buf, size);
+				};
+			provider.getProcessImage = [](void* context, uint32_t processId, wchar_t* buf, size_t size)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					d->calls++;
+					d->imageCalls++;
+					auto it = d->images.find(processId);
+					return Copy(it == d->images.end() ? std::wstring{} : it->second, buf, size);
+				};
+		}
+
+		FakeDesktop(FakeDesktop const&) = delete;
+		FakeDesktop& operator=(FakeDesktop const&) = delete;
+
+		FakeWindow const& Get(WQWindow window) const
+		{
+			return windows[m_index.at(window)];
+		}
+
+		std::vector<FakeWindow> windows;
+		std::unordered_map<uint32_t, std::wstring> images;
+		WQProvider provider{};
+		size_t calls = 0;
+		size_t imageCalls = 0;
+
+	private:
+		static size_t Copy(std::wstring const& s, wchar_t* buf, size_t size)
+		{
+			const size_t len = std::min(size, s.size());
+			std::copy(s.begin(), s.begin() + len, buf);
+			buf[len] = 0;
+			return len;
+		}
+
+		std::unordered_map<WQWindow, size_t> m_index;
+	};
+
+	bool EqualsNoCase(std::wstring const& a, std::wstring const& b)
+	{
+		return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+			[](wchar_t x, wchar_t y) { return std::towlower(x) == std::towlower(y); });
+	}
+
+	bool ContainsNoCase(std::wstring const& s, std::wstring const& text)
+	{
+		return std::search(s.begin(), s.end(), text.begin(), text.end(),
+			[](wchar_t x, wchar_t y) { return std::towlower(x) == std::towlower(y); }) != s.end();
+	}
+
+	// the search as the tools wrote it before the planner: per window, each attribute in the order of the code,
+	// fetched from the provider every time
+	WQWindow FindDirect(FakeDesktop& desktop, std::wstring const& image, std::wstring const& classText)
+	{
+		WQProvider const& p = desktop.provider;
+		wchar_t buf[WQ_MAX_NAME_LEN + 1];
+		for (FakeWindow const& w : desktop.windows)
+		{
+			p.getProcessImage(p.context, w.processId, buf, WQ_MAX_NAME_LEN);
+			if (!EqualsNoCase(buf, image)) continue;
+			p.getClassName(p.context, w.handle, buf, WQ_MAX_NAME_LEN);
+			if (!ContainsNoCase(buf, classText)) continue;
+			if (p.hasOwner(p.context, w.handle)) continue;
+			if (!p.isVisible(p.context, w.handle)) continue;
+			return w.handle;
+		}
+		return 0;
+	}
+}
+
+// Finding the KeePass main window among 500 windows of 60 processes: the compiled plan on a snapshot,
+// against checking the attributes in code order and fetching them for every check
+int main(int argc, char** argv)
+{
+	Benchmark bench{ argc, argv };
+
+	FakeDesktop desktop{ 500, 60 };
+	const wchar_t* image = L"c:\\program files\\keepass password safe 2\\keepass.exe";
+	const wchar_t* classText = L"windowsforms10.window.8";
+
+	WQWindow found = 0;
+	desktop.calls = 0;
+	desktop.imageCalls = 0;
+	bench.Run("direct attribute checks", 2000, [&](size_t)
+		{
+			found = FindDirect(desktop, image, classText);
+		});
+	CHECK(found == 0x90000);
+	const size_t directCalls = desktop.calls;
+	const size_t directImageCalls = desktop.imageCalls;
+
+	WQQuery query;
+	WQQueryInit(&query);
+	WQQueryProcessImage(&query, image);
+	WQQueryClassContains(&query, classText);
+	WQQueryTopLevel(&query);
+	WQQueryVisible(&query);
+	desktop.calls = 0;
+	desktop.imageCalls = 0;
+	bench.Run("WQQueryRun on a new snapshot", 2000, [&](size_t)
+		{
+			WQSnapshot snapshot;
+			CHECK(WQSnapshotTake(&snapshot, &desktop.provider, 0));
+			found = 0;
+			WQQueryRun(&query, &snapshot, &found, 1);
+			WQSnapshotFree(&snapshot);
+		});
+	CHECK(found == 0x90000);
+	const size_t planCalls = desktop.calls;
+	const size_t planImageCalls = desktop.imageCalls;
+
+	// the image, which costs opening the process on Windows, is fetched once per process, not once per window
+	const double runs = bench.IsSmoke() ? 1.0 : 5.0 * 2000.0;
+	CHECK(planImageCalls <= 61 * runs);
+	std::printf("%-48s %12.1f vs %.1f\n", "provider calls per search", planCalls / runs, directCalls / runs);
+	std::printf("%-48s %12.1f vs %.1f\n", "  of which process images", planImageCalls / runs, directImageCalls / runs);
+
+	// further queries on the same snapshot only fetch the attributes not known yet
+	WQQuery visibleOfKeePass;
+	WQQueryInit(&visibleOfKeePass);
+	const uint32_t keePassId = 8;
+	WQQueryProcessIdIn(&visibleOfKeePass, &keePassId, 1);
+	WQQueryVisible(&visibleOfKeePass);
+	std::vector<WQWindow> all(desktop.windows.size());
+	size_t total = 0;
+	bench.Run("two queries on one snapshot", 2000, [&](size_t)
+		{
+			WQSnapshot snapshot;
+			CHECK(WQSnapshotTake(&snapshot, &desktop.provider, 0));
+			total += WQQueryRun(&query, &snapshot, all.data(), all.size());
+			total += WQQueryRun(&visibleOfKeePass, &snapshot, all.data(), all.size());
+			WQSnapshotFree(&snapshot);
+		});
+
+	DoNotOptimize(total);
+	return 0;
+}
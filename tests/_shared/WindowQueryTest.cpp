@@ -0,0 +1,232 @@
+// WindowQuery
+// Freely available via Apache License, v2.0; see LICENSE file in the repository root
+//
+// Copyright 2026 SGrottel (https://www.sgrottel.de)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "WindowQuery/WindowQuery.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+	struct FakeWindow
+	{
+		WQWindow handle;
+		WQWindow parent;
+		uint32_t processId;
+		bool visible;
+		bool owned;
+		std::wstring className;
+	};
+
+	// a desktop in memory, counting the attribute queries
+	class FakeDesktop
+	{
+	public:
+		FakeDesktop(unsigned windowCount, unsigned processCount, unsigned seed)
+		{
+			static const wchar_t* classes[] = { L"SysListView32", L"WindowsForms10.SysListView32.app.0.1", L"Button", L"#32770", L"tooltips_class32", L"Chrome_WidgetWin_1", L"" };
+			std::mt19937 rng{ seed };
+			for (uint32_t p = 1; p <= processCount; ++p)
+			{
+				// some processes cannot be opened
+				if (rng() % 10 != 0) images[p * 4] = L"C:\\Apps\\proc" + std::to_wstring(p % 7) + L".exe";
+			}
+			images[8] = L"C:\\Apps\\KeePass.exe";
+			images[12] = L"c:\\apps\\KEEPASS.exe";
+			for (unsigned i = 0; i < windowCount; ++i)
+			{
+				windows.push_back({ 0x10000 + i * 2, 0, static_cast<uint32_t>(rng() % processCount + 1) * 4, rng() % 3 == 0, rng() % 4 == 0, classes[rng() % 7] });
+			}
+			for (unsigned i = 0; i < windowCount / 10; ++i)
+			{
+				windows.push_back({ 0x90000 + i * 2, 0x10000 + (rng() % windowCount) * 2, 4, true, false, classes[rng() % 7] });
+			}
+			for (size_t i = 0; i < windows.size(); ++i)
+			{
+				m_index[windows[i].handle] = i;
+			}
+
+			provider.context = this;
+			provider.enumWindows = [](void* context, WQWindow parent, WQAddWindowFunc add, WQSnapshot* snapshot)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					d->enumCalls++;
+					for (FakeWindow const& w : d->windows)
+					{
+						if (w.parent == parent && !add(snapshot, w.handle, w.processId)) return;
+					}
+				};
+			provider.isVisible = [](void* context, WQWindow window)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					d->visibleCalls++;
+					return d->Get(window).visible ? 1 : 0;
+				};
+			provider.hasOwner = [](void* context, WQWindow window)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					d->ownerCalls++;
+					return d->Get(window).owned ? 1 : 0;
+				};
+			provider.getClassName = [](void* context, WQWindow window, wchar_t* buf, size_t size)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					d->classCalls++;
+					return Copy(d->Get(window).className, buf, size);
+				};
+			provider.getProcessImage = [](void* context, uint32_t processId, wchar_t* buf, size_t size)
+				{
+					FakeDesktop* d = static_cast<FakeDesktop*>(context);
+					d->imageCalls++;
+					auto it = d->images.find(processId);
+					return Copy(it == d->images.end() ? std::wstring{} : it->second, buf, size);
+				};
+		}
+
+		FakeDesktop(FakeDesktop const&) = delete;
+		FakeDesktop& operator=(FakeDesktop const&) = delete;
+
+		FakeWindow const& Get(WQWindow window) const
+		{
+			return windows[m_index.at(window)];
+		}
+
+		std::vector<FakeWindow> windows;
+		std::unordered_map<uint32_t, std::wstring> images;
+		WQProvider provider{};
+		size_t enumCalls = 0;
+		size_t visibleCalls = 0;
+		size_t ownerCalls = 0;
+		size_t classCalls = 0;
+		size_t imageCalls = 0;
+
+	private:
+		static size_t Copy(std::wstring const& s, wchar_t* buf, size_t size)
+		{
+			const size_t len = std::min(size, s.size());
+			std::copy(s.begin(), s.begin() + len, buf);
+			buf[len] = 0;
+			return len;
+		}
+
+		std::unordered_map<WQWindow, size_t> m_index;
+	};
+
+	std::wstring Lower(std::wstring s)
+	{
+		for (wchar_t& c : s) c = static_cast<wchar_t>(std::towlower(c));
+		return s;
+	}
+
+	// the compiled plan returns the same windows as checking every predicate on every window
+	void TestPlanMatchesBruteForce()
+	{
+		std::mt19937 rng{ 7 };
+		for (unsigned seed = 0; seed < 1500; ++seed)
+		{
+			FakeDesktop desktop{ 20 + seed % 400, 3 + seed % 30, seed };
+			const WQWindow parent = (seed % 5 == 0) ? desktop.windows[rng() % desktop.windows.size()].handle : 0;
+			WQSnapshot snapshot;
+			CHECK(WQSnapshotTake(&snapshot, &desktop.provider, parent));
+
+			const uint32_t processIds[3] = { 4, 8, static_cast<uint32_t>(rng() % 10) * 4 };
+			for (int q = 0; q < 4; ++q)
+			{
+				const unsigned mask = rng() % 32;
+				const wchar_t* path = (rng() % 2 != 0) ? L"C:\\APPS\\keepass.exe" : L"C:\\Apps\\proc3.exe";
+				const wchar_t* classText = (rng() % 2 != 0) ? L"listview32" : L"b";
+
+				// added in reverse cost order, so the plan must reorder them
+				WQQuery query;
+				WQQueryInit(&query);
+				if (mask & 16) WQQueryProcessImage(&query, path);
+				if (mask & 8) WQQueryClassContains(&query, classText);
+				if (mask & 4) WQQueryTopLevel(&query);
+				if (mask & 2) WQQueryVisible(&query);
+				if (mask & 1) WQQueryProcessIdIn(&query, processIds, 3);
+				const size_t maxCount = (rng() % 3 == 0) ? std::min<size_t>(2, snapshot.count) : snapshot.count;
+
+				std::vector<WQWindow> found(snapshot.count + 1);
+				found.resize(WQQueryRun(&query, &snapshot, found.data(), maxCount));
+				for (unsigned i = 1; i < query.count; ++i)
+				{
+					CHECK(query.predicates[i - 1].kind <= query.predicates[i].kind);
+				}
+
+				std::vector<WQWindow> expected;
+				for (FakeWindow const& w : desktop.windows)
+				{
+					if (w.parent != parent) continue;
+					bool match = true;
+					if (mask & 1) match = match && std::find(processIds, processIds + 3, w.processId) != processIds + 3;
+					if (mask & 2) match = match && w.visible;
+					if (mask & 4) match = match && !w.owned;
+					if (mask & 8) match = match && Lower(w.className).find(Lower(classText)) != std::wstring::npos;
+					if (mask & 16)
+					{
+						auto it = desktop.images.find(w.processId);
+						match = match && it != desktop.images.end() && Lower(it->second) == Lower(path);
+					}
+					if (match && expected.size() < maxCount) expected.push_back(w.handle);
+				}
+				CHECK(found == expected);
+			}
+
+			// one enumeration; each attribute at most once per window, each image at most once per process
+			std::unordered_set<uint32_t> processes;
+			for (FakeWindow const& w : desktop.windows)
+			{
+				if (w.parent == parent) processes.insert(w.processId);
+			}
+			CHECK(desktop.enumCalls == 1);
+			CHECK(desktop.visibleCalls <= snapshot.count);
+			CHECK(desktop.ownerCalls <= snapshot.count);
+			CHECK(desktop.classCalls <= snapshot.count);
+			CHECK(desktop.imageCalls <= processes.size());
+			WQSnapshotFree(&snapshot);
+		}
+	}
+
+	// the image is the most expensive attribute, and not queried if a cheaper predicate fails
+	void TestPlanOrder()
+	{
+		FakeDesktop desktop{ 1000, 50, 1 };
+		WQSnapshot snapshot;
+		CHECK(WQSnapshotTake(&snapshot, &desktop.provider, 0));
+		WQQuery query;
+		WQQueryInit(&query);
+		WQQueryProcessImage(&query, L"C:\\Apps\\KeePass.exe");
+		WQQueryProcessIdIn(&query, nullptr, 0);
+		std::vector<WQWindow> found(snapshot.count);
+		CHECK(WQQueryRun(&query, &snapshot, found.data(), found.size()) == 0);
+		CHECK(desktop.imageCalls == 0);
+		WQSnapshotFree(&snapshot);
+	}
+}
+
+int main()
+{
+	TestPlanMatchesBruteForce();
+	TestPlanOrder();
+	return 0;
+}